@@ -0,0 +1,80 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file bench_bars.c
+ * @brief Micro-benchmark of progress bar rendering
+ *
+ * Renders the context gauge line (label, bar, value) into a memory stream
+ * for every fill level, comparing the per-cell loop used with theme colors
+ * against the precomputed gradient tables (256-color and truecolor).
+ *
+ * Usage: bench-bars [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "src/display.h"
+#include "src/render_ctx.h"
+
+#define BENCH_DEFAULT_ITERATIONS 200000
+#define BENCH_FILL_LEVELS 21
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * Average nanoseconds and output bytes per rendered line
+ */
+static void bench_mode(const char *name,
+                       enum mccs_gradient_mode mode,
+                       long iterations) {
+  char *buf = NULL;
+  size_t len = 0;
+  FILE *out = open_memstream(&buf, &len);
+  if (!out) {
+    perror("open_memstream");
+    exit(1);
+  }
+
+  struct mccs_render_ctx ctx;
+  mccs_render_ctx_init(&ctx, true, false, out);
+  ctx.gradient = mode;
+
+  size_t bytes = 0;
+  double start = now_ns();
+  for (long i = 0; i < iterations; i++) {
+    // Walk all fill levels: 0%, 5%, ... 100% of the context limit
+    uint64_t tokens = (uint64_t)(i % BENCH_FILL_LEVELS) * (DEFAULT_TOKEN_LIMIT / 20);
+    rewind(out);
+    print_context_percentage(&ctx, tokens, true);
+    bytes += (size_t)ftell(out);
+  }
+  double elapsed = now_ns() - start;
+
+  printf("%-10s %8.1f ns/render %8.1f bytes/render\n",
+         name, elapsed / (double)iterations, (double)bytes / (double)iterations);
+
+  fclose(out);
+  free(buf);
+  mccs_render_ctx_free(&ctx);
+}
+
+int main(int argc, char *argv[]) {
+  long iterations = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_ITERATIONS;
+  if (iterations <= 0) {
+    fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  printf("Context bar, %ld renders per mode\n", iterations);
+  bench_mode("loop", MCCS_GRADIENT_OFF, iterations);
+  bench_mode("256", MCCS_GRADIENT_256, iterations);
+  bench_mode("truecolor", MCCS_GRADIENT_TRUECOLOR, iterations);
+  return 0;
+}
@@ -0,0 +1,239 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file bench_cache.c
+ * @brief Cost of session cache validity checks, hashed vs string identity
+ *
+ * Checks a few session cache records over and over (the record a render
+ * has just read), then a table larger than the last-level cache in random
+ * order, where each check pays for the memory it touches. The current record (hashes and headline totals in the first
+ * cache line, strings in a cold tail compared when the file is read) is
+ * compared with the previous layout, which kept the session ID and project
+ * directory right after the magic and strcmp'd both on every check:
+ *
+ *   hit            record of the current session, then its headline totals read
+ *   other session  record of another session in the same project
+ *   other project  same session ID, another project directory
+ *
+ * Then times reading a record file for a hit and for another project:
+ * load_cache() (first line, the rest on a hash match) against a whole-record
+ * read_cache_file(). Also reports what hashing the identity costs once per
+ * render.
+ *
+ * Usage: bench-cache [records]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "src/cache.h"
+
+#define BENCH_DEFAULT_RECORDS 32768
+#define BENCH_ROUNDS 5
+#define BENCH_RESIDENT 16 /* Records checked over and over (as after a read) */
+#define BENCH_FILE_READS 20000
+
+/**
+ * Layout before the hot/cold split (same size as struct token_cache)
+ */
+struct bench_old_record {
+  uint32_t magic;
+  int64_t last_update_time;
+  char session_id[BUF_SESSION_ID_SIZE];
+  char project_dir[BUF_PATH_SIZE];
+  uint64_t total_tokens;
+  uint64_t context_tokens;
+  double cost_usd;
+  char rest[sizeof(struct token_cache) - 8 - 8 - BUF_SESSION_ID_SIZE - BUF_PATH_SIZE - 24];
+  bool partial;
+};
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * is_cache_valid() before the split (out of line and reading the clock like it)
+ */
+__attribute__((noinline)) static bool bench_old_valid(const struct bench_old_record *cache,
+                                                      const char *session_id,
+                                                      const char *project_dir) {
+  if (cache->magic != CACHE_MAGIC || (session_id && strcmp(cache->session_id, session_id) != 0) ||
+      (project_dir && strcmp(cache->project_dir, project_dir) != 0)) {
+    return false;
+  }
+  int64_t now = (int64_t)time(NULL);
+  return now - cache->last_update_time <= CACHE_MAX_AGE_S || cache->partial;
+}
+
+/**
+ * What a hit reads after the check: the headline totals
+ */
+static uint64_t bench_old_headline(const struct bench_old_record *cache) {
+  return cache->total_tokens + cache->context_tokens + (uint64_t)cache->cost_usd;
+}
+
+static uint64_t bench_headline(const struct token_cache *cache) {
+  return cache->session_total_tokens + cache->context_tokens + (uint64_t)cache->cost_usd;
+}
+
+/**
+ * Time reading one record file, the whole record against load_cache()
+ * (both find the file from the session ID)
+ *
+ * @param ctx    Render context (owns the cache path buffers)
+ * @param id     Identity the record is read for
+ * @param out    Output: ns per read, whole record then load_cache()
+ */
+static size_t bench_file_reads(struct mccs_render_ctx *ctx,
+                               const struct cache_identity *id,
+                               double out[2]) {
+  size_t valid = 0;
+  for (int mode = 0; mode < 2; mode++) {
+    double best = 0;
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+      double start = now_ns();
+      for (int k = 0; k < BENCH_FILE_READS; k++) {
+        ResultTokenCache result = mode == 0 ? read_cache_file(get_cache_path(ctx, id->session_id)) : load_cache(ctx, id);
+        valid += IS_OK(result) && (mode == 1 || is_cache_valid(&UNWRAP_OK(result), id));
+      }
+      double elapsed = (now_ns() - start) / BENCH_FILE_READS;
+      best = r == 0 || elapsed < best ? elapsed : best;
+    }
+    out[mode] = best;
+  }
+  return valid;
+}
+
+static void bench_session(char *out,
+                          size_t i) {
+  snprintf(out, BUF_SESSION_ID_SIZE, "%08zx-4b1e-4c6a-9f3d-%012zx", i * 2654435761UL, i);
+}
+
+static void bench_project(char *out,
+                          size_t i) {
+  snprintf(out, BUF_PATH_SIZE, "/home/developer/src/github.com/organization/project-%zu", i % 8);
+}
+
+int main(int argc,
+         char *argv[]) {
+  long count = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_RECORDS;
+  if (count <= 0) {
+    count = BENCH_DEFAULT_RECORDS;
+  }
+  size_t n = (size_t)count;
+
+  struct token_cache *records = aligned_alloc(CACHE_LINE_SIZE, n * sizeof(*records));
+  struct bench_old_record *old = aligned_alloc(CACHE_LINE_SIZE, n * sizeof(*old));
+  char(*sessions)[BUF_SESSION_ID_SIZE] = malloc(n * BUF_SESSION_ID_SIZE);
+  char(*projects)[BUF_PATH_SIZE] = malloc(n * BUF_PATH_SIZE);
+  size_t *order = malloc(n * sizeof(*order));
+  struct cache_identity *ids = malloc(n * sizeof(*ids));
+  if (!records || !old || !sessions || !projects || !order || !ids) {
+    perror("alloc");
+    return 1;
+  }
+
+  int64_t now = (int64_t)time(NULL);
+  for (size_t i = 0; i < n; i++) {
+    bench_session(sessions[i], i);
+    bench_project(projects[i], i);
+    memset(&records[i], 0, sizeof(records[i]));
+    records[i].magic = CACHE_MAGIC;
+    records[i].last_update_time = now;
+    records[i].session_total_tokens = i;
+    struct cache_identity id;
+    cache_identity_init(&id, sessions[i], projects[i], "");
+    cache_set_identity(&records[i], &id);
+    memset(&old[i], 0, sizeof(old[i]));
+    old[i].magic = CACHE_MAGIC;
+    old[i].last_update_time = now;
+    old[i].total_tokens = i;
+    memcpy(old[i].session_id, sessions[i], BUF_SESSION_ID_SIZE);
+    memcpy(old[i].project_dir, projects[i], BUF_PATH_SIZE);
+    order[i] = i;
+  }
+  srand(42);
+  for (size_t i = n - 1; i > 0; i--) {
+    size_t j = (size_t)rand() % (i + 1);
+    size_t t = order[i];
+    order[i] = order[j];
+    order[j] = t;
+  }
+
+  printf("records of %zu bytes, ns per check (best of %d): %d resident records, %zu in random order\n",
+         sizeof(struct token_cache), BENCH_ROUNDS, BENCH_RESIDENT, n);
+  printf("%-14s %10s %10s %10s %10s\n", "case", "strings", "hashed", "strings", "hashed");
+
+  const char *names[] = {"hit", "other session", "other project"};
+  static const char other_project[] = "/home/developer/src/github.com/organization/elsewhere";
+  size_t valid = 0;
+  for (int c = 0; c < 3; c++) {
+    // What each render checks its record against; the identity hashes once per render
+    for (size_t i = 0; i < n; i++) {
+      cache_identity_init(&ids[i], sessions[c == 1 ? (i + 8) % n : i], c == 2 ? other_project : projects[i], NULL);
+    }
+    double best[4] = {0, 0, 0, 0};
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+      for (int mode = 0; mode < 4; mode++) {
+        bool resident = mode < 2;
+        double start = now_ns();
+        for (size_t k = 0; k < n; k++) {
+          size_t i = resident ? k % BENCH_RESIDENT : order[k];
+          if (mode % 2 == 0) {
+            valid += bench_old_valid(&old[i], ids[i].session_id, ids[i].project_dir) && bench_old_headline(&old[i]);
+          } else {
+            valid += is_cache_valid(&records[i], &ids[i]) && bench_headline(&records[i]);
+          }
+        }
+        double elapsed = (now_ns() - start) / (double)n;
+        best[mode] = r == 0 || elapsed < best[mode] ? elapsed : best[mode];
+      }
+    }
+    printf("%-14s %10.1f %10.1f %10.1f %10.1f\n", names[c], best[0], best[1], best[2], best[3]);
+  }
+
+  // Reading the record file: one for the first session, checked as itself and from another project
+  struct mccs_render_ctx ctx;
+  mccs_render_ctx_init(&ctx, false, false, NULL);
+  struct cache_identity id;
+  cache_identity_init(&id, "bench-cache-file", projects[0], "/home/developer/.claude/projects/x/session.jsonl");
+  struct token_cache record = records[0];
+  cache_set_identity(&record, &id);
+  if (IS_ERR(save_cache(&ctx, &record, id.session_id))) {
+    perror("save_cache");
+    return 1;
+  }
+  printf("%-14s %10s %10s   (ns per file read)\n", "file", "whole", "load");
+  double reads[2];
+  valid += bench_file_reads(&ctx, &id, reads);
+  printf("%-14s %10.0f %10.0f\n", "hit", reads[0], reads[1]);
+  cache_identity_init(&id, "bench-cache-file", other_project, "/home/developer/.claude/projects/x/session.jsonl");
+  valid += bench_file_reads(&ctx, &id, reads);
+  printf("%-14s %10.0f %10.0f\n", "other project", reads[0], reads[1]);
+  unlink(get_cache_path(&ctx, id.session_id));
+  mccs_render_ctx_free(&ctx);
+
+  // The hashes a render computes once for its checks (strings already in cache)
+  const long hashes = 1000000;
+  double start = now_ns();
+  for (long k = 0; k < hashes; k++) {
+    cache_identity_init(&id, sessions[k & 7], projects[k & 7], "/home/developer/.claude/projects/x/session.jsonl");
+    valid += id.owner_hash == 0;
+  }
+  printf("identity hashing, once per render: %.1f ns\n", (now_ns() - start) / (double)hashes);
+
+  free(records);
+  free(old);
+  free(sessions);
+  free(projects);
+  free(order);
+  free(ids);
+  return valid == 0;
+}
@@ -0,0 +1,210 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file bench_chunks.c
+ * @brief First render of resumed and forked sessions with the chunk store
+ *
+ * Writes a synthetic transcript (assistant lines of about 2 KB with usage)
+ * and times the first parse of the transcripts a new session would start
+ * with, against a full parse without the store:
+ *
+ *   record   first session, every chunk end written to the store
+ *   resume   old transcript copied whole, plus new turns
+ *   fork     first half of the old transcript, then different turns
+ *   unknown  unrelated transcript (lookup cost when nothing matches)
+ *
+ * Usage: bench-chunks [megabytes]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "src/chunk_store.h"
+#include "src/json_tape.h"
+#include "src/token_calculator.h"
+
+#define BENCH_DEFAULT_MB 16
+#define BENCH_ROUNDS 9
+#define BENCH_NEW_TURNS 40
+
+static double now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+/**
+ * Append turns [first, first + count) of a session variant to fp
+ */
+static size_t bench_turns(FILE *fp,
+                          long first,
+                          long count,
+                          const char *variant) {
+  static char text[2048];
+  size_t bytes = 0;
+  for (long i = first; i < first + count; i++) {
+    size_t len = (size_t)snprintf(text, sizeof(text), "Step %ld: ", i);
+    while (len + 40 < sizeof(text) - 1 - (size_t)(i % 512)) {
+      len += (size_t)snprintf(text + len, sizeof(text) - len, "edit \\\"file_%ld.c\\\" line %ld; ", i % 97, len);
+    }
+    int n = fprintf(fp,
+                    "{\"parentUuid\":\"%s-%ld\",\"type\":\"assistant\",\"message\":{\"role\":\"assistant\","
+                    "\"model\":\"claude-sonnet-4-5\",\"content\":[{\"type\":\"text\",\"text\":\"%s\"}],"
+                    "\"usage\":{\"input_tokens\":%ld,\"output_tokens\":%ld,\"cache_creation_input_tokens\":%ld,"
+                    "\"cache_read_input_tokens\":%ld}},\"uuid\":\"%s-%08lx\",\"timestamp\":\"2025-01-15T10:00:01Z\"}\n",
+                    variant, i, text, 10 + i % 50, 200 + i % 900, i % 7 == 0 ? 2048L : 0L, 40000 + i * 3, variant,
+                    (unsigned long)(i * 2654435761UL) & 0xFFFFFFFFUL);
+    bytes += (size_t)n;
+  }
+  return bytes;
+}
+
+/**
+ * Copy a file (the store as left by the first session)
+ */
+static void bench_copy(const char *src,
+                       const char *dst) {
+  static char buf[1 << 16];
+  FILE *in = fopen(src, "r");
+  FILE *out = fopen(dst, "w");
+  if (!in || !out) {
+    perror(dst);
+    exit(1);
+  }
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+    fwrite(buf, 1, n, out);
+  }
+  fclose(in);
+  fclose(out);
+}
+
+/**
+ * Best of BENCH_ROUNDS first parses (store lookup included when store is set)
+ *
+ * @note Each round starts from a copy of base, so chunks recorded by one
+ *       round do not turn the next into a full hit
+ */
+static double bench_parse(const char *path,
+                          const char *base,
+                          const char *store,
+                          struct mccs_scratch *scratch,
+                          struct transcript_stats *stats,
+                          size_t *skipped) {
+  double best = 0;
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    if (store) {
+      bench_copy(base, store);
+    }
+    double start = now_ms();
+    init_transcript_stats(stats);
+    stats->chunk_store = store;
+    if (store) {
+      chunk_store_resume(store, path, NULL, stats);
+    }
+    *skipped = stats->parsed_offset;
+    if (IS_ERR(scan_transcript(path, scratch, stats))) {
+      fprintf(stderr, "scan failed: %s\n", path);
+      exit(1);
+    }
+    double elapsed = now_ms() - start;
+    best = r == 0 || elapsed < best ? elapsed : best;
+  }
+  return best;
+}
+
+static void bench_case(const char *name,
+                       const char *path,
+                       const char *base,
+                       const char *store,
+                       struct mccs_scratch *scratch) {
+  struct transcript_stats with_store, plain;
+  size_t skipped = 0, none = 0;
+  double full_ms = bench_parse(path, NULL, NULL, scratch, &plain, &none);
+  double store_ms = bench_parse(path, base, store, scratch, &with_store, &skipped);
+  printf("%-8s %8.1f MB %10.2f ms %10.2f ms %7.1fx %8.1f%% %s\n", name, (double)plain.parsed_offset / 1048576.0,
+         full_ms, store_ms, full_ms / store_ms, 100.0 * (double)skipped / (double)plain.parsed_offset,
+         with_store.session_tokens.total_tokens == plain.session_tokens.total_tokens &&
+                 with_store.context_tokens == plain.context_tokens
+             ? "same totals"
+             : "TOTALS DIFFER");
+}
+
+int main(int argc,
+         char *argv[]) {
+  long mb = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_MB;
+  if (mb <= 0) {
+    mb = BENCH_DEFAULT_MB;
+  }
+
+  char dir[] = "/tmp/bench-chunks-XXXXXX";
+  if (!mkdtemp(dir)) {
+    perror("mkdtemp");
+    return 1;
+  }
+  char base[256], store[256], old_path[256], new_path[256], fork_path[256], other_path[256];
+  snprintf(base, sizeof(base), "%s/%s", dir, CHUNK_STORE_FILE);
+  snprintf(store, sizeof(store), "%s/work.store", dir);
+  snprintf(old_path, sizeof(old_path), "%s/old.jsonl", dir);
+  snprintf(new_path, sizeof(new_path), "%s/resumed.jsonl", dir);
+  snprintf(fork_path, sizeof(fork_path), "%s/forked.jsonl", dir);
+  snprintf(other_path, sizeof(other_path), "%s/other.jsonl", dir);
+
+  // Turns of about 2 KB on average
+  long turns = mb * 1048576 / 2100;
+  FILE *fps[4] = {fopen(old_path, "w"), fopen(new_path, "w"), fopen(fork_path, "w"), fopen(other_path, "w")};
+  for (int i = 0; i < 4; i++) {
+    if (!fps[i]) {
+      perror(dir);
+      return 1;
+    }
+  }
+  bench_turns(fps[0], 0, turns, "a");
+  bench_turns(fps[1], 0, turns + BENCH_NEW_TURNS, "a");
+  bench_turns(fps[2], 0, turns / 2, "a");
+  bench_turns(fps[2], turns / 2, turns / 2 + BENCH_NEW_TURNS, "b");
+  bench_turns(fps[3], 0, turns, "c");
+  for (int i = 0; i < 4; i++) {
+    fclose(fps[i]);
+  }
+
+  struct mccs_scratch scratch = {.line = NULL, .cap = 0};
+  json_doc_init(&scratch.json);
+  printf("%-8s %11s %13s %13s %8s %9s\n", "case", "transcript", "full parse", "with store", "speedup", "reused");
+
+  // Recording cost: an empty store before each round; the last one is the base of the other cases
+  struct transcript_stats stats;
+  double plain_ms = 0, record_ms = 0;
+  size_t skipped;
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    unlink(base);
+    double start = now_ms();
+    init_transcript_stats(&stats);
+    stats.chunk_store = base;
+    scan_transcript(old_path, &scratch, &stats);
+    double elapsed = now_ms() - start;
+    record_ms = r == 0 || elapsed < record_ms ? elapsed : record_ms;
+  }
+  plain_ms = bench_parse(old_path, NULL, NULL, &scratch, &stats, &skipped);
+  printf("%-8s %8.1f MB %10.2f ms %10.2f ms %7.2fx %9s (store writes)\n", "record",
+         (double)stats.parsed_offset / 1048576.0, plain_ms, record_ms, plain_ms / record_ms, "-");
+
+  bench_case("resume", new_path, base, store, &scratch);
+  bench_case("fork", fork_path, base, store, &scratch);
+  bench_case("unknown", other_path, base, store, &scratch);
+
+  free(scratch.line);
+  json_doc_free(&scratch.json);
+  unlink(old_path);
+  unlink(new_path);
+  unlink(fork_path);
+  unlink(other_path);
+  unlink(base);
+  unlink(store);
+  rmdir(dir);
+  return 0;
+}
@@ -0,0 +1,121 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file bench_history.c
+ * @brief Benchmark of the columnar turn history store
+ *
+ * Appends synthetic turns (spread over sessions, models and 90 days) to a
+ * temporary store, then times typical queries against it: an overall total,
+ * per day and model, per week, and a one-week window that the block index
+ * narrows to a few blocks.
+ *
+ * Usage: bench-history [turns]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "src/cli_parser.h"
+#include "src/history.h"
+#include "src/query.h"
+
+#define BENCH_DEFAULT_TURNS 1000000
+#define BENCH_SESSIONS 2000
+#define BENCH_DAYS 90
+#define BENCH_START_TS 1735689600 /* 2025-01-01 00:00 UTC */
+
+static const char *const bench_models[] = {
+    "claude-sonnet-4-5-20250929", "claude-opus-4-1-20250805", "claude-haiku-4-5-20251001"};
+
+static double now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+/**
+ * Append turns session by session, in time order within each session
+ */
+static void bench_fill(const char *dir,
+                       long turns) {
+  long per_session = turns / BENCH_SESSIONS;
+  struct history_turn *batch = calloc((size_t)per_session + 1, sizeof(*batch));
+  if (!batch) {
+    perror("calloc");
+    exit(1);
+  }
+
+  unsigned int seed = 42;
+  double start = now_ms();
+  for (long s = 0; s < BENCH_SESSIONS; s++) {
+    char session_id[64];
+    snprintf(session_id, sizeof(session_id), "bench-%08ld", s);
+    long count = per_session + (s < turns % BENCH_SESSIONS ? 1 : 0);
+    int64_t ts = BENCH_START_TS + (int64_t)(s * BENCH_DAYS * 86400L / BENCH_SESSIONS);
+    for (long i = 0; i < count; i++) {
+      struct history_turn *t = &batch[i];
+      t->timestamp = ts + i * 20;
+      t->offset = (uint64_t)i * 4096;
+      t->tokens.input_tokens = (uint64_t)(rand_r(&seed) % 50);
+      t->tokens.output_tokens = (uint64_t)(rand_r(&seed) % 4000);
+      t->tokens.cache_creation_tokens = (uint64_t)(rand_r(&seed) % 20000);
+      t->tokens.cache_read_tokens = (uint64_t)(rand_r(&seed) % 150000);
+      snprintf(t->model_id, sizeof(t->model_id), "%s", bench_models[(s + i / 50) % 3]);
+    }
+    ResultVoid result = history_append(dir, session_id, batch, (size_t)count);
+    if (IS_ERR(result)) {
+      fprintf(stderr, "history_append failed (error %d)\n", UNWRAP_ERR(result));
+      exit(1);
+    }
+  }
+  printf("append     %ld turns in %.1f ms\n\n", turns, now_ms() - start);
+  free(batch);
+}
+
+/**
+ * Run one query, printing its table (the footer reports the scan time)
+ */
+static void bench_query(const char *dir,
+                        const char *title,
+                        struct query_options q) {
+  struct cli_options opts;
+  mccs_init_cli_options(&opts);
+  opts.query = true;
+  opts.query_opts = q;
+  opts.query_opts.store = dir;
+
+  printf("== %s\n", title);
+  double start = now_ms();
+  mccs_run_query(&opts);
+  printf("(%.2f ms including open and print)\n\n", now_ms() - start);
+}
+
+int main(int argc,
+         char *argv[]) {
+  long turns = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_TURNS;
+  if (turns < BENCH_SESSIONS) {
+    turns = BENCH_SESSIONS;
+  }
+
+  char dir[] = "/tmp/mccs-bench-history-XXXXXX";
+  if (!mkdtemp(dir)) {
+    perror("mkdtemp");
+    return 1;
+  }
+
+  bench_fill(dir, turns);
+  bench_query(dir, "total", (struct query_options){0});
+  bench_query(dir, "by model", (struct query_options){.by = "model"});
+  bench_query(dir, "by week, sorted by cache efficiency", (struct query_options){.by = "week", .sort = "cache-eff"});
+  bench_query(dir, "by day and model, top 5", (struct query_options){.by = "day,model", .limit = 5});
+  bench_query(dir, "one week by day (block index)",
+              (struct query_options){.by = "day", .since = "2025-02-03", .until = "2025-02-09"});
+
+  char cmd[128];
+  snprintf(cmd, sizeof(cmd), "rm -rf %s", dir);
+  return system(cmd) == 0 ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file bench_json.c
+ * @brief Parse throughput of the tape parser against cJSON
+ *
+ * Parses the status payload, the transcript fixture line by line and a
+ * synthetic assistant line carrying a long escaped message (what real
+ * transcript lines look like) over and over, and reports GB/s for a bare
+ * parse and for a parse followed by the usage lookups the token scan does.
+ *
+ * Usage: bench-json [megabytes per case]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "lib/cjson/cJSON.h"
+#include "src/json_tape.h"
+
+#define BENCH_DEFAULT_MB 256
+#define BENCH_MAX_LINES 64
+#define BENCH_TEXT_BYTES 16384
+
+/**
+ * One input: lines parsed as separate documents
+ */
+struct bench_input {
+  const char *name;
+  char *lines[BENCH_MAX_LINES];
+  size_t lengths[BENCH_MAX_LINES];
+  size_t count;
+  size_t bytes;
+};
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void bench_add_line(struct bench_input *in,
+                           const char *text,
+                           size_t len) {
+  if (in->count == BENCH_MAX_LINES || len == 0) {
+    return;
+  }
+  in->lines[in->count] = malloc(len + 1);
+  if (!in->lines[in->count]) {
+    exit(1);
+  }
+  memcpy(in->lines[in->count], text, len);
+  in->lines[in->count][len] = '\0';
+  in->lengths[in->count++] = len;
+  in->bytes += len;
+}
+
+/**
+ * Load a file whole (one document) or line by line
+ */
+static void bench_load(struct bench_input *in,
+                       const char *path,
+                       int by_line) {
+  FILE *fp = fopen(path, "r");
+  if (!fp) {
+    perror(path);
+    exit(1);
+  }
+  static char buf[1 << 16];
+  if (by_line) {
+    while (fgets(buf, sizeof(buf), fp)) {
+      bench_add_line(in, buf, strlen(buf));
+    }
+  } else {
+    bench_add_line(in, buf, fread(buf, 1, sizeof(buf), fp));
+  }
+  fclose(fp);
+}
+
+/**
+ * Assistant line with BENCH_TEXT_BYTES of escaped message text
+ */
+static void bench_synthetic(struct bench_input *in) {
+  static const char chunk[] = "Refactor the parser: \\\"tape\\\" entries\\n\\tkeep \\u00e9 spans; ";
+  static char line[BENCH_TEXT_BYTES + 1024];
+  size_t len = (size_t)snprintf(line, sizeof(line),
+                                "{\"parentUuid\":\"4f1c\",\"type\":\"assistant\",\"message\":{\"role\":\"assistant\","
+                                "\"model\":\"claude-sonnet-4-5\",\"content\":[{\"type\":\"text\",\"text\":\"");
+  while (len + sizeof(chunk) < BENCH_TEXT_BYTES) {
+    memcpy(line + len, chunk, sizeof(chunk) - 1);
+    len += sizeof(chunk) - 1;
+  }
+  len += (size_t)snprintf(line + len, sizeof(line) - len,
+                          "\"}],\"usage\":{\"input_tokens\":12,\"output_tokens\":845,"
+                          "\"cache_creation_input_tokens\":2048,\"cache_read_input_tokens\":51200,"
+                          "\"cache_creation\":{\"ephemeral_1h_input_tokens\":0}}},"
+                          "\"timestamp\":\"2025-01-15T10:00:01Z\"}\n");
+  bench_add_line(in, line, len);
+}
+
+static double tape_usage(struct json_doc *doc,
+                         json_ref root) {
+  json_ref usage = json_get(doc, json_get(doc, root, "message"), "usage");
+  const char *role = json_string(doc, json_get(doc, json_get(doc, root, "message"), "role"));
+  return json_number(doc, json_get(doc, usage, "input_tokens")) +
+         json_number(doc, json_get(doc, usage, "cache_read_input_tokens")) + (role ? 1 : 0);
+}
+
+static double cjson_usage(const cJSON *root) {
+  const cJSON *message = cJSON_GetObjectItemCaseSensitive(root, "message");
+  const cJSON *usage = cJSON_GetObjectItemCaseSensitive(message, "usage");
+  const char *role = cJSON_GetStringValue(cJSON_GetObjectItemCaseSensitive(message, "role"));
+  const cJSON *input = cJSON_GetObjectItemCaseSensitive(usage, "input_tokens");
+  const cJSON *read = cJSON_GetObjectItemCaseSensitive(usage, "cache_read_input_tokens");
+  return (cJSON_IsNumber(input) ? input->valuedouble : 0) + (cJSON_IsNumber(read) ? read->valuedouble : 0) +
+         (role ? 1 : 0);
+}
+
+/**
+ * Run one case; returns GB/s (lookup selects parse + usage lookups)
+ */
+static double bench_case(const struct bench_input *in,
+                         int use_tape,
+                         int lookup,
+                         double target_bytes,
+                         double *sink) {
+  struct json_doc doc;
+  json_doc_init(&doc);
+  long rounds = (long)(target_bytes / (double)in->bytes) + 1;
+  double start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < in->count; i++) {
+      if (use_tape) {
+        ResultJsonRef root = json_doc_parse(&doc, in->lines[i], in->lengths[i]);
+        if (IS_OK(root) && lookup) {
+          *sink += tape_usage(&doc, UNWRAP_OK(root));
+        }
+      } else {
+        cJSON *root = cJSON_ParseWithLength(in->lines[i], in->lengths[i]);
+        if (root && lookup) {
+          *sink += cjson_usage(root);
+        }
+        cJSON_Delete(root);
+      }
+    }
+  }
+  double elapsed = now_ns() - start;
+  json_doc_free(&doc);
+  return (double)rounds * (double)in->bytes / elapsed;
+}
+
+int main(int argc,
+         char *argv[]) {
+  long mb = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_MB;
+  if (mb <= 0) {
+    mb = BENCH_DEFAULT_MB;
+  }
+  double target = (double)mb * 1024 * 1024;
+
+  struct bench_input inputs[3] = {
+      {.name = "status.json"},
+      {.name = "test_transcript.jsonl"},
+      {.name = "synthetic 16 KB line"},
+  };
+  bench_load(&inputs[0], "../fixtures/status.json", 0);
+  bench_load(&inputs[1], "../fixtures/test_transcript.jsonl", 1);
+  bench_synthetic(&inputs[2]);
+
+  double sink = 0;
+  printf("%-24s %10s %10s %10s %10s   (GB/s, %ld MB per case)\n",
+         "input", "tape", "cJSON", "tape+get", "cJSON+get", mb);
+  for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+    double tape = bench_case(&inputs[i], 1, 0, target, &sink);
+    double cjson = bench_case(&inputs[i], 0, 0, target, &sink);
+    double tape_get = bench_case(&inputs[i], 1, 1, target, &sink);
+    double cjson_get = bench_case(&inputs[i], 0, 1, target, &sink);
+    printf("%-24s %10.2f %10.2f %10.2f %10.2f   (%.1fx)\n",
+           inputs[i].name, tape, cjson, tape_get, cjson_get, tape_get / cjson_get);
+    for (size_t l = 0; l < inputs[i].count; l++) {
+      free(inputs[i].lines[l]);
+    }
+  }
+  return sink < 0;
+}
@@ -0,0 +1,397 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file replay.c
+ * @brief Replay a recorded statusline session against a binary
+ *
+ * Reads a trace written by `mini-ccstatus --record <trace>` and re-runs the
+ * statusline command once per recorded tick, with the original cadence and
+ * the transcript growing underneath exactly as it did during the session.
+ * Reports wall-clock latency percentiles and CPU usage of the child processes.
+ *
+ * Usage: mccs-replay [--speed X] [--session-prefix P] <trace> -- <command> [args...]
+ *   --speed X   Time scale (2 = twice as fast, 0 = no sleeping between ticks)
+ */
+
+#define _GNU_SOURCE // For wait4
+#include <errno.h>
+#include <signal.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cjson/cJSON.h"
+
+#define REPLAY_MAX_TRANSCRIPTS 64
+#define REPLAY_PATH_SIZE 1024
+#define REPLAY_COPY_CHUNK 65536
+
+struct replay_tick {
+  int64_t t_ms;      ///< Recorded wall-clock time
+  int transcript;    ///< Index into transcripts, -1 if none
+  size_t size;       ///< Transcript size at this tick
+  char *payload;     ///< Payload to send on stdin (heap allocated)
+  double latency_us; ///< Measured wall-clock latency
+};
+
+struct replay_transcript {
+  char name[64];                ///< Sidecar file name
+  char source[REPLAY_PATH_SIZE]; ///< Sidecar copy recorded from the session
+  char target[REPLAY_PATH_SIZE]; ///< Growing working copy fed to the binary
+  size_t written;               ///< Bytes copied into target so far
+};
+
+struct replay_state {
+  struct replay_tick *ticks;
+  size_t n_ticks;
+  struct replay_transcript transcripts[REPLAY_MAX_TRANSCRIPTS];
+  size_t n_transcripts;
+  char workdir[64];
+};
+
+static double now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+static int transcript_index(struct replay_state *state,
+                            const char *trace_path,
+                            const char *name) {
+  for (size_t i = 0; i < state->n_transcripts; i++) {
+    if (strcmp(state->transcripts[i].name, name) == 0) {
+      return (int)i;
+    }
+  }
+  if (state->n_transcripts == REPLAY_MAX_TRANSCRIPTS) {
+    return -1;
+  }
+  struct replay_transcript *t = &state->transcripts[state->n_transcripts];
+  snprintf(t->name, sizeof(t->name), "%s", name);
+  snprintf(t->source, sizeof(t->source), "%s.d/%s", trace_path, name);
+  snprintf(t->target, sizeof(t->target), "%s/%s", state->workdir, name);
+  t->written = 0;
+  FILE *f = fopen(t->target, "w"); // Start every replay from an empty transcript
+  if (f) {
+    fclose(f);
+  }
+  return (int)state->n_transcripts++;
+}
+
+/**
+ * Load the trace and rewrite payloads to point at the working transcripts
+ */
+static int load_trace(struct replay_state *state,
+                      const char *trace_path,
+                      const char *session_prefix) {
+  FILE *f = fopen(trace_path, "r");
+  if (!f) {
+    fprintf(stderr, "error: cannot open trace %s\n", trace_path);
+    return -1;
+  }
+
+  char *line = NULL;
+  size_t cap = 0;
+  ssize_t len;
+  size_t tick_cap = 0;
+  while ((len = getline(&line, &cap, f)) != -1) {
+    cJSON *tick = cJSON_ParseWithLength(line, (size_t)len);
+    if (!tick) {
+      continue;
+    }
+    if (state->n_ticks == tick_cap) {
+      tick_cap = tick_cap ? tick_cap * 2 : 256;
+      struct replay_tick *ticks = realloc(state->ticks, tick_cap * sizeof(*ticks));
+      if (!ticks) {
+        cJSON_Delete(tick);
+        break;
+      }
+      state->ticks = ticks;
+    }
+
+    struct replay_tick *t = &state->ticks[state->n_ticks];
+    memset(t, 0, sizeof(*t));
+    t->transcript = -1;
+    t->t_ms = (int64_t)cJSON_GetNumberValue(cJSON_GetObjectItemCaseSensitive(tick, "t_ms"));
+    double size = cJSON_GetNumberValue(cJSON_GetObjectItemCaseSensitive(tick, "size"));
+    t->size = size > 0 ? (size_t)size : 0;
+
+    const char *name = cJSON_GetStringValue(cJSON_GetObjectItemCaseSensitive(tick, "transcript"));
+    cJSON *payload = cJSON_GetObjectItemCaseSensitive(tick, "payload");
+    if (payload && name && name[0] != '\0') {
+      t->transcript = transcript_index(state, trace_path, name);
+      if (t->transcript >= 0) {
+        cJSON_ReplaceItemInObjectCaseSensitive(payload, "transcript_path",
+                                               cJSON_CreateString(state->transcripts[t->transcript].target));
+      }
+    }
+    if (payload && session_prefix[0] != '\0') {
+      // Separate cache entries from the live session that was recorded
+      const char *sid = cJSON_GetStringValue(cJSON_GetObjectItemCaseSensitive(payload, "session_id"));
+      char buf[512];
+      snprintf(buf, sizeof(buf), "%s%s", session_prefix, sid ? sid : "");
+      cJSON_ReplaceItemInObjectCaseSensitive(payload, "session_id", cJSON_CreateString(buf));
+    }
+
+    if (payload) {
+      t->payload = cJSON_PrintUnformatted(payload);
+    } else {
+      const char *raw = cJSON_GetStringValue(cJSON_GetObjectItemCaseSensitive(tick, "payload_raw"));
+      t->payload = strdup(raw ? raw : "");
+    }
+    cJSON_Delete(tick);
+    if (t->payload) {
+      state->n_ticks++;
+    }
+  }
+  free(line);
+  fclose(f);
+  return 0;
+}
+
+/**
+ * Grow a working transcript to the size it had at the recorded tick
+ */
+static void grow_transcript(struct replay_transcript *t,
+                            size_t size) {
+  if (size < t->written) {
+    if (truncate(t->target, 0) == 0) {
+      t->written = 0;
+    }
+  }
+  if (size == t->written) {
+    return;
+  }
+
+  FILE *in = fopen(t->source, "rb");
+  FILE *out = fopen(t->target, "ab");
+  if (in && out && fseeko(in, (off_t)t->written, SEEK_SET) == 0) {
+    char buf[REPLAY_COPY_CHUNK];
+    size_t remaining = size - t->written;
+    while (remaining > 0) {
+      size_t got = fread(buf, 1, remaining < sizeof(buf) ? remaining : sizeof(buf), in);
+      if (got == 0 || fwrite(buf, 1, got, out) != got) {
+        break;
+      }
+      remaining -= got;
+      t->written += got;
+    }
+  }
+  if (in) {
+    fclose(in);
+  }
+  if (out) {
+    fclose(out);
+  }
+}
+
+/**
+ * Run the command once with payload on stdin; returns child rusage
+ */
+static int run_tick(char *const argv[],
+                    const char *payload,
+                    struct rusage *usage) {
+  int pipefd[2];
+  if (pipe(pipefd) != 0) {
+    return -1;
+  }
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    close(pipefd[0]);
+    close(pipefd[1]);
+    return -1;
+  }
+  if (pid == 0) {
+    dup2(pipefd[0], STDIN_FILENO);
+    close(pipefd[0]);
+    close(pipefd[1]);
+    if (!freopen("/dev/null", "w", stdout)) {
+      _exit(127);
+    }
+    execvp(argv[0], argv);
+    _exit(127);
+  }
+
+  close(pipefd[0]);
+  size_t len = strlen(payload);
+  ssize_t w1 = write(pipefd[1], payload, len);
+  ssize_t w2 = write(pipefd[1], "\n", 1);
+  (void)w1;
+  (void)w2;
+  close(pipefd[1]);
+
+  int status = 0;
+  if (wait4(pid, &status, 0, usage) < 0) {
+    return -1;
+  }
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static int compare_double(const void *a,
+                          const void *b) {
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted,
+                         size_t n,
+                         double p) {
+  if (n == 0) {
+    return 0.0;
+  }
+  size_t rank = (size_t)(p / 100.0 * (double)(n - 1) + 0.5);
+  return sorted[rank < n ? rank : n - 1];
+}
+
+static void sleep_until_us(double target) {
+  double wait = target - now_us();
+  if (wait <= 0) {
+    return;
+  }
+  struct timespec ts = {
+      .tv_sec = (time_t)(wait / 1e6),
+      .tv_nsec = (long)((wait - (double)(time_t)(wait / 1e6) * 1e6) * 1e3),
+  };
+  while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+  }
+}
+
+static double timeval_us(struct timeval tv) {
+  return (double)tv.tv_sec * 1e6 + (double)tv.tv_usec;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr, "Usage: %s [--speed X] [--session-prefix P] <trace> -- <command> [args...]\n", prog);
+}
+
+int main(int argc,
+         char *argv[]) {
+  double speed = 1.0;
+  const char *session_prefix = "replay-";
+  const char *trace_path = NULL;
+  int cmd_index = -1;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--") == 0) {
+      cmd_index = i + 1;
+      break;
+    } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+      speed = strtod(argv[++i], NULL);
+    } else if (strcmp(argv[i], "--session-prefix") == 0 && i + 1 < argc) {
+      session_prefix = argv[++i];
+    } else if (!trace_path) {
+      trace_path = argv[i];
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (!trace_path || cmd_index < 0 || cmd_index >= argc || speed < 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  signal(SIGPIPE, SIG_IGN); // A child exiting early must not kill the replayer
+
+  struct replay_state state;
+  memset(&state, 0, sizeof(state));
+  snprintf(state.workdir, sizeof(state.workdir), "/tmp/mccs-replay-XXXXXX");
+  if (!mkdtemp(state.workdir)) {
+    fprintf(stderr, "error: mkdtemp failed\n");
+    return 1;
+  }
+
+  if (load_trace(&state, trace_path, session_prefix) != 0 || state.n_ticks == 0) {
+    fprintf(stderr, "error: no ticks in trace %s\n", trace_path);
+    rmdir(state.workdir);
+    return 1;
+  }
+
+  double *latencies = malloc(state.n_ticks * sizeof(*latencies));
+  if (!latencies) {
+    return 1;
+  }
+
+  size_t failures = 0;
+  double cpu_user_us = 0;
+  double cpu_sys_us = 0;
+  long max_rss_kb = 0;
+  double start = now_us();
+  int64_t t0 = state.ticks[0].t_ms;
+
+  for (size_t i = 0; i < state.n_ticks; i++) {
+    struct replay_tick *t = &state.ticks[i];
+    if (speed > 0) {
+      sleep_until_us(start + (double)(t->t_ms - t0) * 1e3 / speed);
+    }
+    if (t->transcript >= 0) {
+      grow_transcript(&state.transcripts[t->transcript], t->size);
+    }
+
+    struct rusage ru;
+    memset(&ru, 0, sizeof(ru));
+    double before = now_us();
+    int rc = run_tick(&argv[cmd_index], t->payload, &ru);
+    t->latency_us = now_us() - before;
+    latencies[i] = t->latency_us;
+
+    if (rc != 0) {
+      failures++;
+    }
+    cpu_user_us += timeval_us(ru.ru_utime);
+    cpu_sys_us += timeval_us(ru.ru_stime);
+    if (ru.ru_maxrss > max_rss_kb) {
+      max_rss_kb = ru.ru_maxrss;
+    }
+  }
+  double elapsed_us = now_us() - start;
+
+  qsort(latencies, state.n_ticks, sizeof(*latencies), compare_double);
+  double cpu_us = cpu_user_us + cpu_sys_us;
+  size_t final_bytes = 0;
+  for (size_t i = 0; i < state.n_transcripts; i++) {
+    final_bytes += state.transcripts[i].written;
+  }
+
+  printf("Replay Results\n");
+  printf("==============\n");
+  printf("Trace:        %s\n", trace_path);
+  printf("Ticks:        %zu (%zu failed)\n", state.n_ticks, failures);
+  printf("Transcripts:  %zu (%zu bytes replayed)\n", state.n_transcripts, final_bytes);
+  printf("Session:      %.1f s recorded, %.1f s replayed (speed %.2fx)\n",
+         (double)(state.ticks[state.n_ticks - 1].t_ms - t0) / 1e3, elapsed_us / 1e6, speed);
+  printf("Latency:      p50 %.1f us  p90 %.1f us  p99 %.1f us  max %.1f us\n",
+         percentile(latencies, state.n_ticks, 50),
+         percentile(latencies, state.n_ticks, 90),
+         percentile(latencies, state.n_ticks, 99),
+         latencies[state.n_ticks - 1]);
+  printf("CPU:          %.1f ms total (user %.1f ms, sys %.1f ms), %.1f us/tick, %.3f%% of wall time\n",
+         cpu_us / 1e3, cpu_user_us / 1e3, cpu_sys_us / 1e3,
+         cpu_us / (double)state.n_ticks,
+         elapsed_us > 0 ? cpu_us / elapsed_us * 100.0 : 0.0);
+  printf("Max RSS:      %ld KB\n", max_rss_kb);
+
+  for (size_t i = 0; i < state.n_ticks; i++) {
+    free(state.ticks[i].payload);
+  }
+  for (size_t i = 0; i < state.n_transcripts; i++) {
+    unlink(state.transcripts[i].target);
+  }
+  rmdir(state.workdir);
+  free(state.ticks);
+  free(latencies);
+  return 0;
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file bench_roots.c
+ * @brief Benchmark of repository root detection on deeply nested directories
+ *
+ * Builds a temporary repository with a chain of nested directories and times,
+ * at several depths, the uncached walk up to .git against the lookup through
+ * the per-user roots.cache table. The same is done for a chain outside any
+ * repository, where the walk has to go all the way up to "/".
+ *
+ * Usage: bench-roots [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "src/project_root.h"
+#include "src/render_ctx.h"
+
+#define BENCH_DEFAULT_ITERATIONS 20000
+#define BENCH_MAX_DEPTH 48
+
+static const int bench_depths[] = {1, 8, 24, BENCH_MAX_DEPTH};
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * Create base/d/d/.../d (depth levels); path receives each level in turn
+ */
+static void bench_mkchain(const char *base,
+                          char paths[][BUF_PATH_SIZE]) {
+  snprintf(paths[0], BUF_PATH_SIZE, "%s", base);
+  for (int level = 1; level <= BENCH_MAX_DEPTH; level++) {
+    snprintf(paths[level], BUF_PATH_SIZE, "%s/d", paths[level - 1]);
+    if (mkdir(paths[level], 0700) != 0) {
+      perror(paths[level]);
+      exit(1);
+    }
+  }
+}
+
+static void bench_chain(const char *title,
+                        struct mccs_render_ctx *ctx,
+                        char paths[][BUF_PATH_SIZE],
+                        long iterations) {
+  printf("%s\n", title);
+  for (size_t i = 0; i < sizeof(bench_depths) / sizeof(bench_depths[0]); i++) {
+    const char *dir = paths[bench_depths[i]];
+    size_t root_len = 0;
+
+    double start = now_ns();
+    for (long n = 0; n < iterations; n++) {
+      (void)project_root_walk(dir, &root_len);
+    }
+    double walk = (now_ns() - start) / (double)iterations;
+
+    (void)find_project_root(ctx, dir, &root_len); // Prime the table
+    start = now_ns();
+    for (long n = 0; n < iterations; n++) {
+      (void)find_project_root(ctx, dir, &root_len);
+    }
+    double cached = (now_ns() - start) / (double)iterations;
+
+    printf("  depth %3d  walk %8.0f ns  cached %8.0f ns  (%.1fx)\n",
+           bench_depths[i], walk, cached, walk / cached);
+  }
+}
+
+int main(int argc,
+         char *argv[]) {
+  long iterations = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_ITERATIONS;
+  if (iterations <= 0) {
+    iterations = BENCH_DEFAULT_ITERATIONS;
+  }
+
+  char base[] = "/tmp/mccs-bench-roots-XXXXXX";
+  if (!mkdtemp(base)) {
+    perror("mkdtemp");
+    return 1;
+  }
+  char repo[BUF_PATH_SIZE], git[BUF_PATH_SIZE], plain[BUF_PATH_SIZE];
+  snprintf(repo, sizeof(repo), "%s/r", base);
+  snprintf(git, sizeof(git), "%s/r/.git", base);
+  snprintf(plain, sizeof(plain), "%s/p", base);
+  if (mkdir(repo, 0700) != 0 || mkdir(git, 0700) != 0 || mkdir(plain, 0700) != 0) {
+    perror("mkdir");
+    return 1;
+  }
+
+  static char repo_chain[BENCH_MAX_DEPTH + 1][BUF_PATH_SIZE];
+  static char plain_chain[BENCH_MAX_DEPTH + 1][BUF_PATH_SIZE];
+  bench_mkchain(repo, repo_chain);
+  bench_mkchain(plain, plain_chain);
+
+  struct mccs_render_ctx ctx;
+  mccs_render_ctx_init(&ctx, false, false, NULL);
+  bench_chain("inside a repository (walk stops at .git)", &ctx, repo_chain, iterations);
+  bench_chain("outside any repository (walk reaches /)", &ctx, plain_chain, iterations);
+  mccs_render_ctx_free(&ctx);
+
+  char cmd[BUF_PATH_SIZE + 16];
+  snprintf(cmd, sizeof(cmd), "rm -rf %s", base);
+  return system(cmd) == 0 ? 0 : 1;
+}
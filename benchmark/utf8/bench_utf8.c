@@ -0,0 +1,160 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file bench_utf8.c
+ * @brief Cost of UTF-8 validation against JSON parsing
+ *
+ * Reports the validator throughput on ASCII and on multilingual text, then
+ * the share of the status payload load (parse + field copies) spent on
+ * codepoint-safe truncation and validation of the copied strings, and what
+ * validating whole transcript lines would add to parsing them.
+ *
+ * Usage: bench-utf8 [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "src/json_parser.h"
+#include "src/json_tape.h"
+#include "src/utf8.h"
+
+#define BENCH_DEFAULT_ITERATIONS 200000
+#define BENCH_TEXT_BYTES (1 << 20)
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static size_t bench_read(const char *path,
+                         char *buf,
+                         size_t size) {
+  FILE *fp = fopen(path, "r");
+  if (!fp) {
+    perror(path);
+    exit(1);
+  }
+  size_t len = fread(buf, 1, size - 1, fp);
+  buf[len] = '\0';
+  fclose(fp);
+  return len;
+}
+
+/**
+ * Fill buf with copies of a sample (cut on a codepoint boundary)
+ */
+static size_t bench_fill(char *buf,
+                         size_t size,
+                         const char *sample) {
+  size_t n = strlen(sample);
+  size_t len = 0;
+  while (len + n < size) {
+    memcpy(buf + len, sample, n);
+    len += n;
+  }
+  return len;
+}
+
+static double bench_validate(const char *text,
+                             size_t len,
+                             long rounds,
+                             int *sink) {
+  double start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    *sink += utf8_validate(text, len);
+  }
+  return (double)rounds * (double)len / (now_ns() - start);
+}
+
+/**
+ * The UTF-8 work load_string_field does on the fields of one status
+ */
+static size_t bench_fields(struct mccs_status *status) {
+  struct mccs_buffers *b = &status->buffers;
+  char *fields[] = {b->buf_model_name, b->buf_model_id, b->buf_cwd, b->buf_project, b->buf_version};
+  size_t total = 0;
+  for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+    size_t len = strlen(fields[i]);
+    len = utf8_truncate(fields[i], len, len);
+    total += len + utf8_sanitize(fields[i], len);
+  }
+  return total;
+}
+
+int main(int argc,
+         char *argv[]) {
+  long iterations = argc > 1 ? strtol(argv[1], NULL, 10) : BENCH_DEFAULT_ITERATIONS;
+  if (iterations <= 0) {
+    iterations = BENCH_DEFAULT_ITERATIONS;
+  }
+  int sink = 0;
+
+  static char text[BENCH_TEXT_BYTES];
+  size_t len = bench_fill(text, sizeof(text), "Refactor the parser so tape entries keep raw spans. ");
+  printf("validator, ASCII          %8.2f GB/s\n", bench_validate(text, len, 2000, &sink));
+  len = bench_fill(text, sizeof(text), "Caf\xc3\xa9 na\xc3\xafve \xe2\x82\xac \xe6\x97\xa5\xe6\x9c\xac "
+                                       "\xf0\x9f\x98\x80 text ");
+  printf("validator, multilingual   %8.2f GB/s\n", bench_validate(text, len, 200, &sink));
+
+  // Status payloads: parse + load (which includes the UTF-8 work) vs the UTF-8 work alone
+  static char status_json[4096];
+  size_t status_len = bench_read("../fixtures/status.json", status_json, sizeof(status_json));
+  static const char accented_json[] =
+      "{\"session_id\":\"abc123\",\"cwd\":\"/home/jos\xc3\xa9/projets/caf\xc3\xa9\","
+      "\"model\":{\"id\":\"claude-opus-4-1\",\"display_name\":\"Opus \xe2\x9c\xa8\"},"
+      "\"workspace\":{\"project_dir\":\"/home/jos\xc3\xa9/projets/caf\xc3\xa9\"},\"version\":\"1.0.80\","
+      "\"cost\":{\"total_cost_usd\":0.01234,\"total_duration_ms\":45000,\"total_api_duration_ms\":2300,"
+      "\"total_lines_added\":156,\"total_lines_removed\":23},\"exceeds_200k_tokens\":false}";
+  const char *payloads[] = {status_json, accented_json};
+  const size_t lengths[] = {status_len, sizeof(accented_json) - 1};
+  const char *names[] = {"ASCII status   ", "accented status"};
+  struct json_doc doc;
+  json_doc_init(&doc);
+  struct mccs_status status;
+  size_t bytes = 0;
+  for (size_t p = 0; p < 2; p++) {
+    double start = now_ns();
+    for (long n = 0; n < iterations; n++) {
+      ResultJsonRef root = json_doc_parse(&doc, payloads[p], lengths[p]);
+      init_mccs_status(&status);
+      load_mccs_status(&doc, UNWRAP_OK(root), &status);
+    }
+    double load_ns = (now_ns() - start) / (double)iterations;
+    double utf8_ns = 0;
+    if (!json_doc_is_ascii(&doc)) {
+      start = now_ns();
+      for (long n = 0; n < iterations; n++) {
+        bytes += bench_fields(&status);
+      }
+      utf8_ns = (now_ns() - start) / (double)iterations;
+    }
+    printf("%s load %6.0f ns, UTF-8 on copied fields %5.1f ns (%.2f%%)\n",
+           names[p], load_ns, utf8_ns, 100.0 * utf8_ns / load_ns);
+  }
+
+  // Whole transcript lines (not done by the scanner: their text is never printed)
+  long rounds = iterations / 100 + 1;
+  text[0] = '[';
+  len = 1 + bench_fill(text + 1, 16384, "\"caf\xc3\xa9 message text, \\u00e9 escaped\",");
+  text[len++] = '1';
+  text[len++] = ']';
+  double start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    sink += IS_OK(json_doc_parse(&doc, text, len));
+  }
+  double parse_ns = now_ns() - start;
+  start = now_ns();
+  for (long r = 0; r < rounds; r++) {
+    sink += utf8_validate(text, len);
+  }
+  double validate_ns = now_ns() - start;
+  printf("16 KB transcript line: validating adds %.1f%% to parsing\n", 100.0 * validate_ns / parse_ns);
+
+  json_doc_free(&doc);
+  return sink < 0 || bytes == 0;
+}
@@ -89,7 +89,16 @@ typedef struct {
     const unsigned char *json;
     size_t position;
 } error;
-static error global_error = { NULL, 0 };
+/* mini-ccstatus: keep the error position per thread so concurrent parses
+ * (render contexts on worker threads) do not race on a shared global */
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_THREADS__)
+#define CJSON_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define CJSON_THREAD_LOCAL __thread
+#else
+#define CJSON_THREAD_LOCAL
+#endif
+static CJSON_THREAD_LOCAL error global_error = { NULL, 0 };
 
 CJSON_PUBLIC(const char *) cJSON_GetErrorPtr(void)
 {
@@ -0,0 +1,198 @@
+/* Generated by tools/gen_gradients.c - do not edit */
+
+#ifndef MCCS_GRADIENT_TABLES_H
+#define MCCS_GRADIENT_TABLES_H
+
+static const struct mccs_gradient_span
+    gradient_tables[MCCS_GRADIENT_MODE_COUNT - 1][MCCS_BAR_KIND_COUNT][PROGRESS_BAR_WIDTH + 1] = {
+  {
+    { /* 256, context */
+      {79, "\033[1m\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {88, "\033[1;38;5;148m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {99, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {99, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {99, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {99, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {110, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {110, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {110, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {110, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {110, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {121, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {132, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {143, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {154, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;209m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {154, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {165, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;203m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {165, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;203m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\033[0m"},
+      {165, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\033[0m"},
+      {165, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\033[0m"},
+      {165, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;197m\342\226\210\033[0m"},
+    },
+    { /* 256, session */
+      {79, "\033[1m\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {88, "\033[1;38;5;148m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {99, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {99, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {99, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {99, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {110, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {110, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {110, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {110, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {110, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {121, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {132, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {143, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {154, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;209m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {154, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {165, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;203m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {165, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;203m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\033[0m"},
+      {165, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\033[0m"},
+      {165, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\033[0m"},
+      {165, "\033[1;38;5;148m\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;186m\342\226\210\033[38;5;180m\342\226\210\033[38;5;179m\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;197m\342\226\210\033[0m"},
+    },
+    { /* 256, cache */
+      {79, "\033[1m\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {88, "\033[1;38;5;197m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {99, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {99, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {99, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {99, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {110, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;209m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {110, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {121, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;179m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {132, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;179m\342\226\210\033[38;5;180m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {143, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;179m\342\226\210\033[38;5;180m\342\226\210\033[38;5;186m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {154, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;179m\342\226\210\033[38;5;180m\342\226\210\033[38;5;186m\342\226\210\033[38;5;185m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {154, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;179m\342\226\210\033[38;5;180m\342\226\210\033[38;5;186m\342\226\210\033[38;5;185m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {154, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;179m\342\226\210\033[38;5;180m\342\226\210\033[38;5;186m\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {154, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;179m\342\226\210\033[38;5;180m\342\226\210\033[38;5;186m\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {154, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;179m\342\226\210\033[38;5;180m\342\226\210\033[38;5;186m\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {165, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;179m\342\226\210\033[38;5;180m\342\226\210\033[38;5;186m\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;149m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {165, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;179m\342\226\210\033[38;5;180m\342\226\210\033[38;5;186m\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;149m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\033[0m"},
+      {165, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;179m\342\226\210\033[38;5;180m\342\226\210\033[38;5;186m\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\033[0m"},
+      {165, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;179m\342\226\210\033[38;5;180m\342\226\210\033[38;5;186m\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\033[0m"},
+      {165, "\033[1;38;5;197m\342\226\210\033[38;5;203m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;209m\342\226\210\342\226\210\033[38;5;179m\342\226\210\033[38;5;180m\342\226\210\033[38;5;186m\342\226\210\033[38;5;185m\342\226\210\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;149m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;148m\342\226\210\033[0m"},
+    },
+    { /* 256, api_time */
+      {79, "\033[1m\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {87, "\033[1;38;5;60m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {87, "\033[1;38;5;60m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {87, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {97, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {97, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {108, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;103m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {108, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;103m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {108, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;103m\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {119, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;103m\342\226\210\342\226\210\342\226\210\033[38;5;104m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {119, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;103m\342\226\210\342\226\210\342\226\210\033[38;5;104m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {119, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;103m\342\226\210\342\226\210\342\226\210\033[38;5;104m\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {119, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;103m\342\226\210\342\226\210\342\226\210\033[38;5;104m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {130, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;103m\342\226\210\342\226\210\342\226\210\033[38;5;104m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;146m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {130, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;103m\342\226\210\342\226\210\342\226\210\033[38;5;104m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;146m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {130, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;103m\342\226\210\342\226\210\342\226\210\033[38;5;104m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;146m\342\226\210\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {141, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;103m\342\226\210\342\226\210\342\226\210\033[38;5;104m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;146m\342\226\210\342\226\210\342\226\210\033[38;5;147m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {141, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;103m\342\226\210\342\226\210\342\226\210\033[38;5;104m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;146m\342\226\210\342\226\210\342\226\210\033[38;5;147m\342\226\210\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\033[0m"},
+      {152, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;103m\342\226\210\342\226\210\342\226\210\033[38;5;104m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;146m\342\226\210\342\226\210\342\226\210\033[38;5;147m\342\226\210\342\226\210\033[38;5;189m\342\226\210\033[38;5;233m\342\226\221\342\226\221\033[0m"},
+      {152, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;103m\342\226\210\342\226\210\342\226\210\033[38;5;104m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;146m\342\226\210\342\226\210\342\226\210\033[38;5;147m\342\226\210\342\226\210\033[38;5;189m\342\226\210\342\226\210\033[38;5;233m\342\226\221\033[0m"},
+      {141, "\033[1;38;5;60m\342\226\210\342\226\210\342\226\210\033[38;5;61m\342\226\210\342\226\210\033[38;5;103m\342\226\210\342\226\210\342\226\210\033[38;5;104m\342\226\210\342\226\210\342\226\210\342\226\210\033[38;5;146m\342\226\210\342\226\210\342\226\210\033[38;5;147m\342\226\210\342\226\210\033[38;5;189m\342\226\210\342\226\210\342\226\210\033[0m"},
+    },
+  },
+  {
+    { /* truecolor, context */
+      {79, "\033[1m\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {95, "\033[1;38;2;166;226;46m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {113, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {131, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {149, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {167, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {185, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {203, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {221, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {240, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {259, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {278, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {297, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {316, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {335, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {354, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {373, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {391, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\033[0m"},
+      {409, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;5;233m\342\226\221\342\226\221\033[0m"},
+      {427, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;5;233m\342\226\221\033[0m"},
+      {434, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;249;38;114m\342\226\210\033[0m"},
+    },
+    { /* truecolor, session */
+      {79, "\033[1m\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {95, "\033[1;38;2;166;226;46m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {113, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {131, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {149, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {167, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {185, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {203, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {221, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {240, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {259, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {278, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {297, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {316, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {335, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {354, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {373, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {391, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\033[0m"},
+      {409, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;5;233m\342\226\221\342\226\221\033[0m"},
+      {427, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;5;233m\342\226\221\033[0m"},
+      {434, "\033[1;38;2;166;226;46m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;249;38;114m\342\226\210\033[0m"},
+    },
+    { /* truecolor, cache */
+      {79, "\033[1m\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {95, "\033[1;38;2;249;38;114m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {113, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {131, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {149, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {168, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {187, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {206, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {225, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {244, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {263, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {282, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {301, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {319, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {337, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {355, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {373, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {391, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\033[0m"},
+      {409, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;5;233m\342\226\221\342\226\221\033[0m"},
+      {427, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;5;233m\342\226\221\033[0m"},
+      {434, "\033[1;38;2;249;38;114m\342\226\210\033[38;2;247;57;114m\342\226\210\033[38;2;245;76;114m\342\226\210\033[38;2;243;95;115m\342\226\210\033[38;2;241;114;115m\342\226\210\033[38;2;239;133;115m\342\226\210\033[38;2;237;152;115m\342\226\210\033[38;2;235;171;115m\342\226\210\033[38;2;233;190;116m\342\226\210\033[38;2;231;209;116m\342\226\210\033[38;2;227;219;112m\342\226\210\033[38;2;220;220;105m\342\226\210\033[38;2;213;221;98m\342\226\210\033[38;2;206;222;90m\342\226\210\033[38;2;200;222;83m\342\226\210\033[38;2;193;223;75m\342\226\210\033[38;2;186;224;68m\342\226\210\033[38;2;179;225;61m\342\226\210\033[38;2;173;225;53m\342\226\210\033[38;2;166;226;46m\342\226\210\033[0m"},
+    },
+    { /* truecolor, api_time */
+      {79, "\033[1m\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {94, "\033[1;38;2;95;95;135m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {111, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {130, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {149, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {168, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {187, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;2;116;116;177m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {206, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;2;116;116;177m\342\226\210\033[38;2;120;120;186m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {225, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;2;116;116;177m\342\226\210\033[38;2;120;120;186m\342\226\210\033[38;2;124;124;194m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {244, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;2;116;116;177m\342\226\210\033[38;2;120;120;186m\342\226\210\033[38;2;124;124;194m\342\226\210\033[38;2;129;129;202m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {263, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;2;116;116;177m\342\226\210\033[38;2;120;120;186m\342\226\210\033[38;2;124;124;194m\342\226\210\033[38;2;129;129;202m\342\226\210\033[38;2;133;133;211m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {282, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;2;116;116;177m\342\226\210\033[38;2;120;120;186m\342\226\210\033[38;2;124;124;194m\342\226\210\033[38;2;129;129;202m\342\226\210\033[38;2;133;133;211m\342\226\210\033[38;2;139;139;217m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {301, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;2;116;116;177m\342\226\210\033[38;2;120;120;186m\342\226\210\033[38;2;124;124;194m\342\226\210\033[38;2;129;129;202m\342\226\210\033[38;2;133;133;211m\342\226\210\033[38;2;139;139;217m\342\226\210\033[38;2;148;148;221m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {320, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;2;116;116;177m\342\226\210\033[38;2;120;120;186m\342\226\210\033[38;2;124;124;194m\342\226\210\033[38;2;129;129;202m\342\226\210\033[38;2;133;133;211m\342\226\210\033[38;2;139;139;217m\342\226\210\033[38;2;148;148;221m\342\226\210\033[38;2;156;156;226m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {339, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;2;116;116;177m\342\226\210\033[38;2;120;120;186m\342\226\210\033[38;2;124;124;194m\342\226\210\033[38;2;129;129;202m\342\226\210\033[38;2;133;133;211m\342\226\210\033[38;2;139;139;217m\342\226\210\033[38;2;148;148;221m\342\226\210\033[38;2;156;156;226m\342\226\210\033[38;2;164;164;230m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {358, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;2;116;116;177m\342\226\210\033[38;2;120;120;186m\342\226\210\033[38;2;124;124;194m\342\226\210\033[38;2;129;129;202m\342\226\210\033[38;2;133;133;211m\342\226\210\033[38;2;139;139;217m\342\226\210\033[38;2;148;148;221m\342\226\210\033[38;2;156;156;226m\342\226\210\033[38;2;164;164;230m\342\226\210\033[38;2;173;173;234m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {377, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;2;116;116;177m\342\226\210\033[38;2;120;120;186m\342\226\210\033[38;2;124;124;194m\342\226\210\033[38;2;129;129;202m\342\226\210\033[38;2;133;133;211m\342\226\210\033[38;2;139;139;217m\342\226\210\033[38;2;148;148;221m\342\226\210\033[38;2;156;156;226m\342\226\210\033[38;2;164;164;230m\342\226\210\033[38;2;173;173;234m\342\226\210\033[38;2;181;181;238m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\342\226\221\033[0m"},
+      {396, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;2;116;116;177m\342\226\210\033[38;2;120;120;186m\342\226\210\033[38;2;124;124;194m\342\226\210\033[38;2;129;129;202m\342\226\210\033[38;2;133;133;211m\342\226\210\033[38;2;139;139;217m\342\226\210\033[38;2;148;148;221m\342\226\210\033[38;2;156;156;226m\342\226\210\033[38;2;164;164;230m\342\226\210\033[38;2;173;173;234m\342\226\210\033[38;2;181;181;238m\342\226\210\033[38;2;190;190;242m\342\226\210\033[38;5;233m\342\226\221\342\226\221\342\226\221\033[0m"},
+      {415, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;2;116;116;177m\342\226\210\033[38;2;120;120;186m\342\226\210\033[38;2;124;124;194m\342\226\210\033[38;2;129;129;202m\342\226\210\033[38;2;133;133;211m\342\226\210\033[38;2;139;139;217m\342\226\210\033[38;2;148;148;221m\342\226\210\033[38;2;156;156;226m\342\226\210\033[38;2;164;164;230m\342\226\210\033[38;2;173;173;234m\342\226\210\033[38;2;181;181;238m\342\226\210\033[38;2;190;190;242m\342\226\210\033[38;2;198;198;247m\342\226\210\033[38;5;233m\342\226\221\342\226\221\033[0m"},
+      {434, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;2;116;116;177m\342\226\210\033[38;2;120;120;186m\342\226\210\033[38;2;124;124;194m\342\226\210\033[38;2;129;129;202m\342\226\210\033[38;2;133;133;211m\342\226\210\033[38;2;139;139;217m\342\226\210\033[38;2;148;148;221m\342\226\210\033[38;2;156;156;226m\342\226\210\033[38;2;164;164;230m\342\226\210\033[38;2;173;173;234m\342\226\210\033[38;2;181;181;238m\342\226\210\033[38;2;190;190;242m\342\226\210\033[38;2;198;198;247m\342\226\210\033[38;2;207;207;251m\342\226\210\033[38;5;233m\342\226\221\033[0m"},
+      {442, "\033[1;38;2;95;95;135m\342\226\210\033[38;2;99;99;143m\342\226\210\033[38;2;103;103;152m\342\226\210\033[38;2;108;108;160m\342\226\210\033[38;2;112;112;169m\342\226\210\033[38;2;116;116;177m\342\226\210\033[38;2;120;120;186m\342\226\210\033[38;2;124;124;194m\342\226\210\033[38;2;129;129;202m\342\226\210\033[38;2;133;133;211m\342\226\210\033[38;2;139;139;217m\342\226\210\033[38;2;148;148;221m\342\226\210\033[38;2;156;156;226m\342\226\210\033[38;2;164;164;230m\342\226\210\033[38;2;173;173;234m\342\226\210\033[38;2;181;181;238m\342\226\210\033[38;2;190;190;242m\342\226\210\033[38;2;198;198;247m\342\226\210\033[38;2;207;207;251m\342\226\210\033[38;2;215;215;255m\342\226\210\033[0m"},
+    },
+  },
+};
+
+#endif /* MCCS_GRADIENT_TABLES_H */
@@ -0,0 +1,115 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "activity.h"
+
+#include <string.h>
+
+#define ACTIVITY_WORD_BITS 64
+
+/**
+ * Bits of one word that fall in the ring positions [start, end)
+ */
+static inline uint64_t activity_word_mask(uint32_t word,
+                                          uint32_t start,
+                                          uint32_t end) {
+  uint32_t base = word * ACTIVITY_WORD_BITS;
+  uint32_t lo = start > base ? start - base : 0;
+  uint32_t hi = end < base + ACTIVITY_WORD_BITS ? end - base : ACTIVITY_WORD_BITS;
+  if (end <= base || lo >= hi) {
+    return 0;
+  }
+  uint64_t below_hi = hi == ACTIVITY_WORD_BITS ? ~0ULL : (1ULL << hi) - 1;
+  return below_hi & ~((1ULL << lo) - 1);
+}
+
+/**
+ * Mask of the ring positions of the minutes [first, last] (at most a window)
+ *
+ * @note The range wraps around the end of the ring when its last position
+ *       comes before its first one
+ */
+static void activity_range_masks(int64_t first,
+                                 int64_t last,
+                                 uint64_t masks[ACTIVITY_WORDS]) {
+  uint32_t start = (uint32_t)(first % ACTIVITY_WINDOW_MIN);
+  uint32_t end = (uint32_t)(last % ACTIVITY_WINDOW_MIN) + 1;
+  for (uint32_t w = 0; w < ACTIVITY_WORDS; w++) {
+    masks[w] = start < end ? activity_word_mask(w, start, end)
+                           : activity_word_mask(w, start, ACTIVITY_WINDOW_MIN) | activity_word_mask(w, 0, end);
+  }
+}
+
+void activity_init(struct activity_map *map) {
+  memset(map, 0, sizeof(*map));
+}
+
+void activity_mark(struct activity_map *map,
+                   int64_t time_s) {
+  if (time_s <= 0) {
+    return;
+  }
+  int64_t minute = time_s / 60;
+
+  if (map->last_minute == 0 || minute - map->last_minute >= ACTIVITY_WINDOW_MIN) {
+    memset(map->bits, 0, sizeof(map->bits));
+    map->last_minute = minute;
+  } else if (minute > map->last_minute) {
+    // The skipped minutes reuse the bits of minutes that left the window
+    uint64_t masks[ACTIVITY_WORDS];
+    activity_range_masks(map->last_minute + 1, minute, masks);
+    for (uint32_t w = 0; w < ACTIVITY_WORDS; w++) {
+      map->bits[w] &= ~masks[w];
+    }
+    map->last_minute = minute;
+  } else if (map->last_minute - minute >= ACTIVITY_WINDOW_MIN) {
+    return;
+  }
+
+  uint32_t pos = (uint32_t)(minute % ACTIVITY_WINDOW_MIN);
+  map->bits[pos / ACTIVITY_WORD_BITS] |= 1ULL << (pos % ACTIVITY_WORD_BITS);
+}
+
+uint32_t activity_count(const struct activity_map *map,
+                        int64_t first,
+                        int64_t last) {
+  int64_t oldest = map->last_minute - ACTIVITY_WINDOW_MIN + 1;
+  if (map->last_minute == 0) {
+    return 0;
+  }
+  first = first > oldest ? first : oldest;
+  last = last < map->last_minute ? last : map->last_minute;
+  if (first > last) {
+    return 0;
+  }
+
+  uint64_t masks[ACTIVITY_WORDS];
+  activity_range_masks(first, last, masks);
+  uint32_t count = 0;
+  for (uint32_t w = 0; w < ACTIVITY_WORDS; w++) {
+    count += (uint32_t)__builtin_popcountll(map->bits[w] & masks[w]);
+  }
+  return count;
+}
+
+int64_t activity_first(const struct activity_map *map) {
+  if (map->last_minute == 0) {
+    return 0;
+  }
+
+  // Oldest position first: the part of the ring after the latest minute, then up to it
+  uint32_t next = (uint32_t)((map->last_minute + 1) % ACTIVITY_WINDOW_MIN);
+  const uint32_t ranges[2][2] = {{next, ACTIVITY_WINDOW_MIN}, {0, next}};
+  for (int r = 0; r < 2; r++) {
+    for (uint32_t w = 0; w < ACTIVITY_WORDS; w++) {
+      uint64_t bits = map->bits[w] & activity_word_mask(w, ranges[r][0], ranges[r][1]);
+      if (bits != 0) {
+        uint32_t pos = w * ACTIVITY_WORD_BITS + (uint32_t)__builtin_ctzll(bits);
+        uint32_t age = (uint32_t)((map->last_minute % ACTIVITY_WINDOW_MIN + ACTIVITY_WINDOW_MIN - pos) %
+                                  ACTIVITY_WINDOW_MIN);
+        return map->last_minute - age;
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,61 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file activity.h
+ * @brief Per-minute session activity bitmap
+ *
+ * Marks the minutes in which assistant turns were written in a ring of
+ * ACTIVITY_WINDOW_MIN bits that rolls forward with the latest turn, so the
+ * map has a fixed size and can be stored in the session cache as-is.
+ * Range queries mask the ring words and popcount them: their cost depends
+ * on the window size only, never on the session length.
+ */
+
+#ifndef MCCS_ACTIVITY_H
+#define MCCS_ACTIVITY_H
+
+#include <stdint.h>
+
+#include "types_struct.h"
+
+/**
+ * Initialize an empty map
+ *
+ * @param map    Map to initialize
+ */
+void activity_init(struct activity_map *map);
+
+/**
+ * Mark the minute of a turn as active
+ *
+ * @param map       Map to update
+ * @param time_s    Turn time (seconds since epoch, ignored if <= 0)
+ *
+ * @note A later minute moves the window and clears the minutes it skips;
+ *       turns older than the window are ignored
+ */
+void activity_mark(struct activity_map *map,
+                   int64_t time_s);
+
+/**
+ * Count the active minutes of a range
+ *
+ * @param map      Map to read
+ * @param first    First minute of the range (epoch / 60)
+ * @param last     Last minute of the range, inclusive
+ * @return         Active minutes in the part of the range inside the window
+ */
+uint32_t activity_count(const struct activity_map *map,
+                        int64_t first,
+                        int64_t last);
+
+/**
+ * Earliest active minute still inside the window
+ *
+ * @param map    Map to read
+ * @return       Minute (epoch / 60), or 0 if the map is empty
+ */
+int64_t activity_first(const struct activity_map *map);
+
+#endif /* MCCS_ACTIVITY_H */
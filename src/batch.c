@@ -0,0 +1,539 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "batch.h"
+
+#include <dirent.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "constants.h"
+#include "debug.h"
+#include "render.h"
+#include "render_ctx.h"
+#include "safe_conv.h"
+#include "sgr.h"
+
+#define BATCH_INITIAL_DOCS 64
+#define BATCH_NO_SOURCE SIZE_MAX /* Document parses its own transcript */
+#define BATCH_HASH_FNV_OFFSET 1469598103934665603ULL
+#define BATCH_HASH_FNV_PRIME 1099511628211ULL
+
+/**
+ * One input document and its render state
+ */
+struct batch_doc {
+  char *data;                 ///< Raw JSON (heap allocated)
+  size_t len;                 ///< Length of data
+  bool valid;                 ///< Document parsed successfully
+  enum MccsError error;       ///< Error code when !valid
+  size_t source;              ///< Document whose transcript parse is shared, or BATCH_NO_SOURCE
+  struct mccs_render_job *job; ///< Render state kept across phases (refresh only, never copied once prepared)
+  unsigned int worker;        ///< Worker whose buffer holds the output
+  size_t out_offset;          ///< Output offset inside the worker buffer
+  size_t out_len;             ///< Output length
+};
+
+struct batch_docs {
+  struct batch_doc *items;
+  size_t count;
+  size_t cap;
+};
+
+enum batch_phase {
+  BATCH_PHASE_PREPARE, ///< Parse JSON, look up the session cache, render cache hits
+  BATCH_PHASE_PARSE,   ///< Parse each distinct transcript once
+  BATCH_PHASE_OUTPUT,  ///< Share results, store caches, render the refreshed documents
+};
+
+struct batch_worker {
+  struct mccs_render_ctx ctx; ///< Per-worker render context
+  struct mccs_render_job job; ///< Job of the document being prepared (reused)
+  char *buf;                  ///< open_memstream() buffer
+  size_t buf_len;             ///< open_memstream() size
+  unsigned int id;            ///< Worker index
+};
+
+struct batch_pool {
+  const struct cli_options *opts;
+  struct batch_docs *docs;
+  struct batch_worker *workers;
+  unsigned int n_workers;
+  enum batch_phase phase;
+  atomic_size_t next; ///< Next document index to claim
+};
+
+struct batch_task {
+  struct batch_pool *pool;
+  struct batch_worker *worker;
+};
+
+DEFINE_RESULT(ResultBatchDoc, struct batch_doc *, enum MccsError);
+
+/**
+ * Append an empty document slot, growing the array as needed
+ */
+static ResultBatchDoc batch_docs_push(struct batch_docs *docs) {
+  if (docs->count == docs->cap) {
+    size_t new_cap = docs->cap ? docs->cap * 2 : BATCH_INITIAL_DOCS;
+    struct batch_doc *items = realloc(docs->items, new_cap * sizeof(*items));
+    if (!items) {
+      return ERR(ResultBatchDoc, MCCS_ERR_OUT_OF_MEMORY);
+    }
+    docs->items = items;
+    docs->cap = new_cap;
+  }
+  struct batch_doc *doc = &docs->items[docs->count++];
+  memset(doc, 0, sizeof(*doc));
+  doc->source = BATCH_NO_SOURCE;
+  return OK(ResultBatchDoc, doc);
+}
+
+static void batch_docs_free(struct batch_docs *docs) {
+  for (size_t i = 0; i < docs->count; i++) {
+    free(docs->items[i].data);
+    free(docs->items[i].job);
+  }
+  free(docs->items);
+  docs->items = NULL;
+  docs->count = 0;
+  docs->cap = 0;
+}
+
+/**
+ * Read NDJSON documents (one per non-empty line) from a stream
+ */
+static ResultVoid batch_read_ndjson(FILE *f,
+                                    struct batch_docs *docs) {
+  char *line = NULL;
+  size_t cap = 0;
+  ssize_t raw_len;
+
+  while ((raw_len = getline(&line, &cap, f)) != -1) {
+    ResultSize len_result = safe_ssize_to_size(raw_len);
+    if (IS_ERR(len_result)) {
+      free(line);
+      return ERR(ResultVoid, MCCS_ERR_INVALID_CONVERSION);
+    }
+    size_t len = UNWRAP_OK(len_result);
+    if (len > MAX_INPUT_LINE_SIZE) {
+      fprintf(MCCS_STDERR, "error: input exceeds maximum size limit\n");
+      free(line);
+      return ERR(ResultVoid, MCCS_ERR_BUFFER_TOO_SMALL);
+    }
+    while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) {
+      len--;
+    }
+    if (len == 0) {
+      continue;
+    }
+
+    char *data = malloc(len + 1);
+    if (!data) {
+      free(line);
+      return ERR(ResultVoid, MCCS_ERR_OUT_OF_MEMORY);
+    }
+    memcpy(data, line, len);
+    data[len] = '\0';
+
+    ResultBatchDoc doc_result = batch_docs_push(docs);
+    if (IS_ERR(doc_result)) {
+      free(data);
+      free(line);
+      return ERR(ResultVoid, UNWRAP_ERR(doc_result));
+    }
+    struct batch_doc *doc = UNWRAP_OK(doc_result);
+    doc->data = data;
+    doc->len = len;
+  }
+
+  bool failed = ferror(f) != 0;
+  free(line);
+  return failed ? ERR(ResultVoid, MCCS_ERR_IO_ERROR) : OK(ResultVoid, 0);
+}
+
+/**
+ * Read a whole file as a single document (pretty-printed JSON is fine)
+ */
+static ResultVoid batch_read_file(const char *path,
+                                  struct batch_docs *docs) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    fprintf(MCCS_STDERR, "error: cannot read %s\n", path);
+    return ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+  }
+
+  char *data = malloc(MAX_INPUT_LINE_SIZE + 1);
+  if (!data) {
+    fclose(f);
+    return ERR(ResultVoid, MCCS_ERR_OUT_OF_MEMORY);
+  }
+  size_t len = fread(data, 1, MAX_INPUT_LINE_SIZE + 1, f);
+  bool failed = ferror(f) != 0;
+  fclose(f);
+
+  if (failed || len > MAX_INPUT_LINE_SIZE) {
+    fprintf(MCCS_STDERR, "error: cannot read %s\n", path);
+    free(data);
+    return ERR(ResultVoid, failed ? MCCS_ERR_IO_ERROR : MCCS_ERR_BUFFER_TOO_SMALL);
+  }
+
+  ResultBatchDoc doc_result = batch_docs_push(docs);
+  if (IS_ERR(doc_result)) {
+    free(data);
+    return ERR(ResultVoid, UNWRAP_ERR(doc_result));
+  }
+  struct batch_doc *doc = UNWRAP_OK(doc_result);
+  data[len] = '\0';
+  doc->data = data;
+  doc->len = len;
+  return OK(ResultVoid, 0);
+}
+
+static int batch_filter_json(const struct dirent *entry) {
+  size_t len = strlen(entry->d_name);
+  return len > 5 && entry->d_name[0] != '.' && strcmp(entry->d_name + len - 5, ".json") == 0;
+}
+
+/**
+ * Read every *.json file of a directory (sorted by name) as one document
+ */
+static ResultVoid batch_read_dir(const char *dir,
+                                 struct batch_docs *docs) {
+  struct dirent **entries = NULL;
+  int n = scandir(dir, &entries, batch_filter_json, alphasort);
+  if (n < 0) {
+    fprintf(MCCS_STDERR, "error: cannot read %s\n", dir);
+    return ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+  }
+
+  ResultVoid result = OK(ResultVoid, 0);
+  for (int i = 0; i < n; i++) {
+    if (IS_OK(result)) {
+      char path[BUF_TRANSCRIPT_PATH_SIZE];
+      int written = snprintf(path, sizeof(path), "%s/%s", dir, entries[i]->d_name);
+      if (written < 0 || (size_t)written >= sizeof(path)) {
+        fprintf(MCCS_STDERR, "error: path too long: %s/%s\n", dir, entries[i]->d_name);
+        result = ERR(ResultVoid, MCCS_ERR_BUFFER_TOO_SMALL);
+      } else {
+        result = batch_read_file(path, docs);
+      }
+    }
+    free(entries[i]);
+  }
+  free(entries);
+  return result;
+}
+
+static ResultVoid batch_load(const char *source,
+                             struct batch_docs *docs) {
+  if (strcmp(source, "-") == 0) {
+    return batch_read_ndjson(stdin, docs);
+  }
+
+  struct stat st;
+  if (stat(source, &st) != 0) {
+    fprintf(MCCS_STDERR, "error: cannot access %s\n", source);
+    return ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+  }
+  if (S_ISDIR(st.st_mode)) {
+    return batch_read_dir(source, docs);
+  }
+
+  FILE *f = fopen(source, "r");
+  if (!f) {
+    fprintf(MCCS_STDERR, "error: cannot read %s\n", source);
+    return ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+  }
+  ResultVoid result = batch_read_ndjson(f, docs);
+  fclose(f);
+  return result;
+}
+
+static uint64_t batch_hash_path(const char *path) {
+  uint64_t hash = BATCH_HASH_FNV_OFFSET;
+  for (const unsigned char *p = (const unsigned char *)path; *p; p++) {
+    hash ^= (uint64_t)(*p);
+    hash *= BATCH_HASH_FNV_PRIME;
+  }
+  return hash;
+}
+
+/**
+ * Point every document that needs a refresh at the first document sharing
+ * its transcript, so each transcript file is parsed only once per batch
+ */
+static void batch_group_transcripts(struct batch_docs *docs) {
+  size_t n = docs->count;
+  size_t slots = 16;
+  while (slots < n * 2) {
+    slots *= 2;
+  }
+  size_t *table = malloc(slots * sizeof(*table));
+  if (!table) {
+    return; // Every document simply parses its own transcript
+  }
+  for (size_t i = 0; i < slots; i++) {
+    table[i] = BATCH_NO_SOURCE;
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    struct batch_doc *doc = &docs->items[i];
+    if (!doc->job) {
+      continue;
+    }
+    const char *path = doc->job->paths.transcript_path;
+    size_t slot = (size_t)(batch_hash_path(path) & (slots - 1));
+    while (table[slot] != BATCH_NO_SOURCE) {
+      struct batch_doc *owner = &docs->items[table[slot]];
+      if (strcmp(owner->job->paths.transcript_path, path) == 0) {
+        doc->source = table[slot];
+        break;
+      }
+      slot = (slot + 1) & (slots - 1);
+    }
+    if (table[slot] == BATCH_NO_SOURCE) {
+      table[slot] = i;
+    }
+  }
+  free(table);
+}
+
+/**
+ * Render a document into the worker buffer and record where its output is
+ */
+static void batch_render_doc(struct batch_pool *pool,
+                             struct batch_worker *worker,
+                             struct batch_doc *doc,
+                             struct mccs_render_job *job) {
+  struct mccs_render_ctx *ctx = &worker->ctx;
+  long start = ftell(ctx->out);
+  if (doc->valid) {
+    mccs_render_store(ctx, job);
+    mccs_render_output(ctx, pool->opts, job);
+  } else {
+    sgr_puts(ctx, ctx->theme.reset, "error: invalid JSON");
+    sgr_end_line(ctx);
+  }
+  long end = ftell(ctx->out);
+  doc->worker = worker->id;
+  doc->out_offset = start > 0 ? (size_t)start : 0;
+  doc->out_len = end > start ? (size_t)(end - start) : 0;
+}
+
+/**
+ * Keep a job for a document whose transcript must be parsed
+ *
+ * @note Prepared jobs point into themselves, so the document is prepared
+ *       again in its own job and only the cache lookup is carried over
+ */
+static bool batch_keep_job(struct batch_pool *pool,
+                           struct batch_worker *worker,
+                           struct batch_doc *doc) {
+  struct mccs_render_job *job = malloc(sizeof(*job));
+  if (!job) {
+    return false;
+  }
+  ResultVoid result = mccs_render_prepare(&worker->ctx, pool->opts, doc->data, doc->len, job);
+  if (IS_ERR(result)) {
+    free(job);
+    return false;
+  }
+  job->cache = worker->job.cache;
+  job->cache_loaded = worker->job.cache_loaded;
+  job->needs_refresh = true;
+  doc->job = job;
+  return true;
+}
+
+static void batch_run_doc(struct batch_pool *pool,
+                          struct batch_worker *worker,
+                          size_t index) {
+  struct batch_doc *doc = &pool->docs->items[index];
+  struct mccs_render_ctx *ctx = &worker->ctx;
+
+  switch (pool->phase) {
+  case BATCH_PHASE_PREPARE: {
+    // Only documents that need a transcript parse keep a job past this phase
+    struct mccs_render_job *job = &worker->job;
+    ResultVoid result = mccs_render_prepare(ctx, pool->opts, doc->data, doc->len, job);
+    doc->valid = IS_OK(result);
+    if (!doc->valid) {
+      doc->error = UNWRAP_ERR(result);
+    } else {
+      mccs_render_lookup_cache(ctx, job);
+      if (job->needs_refresh) {
+        if (batch_keep_job(pool, worker, doc)) {
+          return;
+        }
+        // No memory for a job: parse here, without sharing the transcript
+        mccs_render_parse(ctx, job);
+      }
+    }
+    batch_render_doc(pool, worker, doc, job);
+    return;
+  }
+  case BATCH_PHASE_PARSE:
+    if (doc->job && doc->source == BATCH_NO_SOURCE) {
+      mccs_render_parse(ctx, doc->job);
+    }
+    return;
+  case BATCH_PHASE_OUTPUT:
+    if (doc->job) {
+      if (doc->source != BATCH_NO_SOURCE) {
+        mccs_render_share_tokens(doc->job, pool->docs->items[doc->source].job);
+      }
+      batch_render_doc(pool, worker, doc, doc->job);
+    }
+    return;
+  }
+}
+
+static void *batch_worker_main(void *arg) {
+  struct batch_task *task = arg;
+  struct batch_pool *pool = task->pool;
+
+  while (true) {
+    size_t i = atomic_fetch_add(&pool->next, 1);
+    if (i >= pool->docs->count) {
+      break;
+    }
+    batch_run_doc(pool, task->worker, i);
+  }
+  return NULL;
+}
+
+/**
+ * Run one phase over all documents on the worker pool
+ */
+static void batch_run_phase(struct batch_pool *pool,
+                            enum batch_phase phase) {
+  pthread_t threads[BATCH_MAX_JOBS];
+  struct batch_task tasks[BATCH_MAX_JOBS];
+  unsigned int started = 0;
+
+  pool->phase = phase;
+  atomic_store(&pool->next, 0);
+
+  for (unsigned int t = 1; t < pool->n_workers; t++) {
+    tasks[t].pool = pool;
+    tasks[t].worker = &pool->workers[t];
+    if (pthread_create(&threads[t], NULL, batch_worker_main, &tasks[t]) != 0) {
+      break; // Remaining work is picked up by the threads already running
+    }
+    started = t;
+  }
+
+  // The calling thread is worker 0
+  tasks[0].pool = pool;
+  tasks[0].worker = &pool->workers[0];
+  batch_worker_main(&tasks[0]);
+
+  for (unsigned int t = 1; t <= started; t++) {
+    pthread_join(threads[t], NULL);
+  }
+}
+
+static unsigned int batch_worker_count(const struct cli_options *opts,
+                                       size_t n_docs) {
+  long n = opts->batch_jobs > 0 ? (long)opts->batch_jobs : sysconf(_SC_NPROCESSORS_ONLN);
+  if (n < 1) {
+    n = 1;
+  }
+  if (n > BATCH_MAX_JOBS) {
+    n = BATCH_MAX_JOBS;
+  }
+  if ((size_t)n > n_docs) {
+    n = n_docs > 0 ? (long)n_docs : 1;
+  }
+  return (unsigned int)n;
+}
+
+static int batch_exit_code(enum MccsError err) {
+  switch (err) {
+  case MCCS_ERR_OUT_OF_MEMORY:
+    return MCCS_ERROR_MEMORY;
+  case MCCS_ERR_INVALID_JSON:
+    return MCCS_ERROR_JSON;
+  default:
+    return MCCS_ERROR_IO;
+  }
+}
+
+int mccs_run_batch(const struct cli_options *opts,
+                   bool use_color,
+                   bool use_verbose) {
+  struct batch_docs docs = {0};
+  ResultVoid load_result = batch_load(opts->batch_source, &docs);
+  if (IS_ERR(load_result)) {
+    batch_docs_free(&docs);
+    return batch_exit_code(UNWRAP_ERR(load_result));
+  }
+
+  struct batch_pool pool = {
+      .opts = opts,
+      .docs = &docs,
+      .n_workers = batch_worker_count(opts, docs.count),
+  };
+  DEBUG_LOG("Batch: %zu documents on %u workers", docs.count, pool.n_workers);
+
+  pool.workers = calloc(pool.n_workers, sizeof(*pool.workers));
+  if (!pool.workers) {
+    batch_docs_free(&docs);
+    return MCCS_ERROR_MEMORY;
+  }
+
+  int exit_code = 0;
+  unsigned int ready = 0;
+  for (; ready < pool.n_workers; ready++) {
+    struct batch_worker *w = &pool.workers[ready];
+    FILE *out = open_memstream(&w->buf, &w->buf_len);
+    if (!out) {
+      exit_code = MCCS_ERROR_MEMORY;
+      break;
+    }
+    w->id = ready;
+    mccs_render_ctx_init(&w->ctx, use_color, use_verbose, out);
+    w->ctx.gradient = opts->gradient;
+    mccs_render_ctx_set_colors(&w->ctx, opts->theme_colors);
+  }
+
+  if (exit_code == 0) {
+    batch_run_phase(&pool, BATCH_PHASE_PREPARE);
+    batch_group_transcripts(&docs);
+    batch_run_phase(&pool, BATCH_PHASE_PARSE);
+    batch_run_phase(&pool, BATCH_PHASE_OUTPUT);
+  }
+
+  for (unsigned int w = 0; w < ready; w++) {
+    fclose(pool.workers[w].ctx.out);
+    mccs_render_ctx_free(&pool.workers[w].ctx);
+  }
+
+  if (exit_code == 0) {
+    for (size_t i = 0; i < docs.count; i++) {
+      const struct batch_doc *doc = &docs.items[i];
+      if (i > 0) {
+        fputc('\n', MCCS_STDOUT);
+      }
+      const struct batch_worker *w = &pool.workers[doc->worker];
+      fwrite(w->buf + doc->out_offset, 1, doc->out_len, MCCS_STDOUT);
+      if (!doc->valid && exit_code == 0) {
+        exit_code = batch_exit_code(doc->error);
+      }
+    }
+  }
+
+  for (unsigned int w = 0; w < pool.n_workers; w++) {
+    free(pool.workers[w].buf);
+  }
+  free(pool.workers);
+  batch_docs_free(&docs);
+  return exit_code;
+}
@@ -0,0 +1,40 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file batch.h
+ * @brief Parallel multi-session batch rendering
+ *
+ * Renders many status documents at once (a directory of .json files or an
+ * NDJSON stream) across a pool of worker threads. Each worker owns a render
+ * context and an output buffer; the final output is stitched together in
+ * input order once all workers are done, so no locks are taken on output.
+ * Sessions that point at the same transcript share a single parse.
+ */
+
+#ifndef MCCS_BATCH_H
+#define MCCS_BATCH_H
+
+#include <stdbool.h>
+
+#include "types_struct.h"
+
+#define BATCH_MAX_JOBS 64 /* Upper bound on worker threads */
+
+/**
+ * Render every document of opts->batch_source to stdout in input order
+ *
+ * @param opts           CLI options (batch_source must be set)
+ * @param use_color      Whether to use ANSI color codes
+ * @param use_verbose    Whether to show field labels
+ * @return               Exit code (0 on success, MCCS_ERROR_* on failure)
+ *
+ * @note batch_source may be a directory (all *.json files, sorted by name),
+ *       an NDJSON file, or "-" for NDJSON on stdin. Outputs of consecutive
+ *       documents are separated by an empty line.
+ */
+int mccs_run_batch(const struct cli_options *opts,
+                   bool use_color,
+                   bool use_verbose);
+
+#endif /* MCCS_BATCH_H */
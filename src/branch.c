@@ -0,0 +1,81 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "branch.h"
+
+#include <string.h>
+
+#define BRANCH_HASH_FNV_OFFSET 1469598103934665603ULL
+#define BRANCH_HASH_FNV_PRIME 1099511628211ULL
+
+void branch_init(struct branch_state *branch) {
+  memset(branch, 0, sizeof(*branch));
+}
+
+uint64_t branch_key(const char *uuid,
+                    size_t len) {
+  if (!uuid || len == 0) {
+    return 0;
+  }
+  uint64_t hash = BRANCH_HASH_FNV_OFFSET;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= (unsigned char)uuid[i];
+    hash *= BRANCH_HASH_FNV_PRIME;
+  }
+  return hash != 0 ? hash : 1;
+}
+
+void branch_follow(struct branch_state *branch,
+                   uint64_t parent,
+                   uint64_t self) {
+  if (parent != 0 && parent != branch->tip.key) {
+    const struct branch_point *fork = &branch->fork_points[parent % BRANCH_FORK_SLOTS];
+    if (fork->key == parent) {
+      branch->tip = *fork;
+      branch->forks++;
+    }
+  }
+  if (self != 0) {
+    branch->tip.key = self;
+  }
+}
+
+void branch_mark_fork(struct branch_state *branch,
+                      uint64_t parent) {
+  if (parent == 0) {
+    return;
+  }
+  // The prompt is not part of the tip yet: the state at the tip is the state at its parent
+  struct branch_point *fork = &branch->fork_points[parent % BRANCH_FORK_SLOTS];
+  *fork = branch->tip;
+  fork->key = parent;
+}
+
+void branch_add_turn(struct branch_state *branch,
+                     uint64_t tokens,
+                     uint64_t context) {
+  branch->tip.path_tokens += tokens;
+  branch->total_tokens += tokens;
+  if (context > 0) {
+    branch->tip.context_tokens = context;
+  }
+}
+
+void branch_add_context(struct branch_state *branch,
+                        enum context_kind kind,
+                        size_t bytes) {
+  if (kind >= CONTEXT_KINDS) {
+    return;
+  }
+  uint32_t *total = &branch->tip.context_bytes[kind];
+  *total = bytes < UINT32_MAX - *total ? *total + (uint32_t)bytes : UINT32_MAX;
+}
+
+void branch_compact(struct branch_state *branch) {
+  branch->tip.context_tokens = 0;
+  memset(branch->tip.context_bytes, 0, sizeof(branch->tip.context_bytes));
+}
+
+uint64_t branch_abandoned_tokens(const struct branch_state *branch) {
+  return branch->total_tokens - branch->tip.path_tokens;
+}
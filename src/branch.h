@@ -0,0 +1,109 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file branch.h
+ * @brief Active branch of a rewound or edited conversation
+ *
+ * Transcript entries point to their parent by uuid. Rewinding or editing a
+ * prompt appends a new prompt whose parent is an earlier entry, leaving the
+ * abandoned branch in the file. The tip of the active branch follows the
+ * entries and jumps back to the state recorded for a prompt's parent when
+ * the prompt does not continue from the tip, so the context comes from the
+ * active branch and the tokens spent on the others can be told apart. The
+ * tip also carries the raw bytes of its context by kind, so an edit drops
+ * the abandoned content from the composition and a compaction clears it.
+ *
+ * Keys are 64-bit hashes of the uuids. The state recorded for prompt
+ * parents lives in a direct-mapped table of BRANCH_FORK_SLOTS entries:
+ * each entry costs O(1) and the state can be stored in the session cache
+ * as-is. A fork to a parent that was evicted, or to an entry that is not
+ * the parent of a prompt, is not detected and continues from the tip.
+ */
+
+#ifndef MCCS_BRANCH_H
+#define MCCS_BRANCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types_struct.h"
+
+/**
+ * Initialize the state of an empty transcript
+ *
+ * @param branch    State to initialize
+ */
+void branch_init(struct branch_state *branch);
+
+/**
+ * Key of an entry uuid
+ *
+ * @param uuid    uuid or parentUuid string (may be NULL)
+ * @param len     Length of uuid
+ * @return        Nonzero hash, or 0 without a uuid
+ */
+uint64_t branch_key(const char *uuid,
+                    size_t len);
+
+/**
+ * Move the tip to an entry
+ *
+ * @param branch    State to update
+ * @param parent    Key of the entry's parent (0 if none)
+ * @param self      Key of the entry (0 if none: the tip stays where it is)
+ *
+ * @note The tip moves back when the parent is a recorded fork point other
+ *       than the tip; otherwise the entry continues the active branch
+ */
+void branch_follow(struct branch_state *branch,
+                   uint64_t parent,
+                   uint64_t self);
+
+/**
+ * Record the parent of a prompt as a possible fork point
+ *
+ * @param branch    State to update (tip moved to the prompt, its content not added yet)
+ * @param parent    Key of the prompt's parent (ignored if 0)
+ */
+void branch_mark_fork(struct branch_state *branch,
+                      uint64_t parent);
+
+/**
+ * Add an assistant turn at the tip
+ *
+ * @param branch     State to update
+ * @param tokens     Total tokens of the turn
+ * @param context    Context tokens of the turn (0 keeps the current context)
+ */
+void branch_add_turn(struct branch_state *branch,
+                     uint64_t tokens,
+                     uint64_t context);
+
+/**
+ * Add content to the context at the tip
+ *
+ * @param branch    State to update
+ * @param kind      What the content is
+ * @param bytes     Raw JSON bytes of the content (saturates at UINT32_MAX)
+ */
+void branch_add_context(struct branch_state *branch,
+                        enum context_kind kind,
+                        size_t bytes);
+
+/**
+ * Start the context over at a compaction boundary
+ *
+ * @param branch    State to update
+ */
+void branch_compact(struct branch_state *branch);
+
+/**
+ * Tokens spent on branches the conversation left
+ *
+ * @param branch    State to read
+ * @return          Assistant turn tokens not on the path to the tip
+ */
+uint64_t branch_abandoned_tokens(const struct branch_state *branch);
+
+#endif /* MCCS_BRANCH_H */
@@ -4,6 +4,8 @@
 #include "cache.h"
 
 #include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/file.h>
@@ -19,6 +21,7 @@
 
 #define CACHE_HASH_FNV_OFFSET 1469598103934665603ULL
 #define CACHE_HASH_FNV_PRIME 1099511628211ULL
+#define CACHE_HASH_WORD_PRIME 0x9E3779B97F4A7C15ULL
 #define CACHE_HASH_OUTPUT_SIZE 17 // 16 hex chars + null terminator
 
 #define CACHE_DIR_PATH "/tmp/mini-ccstatus"
@@ -26,6 +29,9 @@
 #define CACHE_LOCK_TIMEOUT_MS 2000
 #define CACHE_LOCK_INTERVAL_MS 50
 
+_Static_assert(offsetof(struct token_cache, cost_usd) + sizeof(double) <= CACHE_LINE_SIZE,
+               "validity fields and headline totals of struct token_cache must fit its first cache line");
+
 /**
  * Get file size safely
  *
@@ -124,11 +130,58 @@ static void hash_session_id(const char *session_id,
   snprintf(out, out_size, "%016llx", (unsigned long long)hash);
 }
 
-const char *get_cache_path(const char *session_id) {
-  static char path[BUF_PATH_SIZE];
+uint64_t cache_identity_hash(const char *text) {
+  // Eight bytes per multiply: identity strings are hashed on every render
+  const char *p = text ? text : "";
+  size_t len = strlen(p);
+  uint64_t hash = CACHE_HASH_FNV_OFFSET ^ len;
+  for (; len >= sizeof(uint64_t); p += sizeof(uint64_t), len -= sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    hash = (hash ^ word) * CACHE_HASH_WORD_PRIME;
+    hash ^= hash >> 29;
+  }
+  uint64_t tail = 0;
+  memcpy(&tail, p, len);
+  hash = (hash ^ tail) * CACHE_HASH_WORD_PRIME;
+  return hash ^ (hash >> 32);
+}
+
+uint64_t cache_owner_hash(const char *session_id,
+                          const char *project_dir) {
+  uint64_t hash = (cache_identity_hash(session_id) ^ CACHE_HASH_FNV_OFFSET) * CACHE_HASH_WORD_PRIME;
+  return hash ^ cache_identity_hash(project_dir);
+}
+
+void cache_identity_init(struct cache_identity *id,
+                         const char *session_id,
+                         const char *project_dir,
+                         const char *transcript_path) {
+  id->owner_hash = cache_owner_hash(session_id, project_dir);
+  id->transcript_hash = cache_identity_hash(transcript_path);
+  id->session_id = session_id;
+  id->project_dir = project_dir;
+  id->transcript_path = transcript_path;
+}
+
+void cache_set_identity(struct token_cache *cache,
+                        const struct cache_identity *id) {
+  // Hash the stored (possibly truncated) strings so a later check matches them
+  snprintf(cache->session_id, sizeof(cache->session_id), "%s", id->session_id ? id->session_id : "");
+  snprintf(cache->project_dir, sizeof(cache->project_dir), "%s", id->project_dir ? id->project_dir : "");
+  snprintf(cache->transcript_path, sizeof(cache->transcript_path), "%s",
+           id->transcript_path ? id->transcript_path : "");
+  cache->owner_hash = cache_owner_hash(cache->session_id, cache->project_dir);
+  cache->transcript_hash = cache_identity_hash(cache->transcript_path);
+}
+
+const char *get_cache_dir(struct mccs_render_ctx *ctx) {
+  return format_cache_dir(ctx->cache_dir, sizeof(ctx->cache_dir));
+}
 
-  char cache_dir[BUF_PATH_SIZE];
-  snprintf(cache_dir, sizeof(cache_dir), "%s/%u", CACHE_DIR_PATH, (unsigned int)getuid());
+const char *format_cache_dir(char *cache_dir,
+                             size_t size) {
+  snprintf(cache_dir, size, "%s/%u", CACHE_DIR_PATH, (unsigned int)getuid());
 
   struct stat st = {0};
   if (stat(CACHE_DIR_PATH, &st) == -1) {
@@ -137,30 +190,34 @@ const char *get_cache_path(const char *session_id) {
   if (stat(cache_dir, &st) == -1) {
     mkdir(cache_dir, CACHE_DIR_MODE);
   }
+  return cache_dir;
+}
+
+const char *get_cache_path(struct mccs_render_ctx *ctx, const char *session_id) {
+  char *path = ctx->cache_path;
+  const size_t path_size = sizeof(ctx->cache_path);
+  const char *cache_dir = get_cache_dir(ctx);
 
   int ret;
   if (!session_id || !*session_id) {
     // Fallback to user-wide cache if no session_id available
-    ret = snprintf(path, sizeof(path), "%s/default.cache", cache_dir);
+    ret = snprintf(path, path_size, "%s/default.cache", cache_dir);
   } else {
     char hashed_session[CACHE_HASH_OUTPUT_SIZE] = {0};
     hash_session_id(session_id, hashed_session, sizeof(hashed_session));
-    ret = snprintf(path, sizeof(path), "%s/%s.cache", cache_dir, hashed_session);
+    ret = snprintf(path, path_size, "%s/%s.cache", cache_dir, hashed_session);
   }
 
-  if (ret < 0 || (size_t)ret >= sizeof(path)) {
+  if (ret < 0 || (size_t)ret >= path_size) {
     DEBUG_LOG("Cache path truncated or encoding error");
-    snprintf(path, sizeof(path), "%s", CACHE_FALLBACK_PATH);
+    snprintf(path, path_size, "%s", CACHE_FALLBACK_PATH);
   }
 
   DEBUG_LOG("Cache path: %s", path);
   return path;
 }
 
-ResultTokenCache load_cache(const char *session_id) {
-  const char *path = get_cache_path(session_id);
-  DEBUG_LOG("Loading cache from: %s", path);
-
+ResultTokenCache read_cache_file(const char *path) {
   FILE *f = fopen(path, "rb");
   if (!f) {
     DEBUG_LOG("Cache file not found or cannot be opened");
@@ -193,20 +250,73 @@ ResultTokenCache load_cache(const char *session_id) {
     return ERR(ResultTokenCache, MCCS_ERR_INVALID_FORMAT);
   }
 
-  int64_t now = (int64_t)time(NULL);
-  int64_t age = now - cache.last_update_time;
-  if (age > CACHE_MAX_AGE_S) {
-    DEBUG_LOG("Cache expired: age=%ld seconds, max=%d", (long)age, CACHE_MAX_AGE_S);
-    return ERR(ResultTokenCache, MCCS_ERR_INVALID_FORMAT);
+  return OK(ResultTokenCache, cache);
+}
+
+/**
+ * Compare the identity strings of a record read for a render
+ *
+ * @note The hashes matched already; this rules out a collision once per
+ *       read, so later checks of the record compare hashes only
+ */
+static bool cache_identity_strings_match(const struct token_cache *cache,
+                                         const struct cache_identity *id) {
+  return strcmp(cache->session_id, id->session_id ? id->session_id : "") == 0 &&
+         strcmp(cache->project_dir, id->project_dir ? id->project_dir : "") == 0 &&
+         (!id->transcript_path || cache->transcript_hash != id->transcript_hash ||
+          strcmp(cache->transcript_path, id->transcript_path) == 0);
+}
+
+ResultTokenCache load_cache(struct mccs_render_ctx *ctx,
+                            const struct cache_identity *id) {
+  const char *path = get_cache_path(ctx, id->session_id);
+  DEBUG_LOG("Loading cache from: %s", path);
+
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    DEBUG_LOG("Cache file not found or cannot be opened");
+    return ERR(ResultTokenCache, MCCS_ERR_FILE_NOT_FOUND);
+  }
+  ResultVoid lock_result = acquire_lock_with_timeout(fd, LOCK_SH, CACHE_LOCK_TIMEOUT_MS);
+  if (IS_ERR(lock_result)) {
+    close(fd);
+    return ERR(ResultTokenCache, UNWRAP_ERR(lock_result));
+  }
+
+  // The first line decides; the rest is read only for a record of this session
+  struct token_cache cache;
+  char *bytes = (char *)&cache;
+  enum MccsError error = MCCS_ERR_IO_ERROR;
+  if (pread(fd, bytes, CACHE_LINE_SIZE, 0) == CACHE_LINE_SIZE) {
+    error = cache.magic == CACHE_MAGIC && cache.owner_hash == id->owner_hash ? MCCS_OK : MCCS_ERR_INVALID_FORMAT;
+  }
+  if (error == MCCS_OK &&
+      pread(fd, bytes + CACHE_LINE_SIZE, sizeof(cache) - CACHE_LINE_SIZE, CACHE_LINE_SIZE) !=
+          (ssize_t)(sizeof(cache) - CACHE_LINE_SIZE)) {
+    error = MCCS_ERR_IO_ERROR;
   }
+  flock(fd, LOCK_UN);
+  close(fd);
 
-  DEBUG_LOG("Cache loaded successfully (age=%ld seconds)", (long)age);
+  if (error == MCCS_OK && !cache_identity_strings_match(&cache, id)) {
+    error = MCCS_ERR_INVALID_FORMAT;
+  }
+  if (error != MCCS_OK) {
+    DEBUG_LOG("Cache not loaded: %s", error == MCCS_ERR_IO_ERROR ? "read failed or incomplete"
+                                                                 : "bad magic or another session's record");
+    return ERR(ResultTokenCache, error);
+  }
+
+  // An expired record is still returned: is_cache_valid() rejects its
+  // statistics, but its chunk cursor still locates the transcript in the chunk store
+  DEBUG_LOG("Cache loaded successfully (age=%ld seconds)", (long)((int64_t)time(NULL) - cache.last_update_time));
   return OK(ResultTokenCache, cache);
 }
 
-ResultVoidCache save_cache(const struct token_cache *cache,
+ResultVoidCache save_cache(struct mccs_render_ctx *ctx,
+                           const struct token_cache *cache,
                            const char *session_id) {
-  const char *path = get_cache_path(session_id);
+  const char *path = get_cache_path(ctx, session_id);
   DEBUG_LOG("Saving cache to: %s", path);
 
   FILE *f = fopen(path, "wb");
@@ -238,27 +348,65 @@ ResultVoidCache save_cache(const struct token_cache *cache,
   return OK(ResultVoidCache, 0);
 }
 
+ResultVoidCache update_cache_render(struct mccs_render_ctx *ctx,
+                                    const char *session_id,
+                                    const struct cache_render_stamp *full_render,
+                                    struct cache_render_stamp *stored) {
+  const char *path = get_cache_path(ctx, session_id);
+
+  int fd = open(path, O_RDWR);
+  if (fd < 0) {
+    DEBUG_LOG("Cache file not found for render stamp update");
+    return ERR(ResultVoidCache, MCCS_ERR_FILE_NOT_FOUND);
+  }
+
+  ResultVoid lock_result = acquire_lock_with_timeout(fd, LOCK_EX, CACHE_LOCK_TIMEOUT_MS);
+  if (IS_ERR(lock_result)) {
+    close(fd);
+    return ERR(ResultVoidCache, UNWRAP_ERR(lock_result));
+  }
+
+  const off_t offset = (off_t)offsetof(struct token_cache, render);
+  struct cache_render_stamp stamp;
+  bool ok = pread(fd, &stamp, sizeof(stamp), offset) == (ssize_t)sizeof(stamp);
+  if (ok) {
+    if (full_render) {
+      stamp.input_digest = full_render->input_digest;
+      stamp.last_render_ms = full_render->last_render_ms;
+    } else {
+      stamp.debounced_renders++;
+    }
+    ok = pwrite(fd, &stamp, sizeof(stamp), offset) == (ssize_t)sizeof(stamp);
+  }
+
+  flock(fd, LOCK_UN);
+  close(fd);
+
+  if (!ok) {
+    DEBUG_LOG("Cache render stamp update failed");
+    return ERR(ResultVoidCache, MCCS_ERR_IO_ERROR);
+  }
+  if (stored) {
+    *stored = stamp;
+  }
+  return OK(ResultVoidCache, 0);
+}
+
 bool is_cache_valid(const struct token_cache *cache,
-                    const char *session_id,
-                    const char *project_dir) {
+                    const struct cache_identity *id) {
   if (!cache || cache->magic != CACHE_MAGIC) {
     DEBUG_LOG("Cache invalid: bad magic number");
     return false;
   }
 
-  if (session_id && strcmp(cache->session_id, session_id) != 0) {
-    DEBUG_LOG("Cache invalid: session ID mismatch");
-    return false;
-  }
-
-  if (project_dir && strcmp(cache->project_dir, project_dir) != 0) {
-    DEBUG_LOG("Cache invalid: project directory mismatch");
+  if (cache->owner_hash != id->owner_hash) {
+    DEBUG_LOG("Cache invalid: session ID or project directory mismatch");
     return false;
   }
 
   int64_t now = (int64_t)time(NULL);
   int64_t age = now - cache->last_update_time;
-  if (age > CACHE_MAX_AGE_S) {
+  if (age > CACHE_MAX_AGE_S && !cache->partial) {
     DEBUG_LOG("Cache invalid: expired (age=%ld)", (long)age);
     return false;
   }
@@ -267,16 +415,23 @@ bool is_cache_valid(const struct token_cache *cache,
   return true;
 }
 
+bool cache_same_transcript(const struct token_cache *cache,
+                           const struct cache_identity *id) {
+  if (id->transcript_path && cache->transcript_hash != id->transcript_hash) {
+    DEBUG_LOG("Cache not usable: statistics come from another transcript");
+    return false;
+  }
+  return true;
+}
+
 bool should_refresh_cache(const struct token_cache *cache,
-                          const char *session_id,
-                          const char *project_dir,
-                          const char *transcript_path) {
-  if (!is_cache_valid(cache, session_id, project_dir)) {
+                          const struct cache_identity *id) {
+  if (!is_cache_valid(cache, id) || !cache_same_transcript(cache, id)) {
     DEBUG_LOG("Cache refresh needed: invalid cache");
     return true;
   }
 
-  size_t current_size = get_file_size(transcript_path);
+  size_t current_size = get_file_size(id->transcript_path);
   if (current_size != cache->transcript_file_size) {
     DEBUG_LOG("Cache refresh needed: file size changed (cached=%zu, current=%zu)",
               cache->transcript_file_size, current_size);
@@ -286,3 +441,20 @@ bool should_refresh_cache(const struct token_cache *cache,
   DEBUG_LOG("Cache is fresh, no refresh needed (file size unchanged)");
   return false;
 }
+
+bool can_resume_cache(const struct token_cache *cache,
+                      const struct cache_identity *id) {
+  if (!is_cache_valid(cache, id) || !cache_same_transcript(cache, id)) {
+    return false;
+  }
+
+  // A shrunk transcript was rewritten, not appended to: parse from scratch
+  size_t current_size = get_file_size(id->transcript_path);
+  if (current_size < cache->transcript_file_size) {
+    DEBUG_LOG("Cache not resumable: transcript shrank (cached=%zu, current=%zu)",
+              cache->transcript_file_size, current_size);
+    return false;
+  }
+
+  return true;
+}
@@ -8,6 +8,10 @@
  * Implements a persistent cache to avoid re-parsing large transcript files.
  * Cache files are stored per-session in /tmp/mini-ccstatus/<uid>/<session_id>.cache
  * with file locking to prevent race conditions.
+ *
+ * Validity checks compare 64-bit identity hashes kept in the first cache
+ * line of the record, computed once per render (struct cache_identity),
+ * and compare the stored strings only when the hashes match.
  */
 
 #ifndef MCCS_CACHE_H
@@ -15,11 +19,25 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
+#include "render_ctx.h"
 #include "result.h"
 #include "types_struct.h"
 
-#define CACHE_MAGIC 0xCCCC0002
+#define CACHE_MAGIC 0xCCCC0011
+
+/**
+ * What a session cache record must match to be used by a render
+ * Built once per check site by cache_identity_init(); the strings are borrowed
+ */
+struct cache_identity {
+  uint64_t owner_hash;         ///< cache_owner_hash(session_id, project_dir)
+  uint64_t transcript_hash;    ///< cache_identity_hash(transcript_path)
+  const char *session_id;      ///< Current session identifier (NULL is checked like "")
+  const char *project_dir;     ///< Current project directory (NULL is checked like "")
+  const char *transcript_path; ///< Transcript the statistics must come from (NULL = not checked)
+};
 
 // Result types for cache operations
 DEFINE_RESULT(ResultTokenCache, struct token_cache, enum MccsError);
@@ -28,30 +46,121 @@ DEFINE_RESULT(ResultVoidCache, int, enum MccsError);
 /**
  * Get the filesystem path for a session's cache file
  *
+ * @param ctx           Render context owning the path buffers
  * @param session_id    Unique session identifier (NULL for default cache)
- * @return              Static buffer containing cache file path
+ * @return              Pointer to ctx->cache_path containing the cache file path
  *
  * @note Creates cache directory /tmp/mini-ccstatus/<uid>/ if needed
- * @note Returns pointer to static buffer - not thread safe
+ * @note The returned buffer is owned by ctx and valid until the next call
  */
-const char *get_cache_path(const char *session_id);
+const char *get_cache_path(struct mccs_render_ctx *ctx, const char *session_id);
 
 /**
- * Load cache from disk for a specific session
+ * Get the per-user directory holding all session cache files
+ *
+ * @param ctx           Render context owning the path buffers
+ * @return              Pointer to ctx->cache_dir
+ *
+ * @note Creates cache directory /tmp/mini-ccstatus/<uid>/ if needed
+ */
+const char *get_cache_dir(struct mccs_render_ctx *ctx);
+
+/**
+ * Write the per-user cache directory path into a caller buffer
+ *
+ * @param cache_dir     Output buffer (BUF_PATH_SIZE is enough)
+ * @param size          Size of cache_dir
+ * @return              cache_dir
+ *
+ * @note Creates the directory like get_cache_dir(); for callers without a
+ *       render context
+ */
+const char *format_cache_dir(char *cache_dir,
+                             size_t size);
+
+/**
+ * 64-bit hash of an identity string, as stored in a cache record
+ *
+ * @param text    NUL-terminated string (NULL hashes like "")
+ * @return        Hash value
+ */
+uint64_t cache_identity_hash(const char *text);
+
+/**
+ * Hash of the session and project a cache record belongs to
+ *
+ * @param session_id     Session identifier (NULL hashes like "")
+ * @param project_dir    Project directory (NULL hashes like "")
+ * @return               Hash value
+ *
+ * @note One hash for both leaves room for the headline totals in the first
+ *       cache line; a record is only ever used when both match
+ */
+uint64_t cache_owner_hash(const char *session_id,
+                          const char *project_dir);
+
+/**
+ * Hash the identity a render checks cache records against
+ *
+ * @param id                Output identity
+ * @param session_id        Current session identifier (may be NULL)
+ * @param project_dir       Current project directory (may be NULL)
+ * @param transcript_path   Current transcript path (may be NULL)
+ */
+void cache_identity_init(struct cache_identity *id,
+                         const char *session_id,
+                         const char *project_dir,
+                         const char *transcript_path);
+
+/**
+ * Fill the identity part of a record (hashes and cold strings)
  *
- * @param session_id    Session identifier to load cache for
+ * @param cache   Record to fill
+ * @param id      Identity of the render storing it
+ */
+void cache_set_identity(struct token_cache *cache,
+                        const struct cache_identity *id);
+
+/**
+ * Read a cache file without checking its age
+ *
+ * @param path          Cache file path
  * @return              Result<TokenCache> - Ok with cache or Err with error code
  *
+ * @note Uses shared file lock (LOCK_SH); validates the magic number only
+ * @error MCCS_ERR_FILE_NOT_FOUND if the file doesn't exist or can't be opened
+ * @error MCCS_ERR_IO_ERROR if the lock or read fails
+ * @error MCCS_ERR_INVALID_FORMAT if cache magic number is wrong
+ */
+ResultTokenCache read_cache_file(const char *path);
+
+/**
+ * Load cache from disk for a specific session
+ *
+ * @param ctx    Render context owning the path buffers
+ * @param id     Identity of the current render (its session_id names the file)
+ * @return       Result<TokenCache> - Ok with cache or Err with error code
+ *
  * @note Uses shared file lock (LOCK_SH) to prevent reading during writes
- * @note Validates magic number and cache age before returning success
+ * @note Reads the first cache line alone and checks the magic number and
+ *       owner hash there; the rest of the record is read only when they
+ *       match, and its identity strings are compared then, so the checks on
+ *       the loaded record read hashes only
+ * @note An expired record is returned too: is_cache_valid() tells whether
+ *       its statistics can be used, and its chunk cursor still locates the
+ *       transcript in the chunk store
  * @error MCCS_ERR_FILE_NOT_FOUND if cache doesn't exist or can't be opened
- * @error MCCS_ERR_INVALID_FORMAT if cache magic number is wrong
+ * @error MCCS_ERR_IO_ERROR if the lock or read fails
+ * @error MCCS_ERR_INVALID_FORMAT if the magic number is wrong or the record
+ *        belongs to another session, project or transcript path
  */
-ResultTokenCache load_cache(const char *session_id);
+ResultTokenCache load_cache(struct mccs_render_ctx *ctx,
+                            const struct cache_identity *id);
 
 /**
  * Save cache to disk for a specific session
  *
+ * @param ctx           Render context owning the path buffers
  * @param cache         Cache structure to persist
  * @param session_id    Session identifier for cache file
  * @return              ResultVoid - Ok(0) on success or Err with error code
@@ -60,36 +169,81 @@ ResultTokenCache load_cache(const char *session_id);
  * @error MCCS_ERR_FILE_NOT_FOUND if cache file cannot be created
  * @error MCCS_ERR_IO_ERROR if write fails
  */
-ResultVoidCache save_cache(const struct token_cache *cache, const char *session_id);
+ResultVoidCache save_cache(struct mccs_render_ctx *ctx,
+                           const struct token_cache *cache,
+                           const char *session_id);
+
+/**
+ * Update the debounce stamp of a session cache in place
+ *
+ * @param ctx           Render context owning the path buffers
+ * @param session_id    Session identifier of the cache file
+ * @param full_render   Digest and time of a full render to record, or NULL
+ *                      to count one more debounced render
+ * @param stored        Output: stamp as written (may be NULL)
+ * @return              ResultVoidCache - Ok(0) on success or Err with error code
+ *
+ * @note Read-modify-write of the stamp under an exclusive lock; the rest of
+ *       the cache file is left untouched.
+ * @error MCCS_ERR_FILE_NOT_FOUND if the cache file does not exist
+ * @error MCCS_ERR_IO_ERROR if the stamp cannot be read or written
+ */
+ResultVoidCache update_cache_render(struct mccs_render_ctx *ctx,
+                                    const char *session_id,
+                                    const struct cache_render_stamp *full_render,
+                                    struct cache_render_stamp *stored);
 
 /**
  * Check if cache is valid for the current session
  *
  * @param cache         Cache to validate
- * @param session_id    Current session identifier
- * @param project_dir   Current project directory
+ * @param id            Identity of the current render
  * @return              true if cache matches session and is not expired
  *
- * @note Checks magic number, session_id, project_dir, and age
+ * @note Checks magic number, owner hash and age, all in the first cache
+ *       line; the stored strings were compared when load_cache() read it
+ * @note A partial cache (parse cut short by --budget-ms) does not expire,
+ *       so later renders can finish the parse from its offset
  */
 bool is_cache_valid(const struct token_cache *cache,
-                    const char *session_id,
-                    const char *project_dir);
+                    const struct cache_identity *id);
+
+/**
+ * Check that a cache record was parsed from the current transcript
+ *
+ * @param cache            Cache record (its age is not checked)
+ * @param id               Identity of the current render
+ * @return                 true if the transcript hashes match
+ *
+ * @note Compares the hashes only, like is_cache_valid()
+ */
+bool cache_same_transcript(const struct token_cache *cache,
+                           const struct cache_identity *id);
 
 /**
  * Determine if cache needs to be refreshed
  *
  * @param cache            Current cache state
- * @param session_id       Current session identifier
- * @param project_dir      Current project directory
- * @param transcript_path  Path to transcript file (for size check)
+ * @param id               Identity of the current render
  * @return                 true if cache should be regenerated
  *
- * @note Returns true if session changed, cache invalid, or transcript file size changed
+ * @note Returns true if session changed, cache invalid, the statistics come
+ *       from another transcript, or the transcript file size changed
  */
 bool should_refresh_cache(const struct token_cache *cache,
-                          const char *session_id,
-                          const char *project_dir,
-                          const char *transcript_path);
+                          const struct cache_identity *id);
+
+/**
+ * Check whether a transcript parse can resume from the cached statistics
+ *
+ * @param cache            Cache loaded for the session
+ * @param id               Identity of the current render
+ * @return                 true if only bytes after cache->transcript_file_size need parsing
+ *
+ * @note Requires a valid cache of the same transcript, at least as large as
+ *       the parsed offset
+ */
+bool can_resume_cache(const struct token_cache *cache,
+                      const struct cache_identity *id);
 
 #endif /* MCCS_CACHE_H */
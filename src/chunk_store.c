@@ -0,0 +1,560 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "chunk_store.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "debug.h"
+
+#define CHUNK_STORE_MAGIC 0xCCCF0002
+#define CHUNK_HASH_PRIME 0x9E3779B97F4A7C15ULL
+#define CHUNK_HASH_LANES 4
+#define CHUNK_MASK_WORDS(n) (((n) + 63) / 64)
+
+/**
+ * Store file header
+ */
+struct chunk_store_header {
+  uint32_t magic;       ///< CHUNK_STORE_MAGIC
+  uint32_t slots;       ///< CHUNK_STORE_SLOTS
+  uint64_t record_size; ///< CHUNK_STORE_STRIDE, changes with the scan state
+};
+
+/**
+ * Head of one record, followed by the packed scan state at the chunk end
+ */
+struct chunk_store_entry {
+  uint64_t key;     ///< Chained chunk key (0 = empty slot)
+  int64_t used_at;  ///< Last write or hit (epoch s), the least recent is replaced first
+  uint64_t offset;  ///< Transcript offset the chunk ends at (guards against collisions)
+  uint64_t length;  ///< Bytes of packed state after the head
+};
+
+/**
+ * Scan state at a chunk end without its two tables, which follow it packed:
+ * the occupied file set slots (or the sketch registers), then the occupied
+ * fork points, each in slot order
+ */
+struct chunk_store_state {
+  struct token_counts session_tokens;
+  struct token_counts segment_tokens;
+  uint64_t context_tokens;
+  struct top_turns top_turns;
+  struct prompt_cache_state prompt_cache;
+  struct current_turn turn;
+  struct activity_map activity;
+  struct api_error_state api_errors;
+  struct chunk_cursor chunks;
+  struct branch_point branch_tip;
+  uint64_t branch_total_tokens;
+  uint64_t file_mask[CHUNK_MASK_WORDS(FILE_SET_SLOTS)];    ///< Occupied file slots (exact mode)
+  uint64_t fork_mask[CHUNK_MASK_WORDS(BRANCH_FORK_SLOTS)]; ///< Occupied fork points
+  uint32_t compactions;
+  uint32_t branch_forks;
+  uint32_t files_used;
+  uint32_t files_counts[FILE_TOUCH_KINDS];
+  bool files_sketched;
+};
+
+#define CHUNK_STORE_STATE_MAX \
+  (sizeof(struct chunk_store_state) + sizeof(struct file_set) + BRANCH_FORK_SLOTS * sizeof(struct branch_point))
+#define CHUNK_STORE_STRIDE (sizeof(struct chunk_store_entry) + CHUNK_STORE_STATE_MAX)
+
+/**
+ * splitmix64 finalizer
+ */
+static uint64_t chunk_mix(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xBF58476D1CE4E5B9ULL;
+  x ^= x >> 27;
+  x *= 0x94D049BB133111EBULL;
+  x ^= x >> 31;
+  return x;
+}
+
+/**
+ * 64-bit hash of a line, four independent 8-byte lanes at a time
+ *
+ * @note Multiply-accumulate of the two 32-bit halves of each word mixed with
+ *       a lane and position key (as in XXH3): 32x32 multiplies vectorize
+ *       well, and the key makes swapped blocks hash differently
+ */
+static uint64_t chunk_hash_line(const unsigned char *p,
+                                size_t len) {
+  uint64_t lanes[CHUNK_HASH_LANES] = {0};
+  size_t i = 0;
+  for (; len - i >= sizeof(lanes); i += sizeof(lanes)) {
+    for (size_t k = 0; k < CHUNK_HASH_LANES; k++) {
+      uint64_t word;
+      memcpy(&word, p + i + k * sizeof(word), sizeof(word));
+      uint64_t keyed = word ^ (CHUNK_HASH_PRIME * (k + 1) + i);
+      lanes[k] += word + (keyed & 0xFFFFFFFFULL) * (keyed >> 32);
+    }
+  }
+  uint64_t tail[CHUNK_HASH_LANES] = {0};
+  memcpy(tail, p + i, len - i);
+  uint64_t hash = chunk_mix(len);
+  for (size_t k = 0; k < CHUNK_HASH_LANES; k++) {
+    hash = chunk_mix(hash ^ lanes[k] ^ chunk_mix(tail[k] + k));
+  }
+  return hash;
+}
+
+/**
+ * Gear rolling hash of the last CHUNK_GEAR_WINDOW bytes of a line
+ *
+ * @note Each byte is shifted one bit further per byte after it, so only the
+ *       window reaches the top bits tested for a cut
+ */
+static uint64_t chunk_gear(const unsigned char *p,
+                           size_t len) {
+  uint64_t gear = 0;
+  for (size_t i = len > CHUNK_GEAR_WINDOW ? len - CHUNK_GEAR_WINDOW : 0; i < len; i++) {
+    gear = (gear << 1) + ((uint64_t)p[i] + 1) * CHUNK_HASH_PRIME;
+  }
+  return gear;
+}
+
+void chunk_cursor_init(struct chunk_cursor *cursor) {
+  cursor->chain = 0;
+  cursor->digest = 0;
+  cursor->start = 0;
+  cursor->bytes = 0;
+}
+
+bool chunk_cursor_feed(struct chunk_cursor *cursor,
+                       const char *line,
+                       size_t len) {
+  const unsigned char *p = (const unsigned char *)line;
+  cursor->digest = chunk_mix(cursor->digest ^ chunk_hash_line(p, len));
+  cursor->bytes += len;
+  // Chunks grow with their offset: a long transcript takes a few hundred records, not thousands
+  uint64_t min = cursor->start / CHUNK_GROWTH > CHUNK_MIN_BYTES ? cursor->start / CHUNK_GROWTH : CHUNK_MIN_BYTES;
+  if (cursor->bytes < min ||
+      (cursor->bytes < min * CHUNK_MAX_FACTOR && chunk_gear(p, len) >> (64 - CHUNK_CUT_BITS) != 0)) {
+    return false;
+  }
+  uint64_t chain = chunk_mix(cursor->chain ^ chunk_mix(cursor->digest ^ cursor->bytes));
+  cursor->chain = chain != 0 ? chain : 1;
+  cursor->digest = 0;
+  cursor->start += cursor->bytes;
+  cursor->bytes = 0;
+  return true;
+}
+
+/**
+ * File offset of a slot
+ */
+static off_t chunk_store_slot_offset(size_t slot) {
+  return (off_t)(sizeof(struct chunk_store_header) + slot * CHUNK_STORE_STRIDE);
+}
+
+/**
+ * Check the header of an open store
+ */
+static bool chunk_store_header_ok(int fd) {
+  struct chunk_store_header header;
+  return pread(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+         header.magic == CHUNK_STORE_MAGIC && header.slots == CHUNK_STORE_SLOTS &&
+         header.record_size == CHUNK_STORE_STRIDE;
+}
+
+/**
+ * Append one occupied table entry to a packed state
+ */
+static size_t chunk_store_pack_item(unsigned char *out,
+                                    size_t len,
+                                    uint64_t *mask,
+                                    size_t index,
+                                    const void *item,
+                                    size_t size) {
+  mask[index / 64] |= 1ULL << (index % 64);
+  memcpy(out + len, item, size);
+  return len + size;
+}
+
+/**
+ * Pack the scan state of a snapshot
+ *
+ * @param stats    Snapshot (deadline, partial flag and store path are not kept)
+ * @param out      Buffer of CHUNK_STORE_STATE_MAX bytes
+ * @return         Bytes written
+ */
+static size_t chunk_store_pack(const struct transcript_stats *stats,
+                               unsigned char *out) {
+  struct chunk_store_state state;
+  memset(&state, 0, sizeof(state));
+  state.session_tokens = stats->session_tokens;
+  state.segment_tokens = stats->segment_tokens;
+  state.context_tokens = stats->context_tokens;
+  state.top_turns = stats->top_turns;
+  state.prompt_cache = stats->prompt_cache;
+  state.turn = stats->turn;
+  state.activity = stats->activity;
+  state.api_errors = stats->api_errors;
+  state.chunks = stats->chunks;
+  state.branch_tip = stats->branch.tip;
+  state.branch_total_tokens = stats->branch.total_tokens;
+  state.compactions = stats->compactions;
+  state.branch_forks = stats->branch.forks;
+  state.files_used = stats->files.used;
+  memcpy(state.files_counts, stats->files.counts, sizeof(state.files_counts));
+  state.files_sketched = stats->files.sketched;
+
+  size_t len = sizeof(state);
+  if (stats->files.sketched) {
+    memcpy(out + len, stats->files.registers, sizeof(stats->files.registers));
+    len += sizeof(stats->files.registers);
+  } else {
+    for (size_t i = 0; i < FILE_SET_SLOTS; i++) {
+      if (stats->files.slots[i] != 0) {
+        len = chunk_store_pack_item(out, len, state.file_mask, i, &stats->files.slots[i],
+                                    sizeof(stats->files.slots[i]));
+      }
+    }
+  }
+  for (size_t i = 0; i < BRANCH_FORK_SLOTS; i++) {
+    if (stats->branch.fork_points[i].key != 0) {
+      len = chunk_store_pack_item(out, len, state.fork_mask, i, &stats->branch.fork_points[i],
+                                  sizeof(stats->branch.fork_points[i]));
+    }
+  }
+  memcpy(out, &state, sizeof(state));
+  return len;
+}
+
+/**
+ * Bytes of the table entries a mask marks as occupied
+ */
+static size_t chunk_store_mask_bytes(const uint64_t *mask,
+                                     size_t words,
+                                     size_t size) {
+  size_t count = 0;
+  for (size_t w = 0; w < words; w++) {
+    count += (size_t)__builtin_popcountll(mask[w]);
+  }
+  return count * size;
+}
+
+/**
+ * Unpack a state written by chunk_store_pack()
+ *
+ * @param in       Packed state
+ * @param len      Its length
+ * @param stats    Output: the scan state (offset, deadline, partial flag and store path cleared)
+ * @return         false if the length does not match the tables it announces
+ */
+static bool chunk_store_unpack(const unsigned char *in,
+                               size_t len,
+                               struct transcript_stats *stats) {
+  struct chunk_store_state state;
+  if (len < sizeof(state)) {
+    return false;
+  }
+  memcpy(&state, in, sizeof(state));
+  size_t files_len = state.files_sketched
+                         ? sizeof(stats->files.registers)
+                         : chunk_store_mask_bytes(state.file_mask, CHUNK_MASK_WORDS(FILE_SET_SLOTS),
+                                                  sizeof(stats->files.slots[0]));
+  size_t forks_len = chunk_store_mask_bytes(state.fork_mask, CHUNK_MASK_WORDS(BRANCH_FORK_SLOTS),
+                                            sizeof(stats->branch.fork_points[0]));
+  if (len != sizeof(state) + files_len + forks_len) {
+    return false;
+  }
+
+  memset(stats, 0, sizeof(*stats));
+  stats->session_tokens = state.session_tokens;
+  stats->segment_tokens = state.segment_tokens;
+  stats->context_tokens = state.context_tokens;
+  stats->top_turns = state.top_turns;
+  stats->prompt_cache = state.prompt_cache;
+  stats->turn = state.turn;
+  stats->activity = state.activity;
+  stats->api_errors = state.api_errors;
+  stats->chunks = state.chunks;
+  stats->branch.tip = state.branch_tip;
+  stats->branch.total_tokens = state.branch_total_tokens;
+  stats->compactions = state.compactions;
+  stats->branch.forks = state.branch_forks;
+  stats->files.used = state.files_used;
+  memcpy(stats->files.counts, state.files_counts, sizeof(stats->files.counts));
+  stats->files.sketched = state.files_sketched;
+
+  const unsigned char *p = in + sizeof(state);
+  if (state.files_sketched) {
+    memcpy(stats->files.registers, p, sizeof(stats->files.registers));
+  } else {
+    for (size_t i = 0; i < FILE_SET_SLOTS; i++) {
+      if (state.file_mask[i / 64] >> (i % 64) & 1) {
+        memcpy(&stats->files.slots[i], p, sizeof(stats->files.slots[i]));
+        p += sizeof(stats->files.slots[i]);
+      }
+    }
+  }
+  p = in + sizeof(state) + files_len;
+  for (size_t i = 0; i < BRANCH_FORK_SLOTS; i++) {
+    if (state.fork_mask[i / 64] >> (i % 64) & 1) {
+      memcpy(&stats->branch.fork_points[i], p, sizeof(stats->branch.fork_points[i]));
+      p += sizeof(stats->branch.fork_points[i]);
+    }
+  }
+  return true;
+}
+
+int chunk_store_open(const char *path) {
+  int fd = open(path, O_RDWR | O_CREAT, 0600);
+  if (fd < 0) {
+    DEBUG_LOG("Chunk store: cannot open %s", path);
+    return -1;
+  }
+  if (flock(fd, LOCK_EX) != 0) {
+    close(fd);
+    return -1;
+  }
+  bool ok = chunk_store_header_ok(fd);
+  if (!ok) {
+    // New file or another layout: start over
+    struct chunk_store_header header = {
+        .magic = CHUNK_STORE_MAGIC,
+        .slots = CHUNK_STORE_SLOTS,
+        .record_size = CHUNK_STORE_STRIDE,
+    };
+    ok = ftruncate(fd, 0) == 0 && pwrite(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header);
+  }
+  flock(fd, LOCK_UN);
+  if (!ok) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+void chunk_store_put(int fd,
+                     const struct transcript_stats *snapshot) {
+  uint64_t key = snapshot->chunks.chain;
+  size_t first = (size_t)(key % CHUNK_STORE_SLOTS);
+  if (flock(fd, LOCK_EX) != 0) {
+    return;
+  }
+
+  // Same key, else an empty slot, else the least recently used one
+  size_t slot = first;
+  int64_t oldest = INT64_MAX;
+  for (size_t i = 0; i < CHUNK_STORE_PROBE; i++) {
+    size_t probe = (first + i) % CHUNK_STORE_SLOTS;
+    uint64_t head[2] = {0, 0}; // key, used_at; past the end of the file reads as empty
+    if (pread(fd, head, sizeof(head), chunk_store_slot_offset(probe)) < 0) {
+      flock(fd, LOCK_UN);
+      return;
+    }
+    if (head[0] == key || head[0] == 0) {
+      slot = probe;
+      break;
+    }
+    if ((int64_t)head[1] < oldest) {
+      oldest = (int64_t)head[1];
+      slot = probe;
+    }
+  }
+
+  // Only the packed length is written: a record of a short session takes a fraction of its slot
+  unsigned char record[CHUNK_STORE_STRIDE];
+  size_t len = chunk_store_pack(snapshot, record + sizeof(struct chunk_store_entry));
+  struct chunk_store_entry entry = {
+      .key = key,
+      .used_at = (int64_t)time(NULL),
+      .offset = snapshot->parsed_offset,
+      .length = len,
+  };
+  memcpy(record, &entry, sizeof(entry));
+  len += sizeof(entry);
+  if (pwrite(fd, record, len, chunk_store_slot_offset(slot)) != (ssize_t)len) {
+    DEBUG_LOG("Chunk store: write failed");
+  }
+  flock(fd, LOCK_UN);
+}
+
+/**
+ * Find the record of a key
+ *
+ * @param fd           Store opened for reading and writing (locked)
+ * @param key          Chained chunk key
+ * @param offset       Transcript offset the chunk ends at (guards against collisions)
+ * @param now          Current time (epoch s)
+ * @param exclusive    In/out: the lock held is exclusive
+ * @param at           Output: file offset of the record
+ * @return             true if found
+ *
+ * @note Only record heads are read. Refreshes used_at of records older than
+ *       CHUNK_STORE_TOUCH_S, so a prefix still being reused is not the first
+ *       to be replaced; the shared lock is converted to an exclusive one for
+ *       that write, which happens only now and then
+ */
+static bool chunk_store_find(int fd,
+                             uint64_t key,
+                             size_t offset,
+                             int64_t now,
+                             bool *exclusive,
+                             off_t *at) {
+  size_t first = (size_t)(key % CHUNK_STORE_SLOTS);
+  for (size_t i = 0; i < CHUNK_STORE_PROBE; i++) {
+    struct chunk_store_entry entry;
+    *at = chunk_store_slot_offset((first + i) % CHUNK_STORE_SLOTS);
+    if (pread(fd, &entry, sizeof(entry), *at) != (ssize_t)sizeof(entry) || entry.key != key) {
+      continue;
+    }
+    if (entry.offset != offset) {
+      return false;
+    }
+    if (now - entry.used_at > CHUNK_STORE_TOUCH_S) {
+      // The conversion is not atomic: a writer may replace the record meanwhile
+      if (!*exclusive && flock(fd, LOCK_EX) == 0) {
+        *exclusive = true;
+        if (pread(fd, &entry, sizeof(entry), *at) != (ssize_t)sizeof(entry) || entry.key != key ||
+            entry.offset != offset) {
+          return false;
+        }
+      }
+      if (*exclusive) {
+        (void)pwrite(fd, &now, sizeof(now), *at + (off_t)offsetof(struct chunk_store_entry, used_at));
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Read and unpack the record at a file offset
+ */
+static bool chunk_store_load(int fd,
+                             off_t at,
+                             struct transcript_stats *stats) {
+  unsigned char record[CHUNK_STORE_STRIDE];
+  ssize_t got = pread(fd, record, sizeof(record), at);
+  struct chunk_store_entry entry;
+  if (got < (ssize_t)sizeof(entry)) {
+    return false;
+  }
+  memcpy(&entry, record, sizeof(entry));
+  if (entry.length > (uint64_t)got - sizeof(entry) ||
+      !chunk_store_unpack(record + sizeof(entry), (size_t)entry.length, stats)) {
+    return false;
+  }
+  stats->parsed_offset = (size_t)entry.offset;
+  return stats->chunks.chain == entry.key;
+}
+
+/**
+ * Monotonic clock in milliseconds (same clock as stats->deadline_ms)
+ */
+static int64_t chunk_store_now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / MS_TO_NANOSEC;
+}
+
+bool chunk_store_resume(const char *path,
+                        const char *transcript_path,
+                        const struct chunk_cursor *from,
+                        struct transcript_stats *stats) {
+  int fd = open(path, O_RDWR);
+  if (fd < 0) {
+    return false;
+  }
+  int tfd = open(transcript_path, O_RDONLY);
+  struct stat st;
+  if (tfd < 0 || fstat(tfd, &st) != 0 || st.st_size < CHUNK_MIN_BYTES || flock(fd, LOCK_SH) != 0) {
+    if (tfd >= 0) {
+      close(tfd);
+    }
+    close(fd);
+    return false;
+  }
+  size_t size = (size_t)st.st_size;
+  void *map = chunk_store_header_ok(fd) ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, tfd, 0) : MAP_FAILED;
+  close(tfd);
+  if (map == MAP_FAILED) {
+    flock(fd, LOCK_UN);
+    close(fd);
+    return false;
+  }
+  const char *text = map;
+
+  struct chunk_cursor cursor;
+  chunk_cursor_init(&cursor);
+  bool exclusive = false;
+  off_t best_at = -1;
+  int64_t now = (int64_t)time(NULL);
+  size_t offset = 0;
+
+  // A cursor from an earlier scan of this transcript skips hashing the
+  // prefix: the walk starts at its last chunk end if the store knows it,
+  // and the bytes after it must hash to the cursor's digest again
+  size_t verify_end = 0;
+  if (from && from->chain != 0 && from->start + from->bytes <= size &&
+      chunk_store_find(fd, from->chain, from->start, now, &exclusive, &best_at)) {
+    cursor.chain = from->chain;
+    cursor.start = from->start;
+    offset = from->start;
+    verify_end = from->bytes > 0 ? from->start + from->bytes : 0;
+  }
+
+  // Walk the lines in place; only complete lines are ever cut after
+  size_t misses = 0;
+  const char *newline;
+  while (misses < CHUNK_STORE_MISS_LIMIT && (newline = memchr(text + offset, '\n', size - offset)) != NULL) {
+    size_t len = (size_t)(newline - (text + offset)) + 1;
+    bool cut = chunk_cursor_feed(&cursor, text + offset, len);
+    offset += len;
+    if (verify_end != 0 && offset >= verify_end) {
+      if (offset != verify_end || cut || cursor.digest != from->digest) {
+        DEBUG_LOG("Chunk store: %s was rewritten, hashing it from the start", transcript_path);
+        chunk_cursor_init(&cursor);
+        offset = 0;
+        best_at = -1;
+        verify_end = 0;
+        continue;
+      }
+      verify_end = 0;
+    }
+    if (!cut) {
+      continue;
+    }
+    // The lookup counts against --budget-ms like the parse it saves
+    if (stats->deadline_ms > 0 && chunk_store_now_ms() >= stats->deadline_ms) {
+      break;
+    }
+    off_t at;
+    if (chunk_store_find(fd, cursor.chain, offset, now, &exclusive, &at)) {
+      best_at = at;
+      misses = 0;
+    } else {
+      misses++;
+    }
+  }
+  munmap(map, size);
+
+  // A walk stopped by the deadline before the cursor check resumes nowhere
+  struct transcript_stats best;
+  bool found = verify_end == 0 && best_at >= 0 && chunk_store_load(fd, best_at, &best);
+  flock(fd, LOCK_UN);
+  close(fd);
+
+  if (found) {
+    DEBUG_LOG("Chunk store: resuming %s after a known prefix of %zu bytes", transcript_path, best.parsed_offset);
+    best.deadline_ms = stats->deadline_ms;
+    best.chunk_store = stats->chunk_store;
+    *stats = best;
+  }
+  return found;
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file chunk_store.h
+ * @brief Content-defined transcript chunks shared across sessions
+ *
+ * A resumed or forked session starts a new transcript with a copy of the
+ * old one, so its session cache is empty while most of its bytes were
+ * already parsed. Transcript scans therefore cut the file into chunks at
+ * content-defined points: after a line whose last bytes give a gear rolling
+ * hash with its top CHUNK_CUT_BITS bits clear, once the chunk holds at least
+ * CHUNK_MIN_BYTES (or unconditionally at CHUNK_MAX_BYTES). The same bytes
+ * are cut the same way in any file, wherever they start.
+ *
+ * Each chunk is keyed by a hash chained over all chunks up to it, and the
+ * scan state at its end (token totals, context, compactions, top turns) is
+ * kept under that key in /tmp/mini-ccstatus/<uid>/chunks.store. Scan state
+ * carries across chunk boundaries (the context and the compaction segment
+ * depend on everything before), so the chained key names the whole prefix
+ * and the stored state is exact for any file starting with it. A new
+ * transcript is hashed from the start, and the parse resumes after the
+ * longest prefix found in the store.
+ *
+ * The store is a fixed table of CHUNK_STORE_SLOTS records: a key probes
+ * CHUNK_STORE_PROBE consecutive slots, and a new record replaces the least
+ * recently used one among them (hits refresh a record at most hourly). A
+ * record keeps the resumable scan state packed, with only the occupied
+ * entries of the file set and fork point tables, so it takes about 0.7 KB
+ * early in a session and at most 4.3 KB; a lookup reads record heads only,
+ * and the whole record of the longest prefix once.
+ */
+
+#ifndef MCCS_CHUNK_STORE_H
+#define MCCS_CHUNK_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types_struct.h"
+
+#define CHUNK_STORE_FILE "chunks.store" /* Table file inside the cache directory */
+#define CHUNK_STORE_SLOTS 2048          /* Records kept (at most about 9 MB) */
+#define CHUNK_STORE_PROBE 4             /* Slots a key may occupy */
+#define CHUNK_STORE_MISS_LIMIT 2        /* Unknown chunks in a row before a lookup gives up */
+#define CHUNK_STORE_TOUCH_S 3600        /* A hit refreshes a record last used longer ago than this */
+#define CHUNK_MIN_BYTES 16384           /* No cut before this many bytes */
+#define CHUNK_GROWTH 32                 /* ...or before 1/CHUNK_GROWTH of the chunk offset */
+#define CHUNK_MAX_FACTOR 8              /* Forced cut at this many times the minimum */
+#define CHUNK_CUT_BITS 3                /* A line ends a chunk with probability 1/2^bits */
+#define CHUNK_GEAR_WINDOW 64            /* Line bytes the cut hash looks at */
+
+/**
+ * Reset a cursor to the start of a file
+ *
+ * @param cursor    Cursor to reset
+ */
+void chunk_cursor_init(struct chunk_cursor *cursor);
+
+/**
+ * Fold one consumed line into the chunking
+ *
+ * @param cursor    Cursor positioned at the start of the line
+ * @param line      Line bytes (including its newline)
+ * @param len       Line length
+ * @return          true if a chunk ends after the line; cursor->chain is then its key
+ */
+bool chunk_cursor_feed(struct chunk_cursor *cursor,
+                       const char *line,
+                       size_t len);
+
+/**
+ * Open the store for recording, creating it if needed
+ *
+ * @param path    Store file
+ * @return        File descriptor, or -1 (recording is skipped)
+ */
+int chunk_store_open(const char *path);
+
+/**
+ * Record the scan state at the end of a chunk
+ *
+ * @param fd          Descriptor from chunk_store_open()
+ * @param snapshot    State with parsed_offset at the chunk end and chunks.chain as the key
+ *
+ * @note Best effort under an exclusive lock; a failed write only costs a later reparse
+ */
+void chunk_store_put(int fd,
+                     const struct transcript_stats *snapshot);
+
+/**
+ * Resume a scan after the longest stored prefix of a transcript
+ *
+ * @param path               Store file
+ * @param transcript_path    Transcript to look up
+ * @param from               Cursor of an earlier scan of this transcript (NULL = none)
+ * @param stats              In: fresh stats; Out: stored state of the prefix (untouched on a miss)
+ * @return                   true if stats now resumes after a stored prefix
+ *
+ * @note Maps the transcript and hashes it from the last chunk end of from if
+ *       the store has it (else from the start); the bytes from there to the
+ *       cursor offset must hash to its digest again, or the transcript was
+ *       rewritten and is hashed from the start. Stops after
+ *       CHUNK_STORE_MISS_LIMIT unknown chunks in a row or at
+ *       stats->deadline_ms; deadline_ms and chunk_store of stats are kept
+ */
+bool chunk_store_resume(const char *path,
+                        const char *transcript_path,
+                        const struct chunk_cursor *from,
+                        struct transcript_stats *stats);
+
+#endif /* MCCS_CHUNK_STORE_H */
@@ -8,11 +8,25 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "config.h"
+#include "constants.h"
 #include "result.h"
 
 void mccs_print_usage(const char *prog_name) {
-  printf("Usage: %s [OPTIONS]\n\n", prog_name);
+  printf("Usage: %s [OPTIONS]\n", prog_name);
+  printf("       %s top [--once]\n", prog_name);
+  printf("       %s query [--by <dims>] [--since <date>] [--until <date>] [--model <id>]\n", prog_name);
+  printf("                      [--sort <column>] [--reverse] [--limit <n>]\n\n");
   printf("Claude Code status line generator - reads JSON from stdin and outputs formatted status.\n\n");
+  printf("Commands:\n");
+  printf("  top                             Live view of every active session (q to quit)\n");
+  printf("      --once                      Print a single frame and exit\n");
+  printf("  query                           Aggregate the turn history recorded with --history\n");
+  printf("      --by <dims>                 Group by up to two of session,model,day,week (e.g. day,model)\n");
+  printf("      --since, --until <date>     Only turns between these days (YYYY-MM-DD, inclusive)\n");
+  printf("      --model <substr>            Only models whose ID contains substr\n");
+  printf("      --sort <column>             turns|input|output|cache-write|cache-read|total|cache-eff\n");
+  printf("      --reverse, --limit <n>      Ascending order, print at most n groups\n\n");
   printf("Options:\n");
   printf("  -h, --help                      Show this help message and exit\n");
   printf("  -d, --token-breakdown           Show detailed token breakdown\n");
@@ -26,15 +40,35 @@ void mccs_print_usage(const char *prog_name) {
   printf("  -C, --clamping                  Clamp percentages to 100%%%% max\n");
   printf("  -a, --all                       Enable all token features\n");
   printf("      --no-color                  Disable ANSI color output\n");
+  printf("      --gradient <256|truecolor>  Color progress bars with a gradient\n");
   printf("  -v, --verbose                   Show field labels in status line\n");
   printf("  -H, --hide-breakdown            Hide token breakdown line\n");
-  printf("  -s, --simple                    Show simplified status line (Model/Version/Directory only)\n\n");
+  printf("  -s, --simple                    Show simplified status line (Model/Version/Directory only)\n");
+  printf("  -k, --top-turns                 Show the most expensive turns of the session\n");
+  printf("      --top-turns-json            Print the most expensive turns as JSON only\n");
+  printf("  -u, --turn-cost                 Show tokens and cost of the request in progress\n");
+  printf("  -b, --activity                  Show the session activity timeline with active and idle time\n");
+  printf("  -r, --api-errors                Show failed and retried API requests after a recent error\n");
+  printf("  -f, --files                     Show how many distinct files the session read and edited\n");
+  printf("  -x, --abandoned                 Show tokens spent on branches left by rewinds and edited prompts\n");
+  printf("  -m, --context-mix               Show what fills the context window, by entry type\n");
+  printf("      --batch <dir|file|->        Render many status documents (directory of .json or NDJSON)\n");
+  printf("  -j, --jobs <n>                  Worker threads for --batch (default: online CPUs)\n");
+  printf("      --record <trace>            Append each stdin payload and transcript growth to a replay trace\n");
+  printf("      --debounce-ms <n>           Reuse the last result for identical input within n ms (default: 0, off)\n");
+  printf("      --budget-ms <n>             Stop parsing the transcript after n ms, finish on later renders\n");
+  printf("      --approximate               Estimate session totals from a sample while the parse catches up\n");
+  printf("      --history                   Append every parsed turn to the history store (see query)\n");
+  printf("      --no-config                 Ignore $XDG_CONFIG_HOME/mini-ccstatus/config\n\n");
   printf("Environment Variables:\n");
-  printf("  NO_COLOR                 If set, disables ANSI color output\n\n");
+  printf("  NO_COLOR                 If set, disables ANSI color output\n");
+  printf("  XDG_CONFIG_HOME          Directory holding mini-ccstatus/config (default: ~/.config)\n\n");
   printf("Examples:\n");
   printf("  echo '{...}' | %s\n", prog_name);
   printf("  %s --all < status.json\n", prog_name);
   printf("  %s --verbose --context-tokens < status.json\n", prog_name);
+  printf("  %s --all --batch sessions.ndjson --jobs 4\n", prog_name);
+  printf("  %s query --by day,model --since 2025-01-01\n", prog_name);
 }
 
 void mccs_init_cli_options(struct cli_options *opts) {
@@ -55,6 +89,46 @@ void mccs_init_cli_options(struct cli_options *opts) {
   opts->verbose = false;
   opts->hide_token_breakdown = false;
   opts->simple_status_line = false;
+  opts->show_top_turns = false;
+  opts->show_turn_cost = false;
+  opts->show_activity = false;
+  opts->show_api_errors = false;
+  opts->show_files = false;
+  opts->show_abandoned = false;
+  opts->show_context_mix = false;
+  opts->top_turns_json = false;
+  opts->batch_source = NULL;
+  opts->batch_jobs = 0;
+  opts->record_trace = NULL;
+  opts->gradient = MCCS_GRADIENT_OFF;
+  memset(opts->theme_colors, 0, sizeof(opts->theme_colors));
+  opts->debounce_ms = 0;
+  opts->budget_ms = 0;
+  opts->approximate = false;
+  opts->top = false;
+  opts->top_once = false;
+  opts->record_history = false;
+  opts->query = false;
+  memset(&opts->query_opts, 0, sizeof(opts->query_opts));
+}
+
+void mccs_enable_all_features(struct cli_options *opts) {
+  opts->show_all = true;
+  opts->show_token_breakdown = true;
+  opts->show_context_tokens = true;
+  opts->show_session_tokens = true;
+  opts->show_cache_efficiency = true;
+  opts->show_api_time_ratio = true;
+  opts->show_lines_ratio = true;
+  opts->show_input_output_ratio = true;
+  opts->show_cache_write_read_ratio = true;
+  opts->show_top_turns = true;
+  opts->show_turn_cost = true;
+  opts->show_activity = true;
+  opts->show_api_errors = true;
+  opts->show_files = true;
+  opts->show_abandoned = true;
+  opts->show_context_mix = true;
 }
 
 ResultVoid mccs_parse_cli_args(int argc,
@@ -66,8 +140,22 @@ ResultVoid mccs_parse_cli_args(int argc,
 
   mccs_init_cli_options(opts);
 
+  // The config file comes first: command-line options add to it
+  bool use_config = true;
   for (int i = 1; i < argc; i++) {
-    if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+    use_config = use_config && strcmp(argv[i], "--no-config") != 0;
+  }
+  struct mccs_config config;
+  if (use_config && config_load(&config)) {
+    config_apply(&config, opts);
+  }
+
+  for (int i = 1; i < argc; i++) {
+    if (i == 1 && strcmp(argv[i], "top") == 0) {
+      opts->top = true;
+    } else if (i == 1 && strcmp(argv[i], "query") == 0) {
+      opts->query = true;
+    } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
       mccs_print_usage(argv[0]);
       exit(0);
     } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--token-breakdown") == 0) {
@@ -89,23 +177,120 @@ ResultVoid mccs_parse_cli_args(int argc,
     } else if (strcmp(argv[i], "-C") == 0 || strcmp(argv[i], "--clamping") == 0) {
       opts->clamp_percentages = true;
     } else if (strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "--all") == 0) {
-      opts->show_all = true;
-      opts->show_token_breakdown = true;
-      opts->show_context_tokens = true;
-      opts->show_session_tokens = true;
-      opts->show_cache_efficiency = true;
-      opts->show_api_time_ratio = true;
-      opts->show_lines_ratio = true;
-      opts->show_input_output_ratio = true;
-      opts->show_cache_write_read_ratio = true;
+      mccs_enable_all_features(opts);
     } else if (strcmp(argv[i], "--no-color") == 0) {
       opts->no_color = true;
+    } else if (strcmp(argv[i], "--gradient") == 0) {
+      const char *mode = (i + 1 < argc) ? argv[++i] : "";
+      if (strcmp(mode, "256") == 0) {
+        opts->gradient = MCCS_GRADIENT_256;
+      } else if (strcmp(mode, "truecolor") == 0 || strcmp(mode, "24bit") == 0) {
+        opts->gradient = MCCS_GRADIENT_TRUECOLOR;
+      } else {
+        fprintf(MCCS_STDERR, "error: --gradient requires 256 or truecolor\n");
+        return ERR(ResultVoid, MCCS_ERR_INVALID_FORMAT);
+      }
     } else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0) {
       opts->verbose = true;
     } else if (strcmp(argv[i], "-H") == 0 || strcmp(argv[i], "--hide-breakdown") == 0) {
       opts->hide_token_breakdown = true;
     } else if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--simple") == 0) {
       opts->simple_status_line = true;
+    } else if (strcmp(argv[i], "-k") == 0 || strcmp(argv[i], "--top-turns") == 0) {
+      opts->show_top_turns = true;
+    } else if (strcmp(argv[i], "-u") == 0 || strcmp(argv[i], "--turn-cost") == 0) {
+      opts->show_turn_cost = true;
+    } else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--activity") == 0) {
+      opts->show_activity = true;
+    } else if (strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--api-errors") == 0) {
+      opts->show_api_errors = true;
+    } else if (strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--files") == 0) {
+      opts->show_files = true;
+    } else if (strcmp(argv[i], "-x") == 0 || strcmp(argv[i], "--abandoned") == 0) {
+      opts->show_abandoned = true;
+    } else if (strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--context-mix") == 0) {
+      opts->show_context_mix = true;
+    } else if (strcmp(argv[i], "--top-turns-json") == 0) {
+      opts->top_turns_json = true;
+    } else if (strcmp(argv[i], "--batch") == 0) {
+      if (i + 1 >= argc) {
+        fprintf(MCCS_STDERR, "error: --batch requires a path\n");
+        return ERR(ResultVoid, MCCS_ERR_MISSING_FIELD);
+      }
+      opts->batch_source = argv[++i];
+    } else if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) {
+      char *end = NULL;
+      unsigned long jobs = (i + 1 < argc) ? strtoul(argv[i + 1], &end, 10) : 0;
+      if (i + 1 >= argc || !end || *end != '\0' || jobs == 0 || jobs > UINT32_MAX) {
+        fprintf(MCCS_STDERR, "error: --jobs requires a positive number\n");
+        return ERR(ResultVoid, MCCS_ERR_INVALID_FORMAT);
+      }
+      opts->batch_jobs = (uint32_t)jobs;
+      i++;
+    } else if (strcmp(argv[i], "--debounce-ms") == 0) {
+      char *end = NULL;
+      unsigned long window = (i + 1 < argc) ? strtoul(argv[i + 1], &end, 10) : 0;
+      if (i + 1 >= argc || !end || end == argv[i + 1] || *end != '\0' || window > UINT32_MAX) {
+        fprintf(MCCS_STDERR, "error: --debounce-ms requires a number of milliseconds\n");
+        return ERR(ResultVoid, MCCS_ERR_INVALID_FORMAT);
+      }
+      opts->debounce_ms = (uint32_t)window;
+      i++;
+    } else if (strcmp(argv[i], "--budget-ms") == 0) {
+      char *end = NULL;
+      unsigned long budget = (i + 1 < argc) ? strtoul(argv[i + 1], &end, 10) : 0;
+      if (i + 1 >= argc || !end || end == argv[i + 1] || *end != '\0' || budget == 0 || budget > UINT32_MAX) {
+        fprintf(MCCS_STDERR, "error: --budget-ms requires a positive number of milliseconds\n");
+        return ERR(ResultVoid, MCCS_ERR_INVALID_FORMAT);
+      }
+      opts->budget_ms = (uint32_t)budget;
+      i++;
+    } else if (strcmp(argv[i], "--approximate") == 0) {
+      opts->approximate = true;
+    } else if (strcmp(argv[i], "--once") == 0) {
+      opts->top_once = true;
+    } else if (strcmp(argv[i], "--history") == 0) {
+      opts->record_history = true;
+    } else if (opts->query && (strcmp(argv[i], "--by") == 0 || strcmp(argv[i], "--since") == 0 ||
+                               strcmp(argv[i], "--until") == 0 || strcmp(argv[i], "--model") == 0 ||
+                               strcmp(argv[i], "--sort") == 0 || strcmp(argv[i], "--store") == 0)) {
+      if (i + 1 >= argc) {
+        fprintf(MCCS_STDERR, "error: %s requires a value\n", argv[i]);
+        return ERR(ResultVoid, MCCS_ERR_MISSING_FIELD);
+      }
+      struct query_options *q = &opts->query_opts;
+      const char *flag = argv[i];
+      const char *value = argv[++i];
+      if (strcmp(flag, "--by") == 0) {
+        q->by = value;
+      } else if (strcmp(flag, "--since") == 0) {
+        q->since = value;
+      } else if (strcmp(flag, "--until") == 0) {
+        q->until = value;
+      } else if (strcmp(flag, "--model") == 0) {
+        q->model = value;
+      } else if (strcmp(flag, "--sort") == 0) {
+        q->sort = value;
+      } else {
+        q->store = value;
+      }
+    } else if (opts->query && strcmp(argv[i], "--reverse") == 0) {
+      opts->query_opts.reverse = true;
+    } else if (opts->query && strcmp(argv[i], "--limit") == 0) {
+      char *end = NULL;
+      unsigned long limit = (i + 1 < argc) ? strtoul(argv[i + 1], &end, 10) : 0;
+      if (i + 1 >= argc || !end || end == argv[i + 1] || *end != '\0' || limit > UINT32_MAX) {
+        fprintf(MCCS_STDERR, "error: --limit requires a number\n");
+        return ERR(ResultVoid, MCCS_ERR_INVALID_FORMAT);
+      }
+      opts->query_opts.limit = (uint32_t)limit;
+      i++;
+    } else if (strcmp(argv[i], "--record") == 0) {
+      if (i + 1 >= argc) {
+        fprintf(MCCS_STDERR, "error: --record requires a trace path\n");
+        return ERR(ResultVoid, MCCS_ERR_MISSING_FIELD);
+      }
+      opts->record_trace = argv[++i];
     }
   }
 
@@ -24,6 +24,13 @@
  */
 void mccs_init_cli_options(struct cli_options *restrict opts);
 
+/**
+ * Turn on every token feature (--all)
+ *
+ * @param opts    Options to update
+ */
+void mccs_enable_all_features(struct cli_options *restrict opts);
+
 /**
  * Parse command-line arguments
  *
@@ -34,6 +41,8 @@ void mccs_init_cli_options(struct cli_options *restrict opts);
  *
  * @error MCCS_ERR_INVALID_JSON if arguments are NULL (treated as fatal error)
  * @note When help is requested, function prints usage and returns Ok(0)
+ * @note Options from the config file (see config.h) are applied first,
+ *       unless --no-config is given
  */
 ResultVoid mccs_parse_cli_args(int argc,
                                 char *argv[],
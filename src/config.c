@@ -0,0 +1,451 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "config.h"
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cache.h"
+#include "cli_parser.h"
+#include "constants.h"
+#include "debug.h"
+
+#define CONFIG_SNAPSHOT_MAGIC 0xCCCF0003
+#define CONFIG_HASH_FNV_OFFSET 1469598103934665603ULL
+#define CONFIG_HASH_FNV_PRIME 1099511628211ULL
+
+/**
+ * Snapshot file: the parsed values and the config file they came from
+ */
+struct config_snapshot {
+  uint32_t magic;            ///< CONFIG_SNAPSHOT_MAGIC
+  uint32_t size;             ///< sizeof(struct config_snapshot)
+  int64_t mtime_ns;          ///< mtime of the config file when parsed
+  int64_t file_size;         ///< Size of the config file when parsed
+  uint64_t path_hash;        ///< FNV-1a hash of the config file path
+  uint64_t checksum;         ///< FNV-1a hash of values
+  struct mccs_config values; ///< Parsed values
+};
+
+/**
+ * Value types of config keys
+ */
+enum config_kind {
+  CONFIG_BOOL,
+  CONFIG_U32,
+  CONFIG_GRADIENT,
+  CONFIG_COLOR,
+};
+
+/**
+ * One config key and the field it sets
+ */
+struct config_key {
+  const char *name;      ///< Long option name without dashes
+  enum config_kind kind; ///< Value type
+  size_t offset;         ///< Field offset in struct mccs_config
+};
+
+#define CONFIG_KEY(name, kind, field) {name, kind, offsetof(struct mccs_config, field)}
+
+static const struct config_key config_keys[] = {
+    CONFIG_KEY("token-breakdown", CONFIG_BOOL, token_breakdown),
+    CONFIG_KEY("context-tokens", CONFIG_BOOL, context_tokens),
+    CONFIG_KEY("session-tokens", CONFIG_BOOL, session_tokens),
+    CONFIG_KEY("cache-efficiency", CONFIG_BOOL, cache_efficiency),
+    CONFIG_KEY("api-time-ratio", CONFIG_BOOL, api_time_ratio),
+    CONFIG_KEY("lines-ratio", CONFIG_BOOL, lines_ratio),
+    CONFIG_KEY("input-output-ratio", CONFIG_BOOL, input_output_ratio),
+    CONFIG_KEY("cache-write-read-ratio", CONFIG_BOOL, cache_write_read_ratio),
+    CONFIG_KEY("clamping", CONFIG_BOOL, clamping),
+    CONFIG_KEY("all", CONFIG_BOOL, all),
+    CONFIG_KEY("no-color", CONFIG_BOOL, no_color),
+    CONFIG_KEY("verbose", CONFIG_BOOL, verbose),
+    CONFIG_KEY("hide-breakdown", CONFIG_BOOL, hide_breakdown),
+    CONFIG_KEY("simple", CONFIG_BOOL, simple),
+    CONFIG_KEY("top-turns", CONFIG_BOOL, top_turns),
+    CONFIG_KEY("history", CONFIG_BOOL, history),
+    CONFIG_KEY("approximate", CONFIG_BOOL, approximate),
+    CONFIG_KEY("turn-cost", CONFIG_BOOL, turn_cost),
+    CONFIG_KEY("activity", CONFIG_BOOL, activity),
+    CONFIG_KEY("api-errors", CONFIG_BOOL, api_errors),
+    CONFIG_KEY("files", CONFIG_BOOL, files),
+    CONFIG_KEY("abandoned", CONFIG_BOOL, abandoned),
+    CONFIG_KEY("context-mix", CONFIG_BOOL, context_mix),
+    CONFIG_KEY("gradient", CONFIG_GRADIENT, gradient),
+    CONFIG_KEY("debounce-ms", CONFIG_U32, debounce_ms),
+    CONFIG_KEY("budget-ms", CONFIG_U32, budget_ms),
+    CONFIG_KEY("jobs", CONFIG_U32, jobs),
+    CONFIG_KEY("color-label", CONFIG_COLOR, colors[MCCS_THEME_LABEL]),
+    CONFIG_KEY("color-model", CONFIG_COLOR, colors[MCCS_THEME_MODEL_NAME]),
+    CONFIG_KEY("color-model-id", CONFIG_COLOR, colors[MCCS_THEME_MODEL_ID]),
+    CONFIG_KEY("color-version", CONFIG_COLOR, colors[MCCS_THEME_VERSION]),
+    CONFIG_KEY("color-dir", CONFIG_COLOR, colors[MCCS_THEME_DIR]),
+    CONFIG_KEY("color-cost", CONFIG_COLOR, colors[MCCS_THEME_COST]),
+    CONFIG_KEY("color-time", CONFIG_COLOR, colors[MCCS_THEME_TIME_TOTAL]),
+    CONFIG_KEY("color-api-time", CONFIG_COLOR, colors[MCCS_THEME_TIME_API]),
+    CONFIG_KEY("color-lines-added", CONFIG_COLOR, colors[MCCS_THEME_LINES_ADDED]),
+    CONFIG_KEY("color-lines-removed", CONFIG_COLOR, colors[MCCS_THEME_LINES_REMOVED]),
+    CONFIG_KEY("color-badge-under", CONFIG_COLOR, colors[MCCS_THEME_BADGE_UNDER]),
+    CONFIG_KEY("color-badge-over", CONFIG_COLOR, colors[MCCS_THEME_BADGE_OVER]),
+    CONFIG_KEY("color-input", CONFIG_COLOR, colors[MCCS_THEME_TOKEN_INPUT]),
+    CONFIG_KEY("color-output", CONFIG_COLOR, colors[MCCS_THEME_TOKEN_OUTPUT]),
+    CONFIG_KEY("color-cache-write", CONFIG_COLOR, colors[MCCS_THEME_TOKEN_CACHE_CREATE]),
+    CONFIG_KEY("color-cache-read", CONFIG_COLOR, colors[MCCS_THEME_TOKEN_CACHE_READ]),
+    CONFIG_KEY("color-bar-empty", CONFIG_COLOR, colors[MCCS_THEME_PROGRESS_EMPTY]),
+    CONFIG_KEY("color-bar-context", CONFIG_COLOR, colors[MCCS_THEME_PROGRESS_CTX]),
+    CONFIG_KEY("color-bar-session", CONFIG_COLOR, colors[MCCS_THEME_PROGRESS_SES]),
+    CONFIG_KEY("color-bar-cache", CONFIG_COLOR, colors[MCCS_THEME_PROGRESS_CACHE]),
+    CONFIG_KEY("color-bar-api-time", CONFIG_COLOR, colors[MCCS_THEME_PROGRESS_API_TIME]),
+};
+
+static uint64_t config_hash(const void *data,
+                            size_t len) {
+  const unsigned char *bytes = data;
+  uint64_t hash = CONFIG_HASH_FNV_OFFSET;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= bytes[i];
+    hash *= CONFIG_HASH_FNV_PRIME;
+  }
+  return hash;
+}
+
+const char *config_path(char *buf,
+                        size_t size) {
+  const char *xdg = getenv("XDG_CONFIG_HOME");
+  const char *home = getenv("HOME");
+  int ret;
+  // The spec asks for an absolute path; anything else falls back to ~/.config
+  if (xdg && xdg[0] == '/') {
+    ret = snprintf(buf, size, "%s/%s/%s", xdg, CONFIG_DIR_NAME, CONFIG_FILE_NAME);
+  } else if (home && home[0] != '\0') {
+    ret = snprintf(buf, size, "%s/.config/%s/%s", home, CONFIG_DIR_NAME, CONFIG_FILE_NAME);
+  } else {
+    return NULL;
+  }
+  return ret < 0 || (size_t)ret >= size ? NULL : buf;
+}
+
+/**
+ * Parse a boolean value (true/yes/on/1, false/no/off/0)
+ */
+static bool config_parse_bool(const char *value,
+                              size_t len,
+                              uint8_t *out) {
+  static const char *const on[] = {"true", "yes", "on", "1"};
+  static const char *const off[] = {"false", "no", "off", "0"};
+  for (size_t i = 0; i < sizeof(on) / sizeof(on[0]); i++) {
+    if (strlen(on[i]) == len && strncasecmp(value, on[i], len) == 0) {
+      *out = 1;
+      return true;
+    }
+    if (strlen(off[i]) == len && strncasecmp(value, off[i], len) == 0) {
+      *out = 0;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Parse a decimal uint32_t value
+ */
+static bool config_parse_u32(const char *value,
+                             size_t len,
+                             uint32_t *out) {
+  if (len == 0 || len > 10) {
+    return false;
+  }
+  uint64_t n = 0;
+  for (size_t i = 0; i < len; i++) {
+    if (!isdigit((unsigned char)value[i])) {
+      return false;
+    }
+    n = n * 10 + (uint64_t)(value[i] - '0');
+  }
+  if (n > UINT32_MAX) {
+    return false;
+  }
+  *out = (uint32_t)n;
+  return true;
+}
+
+/**
+ * Parse a gradient mode (off, 256, truecolor or 24bit)
+ */
+static bool config_parse_gradient(const char *value,
+                                  size_t len,
+                                  uint32_t *out) {
+  if (len == 3 && strncmp(value, "off", len) == 0) {
+    *out = MCCS_GRADIENT_OFF;
+  } else if (len == 3 && strncmp(value, "256", len) == 0) {
+    *out = MCCS_GRADIENT_256;
+  } else if ((len == 9 && strncmp(value, "truecolor", len) == 0) ||
+             (len == 5 && strncmp(value, "24bit", len) == 0)) {
+    *out = MCCS_GRADIENT_TRUECOLOR;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Parse a 256-color palette index (0-255), stored as index + 1
+ */
+static bool config_parse_color(const char *value,
+                               size_t len,
+                               uint16_t *out) {
+  uint32_t index;
+  if (!config_parse_u32(value, len, &index) || index > 255) {
+    return false;
+  }
+  *out = (uint16_t)(index + 1);
+  return true;
+}
+
+/**
+ * Apply one "key = value" line (already stripped of surrounding blanks)
+ */
+static bool config_parse_line(const char *line,
+                              size_t len,
+                              struct mccs_config *config) {
+  const char *eq = memchr(line, '=', len);
+  if (!eq) {
+    return false;
+  }
+  size_t key_len = (size_t)(eq - line);
+  while (key_len > 0 && isspace((unsigned char)line[key_len - 1])) {
+    key_len--;
+  }
+  const char *value = eq + 1;
+  const char *end = line + len;
+  const char *comment = memchr(value, '#', (size_t)(end - value));
+  if (comment) {
+    end = comment;
+  }
+  while (value < end && isspace((unsigned char)*value)) {
+    value++;
+  }
+  while (end > value && isspace((unsigned char)end[-1])) {
+    end--;
+  }
+  size_t value_len = (size_t)(end - value);
+
+  for (size_t i = 0; i < sizeof(config_keys) / sizeof(config_keys[0]); i++) {
+    const struct config_key *key = &config_keys[i];
+    if (strlen(key->name) != key_len || strncmp(key->name, line, key_len) != 0) {
+      continue;
+    }
+    unsigned char *field = (unsigned char *)config + key->offset;
+    switch (key->kind) {
+    case CONFIG_BOOL:
+      return config_parse_bool(value, value_len, (uint8_t *)field);
+    case CONFIG_U32:
+      return config_parse_u32(value, value_len, (uint32_t *)(void *)field);
+    case CONFIG_GRADIENT:
+      return config_parse_gradient(value, value_len, (uint32_t *)(void *)field);
+    case CONFIG_COLOR:
+      return config_parse_color(value, value_len, (uint16_t *)(void *)field);
+    }
+  }
+  return false;
+}
+
+void config_parse(const char *text,
+                  size_t len,
+                  struct mccs_config *config) {
+  memset(config, 0, sizeof(*config));
+  size_t pos = 0;
+  unsigned int line_no = 0;
+  while (pos < len) {
+    const char *nl = memchr(text + pos, '\n', len - pos);
+    size_t next = nl ? (size_t)(nl - text) + 1 : len;
+    size_t start = pos;
+    size_t stop = nl ? (size_t)(nl - text) : len;
+    pos = next;
+    line_no++;
+
+    while (start < stop && isspace((unsigned char)text[start])) {
+      start++;
+    }
+    while (stop > start && isspace((unsigned char)text[stop - 1])) {
+      stop--;
+    }
+    if (start == stop || text[start] == '#') {
+      continue;
+    }
+    if (!config_parse_line(text + start, stop - start, config)) {
+      DEBUG_LOG("Config line %u ignored: %.*s", line_no, (int)(stop - start), text + start);
+    }
+  }
+}
+
+/**
+ * Copy the values out of a snapshot if it was made from this config file
+ */
+static bool config_snapshot_read(const char *path,
+                                 const struct config_snapshot *key,
+                                 struct mccs_config *config) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size != (off_t)sizeof(struct config_snapshot)) {
+    close(fd);
+    return false;
+  }
+  void *map = mmap(NULL, sizeof(struct config_snapshot), PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return false;
+  }
+  const struct config_snapshot *snap = map;
+  bool valid = snap->magic == CONFIG_SNAPSHOT_MAGIC &&
+               snap->size == sizeof(*snap) &&
+               snap->mtime_ns == key->mtime_ns &&
+               snap->file_size == key->file_size &&
+               snap->path_hash == key->path_hash &&
+               snap->checksum == config_hash(&snap->values, sizeof(snap->values));
+  if (valid) {
+    *config = snap->values;
+  }
+  munmap(map, sizeof(*snap));
+  return valid;
+}
+
+/**
+ * Replace the snapshot through a temporary file and rename()
+ */
+static void config_snapshot_write(const char *cache_dir,
+                                  const char *path,
+                                  const struct config_snapshot *snap) {
+  char tmp[BUF_PATH_SIZE + sizeof("/config.XXXXXX")];
+  snprintf(tmp, sizeof(tmp), "%s/config.XXXXXX", cache_dir);
+  int fd = mkstemp(tmp);
+  if (fd < 0) {
+    DEBUG_LOG("Config snapshot: cannot create %s", tmp);
+    return;
+  }
+  bool ok = write(fd, snap, sizeof(*snap)) == (ssize_t)sizeof(*snap);
+  close(fd);
+  if (!ok || rename(tmp, path) != 0) {
+    DEBUG_LOG("Config snapshot: write failed");
+    unlink(tmp);
+  }
+}
+
+/**
+ * Read and parse the config file (false if it cannot be read whole)
+ */
+static bool config_read_file(const char *path,
+                             size_t size,
+                             struct mccs_config *config) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  char *text = malloc(size + 1);
+  ssize_t n = text ? read(fd, text, size) : -1;
+  close(fd);
+  if (n != (ssize_t)size) {
+    free(text);
+    return false;
+  }
+  config_parse(text, size, config);
+  free(text);
+  return true;
+}
+
+bool config_load(struct mccs_config *config) {
+  memset(config, 0, sizeof(*config));
+
+  char path[BUF_PATH_SIZE];
+  struct stat st;
+  if (!config_path(path, sizeof(path)) || stat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+    return false;
+  }
+  if (st.st_size > CONFIG_MAX_SIZE) {
+    DEBUG_LOG("Config file %s is larger than %d bytes, ignored", path, CONFIG_MAX_SIZE);
+    return false;
+  }
+
+  struct config_snapshot snap;
+  memset(&snap, 0, sizeof(snap));
+  snap.magic = CONFIG_SNAPSHOT_MAGIC;
+  snap.size = sizeof(snap);
+  snap.mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + (int64_t)st.st_mtim.tv_nsec;
+  snap.file_size = (int64_t)st.st_size;
+  snap.path_hash = config_hash(path, strlen(path));
+
+  char cache_dir[BUF_PATH_SIZE];
+  char snap_path[BUF_PATH_SIZE + sizeof("/" CONFIG_SNAPSHOT_FILE)];
+  format_cache_dir(cache_dir, sizeof(cache_dir));
+  snprintf(snap_path, sizeof(snap_path), "%s/%s", cache_dir, CONFIG_SNAPSHOT_FILE);
+  if (config_snapshot_read(snap_path, &snap, config)) {
+    DEBUG_LOG("Config loaded from snapshot %s", snap_path);
+    return true;
+  }
+
+  DEBUG_LOG("Config snapshot missing or stale, parsing %s", path);
+  if (!config_read_file(path, (size_t)st.st_size, config)) {
+    return false;
+  }
+  snap.values = *config;
+  snap.checksum = config_hash(&snap.values, sizeof(snap.values));
+  config_snapshot_write(cache_dir, snap_path, &snap);
+  return true;
+}
+
+void config_apply(const struct mccs_config *config,
+                  struct cli_options *opts) {
+  if (config->all) {
+    mccs_enable_all_features(opts);
+  }
+  opts->show_token_breakdown |= config->token_breakdown != 0;
+  opts->show_context_tokens |= config->context_tokens != 0;
+  opts->show_session_tokens |= config->session_tokens != 0;
+  opts->show_cache_efficiency |= config->cache_efficiency != 0;
+  opts->show_api_time_ratio |= config->api_time_ratio != 0;
+  opts->show_lines_ratio |= config->lines_ratio != 0;
+  opts->show_input_output_ratio |= config->input_output_ratio != 0;
+  opts->show_cache_write_read_ratio |= config->cache_write_read_ratio != 0;
+  opts->clamp_percentages |= config->clamping != 0;
+  opts->no_color |= config->no_color != 0;
+  opts->verbose |= config->verbose != 0;
+  opts->hide_token_breakdown |= config->hide_breakdown != 0;
+  opts->simple_status_line |= config->simple != 0;
+  opts->show_top_turns |= config->top_turns != 0;
+  opts->record_history |= config->history != 0;
+  opts->approximate |= config->approximate != 0;
+  opts->show_turn_cost |= config->turn_cost != 0;
+  opts->show_activity |= config->activity != 0;
+  opts->show_api_errors |= config->api_errors != 0;
+  opts->show_files |= config->files != 0;
+  opts->show_abandoned |= config->abandoned != 0;
+  opts->show_context_mix |= config->context_mix != 0;
+  if (config->gradient > MCCS_GRADIENT_OFF && config->gradient < MCCS_GRADIENT_MODE_COUNT) {
+    opts->gradient = (enum mccs_gradient_mode)config->gradient;
+  }
+  if (config->debounce_ms > 0) {
+    opts->debounce_ms = config->debounce_ms;
+  }
+  if (config->budget_ms > 0) {
+    opts->budget_ms = config->budget_ms;
+  }
+  if (config->jobs > 0) {
+    opts->batch_jobs = config->jobs;
+  }
+  for (size_t i = 0; i < MCCS_THEME_SLOT_COUNT; i++) {
+    if (config->colors[i] > 0) {
+      opts->theme_colors[i] = config->colors[i];
+    }
+  }
+}
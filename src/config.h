@@ -0,0 +1,133 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file config.h
+ * @brief Config file with a binary snapshot for zero-parse startup
+ *
+ * $XDG_CONFIG_HOME/mini-ccstatus/config (or ~/.config/mini-ccstatus/config)
+ * holds the options a statusline command would otherwise repeat on every
+ * run, one "key = value" per line; keys are the long option names:
+ *
+ *   # Layout
+ *   all = true
+ *   verbose = yes
+ *   hide-breakdown = on
+ *   # Theme and budgets
+ *   gradient = truecolor
+ *   color-cost = 214
+ *   color-bar-context = 39
+ *   budget-ms = 50
+ *
+ * The color-* keys have no command-line flag: each takes a 256-color palette
+ * index (0-255) for one theme element and only applies when colors are on.
+ *
+ * The text is parsed once and stored as a binary snapshot (config.snap in
+ * the cache directory) together with the path, mtime and size of the file it
+ * came from. Later runs stat the config, map the snapshot and copy the values
+ * out after checking the key and checksum, without parsing anything. Any
+ * edit of the file changes its mtime and rebuilds the snapshot.
+ *
+ * Options given on the command line are applied after the config, so they
+ * add to it and override its numbers.
+ */
+
+#ifndef MCCS_CONFIG_H
+#define MCCS_CONFIG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types_struct.h"
+
+#define CONFIG_DIR_NAME "mini-ccstatus"   /* Directory inside $XDG_CONFIG_HOME */
+#define CONFIG_FILE_NAME "config"         /* Config file name */
+#define CONFIG_SNAPSHOT_FILE "config.snap" /* Snapshot file inside the cache directory */
+#define CONFIG_MAX_SIZE 65536             /* Larger config files are ignored */
+
+/**
+ * Option values a config file can set (fixed layout, stored as is)
+ *
+ * Booleans are bytes so the snapshot layout does not depend on sizeof(bool).
+ */
+struct mccs_config {
+  uint8_t token_breakdown;        ///< token-breakdown
+  uint8_t context_tokens;         ///< context-tokens
+  uint8_t session_tokens;         ///< session-tokens
+  uint8_t cache_efficiency;       ///< cache-efficiency
+  uint8_t api_time_ratio;         ///< api-time-ratio
+  uint8_t lines_ratio;            ///< lines-ratio
+  uint8_t input_output_ratio;     ///< input-output-ratio
+  uint8_t cache_write_read_ratio; ///< cache-write-read-ratio
+  uint8_t clamping;               ///< clamping
+  uint8_t all;                    ///< all (every token feature, like -a)
+  uint8_t no_color;               ///< no-color
+  uint8_t verbose;                ///< verbose
+  uint8_t hide_breakdown;         ///< hide-breakdown
+  uint8_t simple;                 ///< simple
+  uint8_t top_turns;              ///< top-turns
+  uint8_t history;                ///< history
+  uint8_t approximate;            ///< approximate
+  uint8_t turn_cost;              ///< turn-cost
+  uint8_t activity;               ///< activity
+  uint8_t api_errors;             ///< api-errors
+  uint8_t files;                  ///< files
+  uint8_t abandoned;              ///< abandoned
+  uint8_t context_mix;            ///< context-mix
+  uint8_t reserved[1];            ///< Padding (always 0)
+  uint32_t gradient;              ///< gradient (enum mccs_gradient_mode)
+  uint32_t debounce_ms;           ///< debounce-ms
+  uint32_t budget_ms;             ///< budget-ms
+  uint32_t jobs;                  ///< jobs
+  uint16_t colors[MCCS_THEME_SLOT_COUNT]; ///< color-* (palette index + 1, 0 = unset)
+};
+
+/**
+ * Path of the config file
+ *
+ * @param buf     Output buffer
+ * @param size    Size of buf
+ * @return        buf, or NULL if neither XDG_CONFIG_HOME nor HOME is set
+ *                (or the path does not fit)
+ */
+const char *config_path(char *buf,
+                        size_t size);
+
+/**
+ * Parse config text
+ *
+ * @param text    Config file contents (need not be NUL-terminated)
+ * @param len     Length of text
+ * @param config  Output: values (zeroed first)
+ *
+ * @note Blank lines and lines starting with '#' are ignored, as is anything
+ *       after a '#' in a value. Unknown keys and malformed values are skipped
+ *       (reported by the debug build).
+ */
+void config_parse(const char *text,
+                  size_t len,
+                  struct mccs_config *config);
+
+/**
+ * Load the config through its snapshot
+ *
+ * @param config  Output: values (all zero when there is no config file)
+ * @return        true if a config file was found
+ *
+ * @note Rebuilds the snapshot (mkstemp + rename) when it is missing, from
+ *       another file or stale; a snapshot that cannot be written only costs
+ *       a parse on the next run.
+ */
+bool config_load(struct mccs_config *config);
+
+/**
+ * Copy config values into CLI options
+ *
+ * @param config  Loaded values
+ * @param opts    Options to update (only the values the config sets)
+ */
+void config_apply(const struct mccs_config *config,
+                  struct cli_options *opts);
+
+#endif /* MCCS_CONFIG_H */
@@ -53,53 +53,33 @@
 #define TOKEN_SCALE_THOUSAND 1000.0      /* Scale factor for thousand tokens (K suffix) */
 #define CACHE_MAX_AGE_S 60               /* Maximum cache age in seconds (safety limit) */
 #define CACHE_DIR_MODE 0700              /* Directory permissions: rwx------ (user only) */
+#define CACHE_LINE_SIZE 64               /* Hot part of a session cache record (one CPU cache line) */
+#define TOP_TURNS_CAPACITY 5             /* Most expensive turns tracked per session */
+#define ACTIVITY_WINDOW_MIN 512          /* Minutes of activity kept per session (rolling, about 8.5 h) */
+#define ACTIVITY_WORDS (ACTIVITY_WINDOW_MIN / 64) /* 64-bit words of the activity bitmap */
+#define FILE_SET_SLOTS 128               /* Path hashes of touched files kept exactly per session */
+#define FILE_SKETCH_REGISTERS 512        /* HyperLogLog registers per kind once the exact set is full */
+#define FILE_SKETCH_INDEX_BITS 9         /* log2(FILE_SKETCH_REGISTERS) */
+#define BRANCH_FORK_SLOTS 64             /* Prompt parents remembered as possible fork points */
+#define CONTEXT_BYTES_PER_TOKEN 4        /* Transcript bytes per token when splitting the context by kind */
+#define PROMPT_CACHE_TTL_S 300           /* Default prompt cache lifetime (5 minute ephemeral) */
+#define PROMPT_CACHE_TTL_LONG_S 3600     /* Extended prompt cache lifetime (1 hour ephemeral) */
+#define API_ERROR_RECENT_S 900           /* API errors are shown for this long after the last one */
+#define TRANSCRIPT_DEADLINE_CHECK_LINES 64 /* Transcript lines parsed between --budget-ms deadline checks */
+#define ESTIMATE_SAMPLE_CHUNKS 32        /* Evenly spaced chunks sampled by --approximate */
+#define ESTIMATE_CHUNK_BYTES 32768       /* Bytes per sampled chunk */
+#define ESTIMATE_TAIL_BYTES 262144       /* First tail window searched for the exact context tokens */
+#define ESTIMATE_TAIL_MAX_BYTES 8388608  /* Largest tail window before giving up */
+#define ESTIMATE_DEFAULT_BUDGET_MS 200   /* Parse budget implied by --approximate without --budget-ms */
 
 /* Display and UI constants */
 #define PROGRESS_BAR_WIDTH 20   /* Width of progress bars in status display */
 #define PROGRESS_BAR_FILLED "█" /* U+2588 Full block for filled progress segments */
 #define PROGRESS_BAR_EMPTY "░"  /* U+2591 Light shade for empty progress segments */
-
-/* Output format strings for status line display */
-
-/**
- * Compact verbose format: cwd == project_dir
- * Includes "Model:", "Version:", etc. labels with colors
- */
-#define FMT_STATUS_COMPACT_VERBOSE                 \
-  "%s%sModel:%s %s%s%s (%s%s%s) %s|%s "            \
-  "%sVersion:%s %s%s%s %s|%s "                     \
-  "%sDirectory:%s %s%s%s %s|%s "                   \
-  "%sCost:%s %s$%.4f%s %sTokens:%s %s%s%s %s|%s "  \
-  "%sTotal:%s %s%.1fs%s %sAPI:%s %s%.1fs%s %s|%s " \
-  "%sLines:%s %s+%" PRIu32 "%s/%s-%" PRIu32 "%s\n"
-
-/**
- * Extended verbose format: cwd != project_dir
- * Shows both "Directory:" and "Project:" fields
- */
-#define FMT_STATUS_EXTENDED_VERBOSE                \
-  "%s%sModel:%s %s%s%s (%s%s%s) %s|%s "            \
-  "%sVersion:%s %s%s%s %s|%s "                     \
-  "%sDirectory:%s %s%s%s %s|%s "                   \
-  "%sProject:%s %s%s%s %s|%s "                     \
-  "%sCost:%s %s$%.4f%s %sTokens:%s %s%s%s %s|%s "  \
-  "%sTotal:%s %s%.1fs%s %sAPI:%s %s%.1fs%s %s|%s " \
-  "%sLines:%s %s+%" PRIu32 "%s/%s-%" PRIu32 "%s\n"
-
-/**
- * Compact plain format: no field labels
- * Uses | separators between sections
- */
-#define FMT_STATUS_COMPACT_PLAIN                                        \
-  "%s%s%s%s (%s%s%s) | %s%s%s | %s%s%s | %s$%.4f%s %s%s%s | %s%.1fs%s " \
-  "%s%.1fs%s | %s+%" PRIu32 "%s/%s-%" PRIu32 "%s\n"
-
-/**
- * Extended plain format: no field labels, separate directory/project
- */
-#define FMT_STATUS_EXTENDED_PLAIN                                      \
-  "%s%s%s%s (%s%s%s) | %s%s%s | %s%s%s | %s%s%s | %s$%.4f%s %s%s%s | " \
-  "%s%.1fs%s %s%.1fs%s | %s+%" PRIu32 "%s/%s-%" PRIu32 "%s\n"
+#define ACTIVITY_CELLS 16       /* Cells of the activity timeline (ACTIVITY_WINDOW_MIN / 16 minutes each) */
+#define PARTIAL_MARK "+"        /* Suffix of token values from a parse cut short by --budget-ms */
+#define ESTIMATE_MARK "~"       /* Prefix of session values estimated by --approximate */
+#define ESTIMATE_ERROR_MARK "±" /* U+00B1 Prefix of the error bound of an estimate */
 
 /* JSON path arrays - NULL-terminated key sequences for navigation */
 /* Example: PATH_MODEL_NAME navigates root["model"]["display_name"] */
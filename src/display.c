@@ -7,11 +7,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
+#include "activity.h"
+#include "branch.h"
 #include "colors.h"
 #include "constants.h"
+#include "file_set.h"
+#include "gradient.h"
 #include "safe_conv.h"
+#include "sgr.h"
 #include "token_calculator.h"
+#include "top_turns.h"
 
 /**
  * Extract the basename from a file path (modifies path in-place)
@@ -46,24 +53,53 @@ static const char *mccs_extract_basename(char *path) {
 }
 
 /**
- * Return color from theme based on use_color flag
+ * Directory as shown in the status line (modifies path in-place)
  *
- * @param use_color    If true, return colored theme; if false, return no-color theme
- * @return             Pointer to appropriate color theme
+ * @param path        Directory path (modified)
+ * @param root_len    Length of its repository root prefix (0 = not in a repository)
+ * @return            Pointer into path: "<repo>/<relative path>" inside a
+ *                    repository, the basename otherwise
  */
-static inline const struct color_theme *get_colors(bool use_color) {
-  return get_theme(use_color);
+static const char *mccs_directory_display(char *path,
+                                          size_t root_len) {
+  const char *base = mccs_extract_basename(path);
+  if (root_len == 0 || root_len > strlen(path) || base == path) {
+    return base;
+  }
+
+  // Start of the root's own name: after the last slash of the root prefix
+  const char *start = path + root_len;
+  while (start > path && *(start - 1) != '/') {
+    --start;
+  }
+  return *start ? start : base;
+}
+
+/**
+ * Return the color theme owned by the render context
+ *
+ * @param ctx    Render context
+ * @return       Pointer to the context's private theme copy
+ */
+static inline const struct color_theme *get_colors(const struct mccs_render_ctx *ctx) {
+  return &ctx->theme;
 }
 
 /**
  * Print a visual progress bar with percentage fill
  *
- * @param use_color    Whether to use ANSI colors
+ * @param ctx          Render context
+ * @param kind         Bar kind (selects the gradient table)
  * @param percentage   Percentage value (0-100, or higher if not clamped)
  * @param clamp        If true, cap display at 100%
  * @param bar_color    ANSI color code for filled portion
+ * @param empty_color_override  ANSI color code for empty cells (NULL uses the theme's progress_empty)
+ *
+ * @note With a gradient mode enabled the cells come from the precomputed
+ *       gradient tables instead of the theme colors.
  */
-static void print_progress_bar(bool use_color,
+static void print_progress_bar(struct mccs_render_ctx *ctx,
+                               enum mccs_bar_kind kind,
                                uint32_t percentage,
                                bool clamp,
                                const char *bar_color,
@@ -79,22 +115,83 @@ static void print_progress_bar(bool use_color,
     bar_color = "";
   }
 
-  const struct color_theme *c = get_colors(use_color);
+  const struct color_theme *c = get_colors(ctx);
   const char *empty_color = empty_color_override ? empty_color_override : c->progress_empty;
 
-  printf("%s[%s", c->reset, bar_color);
+  sgr_puts(ctx, c->reset, "[");
+  const struct mccs_gradient_span *span =
+      ctx->use_color ? gradient_bar_span(ctx->gradient, kind, filled) : NULL;
+  if (span) {
+    sgr_write_span(ctx, span->bytes, span->len);
+    sgr_puts(ctx, c->reset, "]");
+    return;
+  }
+
   for (uint32_t i = 0; i < bar_width; i++) {
     if (i < filled) {
-      printf(PROGRESS_BAR_FILLED);
+      sgr_puts(ctx, bar_color, PROGRESS_BAR_FILLED);
     } else {
-      printf("%s" PROGRESS_BAR_EMPTY, empty_color);
+      sgr_puts(ctx, empty_color, PROGRESS_BAR_EMPTY);
     }
   }
-  printf("%s]", c->reset);
+  sgr_puts(ctx, c->reset, "]");
 }
 
-void print_token_breakdown(bool use_color,
-                           bool use_verbose,
+/**
+ * Print a two-color split bar (left segment, then right segment)
+ *
+ * @param ctx            Render context
+ * @param left_width     Cells in the left segment
+ * @param left_color     ANSI color code for the left segment
+ * @param right_width    Cells in the right segment
+ * @param right_color    ANSI color code for the right segment
+ */
+static void print_split_bar(struct mccs_render_ctx *ctx,
+                            uint32_t left_width,
+                            const char *left_color,
+                            uint32_t right_width,
+                            const char *right_color) {
+  const struct color_theme *c = get_colors(ctx);
+
+  sgr_puts(ctx, c->reset, "[");
+  for (uint32_t i = 0; i < left_width; i++) {
+    sgr_puts(ctx, left_color, PROGRESS_BAR_FILLED);
+  }
+  for (uint32_t i = 0; i < right_width; i++) {
+    sgr_puts(ctx, right_color, PROGRESS_BAR_FILLED);
+  }
+  sgr_puts(ctx, c->reset, "]");
+}
+
+/**
+ * Print a bar of consecutive colored segments, then empty cells up to the bar width
+ *
+ * @param ctx       Render context
+ * @param widths    Cells of each segment (summing to at most PROGRESS_BAR_WIDTH)
+ * @param colors    ANSI color code of each segment
+ * @param count     Number of segments
+ */
+static void print_stacked_bar(struct mccs_render_ctx *ctx,
+                              const uint32_t *widths,
+                              const char *const *colors,
+                              size_t count) {
+  const struct color_theme *c = get_colors(ctx);
+  uint32_t used = 0;
+
+  sgr_puts(ctx, c->reset, "[");
+  for (size_t k = 0; k < count; k++) {
+    for (uint32_t i = 0; i < widths[k]; i++) {
+      sgr_puts(ctx, colors[k], PROGRESS_BAR_FILLED);
+    }
+    used += widths[k];
+  }
+  for (; used < PROGRESS_BAR_WIDTH; used++) {
+    sgr_puts(ctx, c->progress_empty, PROGRESS_BAR_EMPTY);
+  }
+  sgr_puts(ctx, c->reset, "]");
+}
+
+void print_token_breakdown(struct mccs_render_ctx *ctx,
                            const struct token_counts *tokens) {
   if (!tokens) {
     return;
@@ -108,32 +205,32 @@ void print_token_breakdown(bool use_color,
 
   char buf_in[32], buf_out[32], buf_cr[32], buf_rd[32];
 
-  format_tokens(buf_in, sizeof(buf_in), tokens->input_tokens);
-  format_tokens(buf_out, sizeof(buf_out), tokens->output_tokens);
-  format_tokens(buf_cr, sizeof(buf_cr), tokens->cache_creation_tokens);
-  format_tokens(buf_rd, sizeof(buf_rd), tokens->cache_read_tokens);
-
-  const struct color_theme *c = get_colors(use_color);
-
-  if (use_verbose) {
-    printf("%sInput: %s%s%s  Output: %s%s%s  Cache Write: %s%s%s  Cache Read: %s%s%s\n",
-           c->reset,
-           c->token_input, buf_in, c->reset,
-           c->token_output, buf_out, c->reset,
-           c->token_cache_create, buf_cr, c->reset,
-           c->token_cache_read, buf_rd, c->reset);
-  } else {
-    printf("%sIn: %s%s%s  Out: %s%s%s  CaWr: %s%s%s  CaRd: %s%s%s\n",
-           c->reset,
-           c->token_input, buf_in, c->reset,
-           c->token_output, buf_out, c->reset,
-           c->token_cache_create, buf_cr, c->reset,
-           c->token_cache_read, buf_rd, c->reset);
-  }
+  // Estimates carry the mark on every value: "In: ~1.2k"
+  size_t mark = ctx->estimated_tokens ? strlen(ESTIMATE_MARK) : 0;
+  memcpy(buf_in, ESTIMATE_MARK, mark);
+  memcpy(buf_out, ESTIMATE_MARK, mark);
+  memcpy(buf_cr, ESTIMATE_MARK, mark);
+  memcpy(buf_rd, ESTIMATE_MARK, mark);
+  format_tokens(buf_in + mark, sizeof(buf_in) - mark, tokens->input_tokens);
+  format_tokens(buf_out + mark, sizeof(buf_out) - mark, tokens->output_tokens);
+  format_tokens(buf_cr + mark, sizeof(buf_cr) - mark, tokens->cache_creation_tokens);
+  format_tokens(buf_rd + mark, sizeof(buf_rd) - mark, tokens->cache_read_tokens);
+
+  const struct color_theme *c = get_colors(ctx);
+
+  bool v = ctx->use_verbose;
+  sgr_puts(ctx, c->reset, v ? "Input: " : "In: ");
+  sgr_puts(ctx, c->token_input, buf_in);
+  sgr_puts(ctx, c->reset, v ? "  Output: " : "  Out: ");
+  sgr_puts(ctx, c->token_output, buf_out);
+  sgr_puts(ctx, c->reset, v ? "  Cache Write: " : "  CaWr: ");
+  sgr_puts(ctx, c->token_cache_create, buf_cr);
+  sgr_puts(ctx, c->reset, v ? "  Cache Read: " : "  CaRd: ");
+  sgr_puts(ctx, c->token_cache_read, buf_rd);
+  sgr_end_line(ctx);
 }
 
-void print_context_percentage(bool use_color,
-                              bool use_verbose,
+void print_context_percentage(struct mccs_render_ctx *ctx,
                               uint64_t context_tokens,
                               bool clamp) {
   uint32_t percentage = calculate_percentage(context_tokens, DEFAULT_TOKEN_LIMIT, clamp);
@@ -141,29 +238,34 @@ void print_context_percentage(bool use_color,
   format_tokens(buf_tokens, sizeof(buf_tokens), context_tokens);
   format_tokens(buf_limit, sizeof(buf_limit), DEFAULT_TOKEN_LIMIT);
 
-  const struct color_theme *c = get_colors(use_color);
+  const struct color_theme *c = get_colors(ctx);
 
-  if (use_verbose) {
-    printf("%sContext   ", c->reset);
-    print_progress_bar(use_color,
+  if (ctx->use_verbose) {
+    sgr_puts(ctx, c->reset, "Context   ");
+    print_progress_bar(ctx,
+                       MCCS_BAR_CONTEXT,
                        percentage,
                        clamp,
                        c->progress_ctx,
-                       use_color ? ANSI_CTX_EMPTY : NULL);
-    printf(" %7u%% (%s used / %s limit)\n", percentage, buf_tokens, buf_limit);
+                       ctx->use_color ? ANSI_CTX_EMPTY : NULL);
+    sgr_printf(ctx, c->reset, " %7u%% (%s used / %s limit%s)", percentage, buf_tokens, buf_limit,
+               ctx->partial_tokens ? ", partial" : "");
+    sgr_end_line(ctx);
   } else {
-    printf("%sCtx%s ", c->label, c->reset);
-    print_progress_bar(use_color,
+    sgr_puts(ctx, c->label, "Ctx");
+    sgr_puts(ctx, c->reset, " ");
+    print_progress_bar(ctx,
+                       MCCS_BAR_CONTEXT,
                        percentage,
                        clamp,
                        c->progress_ctx,
-                       use_color ? ANSI_CTX_EMPTY : NULL);
-    printf(" %s\n", buf_tokens);
+                       ctx->use_color ? ANSI_CTX_EMPTY : NULL);
+    sgr_printf(ctx, c->reset, " %s%s", buf_tokens, ctx->partial_tokens ? PARTIAL_MARK : "");
+    sgr_end_line(ctx);
   }
 }
 
-void print_session_total(bool use_color,
-                         bool use_verbose,
+void print_session_total(struct mccs_render_ctx *ctx,
                          uint64_t total_tokens,
                          bool clamp) {
   // Hide display entirely if no tokens
@@ -176,30 +278,322 @@ void print_session_total(bool use_color,
   format_tokens(buf_total, sizeof(buf_total), total_tokens);
   format_tokens(buf_limit, sizeof(buf_limit), DEFAULT_TOKEN_LIMIT);
 
-  const struct color_theme *c = get_colors(use_color);
+  const struct color_theme *c = get_colors(ctx);
 
-  if (use_verbose) {
-    printf("%sSession   ", c->reset);
-    print_progress_bar(use_color,
+  if (ctx->use_verbose) {
+    sgr_puts(ctx, c->reset, "Session   ");
+    print_progress_bar(ctx,
+                       MCCS_BAR_SESSION,
                        percentage,
                        clamp,
                        c->progress_ses,
-                       use_color ? ANSI_CTX_EMPTY : NULL);
-    printf(" %7u%% (%s used / %s limit)\n", percentage, buf_total, buf_limit);
+                       ctx->use_color ? ANSI_CTX_EMPTY : NULL);
+    if (ctx->estimated_tokens) {
+      sgr_printf(ctx, c->reset, " %7u%% (%s%s used / %s limit, %s%u%%)", percentage, ESTIMATE_MARK, buf_total,
+                 buf_limit, ESTIMATE_ERROR_MARK, ctx->estimate_error_pct);
+    } else {
+      sgr_printf(ctx, c->reset, " %7u%% (%s used / %s limit%s)", percentage, buf_total, buf_limit,
+                 ctx->partial_tokens ? ", partial" : "");
+    }
+    sgr_end_line(ctx);
   } else {
-    printf("%sSes%s ", c->label, c->reset);
-    print_progress_bar(use_color,
+    sgr_puts(ctx, c->label, "Ses");
+    sgr_puts(ctx, c->reset, " ");
+    print_progress_bar(ctx,
+                       MCCS_BAR_SESSION,
                        percentage,
                        clamp,
                        c->progress_ses,
-                       use_color ? ANSI_CTX_EMPTY : NULL);
-    printf(" %s\n", buf_total);
+                       ctx->use_color ? ANSI_CTX_EMPTY : NULL);
+    if (ctx->estimated_tokens) {
+      sgr_printf(ctx, c->reset, " %s%s %s%u%%", ESTIMATE_MARK, buf_total, ESTIMATE_ERROR_MARK, ctx->estimate_error_pct);
+    } else {
+      sgr_printf(ctx, c->reset, " %s%s", buf_total, ctx->partial_tokens ? PARTIAL_MARK : "");
+    }
+    sgr_end_line(ctx);
+  }
+}
+
+void print_compaction_segment(struct mccs_render_ctx *ctx,
+                              uint32_t compactions,
+                              const struct token_counts *segment) {
+  if (compactions == 0) {
+    return;
+  }
+
+  char buf_segment[32];
+  format_tokens(buf_segment, sizeof(buf_segment), segment->total_tokens);
+
+  const struct color_theme *c = get_colors(ctx);
+
+  if (ctx->use_verbose) {
+    sgr_puts(ctx, c->reset, "Compacted ");
+    sgr_printf(ctx, c->reset, "%u %s, ", compactions, compactions == 1 ? "time" : "times");
+    sgr_puts(ctx, c->progress_ses, buf_segment);
+    sgr_puts(ctx, c->reset, " tokens since the last compaction");
+    sgr_end_line(ctx);
+  } else {
+    sgr_puts(ctx, c->label, "Cmp");
+    sgr_printf(ctx, c->reset, " #%u ", compactions);
+    sgr_puts(ctx, c->progress_ses, buf_segment);
+    sgr_puts(ctx, c->reset, " since");
+    sgr_end_line(ctx);
+  }
+}
+
+void print_turn_cost(struct mccs_render_ctx *ctx,
+                     const struct current_turn *turn,
+                     double cost_usd) {
+  if (!turn->started) {
+    return;
+  }
+
+  char buf_tokens[32];
+  format_tokens(buf_tokens, sizeof(buf_tokens), turn->tokens.total_tokens);
+
+  const struct color_theme *c = get_colors(ctx);
+
+  if (ctx->use_verbose) {
+    sgr_puts(ctx, c->reset, "This turn ");
+    sgr_puts(ctx, c->progress_ses, buf_tokens);
+    sgr_printf(ctx, c->reset, "%s tokens", ctx->partial_tokens ? PARTIAL_MARK : "");
+  } else {
+    sgr_puts(ctx, c->label, "Trn");
+    sgr_puts(ctx, c->reset, " ");
+    sgr_puts(ctx, c->progress_ses, buf_tokens);
+    sgr_puts(ctx, c->reset, ctx->partial_tokens ? PARTIAL_MARK : "");
+  }
+  if (!isnan(cost_usd)) {
+    sgr_puts(ctx, c->reset, " / ");
+    sgr_printf(ctx, c->cost, "$%.4f", cost_usd);
+  }
+  sgr_end_line(ctx);
+}
+
+/**
+ * Timeline cell shades by active eighth of the cell (any activity shows)
+ */
+static const char *const ACTIVITY_SHADES[] = {"▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+
+void print_activity(struct mccs_render_ctx *ctx,
+                    const struct activity_map *map) {
+  if (map->last_minute == 0) {
+    return;
+  }
+
+  const struct color_theme *c = get_colors(ctx);
+  const uint32_t cell_min = ACTIVITY_WINDOW_MIN / ACTIVITY_CELLS;
+  const uint32_t shades = sizeof(ACTIVITY_SHADES) / sizeof(ACTIVITY_SHADES[0]);
+
+  sgr_puts(ctx, c->label, ctx->use_verbose ? "Activity" : "Act");
+  sgr_puts(ctx, c->reset, " ");
+  int64_t start = map->last_minute - ACTIVITY_WINDOW_MIN + 1;
+  for (uint32_t i = 0; i < ACTIVITY_CELLS; i++) {
+    int64_t first = start + (int64_t)(i * cell_min);
+    uint32_t active = activity_count(map, first, first + cell_min - 1);
+    if (active == 0) {
+      sgr_puts(ctx, c->progress_empty, PROGRESS_BAR_EMPTY);
+    } else {
+      sgr_puts(ctx, c->time_api, ACTIVITY_SHADES[(active * shades - 1) / cell_min]);
+    }
+  }
+
+  uint32_t active = activity_count(map, start, map->last_minute);
+  uint32_t idle = (uint32_t)(map->last_minute - activity_first(map) + 1) - active;
+  sgr_printf(ctx, c->time_api, " %uh%02um", active / 60, active % 60);
+  sgr_printf(ctx, c->reset, "%s%uh%02um idle%s", ctx->use_verbose ? " active, " : "/", idle / 60, idle % 60,
+             ctx->partial_tokens ? PARTIAL_MARK : "");
+  sgr_end_line(ctx);
+}
+
+void print_api_errors(struct mccs_render_ctx *ctx,
+                      const struct api_error_state *errors) {
+  int64_t age = (int64_t)time(NULL) - errors->last_error;
+  if (errors->last_error <= 0 || age > API_ERROR_RECENT_S) {
+    return;
+  }
+  // Clock skew can put the error in the future
+  age = age > 0 ? age : 0;
+
+  const struct color_theme *c = get_colors(ctx);
+
+  if (ctx->use_verbose) {
+    sgr_puts(ctx, c->reset, "API errors ");
+  } else {
+    sgr_puts(ctx, c->label, "Err");
+    sgr_puts(ctx, c->reset, " ");
+  }
+  sgr_printf(ctx, c->badge_over, "%u", errors->failed);
+  sgr_puts(ctx, c->reset, " failed, ");
+  sgr_printf(ctx, c->badge_over, "%u", errors->retried);
+  sgr_puts(ctx, c->reset, ctx->use_verbose ? " retried, last " : " retried, ");
+  if (age < 60) {
+    sgr_printf(ctx, c->reset, "%lds ago", (long)age);
+  } else {
+    sgr_printf(ctx, c->reset, "%ldm ago", (long)(age / 60));
+  }
+  sgr_puts(ctx, c->reset, ctx->partial_tokens ? PARTIAL_MARK : "");
+  sgr_end_line(ctx);
+}
+
+void print_files_touched(struct mccs_render_ctx *ctx,
+                         const struct file_set *files) {
+  uint32_t edited = file_set_count(files, FILE_TOUCH_EDIT);
+  uint32_t read = file_set_count(files, FILE_TOUCH_READ);
+  if (edited == 0 && read == 0) {
+    return;
+  }
+
+  const struct color_theme *c = get_colors(ctx);
+  const char *mark = files->sketched ? ESTIMATE_MARK : "";
+
+  if (ctx->use_verbose) {
+    sgr_puts(ctx, c->reset, "Files touched ");
+  } else {
+    sgr_puts(ctx, c->label, "Files");
+    sgr_puts(ctx, c->reset, " ");
+  }
+  sgr_printf(ctx, c->lines_added, "%s%u", mark, edited);
+  sgr_puts(ctx, c->reset, ctx->use_verbose ? " edited, " : " edited / ");
+  sgr_printf(ctx, c->token_input, "%s%u", mark, read);
+  sgr_printf(ctx, c->reset, " read%s", ctx->partial_tokens ? PARTIAL_MARK : "");
+  sgr_end_line(ctx);
+}
+
+void print_context_mix(struct mccs_render_ctx *ctx,
+                       const struct branch_state *branch,
+                       uint64_t context_tokens) {
+  static const char *const names[CONTEXT_KINDS] = {"tool results", "assistant", "prompts", "attachments"};
+  static const char *const short_names[CONTEXT_KINDS] = {"tools", "asst", "user", "att"};
+  uint64_t tokens[CONTEXT_KINDS];
+  uint64_t known = 0;
+  for (size_t k = 0; k < CONTEXT_KINDS; k++) {
+    tokens[k] = branch->tip.context_bytes[k] / CONTEXT_BYTES_PER_TOKEN;
+    known += tokens[k];
+  }
+  if (known == 0) {
+    return;
+  }
+
+  // The rest of the context (system prompt, tool definitions) is not in the transcript;
+  // byte estimates beyond the real context are scaled down to it
+  uint64_t other = context_tokens > known ? context_tokens - known : 0;
+  if (context_tokens > 0 && context_tokens < known) {
+    for (size_t k = 0; k < CONTEXT_KINDS; k++) {
+      tokens[k] = (uint64_t)((double)tokens[k] * (double)context_tokens / (double)known);
+    }
+    known = context_tokens;
+  }
+  uint64_t total = known + other;
+
+  const struct color_theme *c = get_colors(ctx);
+  const char *const colors[CONTEXT_KINDS] = {c->token_cache_read, c->token_output, c->token_input,
+                                             c->token_cache_create};
+  // Cumulative rounding keeps the segments adding up to the share of the whole
+  uint32_t widths[CONTEXT_KINDS];
+  uint64_t cumulative = 0;
+  uint32_t drawn = 0;
+  for (size_t k = 0; k < CONTEXT_KINDS; k++) {
+    cumulative += tokens[k];
+    uint32_t end = (uint32_t)((cumulative * PROGRESS_BAR_WIDTH + total / 2) / total);
+    widths[k] = end - drawn;
+    drawn = end;
+  }
+
+  if (ctx->use_verbose) {
+    sgr_puts(ctx, c->reset, "Mix       ");
+    print_stacked_bar(ctx, widths, colors, CONTEXT_KINDS);
+    sgr_puts(ctx, c->reset, " (");
+  } else {
+    sgr_puts(ctx, c->label, "Mix");
+    sgr_puts(ctx, c->reset, " ");
+    print_stacked_bar(ctx, widths, colors, CONTEXT_KINDS);
   }
+  bool first = true;
+  for (size_t k = 0; k < CONTEXT_KINDS; k++) {
+    if (tokens[k] == 0) {
+      continue;
+    }
+    if (ctx->use_verbose) {
+      char buf_tokens[32];
+      format_tokens(buf_tokens, sizeof(buf_tokens), tokens[k]);
+      sgr_printf(ctx, c->reset, "%s", first ? "" : ", ");
+      sgr_puts(ctx, colors[k], buf_tokens);
+      sgr_printf(ctx, c->reset, " %s", names[k]);
+    } else {
+      uint32_t pct = (uint32_t)((tokens[k] * 100 + total / 2) / total);
+      if (pct == 0) {
+        continue;
+      }
+      sgr_printf(ctx, c->reset, " %s ", short_names[k]);
+      sgr_printf(ctx, colors[k], "%u%%", pct);
+    }
+    first = false;
+  }
+  if (ctx->use_verbose) {
+    if (other > 0) {
+      char buf_other[32];
+      format_tokens(buf_other, sizeof(buf_other), other);
+      sgr_printf(ctx, c->reset, ", %s other", buf_other);
+    }
+    sgr_printf(ctx, c->reset, "%s)", ctx->partial_tokens ? ", partial" : "");
+  } else {
+    sgr_puts(ctx, c->reset, ctx->partial_tokens ? PARTIAL_MARK : "");
+  }
+  sgr_end_line(ctx);
 }
 
-void print_cache_efficiency(bool use_color,
-                            bool use_verbose,
-                            const struct token_counts *tokens) {
+void print_abandoned_branches(struct mccs_render_ctx *ctx,
+                              const struct branch_state *branch) {
+  uint64_t abandoned = branch_abandoned_tokens(branch);
+  if (abandoned == 0) {
+    return;
+  }
+
+  const struct color_theme *c = get_colors(ctx);
+  char buf_tokens[32];
+  format_tokens(buf_tokens, sizeof(buf_tokens), abandoned);
+
+  if (ctx->use_verbose) {
+    sgr_puts(ctx, c->reset, "Abandoned branches ");
+  } else {
+    sgr_puts(ctx, c->label, "Abandoned");
+    sgr_puts(ctx, c->reset, " ");
+  }
+  sgr_puts(ctx, c->badge_over, buf_tokens);
+  sgr_printf(ctx, c->reset, "%s%u fork%s%s", ctx->use_verbose ? " tokens, " : " in ", branch->forks,
+             branch->forks == 1 ? "" : "s", ctx->partial_tokens ? PARTIAL_MARK : "");
+  sgr_end_line(ctx);
+}
+
+/**
+ * Append the prompt cache expiry countdown to the current line
+ */
+static void print_cache_expiry(struct mccs_render_ctx *ctx,
+                               const struct prompt_cache_state *prompt_cache) {
+  if (!prompt_cache || prompt_cache->last_touch <= 0) {
+    return;
+  }
+
+  const struct color_theme *c = get_colors(ctx);
+  int64_t left = prompt_cache->last_touch + (int64_t)prompt_cache->ttl_s - (int64_t)time(NULL);
+  if (left <= 0) {
+    sgr_puts(ctx, c->reset, ctx->use_verbose ? ", " : " ");
+    sgr_puts(ctx, c->badge_over, "expired");
+    return;
+  }
+
+  // Clock skew can put the last turn in the future: never show more than the TTL
+  if (left > (int64_t)prompt_cache->ttl_s) {
+    left = (int64_t)prompt_cache->ttl_s;
+  }
+  sgr_puts(ctx, c->reset, ctx->use_verbose ? ", expires in " : " exp ");
+  sgr_printf(ctx, c->progress_cache, "%ld:%02ld", (long)(left / 60), (long)(left % 60));
+}
+
+void print_cache_efficiency(struct mccs_render_ctx *ctx,
+                            const struct token_counts *tokens,
+                            const struct prompt_cache_state *prompt_cache) {
   if (!tokens) {
     return;
   }
@@ -231,29 +625,35 @@ void print_cache_efficiency(bool use_color,
   format_tokens(buf_read, sizeof(buf_read), cache_read);
   format_tokens(buf_total, sizeof(buf_total), cache_total);
 
-  const struct color_theme *c = get_colors(use_color);
+  const struct color_theme *c = get_colors(ctx);
 
-  if (use_verbose) {
-    printf("%sCache     ", c->reset);
-    print_progress_bar(use_color,
+  if (ctx->use_verbose) {
+    sgr_puts(ctx, c->reset, "Cache     ");
+    print_progress_bar(ctx,
+                       MCCS_BAR_CACHE,
                        percentage,
                        false,
                        c->progress_cache,
-                       use_color ? ANSI_CTX_EMPTY : NULL);
-    printf(" %7u%% (%s read / %s total)\n", percentage, buf_read, buf_total);
+                       ctx->use_color ? ANSI_CTX_EMPTY : NULL);
+    sgr_printf(ctx, c->reset, " %7u%% (%s read / %s total)", percentage, buf_read, buf_total);
+    print_cache_expiry(ctx, prompt_cache);
+    sgr_end_line(ctx);
   } else {
-    printf("%sCef%s ", c->label, c->reset);
-    print_progress_bar(use_color,
+    sgr_puts(ctx, c->label, "Cef");
+    sgr_puts(ctx, c->reset, " ");
+    print_progress_bar(ctx,
+                       MCCS_BAR_CACHE,
                        percentage,
                        false,
                        c->progress_cache,
-                       use_color ? ANSI_CTX_EMPTY : NULL);
-    printf(" %s/%s\n", buf_read, buf_total);
+                       ctx->use_color ? ANSI_CTX_EMPTY : NULL);
+    sgr_printf(ctx, c->reset, " %s/%s", buf_read, buf_total);
+    print_cache_expiry(ctx, prompt_cache);
+    sgr_end_line(ctx);
   }
 }
 
-void print_api_time_ratio(bool use_color,
-                          bool use_verbose,
+void print_api_time_ratio(struct mccs_render_ctx *ctx,
                           uint32_t api_ms,
                           uint32_t total_ms) {
   // Calculate percentage: API time / total time
@@ -270,29 +670,33 @@ void print_api_time_ratio(bool use_color,
   double api_s = api_ms / MS_PER_SECOND;
   double total_s = total_ms / MS_PER_SECOND;
 
-  const struct color_theme *c = get_colors(use_color);
+  const struct color_theme *c = get_colors(ctx);
 
-  if (use_verbose) {
-    printf("%sAPI Time  ", c->reset);
-    print_progress_bar(use_color,
+  if (ctx->use_verbose) {
+    sgr_puts(ctx, c->reset, "API Time  ");
+    print_progress_bar(ctx,
+                       MCCS_BAR_API_TIME,
                        percentage,
                        false,
                        c->progress_api_time,
-                       use_color ? ANSI_CTX_EMPTY : NULL);
-    printf(" %7u%% (%.1fs API / %.1fs total)\n", percentage, api_s, total_s);
+                       ctx->use_color ? ANSI_CTX_EMPTY : NULL);
+    sgr_printf(ctx, c->reset, " %7u%% (%.1fs API / %.1fs total)", percentage, api_s, total_s);
+    sgr_end_line(ctx);
   } else {
-    printf("%sAPI%s ", c->label, c->reset);
-    print_progress_bar(use_color,
+    sgr_puts(ctx, c->label, "API");
+    sgr_puts(ctx, c->reset, " ");
+    print_progress_bar(ctx,
+                       MCCS_BAR_API_TIME,
                        percentage,
                        false,
                        c->progress_api_time,
-                       use_color ? ANSI_CTX_EMPTY : NULL);
-    printf(" %.1fs/%.1fs\n", api_s, total_s);
+                       ctx->use_color ? ANSI_CTX_EMPTY : NULL);
+    sgr_printf(ctx, c->reset, " %.1fs/%.1fs", api_s, total_s);
+    sgr_end_line(ctx);
   }
 }
 
-void print_lines_ratio(bool use_color,
-                       bool use_verbose,
+void print_lines_ratio(struct mccs_render_ctx *ctx,
                        uint32_t added,
                        uint32_t removed) {
   const uint32_t bar_width = PROGRESS_BAR_WIDTH;
@@ -332,35 +736,24 @@ void print_lines_ratio(bool use_color,
     removed_width = bar_width - added_width;
   }
 
-  const struct color_theme *c = get_colors(use_color);
+  const struct color_theme *c = get_colors(ctx);
 
-  if (use_verbose) {
-    printf("%sLines    %s [%s", c->reset, c->reset, c->lines_added);
-    for (uint32_t i = 0; i < added_width; i++) {
-      printf(PROGRESS_BAR_FILLED);
-    }
-    printf("%s", c->lines_removed);
-    for (uint32_t i = 0; i < removed_width; i++) {
-      printf(PROGRESS_BAR_FILLED);
-    }
-    printf("%s] %3u%%/%u%% (%" PRIu32 " added / %" PRIu32 " removed)\n",
-           c->reset, added_pct, removed_pct, added, removed);
+  if (ctx->use_verbose) {
+    sgr_puts(ctx, c->reset, "Lines     ");
+    print_split_bar(ctx, added_width, c->lines_added, removed_width, c->lines_removed);
+    sgr_printf(ctx, c->reset, " %3u%%/%u%% (%" PRIu32 " added / %" PRIu32 " removed)",
+               added_pct, removed_pct, added, removed);
+    sgr_end_line(ctx);
   } else {
-    printf("%sLin%s [%s", c->label, c->reset, c->lines_added);
-    for (uint32_t i = 0; i < added_width; i++) {
-      printf(PROGRESS_BAR_FILLED);
-    }
-    printf("%s", c->lines_removed);
-    for (uint32_t i = 0; i < removed_width; i++) {
-      printf(PROGRESS_BAR_FILLED);
-    }
-    printf("%s] +%" PRIu32 "/-%" PRIu32 "\n",
-           c->reset, added, removed);
+    sgr_puts(ctx, c->label, "Lin");
+    sgr_puts(ctx, c->reset, " ");
+    print_split_bar(ctx, added_width, c->lines_added, removed_width, c->lines_removed);
+    sgr_printf(ctx, c->reset, " +%" PRIu32 "/-%" PRIu32, added, removed);
+    sgr_end_line(ctx);
   }
 }
 
-void print_input_output_ratio(bool use_color,
-                              bool use_verbose,
+void print_input_output_ratio(struct mccs_render_ctx *ctx,
                               const struct token_counts *tokens) {
   if (!tokens) {
     return;
@@ -410,34 +803,23 @@ void print_input_output_ratio(bool use_color,
   format_tokens(buf_input, sizeof(buf_input), input);
   format_tokens(buf_output, sizeof(buf_output), output);
 
-  const struct color_theme *c = get_colors(use_color);
+  const struct color_theme *c = get_colors(ctx);
 
-  if (use_verbose) {
-    printf("%sTokens IO%s [%s", c->reset, c->reset, c->token_input);
-    for (uint32_t i = 0; i < input_width; i++) {
-      printf(PROGRESS_BAR_FILLED);
-    }
-    printf("%s", c->token_output);
-    for (uint32_t i = 0; i < output_width; i++) {
-      printf(PROGRESS_BAR_FILLED);
-    }
-    printf("%s] %3u%%/%u%% (%s input / %s output)\n",
-           c->reset, input_pct, output_pct, buf_input, buf_output);
+  if (ctx->use_verbose) {
+    sgr_puts(ctx, c->reset, "Tokens IO ");
+    print_split_bar(ctx, input_width, c->token_input, output_width, c->token_output);
+    sgr_printf(ctx, c->reset, " %3u%%/%u%% (%s input / %s output)", input_pct, output_pct, buf_input, buf_output);
+    sgr_end_line(ctx);
   } else {
-    printf("%sTIO%s [%s", c->label, c->reset, c->token_input);
-    for (uint32_t i = 0; i < input_width; i++) {
-      printf(PROGRESS_BAR_FILLED);
-    }
-    printf("%s", c->token_output);
-    for (uint32_t i = 0; i < output_width; i++) {
-      printf(PROGRESS_BAR_FILLED);
-    }
-    printf("%s] %s/%s\n", c->reset, buf_input, buf_output);
+    sgr_puts(ctx, c->label, "TIO");
+    sgr_puts(ctx, c->reset, " ");
+    print_split_bar(ctx, input_width, c->token_input, output_width, c->token_output);
+    sgr_printf(ctx, c->reset, " %s/%s", buf_input, buf_output);
+    sgr_end_line(ctx);
   }
 }
 
-void print_cache_write_read_ratio(bool use_color,
-                                  bool use_verbose,
+void print_cache_write_read_ratio(struct mccs_render_ctx *ctx,
                                   const struct token_counts *tokens) {
   if (!tokens) {
     return;
@@ -487,34 +869,66 @@ void print_cache_write_read_ratio(bool use_color,
   format_tokens(buf_write, sizeof(buf_write), cache_write);
   format_tokens(buf_read, sizeof(buf_read), cache_read);
 
-  const struct color_theme *c = get_colors(use_color);
+  const struct color_theme *c = get_colors(ctx);
 
-  if (use_verbose) {
-    printf("%sCache RW %s [%s", c->reset, c->reset, c->token_cache_create);
-    for (uint32_t i = 0; i < write_width; i++) {
-      printf(PROGRESS_BAR_FILLED);
-    }
-    printf("%s", c->token_cache_read);
-    for (uint32_t i = 0; i < read_width; i++) {
-      printf(PROGRESS_BAR_FILLED);
-    }
-    printf("%s] %3u%%/%u%% (%s write / %s read)\n",
-           c->reset, write_pct, read_pct, buf_write, buf_read);
+  if (ctx->use_verbose) {
+    sgr_puts(ctx, c->reset, "Cache RW  ");
+    print_split_bar(ctx, write_width, c->token_cache_create, read_width, c->token_cache_read);
+    sgr_printf(ctx, c->reset, " %3u%%/%u%% (%s write / %s read)", write_pct, read_pct, buf_write, buf_read);
+    sgr_end_line(ctx);
   } else {
-    printf("%sCWR%s [%s", c->label, c->reset, c->token_cache_create);
-    for (uint32_t i = 0; i < write_width; i++) {
-      printf(PROGRESS_BAR_FILLED);
-    }
-    printf("%s", c->token_cache_read);
-    for (uint32_t i = 0; i < read_width; i++) {
-      printf(PROGRESS_BAR_FILLED);
-    }
-    printf("%s] %s/%s\n", c->reset, buf_write, buf_read);
+    sgr_puts(ctx, c->label, "CWR");
+    sgr_puts(ctx, c->reset, " ");
+    print_split_bar(ctx, write_width, c->token_cache_create, read_width, c->token_cache_read);
+    sgr_printf(ctx, c->reset, " %s/%s", buf_write, buf_read);
+    sgr_end_line(ctx);
   }
 }
 
-void print_mccs_status_line(bool use_color,
-                            bool use_verbose,
+/**
+ * Print a status line separator and, in verbose mode, the field label
+ *
+ * @param ctx      Render context
+ * @param sep      Separator printed before the field (NULL for none)
+ * @param label    Field label shown in verbose mode (without the colon)
+ * @param style    ANSI color code for the value
+ * @param value    Value text, or NULL if the caller prints the value itself
+ */
+static void print_status_field(struct mccs_render_ctx *ctx,
+                               const char *sep,
+                               const char *label,
+                               const char *style,
+                               const char *value) {
+  const struct color_theme *c = get_colors(ctx);
+
+  if (sep) {
+    sgr_puts(ctx, c->reset, sep);
+  }
+  if (ctx->use_verbose) {
+    sgr_printf(ctx, c->label, "%s: ", label);
+  }
+  if (value) {
+    sgr_puts(ctx, style, value);
+  }
+}
+
+/**
+ * Print the leading "Model: name (id)" field of the status line
+ *
+ * @param ctx     Render context
+ * @param refs    Status string references
+ */
+static void print_status_model(struct mccs_render_ctx *ctx,
+                               const struct mccs_string_refs *refs) {
+  const struct color_theme *c = get_colors(ctx);
+
+  print_status_field(ctx, NULL, "Model", c->model_name, refs->model_name);
+  sgr_puts(ctx, c->reset, " (");
+  sgr_puts(ctx, c->model_id, refs->model_id);
+  sgr_puts(ctx, c->reset, ")");
+}
+
+void print_mccs_status_line(struct mccs_render_ctx *ctx,
                             const struct mccs_status *status,
                             bool simple) {
   if (!status) {
@@ -528,7 +942,7 @@ void print_mccs_status_line(bool use_color,
   char cwd_copy[BUF_PATH_SIZE];
   char proj_copy[BUF_PATH_SIZE];
 
-  const struct color_theme *c = get_colors(use_color);
+  const struct color_theme *c = get_colors(ctx);
 
   // Calculate cost early so it's available for simple mode
   double cost = isnan(counters->cost_usd) ? ZERO_VALUE : counters->cost_usd;
@@ -538,32 +952,15 @@ void print_mccs_status_line(bool use_color,
     const char *cwd_display = refs->cwd;
     if (refs->cwd == buffers->buf_cwd) {
       (void)snprintf(cwd_copy, sizeof(cwd_copy), "%s", buffers->buf_cwd);
-      cwd_display = mccs_extract_basename(cwd_copy);
+      cwd_display = mccs_directory_display(cwd_copy, status->cwd_root_len);
     }
 
-    if (use_verbose) {
-      printf("%s%sModel:%s %s%s%s (%s%s%s) %s|%s %sVersion:%s %s%s%s %s|%s %sCost:%s %s$%.4f%s %s|%s %sDirectory:%s %s%s%s\n",
-             c->reset, c->reset, c->reset,
-             c->model_name, refs->model_name, c->reset,
-             c->model_id, refs->model_id, c->reset,
-             c->reset, c->reset,
-             c->reset, c->reset,
-             c->version, refs->version, c->reset,
-             c->reset, c->reset,
-             c->reset, c->reset,
-             c->cost, cost, c->reset,
-             c->reset, c->reset,
-             c->reset, c->reset,
-             c->dir, cwd_display, c->reset);
-    } else {
-      printf("%s%s%s%s (%s%s%s) | %s%s%s | %s$%.4f%s | %s%s%s\n",
-             c->reset,
-             c->model_name, refs->model_name, c->reset,
-             c->model_id, refs->model_id, c->reset,
-             c->version, refs->version, c->reset,
-             c->cost, cost, c->reset,
-             c->dir, cwd_display, c->reset);
-    }
+    print_status_model(ctx, refs);
+    print_status_field(ctx, " | ", "Version", c->version, refs->version);
+    print_status_field(ctx, " | ", "Cost", c->cost, NULL);
+    sgr_printf(ctx, c->cost, "$%.4f", cost);
+    print_status_field(ctx, " | ", "Directory", c->dir, cwd_display);
+    sgr_end_line(ctx);
     return;
   }
 
@@ -581,7 +978,7 @@ void print_mccs_status_line(bool use_color,
                    sizeof(cwd_copy),
                    "%s",
                    buffers->buf_cwd);
-    cwd_display = mccs_extract_basename(cwd_copy);
+    cwd_display = mccs_directory_display(cwd_copy, status->cwd_root_len);
   }
 
   if (refs->project_dir == buffers->buf_project) {
@@ -592,96 +989,102 @@ void print_mccs_status_line(bool use_color,
     proj_display = mccs_extract_basename(proj_copy);
   }
 
-  printf("%s", c->reset);
-
   const char *badge_text = counters->exceeds_200k_tokens ? ">200k" : "<200k";
   const char *c_badge = counters->exceeds_200k_tokens ? c->badge_over : c->badge_under;
 
-  if (strcmp(cwd_display, proj_display) == 0) {
-    if (use_verbose) {
-      printf(FMT_STATUS_COMPACT_VERBOSE,
-             c->reset,                                  // initial reset
-             c->reset, c->reset,                        // "Model:" label
-             c->model_name, refs->model_name, c->reset, // model name value
-             c->model_id, refs->model_id, c->reset,     // model id value
-             c->reset, c->reset,                        // separator "|"
-             c->reset, c->reset,                        // "Version:" label
-             c->version, refs->version, c->reset,       // version value
-             c->reset, c->reset,                        // separator "|"
-             c->reset, c->reset,                        // "Directory:" label
-             c->dir, cwd_display, c->reset,             // directory value
-             c->reset, c->reset,                        // separator "|"
-             c->reset, c->reset,                        // "Cost:" label
-             c->cost, cost, c->reset,                   // cost value
-             c->reset, c->reset,                        // "Tokens:" label
-             c_badge, badge_text, c->reset,             // badge value
-             c->reset, c->reset,                        // separator "|"
-             c->reset, c->reset,                        // "Total:" label
-             c->time_total, dur_s, c->reset,            // total time value
-             c->reset, c->reset,                        // "API:" label
-             c->time_api, api_s, c->reset,              // API time value
-             c->reset, c->reset,                        // separator "|"
-             c->reset, c->reset,                        // "Lines:" label
-             c->lines_added, added, c->reset,           // lines added value
-             c->lines_removed, removed, c->reset);      // lines removed value
+  print_status_model(ctx, refs);
+  print_status_field(ctx, " | ", "Version", c->version, refs->version);
+  print_status_field(ctx, " | ", "Directory", c->dir, cwd_display);
+  // Inside a repository the directory starts with the repository name
+  size_t repo_name_len = cwd_display[0] == '/' ? strlen(cwd_display) : strcspn(cwd_display, "/");
+  if (strlen(proj_display) != repo_name_len ||
+      strncmp(cwd_display, proj_display, repo_name_len) != 0) {
+    print_status_field(ctx, " | ", "Project", c->dir, proj_display);
+  }
+  print_status_field(ctx, " | ", "Cost", c->cost, NULL);
+  sgr_printf(ctx, c->cost, "$%.4f", cost);
+  print_status_field(ctx, " ", "Tokens", c_badge, badge_text);
+  print_status_field(ctx, " | ", "Total", c->time_total, NULL);
+  sgr_printf(ctx, c->time_total, "%.1fs", dur_s);
+  print_status_field(ctx, " ", "API", c->time_api, NULL);
+  sgr_printf(ctx, c->time_api, "%.1fs", api_s);
+  print_status_field(ctx, " | ", "Lines", c->lines_added, NULL);
+  sgr_printf(ctx, c->lines_added, "+%" PRIu32, added);
+  sgr_puts(ctx, c->reset, "/");
+  sgr_printf(ctx, c->lines_removed, "-%" PRIu32, removed);
+  sgr_end_line(ctx);
+}
+
+void print_top_turns(struct mccs_render_ctx *ctx,
+                     const struct top_turns *turns) {
+  struct turn_record sorted[TOP_TURNS_CAPACITY];
+  size_t n = turns ? top_turns_sorted(turns, sorted) : 0;
+  if (n == 0) {
+    return;
+  }
+
+  const struct color_theme *c = get_colors(ctx);
+
+  if (ctx->use_verbose) {
+    sgr_puts(ctx, c->reset, "Top turns:");
+  } else {
+    sgr_puts(ctx, c->label, "Top");
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    char buf_total[32];
+    char buf_time[16] = "";
+    format_tokens(buf_total, sizeof(buf_total), sorted[i].tokens.total_tokens);
+
+    time_t t = (time_t)sorted[i].timestamp;
+    struct tm tm;
+    if (sorted[i].timestamp > 0 && localtime_r(&t, &tm)) {
+      strftime(buf_time, sizeof(buf_time), ctx->use_verbose ? "%H:%M:%S" : "%H:%M", &tm);
+    }
+
+    const char *sep = i == 0 ? " " : "  ";
+    if (ctx->use_verbose) {
+      sgr_printf(ctx, c->reset, "%s#%zu ", sep, i + 1);
     } else {
-      printf(FMT_STATUS_COMPACT_PLAIN,
-             c->reset,                                  // initial reset
-             c->model_name, refs->model_name, c->reset, // model name value
-             c->model_id, refs->model_id, c->reset,     // model id value
-             c->version, refs->version, c->reset,       // version value
-             c->dir, cwd_display, c->reset,             // directory value
-             c->cost, cost, c->reset,                   // cost value
-             c_badge, badge_text, c->reset,             // badge value
-             c->time_total, dur_s, c->reset,            // total time value
-             c->time_api, api_s, c->reset,              // API time value
-             c->lines_added, added, c->reset,           // lines added value
-             c->lines_removed, removed, c->reset);      // lines removed value
+      sgr_puts(ctx, c->reset, sep);
     }
-  } else {
-    if (use_verbose) {
-      printf(FMT_STATUS_EXTENDED_VERBOSE,
-             c->reset,                                  // initial reset
-             c->reset, c->reset,                        // "Model:" label
-             c->model_name, refs->model_name, c->reset, // model name value
-             c->model_id, refs->model_id, c->reset,     // model id value
-             c->reset, c->reset,                        // separator "|"
-             c->reset, c->reset,                        // "Version:" label
-             c->version, refs->version, c->reset,       // version value
-             c->reset, c->reset,                        // separator "|"
-             c->reset, c->reset,                        // "Directory:" label
-             c->dir, cwd_display, c->reset,             // directory value
-             c->reset, c->reset,                        // separator "|"
-             c->reset, c->reset,                        // "Project:" label
-             c->dir, proj_display, c->reset,            // project value
-             c->reset, c->reset,                        // separator "|"
-             c->reset, c->reset,                        // "Cost:" label
-             c->cost, cost, c->reset,                   // cost value
-             c->reset, c->reset,                        // "Tokens:" label
-             c_badge, badge_text, c->reset,             // badge value
-             c->reset, c->reset,                        // separator "|"
-             c->reset, c->reset,                        // "Total:" label
-             c->time_total, dur_s, c->reset,            // total time value
-             c->reset, c->reset,                        // "API:" label
-             c->time_api, api_s, c->reset,              // API time value
-             c->reset, c->reset,                        // separator "|"
-             c->reset, c->reset,                        // "Lines:" label
-             c->lines_added, added, c->reset,           // lines added value
-             c->lines_removed, removed, c->reset);      // lines removed value
+    sgr_puts(ctx, c->token_output, buf_total);
+    if (buf_time[0]) {
+      sgr_puts(ctx, c->reset, ctx->use_verbose ? " at " : " ");
+      sgr_puts(ctx, c->time_api, buf_time);
+    }
+  }
+  sgr_end_line(ctx);
+}
+
+void print_top_turns_json(struct mccs_render_ctx *ctx,
+                          const struct top_turns *turns) {
+  struct turn_record sorted[TOP_TURNS_CAPACITY];
+  size_t n = turns ? top_turns_sorted(turns, sorted) : 0;
+
+  fputs("{\"top_turns\":[", ctx->out);
+  for (size_t i = 0; i < n; i++) {
+    const struct turn_record *r = &sorted[i];
+    char buf_time[32] = "";
+    time_t t = (time_t)r->timestamp;
+    struct tm tm;
+    if (r->timestamp > 0 && gmtime_r(&t, &tm)) {
+      strftime(buf_time, sizeof(buf_time), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    }
+
+    fprintf(ctx->out, "%s{\"offset\":%" PRIu64 ",", i == 0 ? "" : ",", r->offset);
+    if (buf_time[0]) {
+      fprintf(ctx->out, "\"timestamp\":\"%s\",", buf_time);
     } else {
-      printf(FMT_STATUS_EXTENDED_PLAIN,
-             c->reset,                                  // initial reset
-             c->model_name, refs->model_name, c->reset, // model name value
-             c->model_id, refs->model_id, c->reset,     // model id value
-             c->version, refs->version, c->reset,       // version value
-             c->dir, cwd_display, c->reset,             // directory value
-             c->dir, proj_display, c->reset,            // project value
-             c->cost, cost, c->reset,                   // cost value
-             c_badge, badge_text, c->reset,             // badge value
-             c->time_total, dur_s, c->reset,            // total time value
-             c->time_api, api_s, c->reset,              // API time value
-             c->lines_added, added, c->reset,           // lines added value
-             c->lines_removed, removed, c->reset);      // lines removed value
+      fputs("\"timestamp\":null,", ctx->out);
     }
+    fprintf(ctx->out,
+            "\"input_tokens\":%" PRIu64 ",\"output_tokens\":%" PRIu64
+            ",\"cache_creation_tokens\":%" PRIu64 ",\"cache_read_tokens\":%" PRIu64
+            ",\"total_tokens\":%" PRIu64 "}",
+            r->tokens.input_tokens, r->tokens.output_tokens,
+            r->tokens.cache_creation_tokens, r->tokens.cache_read_tokens,
+            r->tokens.total_tokens);
   }
+  fputs("]}\n", ctx->out);
 }
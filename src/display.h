@@ -15,89 +15,188 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "render_ctx.h"
 #include "types_struct.h"
 
 /**
  * Print detailed token breakdown by category
  *
- * @param use_color    Whether to use ANSI colors
- * @param use_verbose  Whether to use long label names
+ * @param ctx          Render context (colors, verbosity, output stream)
  * @param tokens       Token counts to display
  *
  * @note Output format (non-verbose): In: X.XK  Out: X.XK  CaWr: X.XK  CaRd: X.XK
  * @note Output format (verbose): Input: X.XK  Output: X.XK  Cache Write: X.XK  Cache Read: X.XK
+ * @note Estimated values (ctx->estimated_tokens) are prefixed with ESTIMATE_MARK
  */
-void print_token_breakdown(bool use_color,
-                           bool use_verbose,
+void print_token_breakdown(struct mccs_render_ctx *ctx,
                            const struct token_counts *tokens);
 
 /**
  * Print context window usage with progress bar
  *
- * @param use_color       Whether to use ANSI colors
- * @param use_verbose     Whether to show verbose labels and percentage
+ * @param ctx             Render context (colors, verbosity, output stream)
  * @param context_tokens  Current context token count
  * @param clamp           If true, cap percentage display at 100%
  *
  * @note Output format: Ctx: [████░░░░] X.XK/200K (verbose OFF)
  * @note Output format: Context: [████░░░░] X% (X.XM used / 200K limit) (verbose ON)
  */
-void print_context_percentage(bool use_color,
-                              bool use_verbose,
+void print_context_percentage(struct mccs_render_ctx *ctx,
                               uint64_t context_tokens,
                               bool clamp);
 
 /**
  * Print session total token usage with progress bar
  *
- * @param use_color     Whether to use ANSI colors
- * @param use_verbose   Whether to show verbose labels and percentage
+ * @param ctx           Render context (colors, verbosity, output stream)
  * @param total_tokens  Total session token count
  * @param clamp         If true, cap percentage display at 100%
  *
  * @note Output format: Ses: [████░░░░] X.XK/200K (verbose OFF)
  * @note Output format: Session: [████░░░░] X% (X.XM used / 200K limit) (verbose ON)
+ * @note Estimates (ctx->estimated_tokens): "~X.XM ±N%" and "(~X.XM used / 200K limit, ±N%)"
  */
-void print_session_total(bool use_color,
-                         bool use_verbose,
+void print_session_total(struct mccs_render_ctx *ctx,
                          uint64_t total_tokens,
                          bool clamp);
 
+/**
+ * Print the tokens used since the last conversation compaction
+ *
+ * @param ctx            Render context (colors, verbosity, output stream)
+ * @param compactions    Compaction boundaries seen in the transcript
+ * @param segment        Token counts since the last compaction
+ *
+ * @note Nothing is printed until the session has been compacted once
+ * @note Output format: Cmp: #N X.XK since (verbose OFF)
+ * @note Output format: Compacted: N times, X.XK tokens since the last compaction (verbose ON)
+ */
+void print_compaction_segment(struct mccs_render_ctx *ctx,
+                              uint32_t compactions,
+                              const struct token_counts *segment);
+
+/**
+ * Print what the request in progress has cost so far
+ *
+ * @param ctx         Render context (colors, verbosity, output stream)
+ * @param turn        Prompt of the request and the usage since
+ * @param cost_usd    Session cost since the prompt (NaN if unknown: tokens only)
+ *
+ * @note Nothing is printed before the first user prompt
+ * @note Output format: Trn: X.XK / $X.XXXX (verbose OFF)
+ * @note Output format: This turn: X.XK tokens / $X.XXXX (verbose ON)
+ */
+void print_turn_cost(struct mccs_render_ctx *ctx,
+                     const struct current_turn *turn,
+                     double cost_usd);
+
+/**
+ * Print the session activity timeline with active and idle time
+ *
+ * @param ctx    Render context (colors, verbosity, output stream)
+ * @param map    Minutes with assistant turns
+ *
+ * @note The timeline ends at the latest active minute; each of its
+ *       ACTIVITY_CELLS cells shades how many of its minutes were active
+ * @note Idle time counts the inactive minutes since the first active one
+ *       still inside the window
+ * @note Output format: Act ░░▁▄█▆ 1h12m/0h25m idle (verbose OFF)
+ * @note Output format: Activity ░░▁▄█▆ 1h12m active, 0h25m idle (verbose ON)
+ */
+void print_activity(struct mccs_render_ctx *ctx,
+                    const struct activity_map *map);
+
+/**
+ * Print failed and retried API requests if one happened recently
+ *
+ * @param ctx       Render context (colors, verbosity, output stream)
+ * @param errors    Error counts of the session
+ *
+ * @note Nothing is printed more than API_ERROR_RECENT_S after the last error
+ * @note Output format: Err 1 failed, 4 retried, 3m ago (verbose OFF)
+ * @note Output format: API errors 1 failed, 4 retried, last 3m ago (verbose ON)
+ */
+void print_api_errors(struct mccs_render_ctx *ctx,
+                      const struct api_error_state *errors);
+
+/**
+ * Print how many distinct files the session read and edited
+ *
+ * @param ctx      Render context (colors, verbosity, output stream)
+ * @param files    Files touched by tool calls
+ *
+ * @note Nothing is printed before the first file tool call
+ * @note Counts past the exact set are estimates, marked with ESTIMATE_MARK
+ * @note Output format: Files 4 edited / 12 read (verbose OFF)
+ * @note Output format: Files touched 4 edited, 12 read (verbose ON)
+ */
+void print_files_touched(struct mccs_render_ctx *ctx,
+                         const struct file_set *files);
+
+/**
+ * Print what fills the context window, as a stacked bar by entry content
+ *
+ * @param ctx               Render context (colors, verbosity, output stream)
+ * @param branch            Branch state of the session (composition at its tip)
+ * @param context_tokens    Context tokens of the last assistant turn (0 if unknown)
+ *
+ * @note Each kind's tokens are its raw bytes since the last compaction over
+ *       CONTEXT_BYTES_PER_TOKEN, scaled down if they exceed the context; the
+ *       rest of the context (system prompt, tools) is left empty in the bar
+ * @note Nothing is printed before the first content on the active branch
+ * @note Output format: Mix [███▓▓░░] tools 52% asst 18% user 6% att 4% (verbose OFF)
+ * @note Output format: Mix       [███▓▓░░] (47.1K tool results, ..., 18.1K other) (verbose ON)
+ */
+void print_context_mix(struct mccs_render_ctx *ctx,
+                       const struct branch_state *branch,
+                       uint64_t context_tokens);
+
+/**
+ * Print the tokens spent on branches left by rewinds and edited prompts
+ *
+ * @param ctx       Render context (colors, verbosity, output stream)
+ * @param branch    Branch state of the session
+ *
+ * @note Nothing is printed while no tokens were spent off the active branch
+ * @note Output format: Abandoned 12.3K in 2 forks (verbose OFF)
+ * @note Output format: Abandoned branches 12.3K tokens, 2 forks (verbose ON)
+ */
+void print_abandoned_branches(struct mccs_render_ctx *ctx,
+                              const struct branch_state *branch);
+
 /**
  * Print cache efficiency with progress bar
  *
- * @param use_color    Whether to use ANSI colors
- * @param use_verbose  Whether to show verbose labels and percentage
- * @param tokens       Token counts containing cache read and creation
+ * @param ctx            Render context (colors, verbosity, output stream)
+ * @param tokens         Token counts containing cache read and creation
+ * @param prompt_cache   Last prompt cache activity for the expiry countdown (may be NULL)
  *
- * @note Output format: Cef: [████░░░░] X.XM/X.XM (verbose OFF)
- * @note Output format: Cache: [████░░░░] X% (X.XM read / X.XM total) (verbose ON)
+ * @note Output format: Cef: [████░░░░] X.XM/X.XM exp M:SS (verbose OFF)
+ * @note Output format: Cache: [████░░░░] X% (X.XM read / X.XM total), expires in M:SS (verbose ON)
  * @note Percentage shows cache_read / (cache_read + cache_creation)
+ * @note The countdown is last_touch + ttl_s - now: O(1), no transcript access
  */
-void print_cache_efficiency(bool use_color,
-                            bool use_verbose,
-                            const struct token_counts *tokens);
+void print_cache_efficiency(struct mccs_render_ctx *ctx,
+                            const struct token_counts *tokens,
+                            const struct prompt_cache_state *prompt_cache);
 
 /**
  * Print the main status line with all session information
  *
- * @param use_color    Whether to use ANSI colors
- * @param use_verbose  Whether to show field labels
+ * @param ctx          Render context (colors, verbosity, output stream)
  * @param status       Pointer to loaded status structure
  * @param simple       Whether to show simplified status line (Model/Version/Directory only)
  *
- * @note Format selected based on use_verbose flag and cwd==project_dir comparison.
+ * @note Format selected based on ctx->use_verbose and cwd==project_dir comparison.
  */
-void print_mccs_status_line(bool use_color,
-                            bool use_verbose,
+void print_mccs_status_line(struct mccs_render_ctx *ctx,
                             const struct mccs_status *status,
                             bool simple);
 
 /**
  * Print API time vs total time ratio with progress bar
  *
- * @param use_color    Whether to use ANSI colors
- * @param use_verbose  Whether to show verbose labels and percentage
+ * @param ctx          Render context (colors, verbosity, output stream)
  * @param api_ms       API time in milliseconds
  * @param total_ms     Total time in milliseconds
  *
@@ -105,16 +204,14 @@ void print_mccs_status_line(bool use_color,
  * @note Output format: API Time: [████░░░░]  45% (2.3s API / 5.1s total) (verbose ON)
  * @note Percentage shows api_ms / total_ms
  */
-void print_api_time_ratio(bool use_color,
-                          bool use_verbose,
+void print_api_time_ratio(struct mccs_render_ctx *ctx,
                           uint32_t api_ms,
                           uint32_t total_ms);
 
 /**
  * Print lines added vs removed ratio with dual-color progress bar
  *
- * @param use_color    Whether to use ANSI colors
- * @param use_verbose  Whether to show verbose labels and percentage
+ * @param ctx          Render context (colors, verbosity, output stream)
  * @param added        Number of lines added
  * @param removed      Number of lines removed
  *
@@ -122,39 +219,60 @@ void print_api_time_ratio(bool use_color,
  * @note Output format: Lines:    [████████████]  75%/25% (150 added / 50 removed) (verbose ON)
  * @note Bar shows proportions: added (green) and removed (red) segments
  */
-void print_lines_ratio(bool use_color,
-                       bool use_verbose,
+void print_lines_ratio(struct mccs_render_ctx *ctx,
                        uint32_t added,
                        uint32_t removed);
 
 /**
  * Print input vs output tokens ratio with dual-color progress bar
  *
- * @param use_color    Whether to use ANSI colors
- * @param use_verbose  Whether to show verbose labels and percentage
+ * @param ctx          Render context (colors, verbosity, output stream)
  * @param tokens       Token counts containing input and output tokens
  *
  * @note Output format: Tio: [████████░░░░░░░░░░░░] 4.5K/1.9K (verbose OFF)
  * @note Output format: Tokens IO:[████████░░░░░░░░░░░░]  70%/30% (4.5K input / 1.9K output) (verbose ON)
  * @note Bar shows proportions: input (cyan) and output (green) segments
  */
-void print_input_output_ratio(bool use_color,
-                              bool use_verbose,
+void print_input_output_ratio(struct mccs_render_ctx *ctx,
                               const struct token_counts *tokens);
 
 /**
  * Print cache write vs read tokens ratio with dual-color progress bar
  *
- * @param use_color    Whether to use ANSI colors
- * @param use_verbose  Whether to show verbose labels and percentage
+ * @param ctx          Render context (colors, verbosity, output stream)
  * @param tokens       Token counts containing cache creation and read tokens
  *
  * @note Output format: Cwr: [████████████████░░░░] 3.5K/800 (verbose OFF)
  * @note Output format: Cache RW: [████████████████░░░░]  81%/19% (3.5K write / 800 read) (verbose ON)
  * @note Bar shows proportions: cache write (yellow) and cache read (orchid) segments
  */
-void print_cache_write_read_ratio(bool use_color,
-                                  bool use_verbose,
+void print_cache_write_read_ratio(struct mccs_render_ctx *ctx,
                                   const struct token_counts *tokens);
 
+/**
+ * Print the most expensive turns of the session
+ *
+ * @param ctx      Render context (colors, verbosity, output stream)
+ * @param turns    Top-turns heap
+ *
+ * @note Output format: Top 12.3K 10:02  8.1K 09:55 ... (verbose OFF)
+ * @note Output format: Top turns: #1 12.3K at 10:02:01  #2 ... (verbose ON)
+ * @note Times are shown in local time; hidden if the heap is empty.
+ */
+void print_top_turns(struct mccs_render_ctx *ctx,
+                     const struct top_turns *turns);
+
+/**
+ * Print the most expensive turns as a single JSON line
+ *
+ * @param ctx      Render context (output stream)
+ * @param turns    Top-turns heap (NULL prints an empty list)
+ *
+ * @note Format: {"top_turns":[{"offset":N,"timestamp":"...Z","input_tokens":N,
+ *       "output_tokens":N,"cache_creation_tokens":N,"cache_read_tokens":N,
+ *       "total_tokens":N},...]} sorted by total_tokens, most expensive first.
+ */
+void print_top_turns_json(struct mccs_render_ctx *ctx,
+                          const struct top_turns *turns);
+
 #endif /* MCCS_DISPLAY_H */
@@ -0,0 +1,125 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "file_set.h"
+
+#include <math.h>
+#include <string.h>
+
+#define FILE_HASH_FNV_OFFSET 1469598103934665603ULL
+#define FILE_HASH_FNV_PRIME 1099511628211ULL
+#define FILE_SET_MAX_USED (FILE_SET_SLOTS * 3 / 4)
+
+_Static_assert(sizeof(((struct file_set *)0)->slots) == sizeof(((struct file_set *)0)->registers),
+               "the sketch must fit in the bytes of the exact set");
+
+/**
+ * FNV-1a of a path, finished with the splitmix64 mixer
+ *
+ * @note The sketch takes its register index from the top bits and the rank
+ *       from the rest, so every bit has to depend on every byte
+ */
+static uint64_t file_hash(const char *path,
+                          size_t len) {
+  uint64_t hash = FILE_HASH_FNV_OFFSET;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= (unsigned char)path[i];
+    hash *= FILE_HASH_FNV_PRIME;
+  }
+  hash ^= hash >> 30;
+  hash *= 0xBF58476D1CE4E5B9ULL;
+  hash ^= hash >> 27;
+  hash *= 0x94D049BB133111EBULL;
+  hash ^= hash >> 31;
+  return hash;
+}
+
+/**
+ * Record a hash in the sketch of its kind
+ */
+static void file_sketch_add(struct file_set *set,
+                            enum file_touch kind,
+                            uint64_t hash) {
+  uint32_t index = (uint32_t)(hash >> (64 - FILE_SKETCH_INDEX_BITS));
+  uint64_t rest = hash << FILE_SKETCH_INDEX_BITS;
+  uint8_t rank = rest == 0 ? 64 - FILE_SKETCH_INDEX_BITS + 1 : (uint8_t)(__builtin_clzll(rest) + 1);
+  if (rank > set->registers[kind][index]) {
+    set->registers[kind][index] = rank;
+  }
+}
+
+/**
+ * Move the exact set into the sketches
+ */
+static void file_set_to_sketch(struct file_set *set) {
+  uint64_t slots[FILE_SET_SLOTS];
+  memcpy(slots, set->slots, sizeof(slots));
+  memset(set->registers, 0, sizeof(set->registers));
+  for (size_t i = 0; i < FILE_SET_SLOTS; i++) {
+    if (slots[i] != 0) {
+      file_sketch_add(set, (enum file_touch)(slots[i] & 1), slots[i] & ~1ULL);
+    }
+  }
+  set->sketched = true;
+}
+
+void file_set_init(struct file_set *set) {
+  memset(set, 0, sizeof(*set));
+}
+
+void file_set_add(struct file_set *set,
+                  enum file_touch kind,
+                  const char *path,
+                  size_t len) {
+  if (!path || len == 0 || kind >= FILE_TOUCH_KINDS) {
+    return;
+  }
+  // Bit 0 holds the kind; bit 1 keeps a key from being 0 (the empty slot)
+  uint64_t hash = file_hash(path, len) & ~1ULL;
+  hash = hash != 0 ? hash : 2;
+  if (set->sketched) {
+    file_sketch_add(set, kind, hash);
+    return;
+  }
+
+  uint64_t key = hash | (uint64_t)kind;
+  size_t slot = (size_t)(hash >> 32) % FILE_SET_SLOTS;
+  while (set->slots[slot] != 0) {
+    if (set->slots[slot] == key) {
+      return;
+    }
+    slot = (slot + 1) % FILE_SET_SLOTS;
+  }
+  if (set->used >= FILE_SET_MAX_USED) {
+    file_set_to_sketch(set);
+    file_sketch_add(set, kind, hash);
+    return;
+  }
+  set->slots[slot] = key;
+  set->used++;
+  set->counts[kind]++;
+}
+
+uint32_t file_set_count(const struct file_set *set,
+                        enum file_touch kind) {
+  if (kind >= FILE_TOUCH_KINDS) {
+    return 0;
+  }
+  if (!set->sketched) {
+    return set->counts[kind];
+  }
+
+  // HyperLogLog estimate, linear counting while registers are still empty
+  const double m = FILE_SKETCH_REGISTERS;
+  double sum = 0;
+  uint32_t zeros = 0;
+  for (size_t i = 0; i < FILE_SKETCH_REGISTERS; i++) {
+    sum += ldexp(1.0, -set->registers[kind][i]);
+    zeros += set->registers[kind][i] == 0;
+  }
+  double estimate = 0.7213 / (1.0 + 1.079 / m) * m * m / sum;
+  if (estimate <= 2.5 * m && zeros > 0) {
+    estimate = m * log(m / zeros);
+  }
+  return (uint32_t)(estimate + 0.5);
+}
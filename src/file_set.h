@@ -0,0 +1,57 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file file_set.h
+ * @brief Distinct files touched in a session
+ *
+ * Keeps the 64-bit hashes of the paths given to Read, Edit, MultiEdit and
+ * Write tool calls in a fixed open-addressing table, tagged with the kind
+ * of access, so a session's blast radius can be counted exactly and the
+ * table stored in the session cache as-is.
+ *
+ * Once the table is three quarters full, its hashes move into one
+ * HyperLogLog sketch per kind that reuses the same bytes: counts become
+ * estimates (about 4.6% standard error with FILE_SKETCH_REGISTERS) and the
+ * memory stays bounded whatever the number of files.
+ */
+
+#ifndef MCCS_FILE_SET_H
+#define MCCS_FILE_SET_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types_struct.h"
+
+/**
+ * Initialize an empty set
+ *
+ * @param set    Set to initialize
+ */
+void file_set_init(struct file_set *set);
+
+/**
+ * Add a touched file
+ *
+ * @param set     Set to update
+ * @param kind    How the file was touched
+ * @param path    File path (as passed to the tool)
+ * @param len     Length of path
+ */
+void file_set_add(struct file_set *set,
+                  enum file_touch kind,
+                  const char *path,
+                  size_t len);
+
+/**
+ * Number of distinct files touched in one way
+ *
+ * @param set     Set to read
+ * @param kind    Kind of access
+ * @return        Exact count, or an estimate once set->sketched
+ */
+uint32_t file_set_count(const struct file_set *set,
+                        enum file_touch kind);
+
+#endif /* MCCS_FILE_SET_H */
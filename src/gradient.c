@@ -0,0 +1,19 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "gradient.h"
+
+#include <stddef.h>
+
+#include "constants.h"
+#include "gradient_tables.h" /* Generated by tools/gen_gradients.c */
+
+const struct mccs_gradient_span *gradient_bar_span(enum mccs_gradient_mode mode,
+                                                   enum mccs_bar_kind kind,
+                                                   uint32_t filled) {
+  if (mode <= MCCS_GRADIENT_OFF || mode >= MCCS_GRADIENT_MODE_COUNT ||
+      kind >= MCCS_BAR_KIND_COUNT || filled > PROGRESS_BAR_WIDTH) {
+    return NULL;
+  }
+  return &gradient_tables[mode - 1][kind][filled];
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file gradient.h
+ * @brief Precomputed gradient progress bars
+ *
+ * Every cell of a gradient bar has its own color, so rendering one naively
+ * means an escape sequence per cell and a color computation per cell. Since
+ * a bar can only take PROGRESS_BAR_WIDTH + 1 shapes, tools/gen_gradients.c
+ * renders all of them at build time into gradient_tables.h: one byte span
+ * per (mode, bar kind, fill level). Drawing a bar is a table lookup plus a
+ * single write of the span.
+ *
+ * Spans start and end in the default style so they compose with the SGR
+ * state tracker (see sgr.h).
+ */
+
+#ifndef MCCS_GRADIENT_H
+#define MCCS_GRADIENT_H
+
+#include <stdint.h>
+
+#include "types_struct.h"
+
+/**
+ * Progress bars that have their own gradient
+ */
+enum mccs_bar_kind {
+  MCCS_BAR_CONTEXT = 0, ///< Context window usage (green to red)
+  MCCS_BAR_SESSION,     ///< Session total tokens (green to red)
+  MCCS_BAR_CACHE,       ///< Cache efficiency (red to green: higher is better)
+  MCCS_BAR_API_TIME,    ///< API time ratio (steel blue to lavender)
+  MCCS_BAR_KIND_COUNT
+};
+
+/**
+ * Pre-rendered bar cells for one fill level
+ */
+struct mccs_gradient_span {
+  uint16_t len;      ///< Length of bytes
+  const char *bytes; ///< Cell glyphs with their escapes, ending in a reset
+};
+
+/**
+ * Look up the pre-rendered cells of a gradient bar
+ *
+ * @param mode      Gradient mode
+ * @param kind      Bar kind
+ * @param filled    Number of filled cells (0..PROGRESS_BAR_WIDTH)
+ * @return          Span to write, or NULL if mode is MCCS_GRADIENT_OFF or out of range
+ */
+const struct mccs_gradient_span *gradient_bar_span(enum mccs_gradient_mode mode,
+                                                   enum mccs_bar_kind kind,
+                                                   uint32_t filled);
+
+#endif /* MCCS_GRADIENT_H */
@@ -0,0 +1,577 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "history.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cache.h"
+#include "constants.h"
+#include "debug.h"
+#include "safe_conv.h"
+
+#define HISTORY_LOCK_FILE "lock"
+#define HISTORY_INDEX_FILE "ts.idx"
+#define HISTORY_WATERMARK_FILE "session.wm"
+#define HISTORY_SESSION_DICT "session.dict"
+#define HISTORY_MODEL_DICT "model.dict"
+#define HISTORY_FILE_MODE 0600
+
+/**
+ * Column files, in the order of history_view::maps
+ */
+enum history_file {
+  HISTORY_FILE_TS,
+  HISTORY_FILE_SESSION,
+  HISTORY_FILE_MODEL,
+  HISTORY_FILE_INPUT,
+  HISTORY_FILE_OUTPUT,
+  HISTORY_FILE_CACHE_WRITE,
+  HISTORY_FILE_CACHE_READ,
+  HISTORY_COLUMN_FILES
+};
+
+static const struct {
+  const char *name;
+  size_t width;
+} history_files[HISTORY_COLUMN_FILES] = {
+    [HISTORY_FILE_TS] = {"ts.col", sizeof(int64_t)},
+    [HISTORY_FILE_SESSION] = {"session.col", sizeof(uint32_t)},
+    [HISTORY_FILE_MODEL] = {"model.col", sizeof(uint32_t)},
+    [HISTORY_FILE_INPUT] = {"input.col", sizeof(uint64_t)},
+    [HISTORY_FILE_OUTPUT] = {"output.col", sizeof(uint64_t)},
+    [HISTORY_FILE_CACHE_WRITE] = {"cache_write.col", sizeof(uint64_t)},
+    [HISTORY_FILE_CACHE_READ] = {"cache_read.col", sizeof(uint64_t)},
+};
+
+/**
+ * Newline-separated string dictionary (line number = code)
+ */
+struct history_dict {
+  char *data;     ///< File contents, newlines replaced by terminators
+  char **entries; ///< Entry pointers into data (or caller strings once appended)
+  size_t count;   ///< Entries in use
+  size_t cap;     ///< Allocated entries
+  size_t length;  ///< File bytes up to the end of the last complete line
+};
+
+const char *history_dir(struct mccs_render_ctx *ctx,
+                        char *out,
+                        size_t size) {
+  snprintf(out, size, "%s/%s", get_cache_dir(ctx), HISTORY_DIR_NAME);
+  return out;
+}
+
+void history_collect(const struct turn_record *turn,
+                     const char *model_id,
+                     void *user) {
+  struct history_batch *batch = user;
+  if (batch->count == batch->cap) {
+    size_t cap = batch->cap ? batch->cap * 2 : 64;
+    struct history_turn *turns = realloc(batch->turns, cap * sizeof(*turns));
+    if (!turns) {
+      DEBUG_LOG("History: dropping turn at offset %llu (out of memory)", (unsigned long long)turn->offset);
+      return;
+    }
+    batch->turns = turns;
+    batch->cap = cap;
+  }
+
+  struct history_turn *out = &batch->turns[batch->count++];
+  out->timestamp = turn->timestamp;
+  out->offset = turn->offset;
+  out->tokens = turn->tokens;
+  snprintf(out->model_id, sizeof(out->model_id), "%s", model_id ? model_id : "");
+}
+
+/**
+ * Write a whole buffer, retrying short writes
+ */
+static bool history_write_all(int fd,
+                              const void *buf,
+                              size_t len) {
+  const char *p = buf;
+  while (len > 0) {
+    ssize_t n = write(fd, p, len);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    len -= (size_t)n;
+  }
+  return true;
+}
+
+/**
+ * Size of an open file in bytes (0 on error)
+ */
+static size_t history_fd_size(int fd) {
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    return 0;
+  }
+  ResultSize size_result = safe_off_to_size(st.st_size);
+  return IS_OK(size_result) ? UNWRAP_OK(size_result) : 0;
+}
+
+static void history_dict_free(struct history_dict *dict) {
+  free(dict->data);
+  free(dict->entries);
+  memset(dict, 0, sizeof(*dict));
+}
+
+static bool history_dict_push(struct history_dict *dict,
+                              char *entry) {
+  if (dict->count == dict->cap) {
+    size_t cap = dict->cap ? dict->cap * 2 : 16;
+    char **entries = realloc(dict->entries, cap * sizeof(*entries));
+    if (!entries) {
+      return false;
+    }
+    dict->entries = entries;
+    dict->cap = cap;
+  }
+  dict->entries[dict->count++] = entry;
+  return true;
+}
+
+/**
+ * Read a dictionary file (a missing file is an empty dictionary)
+ */
+static ResultVoid history_dict_load(int dfd,
+                                    const char *name,
+                                    struct history_dict *dict) {
+  memset(dict, 0, sizeof(*dict));
+  int fd = openat(dfd, name, O_RDONLY);
+  if (fd < 0) {
+    return errno == ENOENT ? OK(ResultVoid, 0) : ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+  }
+
+  size_t size = history_fd_size(fd);
+  dict->data = malloc(size + 1);
+  if (!dict->data) {
+    close(fd);
+    return ERR(ResultVoid, MCCS_ERR_OUT_OF_MEMORY);
+  }
+  ssize_t got = pread(fd, dict->data, size, 0);
+  close(fd);
+  if (got < 0) {
+    history_dict_free(dict);
+    return ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+  }
+
+  // Only complete lines count: a torn append is cut off by the next append
+  size_t len = (size_t)got;
+  dict->data[len] = '\0';
+  char *line = dict->data;
+  for (char *nl = memchr(line, '\n', len); nl; nl = memchr(line, '\n', len - (size_t)(line - dict->data))) {
+    *nl = '\0';
+    if (!history_dict_push(dict, line)) {
+      history_dict_free(dict);
+      return ERR(ResultVoid, MCCS_ERR_OUT_OF_MEMORY);
+    }
+    line = nl + 1;
+  }
+  dict->length = (size_t)(line - dict->data);
+  return OK(ResultVoid, 0);
+}
+
+/**
+ * Code of a dictionary entry, appending it to the file if new
+ *
+ * @note value must outlive dict (it is referenced, not copied)
+ */
+static ResultU32 history_dict_code(int dfd,
+                                   const char *name,
+                                   struct history_dict *dict,
+                                   const char *value) {
+  for (size_t i = 0; i < dict->count; i++) {
+    if (strcmp(dict->entries[i], value) == 0) {
+      return OK(ResultU32, (uint32_t)i);
+    }
+  }
+  if (dict->count >= UINT32_MAX) {
+    return ERR(ResultU32, MCCS_ERR_OVERFLOW);
+  }
+
+  // Drop a torn line left by an interrupted append, or its bytes would prefix
+  // this entry and shift the codes of every entry after it
+  int fd = openat(dfd, name, O_WRONLY | O_CREAT | O_APPEND, HISTORY_FILE_MODE);
+  if (fd < 0) {
+    return ERR(ResultU32, MCCS_ERR_IO_ERROR);
+  }
+  size_t len = strlen(value);
+  bool ok = (history_fd_size(fd) == dict->length || ftruncate(fd, (off_t)dict->length) == 0) &&
+            history_write_all(fd, value, len) && history_write_all(fd, "\n", 1);
+  close(fd);
+  if (!ok) {
+    return ERR(ResultU32, MCCS_ERR_IO_ERROR);
+  }
+  dict->length += len + 1;
+  if (!history_dict_push(dict, (char *)(uintptr_t)value)) {
+    return ERR(ResultU32, MCCS_ERR_OUT_OF_MEMORY);
+  }
+  return OK(ResultU32, (uint32_t)(dict->count - 1));
+}
+
+/**
+ * Extend the block index over rows [first, first + count) of ts
+ */
+static bool history_index_update(int fd,
+                                 size_t first,
+                                 const int64_t *ts,
+                                 size_t count) {
+  size_t i = 0;
+  while (i < count) {
+    size_t row = first + i;
+    size_t block = row / HISTORY_BLOCK_ROWS;
+    size_t block_end = (block + 1) * HISTORY_BLOCK_ROWS;
+    off_t at = (off_t)(block * sizeof(struct history_block_index));
+
+    struct history_block_index entry = {.min_ts = ts[i], .max_ts = ts[i]};
+    if (row % HISTORY_BLOCK_ROWS != 0) {
+      // Block already started: merge with its stored range
+      struct history_block_index stored;
+      if (pread(fd, &stored, sizeof(stored), at) == (ssize_t)sizeof(stored)) {
+        entry = stored;
+      }
+    }
+    for (; i < count && first + i < block_end; i++) {
+      entry.min_ts = ts[i] < entry.min_ts ? ts[i] : entry.min_ts;
+      entry.max_ts = ts[i] > entry.max_ts ? ts[i] : entry.max_ts;
+    }
+    if (pwrite(fd, &entry, sizeof(entry), at) != (ssize_t)sizeof(entry)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Column buffers for the rows of one append
+ */
+struct history_rows {
+  int64_t *ts;
+  uint32_t *session;
+  uint32_t *model;
+  uint64_t *tokens[HISTORY_TOKEN_COLUMNS];
+};
+
+static void history_rows_free(struct history_rows *rows) {
+  free(rows->ts);
+  free(rows->session);
+  free(rows->model);
+  for (size_t c = 0; c < HISTORY_TOKEN_COLUMNS; c++) {
+    free(rows->tokens[c]);
+  }
+}
+
+/**
+ * Append one session's turns with the store lock held
+ */
+static ResultVoid history_append_locked(int dfd,
+                                        const char *session_id,
+                                        const struct history_turn *turns,
+                                        size_t count) {
+  int fds[HISTORY_COLUMN_FILES];
+  size_t rows = SIZE_MAX;
+  bool ok = true;
+  for (size_t f = 0; f < HISTORY_COLUMN_FILES; f++) {
+    fds[f] = openat(dfd, history_files[f].name, O_RDWR | O_CREAT | O_APPEND, HISTORY_FILE_MODE);
+    ok = ok && fds[f] >= 0;
+    if (fds[f] >= 0) {
+      size_t n = history_fd_size(fds[f]) / history_files[f].width;
+      rows = n < rows ? n : rows;
+    }
+  }
+  int index_fd = openat(dfd, HISTORY_INDEX_FILE, O_RDWR | O_CREAT, HISTORY_FILE_MODE);
+  int wm_fd = openat(dfd, HISTORY_WATERMARK_FILE, O_RDWR | O_CREAT, HISTORY_FILE_MODE);
+  ok = ok && index_fd >= 0 && wm_fd >= 0;
+
+  // Cut every column back to the common row count (repairs a torn append)
+  for (size_t f = 0; ok && f < HISTORY_COLUMN_FILES; f++) {
+    size_t want = rows * history_files[f].width;
+    if (history_fd_size(fds[f]) != want && ftruncate(fds[f], (off_t)want) != 0) {
+      ok = false;
+    }
+  }
+
+  struct history_dict sessions = {0};
+  struct history_dict models = {0};
+  struct history_rows out = {0};
+  ResultVoid result = ok ? OK(ResultVoid, 0) : ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+  if (IS_OK(result)) {
+    result = history_dict_load(dfd, HISTORY_SESSION_DICT, &sessions);
+  }
+  if (IS_OK(result)) {
+    result = history_dict_load(dfd, HISTORY_MODEL_DICT, &models);
+  }
+
+  uint32_t session_code = 0;
+  if (IS_OK(result)) {
+    ResultU32 code_result = history_dict_code(dfd, HISTORY_SESSION_DICT, &sessions, session_id);
+    if (IS_ERR(code_result)) {
+      result = ERR(ResultVoid, UNWRAP_ERR(code_result));
+    } else {
+      session_code = UNWRAP_OK(code_result);
+    }
+  }
+
+  uint64_t watermark = 0;
+  off_t wm_at = (off_t)session_code * (off_t)sizeof(uint64_t);
+  if (IS_OK(result) && pread(wm_fd, &watermark, sizeof(watermark), wm_at) != (ssize_t)sizeof(watermark)) {
+    watermark = 0;
+  }
+
+  if (IS_OK(result)) {
+    out.ts = malloc(count * sizeof(*out.ts));
+    out.session = malloc(count * sizeof(*out.session));
+    out.model = malloc(count * sizeof(*out.model));
+    bool allocated = out.ts && out.session && out.model;
+    for (size_t c = 0; c < HISTORY_TOKEN_COLUMNS; c++) {
+      out.tokens[c] = malloc(count * sizeof(uint64_t));
+      allocated = allocated && out.tokens[c];
+    }
+    if (!allocated) {
+      result = ERR(ResultVoid, MCCS_ERR_OUT_OF_MEMORY);
+    }
+  }
+
+  size_t n = 0;
+  uint64_t next_watermark = watermark;
+  for (size_t i = 0; IS_OK(result) && i < count; i++) {
+    const struct history_turn *turn = &turns[i];
+    if (turn->offset < watermark) {
+      continue;
+    }
+    const char *model_id = strchr(turn->model_id, '\n') ? UNKNOWN_VALUE : turn->model_id;
+    ResultU32 model_result = history_dict_code(dfd, HISTORY_MODEL_DICT, &models, model_id);
+    if (IS_ERR(model_result)) {
+      result = ERR(ResultVoid, UNWRAP_ERR(model_result));
+      break;
+    }
+    out.ts[n] = turn->timestamp;
+    out.session[n] = session_code;
+    out.model[n] = UNWRAP_OK(model_result);
+    out.tokens[HISTORY_INPUT][n] = turn->tokens.input_tokens;
+    out.tokens[HISTORY_OUTPUT][n] = turn->tokens.output_tokens;
+    out.tokens[HISTORY_CACHE_WRITE][n] = turn->tokens.cache_creation_tokens;
+    out.tokens[HISTORY_CACHE_READ][n] = turn->tokens.cache_read_tokens;
+    next_watermark = turn->offset + 1;
+    n++;
+  }
+
+  if (IS_OK(result) && n > 0) {
+    const void *columns[HISTORY_COLUMN_FILES] = {
+        out.ts, out.session, out.model,
+        out.tokens[HISTORY_INPUT], out.tokens[HISTORY_OUTPUT],
+        out.tokens[HISTORY_CACHE_WRITE], out.tokens[HISTORY_CACHE_READ]};
+    for (size_t f = 0; ok && f < HISTORY_COLUMN_FILES; f++) {
+      ok = history_write_all(fds[f], columns[f], n * history_files[f].width);
+    }
+    ok = ok && history_index_update(index_fd, rows, out.ts, n);
+    ok = ok && pwrite(wm_fd, &next_watermark, sizeof(next_watermark), wm_at) == (ssize_t)sizeof(next_watermark);
+    if (!ok) {
+      result = ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+    }
+    DEBUG_LOG("History: appended %zu turns (%zu skipped) at row %zu", n, count - n, rows);
+  }
+
+  history_rows_free(&out);
+  history_dict_free(&sessions);
+  history_dict_free(&models);
+  for (size_t f = 0; f < HISTORY_COLUMN_FILES; f++) {
+    if (fds[f] >= 0) {
+      close(fds[f]);
+    }
+  }
+  if (index_fd >= 0) {
+    close(index_fd);
+  }
+  if (wm_fd >= 0) {
+    close(wm_fd);
+  }
+  return result;
+}
+
+ResultVoid history_append(const char *dir,
+                          const char *session_id,
+                          const struct history_turn *turns,
+                          size_t count) {
+  if (count == 0) {
+    return OK(ResultVoid, 0);
+  }
+  if (!session_id || !*session_id || strchr(session_id, '\n')) {
+    return ERR(ResultVoid, MCCS_ERR_INVALID_FORMAT);
+  }
+
+  if (mkdir(dir, CACHE_DIR_MODE) != 0 && errno != EEXIST) {
+    return ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+  }
+  int dfd = open(dir, O_RDONLY | O_DIRECTORY);
+  if (dfd < 0) {
+    return ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+  }
+  int lock_fd = openat(dfd, HISTORY_LOCK_FILE, O_RDWR | O_CREAT, HISTORY_FILE_MODE);
+  if (lock_fd < 0 || flock(lock_fd, LOCK_EX) != 0) {
+    if (lock_fd >= 0) {
+      close(lock_fd);
+    }
+    close(dfd);
+    return ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+  }
+
+  ResultVoid result = history_append_locked(dfd, session_id, turns, count);
+
+  flock(lock_fd, LOCK_UN);
+  close(lock_fd);
+  close(dfd);
+  return result;
+}
+
+/**
+ * Map the first len bytes of a store file read-only
+ */
+static const void *history_map(int dfd,
+                               const char *name,
+                               size_t len,
+                               struct history_view *view,
+                               size_t slot) {
+  if (len == 0) {
+    return NULL;
+  }
+  int fd = openat(dfd, name, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  void *map = mmap(NULL, len, PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return NULL;
+  }
+  view->maps[slot] = map;
+  view->map_sizes[slot] = len;
+  return map;
+}
+
+/**
+ * Move a loaded dictionary into the view
+ */
+static void history_view_take_dict(struct history_view *view,
+                                   size_t slot,
+                                   struct history_dict *dict,
+                                   char ***entries,
+                                   size_t *count) {
+  view->dict_data[slot] = dict->data;
+  *entries = dict->entries;
+  *count = dict->count;
+  memset(dict, 0, sizeof(*dict));
+}
+
+ResultVoid history_open(const char *dir,
+                        struct history_view *view) {
+  memset(view, 0, sizeof(*view));
+  view->lock_fd = -1;
+
+  int dfd = open(dir, O_RDONLY | O_DIRECTORY);
+  if (dfd < 0) {
+    return OK(ResultVoid, 0);
+  }
+  view->lock_fd = openat(dfd, HISTORY_LOCK_FILE, O_RDONLY);
+  if (view->lock_fd >= 0) {
+    flock(view->lock_fd, LOCK_SH);
+  }
+
+  size_t rows = SIZE_MAX;
+  for (size_t f = 0; f < HISTORY_COLUMN_FILES; f++) {
+    struct stat st;
+    size_t n = 0;
+    if (fstatat(dfd, history_files[f].name, &st, 0) == 0) {
+      ResultSize size_result = safe_off_to_size(st.st_size);
+      n = IS_OK(size_result) ? UNWRAP_OK(size_result) / history_files[f].width : 0;
+    }
+    rows = n < rows ? n : rows;
+  }
+
+  ResultVoid result = OK(ResultVoid, 0);
+  if (rows > 0) {
+    const void *maps[HISTORY_COLUMN_FILES];
+    for (size_t f = 0; f < HISTORY_COLUMN_FILES; f++) {
+      maps[f] = history_map(dfd, history_files[f].name, rows * history_files[f].width, view, f);
+      if (!maps[f]) {
+        result = ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+      }
+    }
+    if (IS_OK(result)) {
+      view->rows = rows;
+      view->ts = maps[HISTORY_FILE_TS];
+      view->session = maps[HISTORY_FILE_SESSION];
+      view->model = maps[HISTORY_FILE_MODEL];
+      view->tokens[HISTORY_INPUT] = maps[HISTORY_FILE_INPUT];
+      view->tokens[HISTORY_OUTPUT] = maps[HISTORY_FILE_OUTPUT];
+      view->tokens[HISTORY_CACHE_WRITE] = maps[HISTORY_FILE_CACHE_WRITE];
+      view->tokens[HISTORY_CACHE_READ] = maps[HISTORY_FILE_CACHE_READ];
+    }
+
+    // A short index (torn append) just means the last blocks are not skippable
+    struct stat st;
+    size_t blocks = (rows + HISTORY_BLOCK_ROWS - 1) / HISTORY_BLOCK_ROWS;
+    if (IS_OK(result) && fstatat(dfd, HISTORY_INDEX_FILE, &st, 0) == 0) {
+      ResultSize size_result = safe_off_to_size(st.st_size);
+      size_t stored = IS_OK(size_result) ? UNWRAP_OK(size_result) / sizeof(struct history_block_index) : 0;
+      blocks = stored < blocks ? stored : blocks;
+      view->index = history_map(dfd, HISTORY_INDEX_FILE, blocks * sizeof(struct history_block_index),
+                                view, HISTORY_COLUMN_FILES);
+      view->blocks = view->index ? blocks : 0;
+    }
+  }
+
+  struct history_dict dict;
+  if (IS_OK(result)) {
+    result = history_dict_load(dfd, HISTORY_SESSION_DICT, &dict);
+    if (IS_OK(result)) {
+      history_view_take_dict(view, 0, &dict, &view->sessions, &view->session_count);
+    }
+  }
+  if (IS_OK(result)) {
+    result = history_dict_load(dfd, HISTORY_MODEL_DICT, &dict);
+    if (IS_OK(result)) {
+      history_view_take_dict(view, 1, &dict, &view->models, &view->model_count);
+    }
+  }
+  close(dfd);
+
+  if (IS_ERR(result)) {
+    history_close(view);
+  }
+  return result;
+}
+
+void history_close(struct history_view *view) {
+  for (size_t i = 0; i < HISTORY_MAPPED_FILES; i++) {
+    if (view->maps[i]) {
+      munmap(view->maps[i], view->map_sizes[i]);
+    }
+  }
+  free(view->sessions);
+  free(view->models);
+  free(view->dict_data[0]);
+  free(view->dict_data[1]);
+  if (view->lock_fd >= 0) {
+    flock(view->lock_fd, LOCK_UN);
+    close(view->lock_fd);
+  }
+  memset(view, 0, sizeof(*view));
+  view->lock_fd = -1;
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file history.h
+ * @brief Append-only columnar store of per-turn token statistics
+ *
+ * With --history, every assistant turn seen by a transcript scan is appended
+ * to /tmp/mini-ccstatus/<uid>/history/. Each field lives in its own column
+ * file of fixed-width little-endian values, so a query maps only the columns
+ * it needs and runs tight loops over them:
+ *
+ *   ts.col           int64   turn time (seconds since epoch, 0 if unknown)
+ *   session.col      uint32  code into session.dict (one session ID per line)
+ *   model.col        uint32  code into model.dict (one model ID per line)
+ *   input.col        uint64  input tokens
+ *   output.col       uint64  output tokens
+ *   cache_write.col  uint64  cache creation tokens
+ *   cache_read.col   uint64  cache read tokens
+ *   ts.idx           per HISTORY_BLOCK_ROWS rows: min and max of ts.col
+ *   session.wm       uint64 per session code: next transcript offset to accept
+ *
+ * Writers hold an exclusive lock on the "lock" file, readers a shared one.
+ * The watermark makes appends idempotent: re-parsing a transcript from the
+ * start (e.g. after the session cache expired) adds no duplicate rows.
+ */
+
+#ifndef MCCS_HISTORY_H
+#define MCCS_HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "render_ctx.h"
+#include "result.h"
+#include "token_calculator.h"
+#include "types_struct.h"
+
+#define HISTORY_DIR_NAME "history" /* Store directory inside the cache directory */
+#define HISTORY_BLOCK_ROWS 4096    /* Rows per min/max index entry */
+#define HISTORY_MAPPED_FILES 8     /* Seven column files plus the block index */
+
+/**
+ * Token columns, in file order
+ */
+enum history_token_column {
+  HISTORY_INPUT,
+  HISTORY_OUTPUT,
+  HISTORY_CACHE_WRITE,
+  HISTORY_CACHE_READ,
+  HISTORY_TOKEN_COLUMNS
+};
+
+/**
+ * ts.idx entry: time range covered by one block of rows
+ */
+struct history_block_index {
+  int64_t min_ts; ///< Smallest ts in the block
+  int64_t max_ts; ///< Largest ts in the block
+};
+
+/**
+ * Read-only view of a store (columns are mmapped)
+ */
+struct history_view {
+  size_t rows;                                     ///< Rows present in every column
+  const int64_t *ts;                               ///< Turn times
+  const uint32_t *session;                         ///< Session codes
+  const uint32_t *model;                           ///< Model codes
+  const uint64_t *tokens[HISTORY_TOKEN_COLUMNS];   ///< Token columns
+  const struct history_block_index *index;         ///< Block index (blocks entries)
+  size_t blocks;                                   ///< Index entries
+  char **sessions;                                 ///< Session IDs by code
+  size_t session_count;                            ///< Entries in sessions
+  char **models;                                   ///< Model IDs by code
+  size_t model_count;                              ///< Entries in models
+  int lock_fd;                                     ///< Shared lock held while the view is open
+  void *maps[HISTORY_MAPPED_FILES];                ///< Mappings to release (columns and index)
+  size_t map_sizes[HISTORY_MAPPED_FILES];          ///< Lengths of maps
+  char *dict_data[2];                              ///< Dictionary file contents
+};
+
+/**
+ * Path of the store directory for the current user
+ *
+ * @param ctx     Render context owning the cache directory buffer
+ * @param out     Output buffer
+ * @param size    Size of out
+ * @return        out
+ */
+const char *history_dir(struct mccs_render_ctx *ctx,
+                        char *out,
+                        size_t size);
+
+/**
+ * Turn visitor collecting turns into a history batch
+ *
+ * @param turn        Turn reported by scan_transcript_turns()
+ * @param model_id    Model of the turn (may be NULL)
+ * @param user        struct history_batch to append to
+ *
+ * @note On allocation failure the turn is dropped (the store is best effort)
+ */
+void history_collect(const struct turn_record *turn,
+                     const char *model_id,
+                     void *user);
+
+/**
+ * Append a session's turns to the store
+ *
+ * @param dir           Store directory (created if missing)
+ * @param session_id    Session the turns belong to
+ * @param turns         Turns in transcript order
+ * @param count         Number of turns
+ * @return              ResultVoid - Ok(0) on success or Err with error code
+ *
+ * @note Turns before the session's watermark are skipped
+ * @error MCCS_ERR_IO_ERROR if the store cannot be locked or written
+ * @error MCCS_ERR_OUT_OF_MEMORY on allocation failure
+ */
+ResultVoid history_append(const char *dir,
+                          const char *session_id,
+                          const struct history_turn *turns,
+                          size_t count);
+
+/**
+ * Map a store for reading
+ *
+ * @param dir     Store directory
+ * @param view    Output: mapped columns and dictionaries
+ * @return        ResultVoid - Ok(0) on success or Err with error code
+ *
+ * @note An empty or missing store opens as a view with zero rows
+ * @error MCCS_ERR_IO_ERROR if a column cannot be mapped
+ * @error MCCS_ERR_OUT_OF_MEMORY on allocation failure
+ */
+ResultVoid history_open(const char *dir,
+                        struct history_view *view);
+
+/**
+ * Release a view opened with history_open()
+ *
+ * @param view    View to close
+ */
+void history_close(struct history_view *view);
+
+#endif /* MCCS_HISTORY_H */
@@ -11,6 +11,7 @@
 #include "constants.h"
 #include "debug.h"
 #include "safe_conv.h"
+#include "utf8.h"
 
 /**
  * Replace all whitespace control characters with spaces
@@ -36,44 +37,46 @@ static void sanitize_whitespace(char *str,
   }
 }
 
-const cJSON *find_path(const cJSON *root, const char *const *keys) {
-  if (!root || !keys) {
-    return NULL;
+json_ref find_path(struct json_doc *doc, json_ref root, const char *const *keys) {
+  if (!doc || !keys) {
+    return JSON_REF_NONE;
   }
 
-  const cJSON *node = root;
+  json_ref node = root;
   for (int level = 0; keys[level] != NULL; ++level) {
-    if (!cJSON_IsObject(node)) {
-      return NULL;
-    }
-    node = cJSON_GetObjectItemCaseSensitive(node, keys[level]);
-    if (!node) {
-      return NULL;
+    node = json_get(doc, node, keys[level]);
+    if (node == JSON_REF_NONE) {
+      return JSON_REF_NONE;
     }
   }
   return node;
 }
 
-ResultJson parse_json_document(const char *restrict buffer, size_t length) {
-  if (!buffer) {
-    return ERR(ResultJson, MCCS_ERR_INVALID_JSON);
+ResultJsonRef parse_json_document(struct mccs_render_ctx *ctx,
+                                  struct json_doc *doc,
+                                  const char *restrict buffer,
+                                  size_t length) {
+  if (!doc || !buffer) {
+    return ERR(ResultJsonRef, MCCS_ERR_INVALID_JSON);
   }
 
   DEBUG_LOG("Parsing JSON document of length %zu", length);
-  cJSON *root = cJSON_ParseWithLength(buffer, length);
-  if (!root) {
-    if (cJSON_GetErrorPtr() == NULL) {
+  ResultJsonRef root = json_doc_parse(doc, buffer, length);
+  if (ctx) {
+    ctx->json_error_ptr = IS_OK(root) ? NULL : buffer + doc->error_offset;
+  }
+  if (IS_ERR(root)) {
+    if (UNWRAP_ERR(root) == MCCS_ERR_OUT_OF_MEMORY) {
       DEBUG_LOG("JSON parse failed: out of memory");
       fprintf(MCCS_STDERR, "error: out of memory\n");
-      return ERR(ResultJson, MCCS_ERR_OUT_OF_MEMORY);
     } else {
-      DEBUG_LOG("JSON parse failed: syntax error near position %ld", cJSON_GetErrorPtr() - buffer);
-      return ERR(ResultJson, MCCS_ERR_INVALID_JSON);
+      DEBUG_LOG("JSON parse failed: syntax error near position %zu", doc->error_offset);
     }
+    return ERR(ResultJsonRef, mccs_render_ctx_fail(ctx, UNWRAP_ERR(root)));
   }
 
   DEBUG_LOG("JSON parsed successfully");
-  return OK(ResultJson, root);
+  return root;
 }
 
 void init_mccs_status(struct mccs_status *status) {
@@ -92,6 +95,7 @@ void init_mccs_status(struct mccs_status *status) {
   status->counters.lines_added = 0;
   status->counters.lines_removed = 0;
   status->counters.exceeds_200k_tokens = false;
+  status->cwd_root_len = 0;
 
   status->buffers.buf_model_name[0] = '\0';
   status->buffers.buf_model_id[0] = '\0';
@@ -100,63 +104,69 @@ void init_mccs_status(struct mccs_status *status) {
   status->buffers.buf_version[0] = '\0';
 }
 
-ResultVoid load_string_field(const cJSON *restrict root,
+ResultVoid load_string_field(struct json_doc *doc,
+                             json_ref root,
                              const char *const *restrict path,
                              char *restrict buffer,
                              size_t capacity,
                              const char **restrict out) {
-  if (!root || !path || !buffer || !out || capacity == 0) {
+  if (!doc || !path || !buffer || !out || capacity == 0) {
     return ERR(ResultVoid, MCCS_ERR_INVALID_JSON);
   }
 
-  const cJSON *node = find_path(root, path);
-  if (!cJSON_IsString(node)) {
+  json_ref node = find_path(doc, root, path);
+  if (!json_is_string(doc, node)) {
     return ERR(ResultVoid, MCCS_ERR_MISSING_FIELD);
   }
 
-  const char *value = cJSON_GetStringValue(node);
+  const char *value = json_string(doc, node);
   if (!value) {
     return ERR(ResultVoid, MCCS_ERR_INVALID_JSON);
   }
 
-  size_t len = strlen(value);
-  if (len >= capacity) {
-    len = capacity - 1;
-  }
+  // Never split a codepoint; invalid bytes would garble the terminal line
+  size_t len = utf8_truncate(value, strlen(value), capacity - 1);
   memcpy(buffer, value, len);
   buffer[len] = '\0';
+  // An all-ASCII payload (the usual case, flagged by the parser) needs no check:
+  // escapes always decode to valid UTF-8
+  if (!json_doc_is_ascii(doc) && utf8_sanitize(buffer, len) > 0) {
+    DEBUG_LOG("Invalid UTF-8 replaced in field %s", path[0]);
+  }
   sanitize_whitespace(buffer, len);
   *out = buffer;
   return OK(ResultVoid, 0);
 }
 
-ResultVoid load_double_field(const cJSON *root,
+ResultVoid load_double_field(struct json_doc *doc,
+                             json_ref root,
                              const char *const *path,
                              double *out) {
-  if (!root || !path || !out) {
+  if (!doc || !path || !out) {
     return ERR(ResultVoid, MCCS_ERR_INVALID_JSON);
   }
-  const cJSON *node = find_path(root, path);
-  if (!cJSON_IsNumber(node)) {
+  json_ref node = find_path(doc, root, path);
+  if (!json_is_number(doc, node)) {
     return ERR(ResultVoid, MCCS_ERR_MISSING_FIELD);
   }
 
-  *out = node->valuedouble;
+  *out = json_number(doc, node);
   return OK(ResultVoid, 0);
 }
 
-ResultVoid load_uint32_field(const cJSON *root,
+ResultVoid load_uint32_field(struct json_doc *doc,
+                             json_ref root,
                              const char *const *path,
                              uint32_t *out) {
-  if (!root || !path || !out) {
+  if (!doc || !path || !out) {
     return ERR(ResultVoid, MCCS_ERR_INVALID_JSON);
   }
-  const cJSON *node = find_path(root, path);
-  if (!cJSON_IsNumber(node)) {
+  json_ref node = find_path(doc, root, path);
+  if (!json_is_number(doc, node)) {
     return ERR(ResultVoid, MCCS_ERR_MISSING_FIELD);
   }
 
-  double value = node->valuedouble;
+  double value = json_number(doc, node);
 
   ResultU32 result = safe_double_to_uint32(value);
   if (IS_ERR(result)) {
@@ -166,24 +176,26 @@ ResultVoid load_uint32_field(const cJSON *root,
   return OK(ResultVoid, 0);
 }
 
-ResultVoid load_bool_field(const cJSON *root,
+ResultVoid load_bool_field(struct json_doc *doc,
+                           json_ref root,
                            const char *const *path,
                            bool *out) {
-  if (!root || !path || !out) {
+  if (!doc || !path || !out) {
     return ERR(ResultVoid, MCCS_ERR_INVALID_JSON);
   }
-  const cJSON *node = find_path(root, path);
-  if (!cJSON_IsBool(node)) {
+  json_ref node = find_path(doc, root, path);
+  if (!json_is_bool(doc, node)) {
     return ERR(ResultVoid, MCCS_ERR_MISSING_FIELD);
   }
 
-  *out = cJSON_IsTrue(node);
+  *out = json_is_true(doc, node);
   return OK(ResultVoid, 0);
 }
 
-void load_mccs_status(const cJSON *root,
+void load_mccs_status(struct json_doc *doc,
+                      json_ref root,
                       struct mccs_status *status) {
-  if (!root || !status) {
+  if (!doc || !status) {
     return;
   }
   DEBUG_LOG("Loading status fields from JSON");
@@ -191,70 +203,71 @@ void load_mccs_status(const cJSON *root,
   struct mccs_string_refs *refs = &status->string_refs;
   struct mccs_counters *counters = &status->counters;
 
-  (void)load_string_field(root,
+  (void)load_string_field(doc, root,
                           PATH_MODEL_NAME,
                           buffers->buf_model_name,
                           sizeof(buffers->buf_model_name),
                           &refs->model_name);
-  (void)load_string_field(root,
+  (void)load_string_field(doc, root,
                           PATH_MODEL_ID,
                           buffers->buf_model_id,
                           sizeof(buffers->buf_model_id),
                           &refs->model_id);
-  (void)load_string_field(root,
+  (void)load_string_field(doc, root,
                           PATH_CWD,
                           buffers->buf_cwd,
                           sizeof(buffers->buf_cwd),
                           &refs->cwd);
-  (void)load_string_field(root,
+  (void)load_string_field(doc, root,
                           PATH_PROJECT_DIR,
                           buffers->buf_project,
                           sizeof(buffers->buf_project),
                           &refs->project_dir);
-  (void)load_string_field(root,
+  (void)load_string_field(doc, root,
                           PATH_VERSION,
                           buffers->buf_version,
                           sizeof(buffers->buf_version),
                           &refs->version);
 
-  (void)load_double_field(root,
+  (void)load_double_field(doc, root,
                           PATH_COST,
                           &counters->cost_usd);
-  (void)load_uint32_field(root,
+  (void)load_uint32_field(doc, root,
                           PATH_DURATION,
                           &counters->duration_ms);
-  (void)load_uint32_field(root,
+  (void)load_uint32_field(doc, root,
                           PATH_API_DURATION,
                           &counters->api_ms);
-  (void)load_uint32_field(root,
+  (void)load_uint32_field(doc, root,
                           PATH_LINES_ADDED,
                           &counters->lines_added);
-  (void)load_uint32_field(root,
+  (void)load_uint32_field(doc, root,
                           PATH_LINES_REMOVED,
                           &counters->lines_removed);
 
-  (void)load_bool_field(root, PATH_EXCEEDS_200K,
+  (void)load_bool_field(doc, root, PATH_EXCEEDS_200K,
                         &counters->exceeds_200k_tokens);
 
   DEBUG_LOG("Loaded: model=%s, version=%s, cwd=%s",
             refs->model_name, refs->version, refs->cwd);
 }
 
-ResultVoid load_mccs_paths(const cJSON *root,
+ResultVoid load_mccs_paths(struct json_doc *doc,
+                           json_ref root,
                            struct mccs_paths *paths) {
-  if (!root || !paths) {
+  if (!doc || !paths) {
     return ERR(ResultVoid, MCCS_ERR_INVALID_JSON);
   }
   const char *session_id_ptr = NULL;
   const char *transcript_ptr = NULL;
 
-  ResultVoid session_id_result = load_string_field(root,
+  ResultVoid session_id_result = load_string_field(doc, root,
                                                    PATH_SESSION_ID,
                                                    paths->session_id,
                                                    sizeof(paths->session_id),
                                                    &session_id_ptr);
 
-  ResultVoid transcript_result = load_string_field(root,
+  ResultVoid transcript_result = load_string_field(doc, root,
                                                    PATH_TRANSCRIPT_PATH,
                                                    paths->transcript_path,
                                                    sizeof(paths->transcript_path),
@@ -16,40 +16,47 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include "lib/cjson/cJSON.h"
+#include "json_tape.h"
+#include "render_ctx.h"
 #include "result.h"
 #include "token_calculator.h"
 #include "types_struct.h"
 
-// Result types for JSON parsing
-DEFINE_RESULT(ResultJson, cJSON *, enum MccsError);
-
 /**
  * Parse a JSON document from a buffer
  *
+ * @param ctx        Render context receiving the error state (may be NULL)
+ * @param doc        Document receiving the parse (its buffers are reused)
  * @param buffer     JSON string buffer to parse
  * @param length     Length of the buffer
- * @return           Result<cJSON*> - Ok with parsed JSON or Err with error code
+ * @return           Result<json_ref> - Ok with the root value or Err with error code
  *
- * @note Caller must call cJSON_Delete() on the returned object if Result is Ok.
+ * @note The document points into buffer, which must outlive its use.
+ * @note On syntax errors ctx->json_error_ptr points at the offending position.
  * @error MCCS_ERR_INVALID_JSON on parse error, MCCS_ERR_OUT_OF_MEMORY on OOM
  */
-ResultJson parse_json_document(const char *restrict buffer, size_t length);
+ResultJsonRef parse_json_document(struct mccs_render_ctx *ctx,
+                                  struct json_doc *doc,
+                                  const char *restrict buffer,
+                                  size_t length);
 
 /**
  * Navigate a JSON object tree following a path of keys
  *
+ * @param doc     Parsed document
+ * @param doc     Parsed document
  * @param root    Root JSON object to search
  * @param keys    NULL-terminated array of key names to traverse
- * @return        JSON node at the specified path, or NULL if not found
+ * @return        JSON value at the specified path, or JSON_REF_NONE if not found
  *
  * @note Uses case-sensitive key matching.
  */
-const cJSON *find_path(const cJSON *root, const char *const *keys);
+json_ref find_path(struct json_doc *doc, json_ref root, const char *const *keys);
 
 /**
  * Load a string field from JSON into a buffer
  *
+ * @param doc        Parsed document
  * @param root       Root JSON object to search
  * @param path       NULL-terminated array of keys to traverse
  * @param buffer     Destination buffer for the string value
@@ -57,10 +64,12 @@ const cJSON *find_path(const cJSON *root, const char *const *keys);
  * @param out        Output: pointer set to buffer on success
  * @return           ResultVoid - Ok if field found and loaded, Err with error code otherwise
  *
- * @error MCCS_ERR_INVALID_JSON if parameters are NULL or field not found/wrong type
+ * @note Truncation keeps whole codepoints; invalid UTF-8 bytes become UTF8_REPLACEMENT.
+ * @error MCCS_ERR_INVALID_JSON if parameters are NULL or the string holds a bad escape
  * @error MCCS_ERR_BUFFER_TOO_SMALL should never occur (truncation is allowed)
  */
-ResultVoid load_string_field(const cJSON *restrict root,
+ResultVoid load_string_field(struct json_doc *doc,
+                             json_ref root,
                              const char *const *restrict path,
                              char *restrict buffer,
                              size_t capacity,
@@ -69,6 +78,7 @@ ResultVoid load_string_field(const cJSON *restrict root,
 /**
  * Load a double-precision floating point field from JSON
  *
+ * @param doc     Parsed document
  * @param root    Root JSON object to search
  * @param path    NULL-terminated array of keys to traverse
  * @param out     Output: value set on success
@@ -76,13 +86,15 @@ ResultVoid load_string_field(const cJSON *restrict root,
  *
  * @error MCCS_ERR_INVALID_JSON if parameters are NULL or field not found/not a number
  */
-ResultVoid load_double_field(const cJSON *root,
+ResultVoid load_double_field(struct json_doc *doc,
+                             json_ref root,
                              const char *const *path,
                              double *out);
 
 /**
  * Load an unsigned 32-bit integer field from JSON
  *
+ * @param doc     Parsed document
  * @param root    Root JSON object to search
  * @param path    NULL-terminated array of keys to traverse
  * @param out     Output: value set on success
@@ -91,13 +103,15 @@ ResultVoid load_double_field(const cJSON *root,
  * @error MCCS_ERR_INVALID_JSON if parameters are NULL or field not found/not a number
  * @error MCCS_ERR_INVALID_CONVERSION if value is out of uint32_t range
  */
-ResultVoid load_uint32_field(const cJSON *root,
+ResultVoid load_uint32_field(struct json_doc *doc,
+                             json_ref root,
                              const char *const *path,
                              uint32_t *out);
 
 /**
  * Load a boolean field from JSON
  *
+ * @param doc     Parsed document
  * @param root    Root JSON object to search
  * @param path    NULL-terminated array of keys to traverse
  * @param out     Output: value set on success
@@ -105,7 +119,8 @@ ResultVoid load_uint32_field(const cJSON *root,
  *
  * @error MCCS_ERR_INVALID_JSON if parameters are NULL or field not found/not a boolean
  */
-ResultVoid load_bool_field(const cJSON *root,
+ResultVoid load_bool_field(struct json_doc *doc,
+                           json_ref root,
                            const char *const *path,
                            bool *out);
 
@@ -119,20 +134,22 @@ void init_mccs_status(struct mccs_status *status);
 /**
  * Load all status fields from JSON into mccs_status structure
  *
+ * @param doc       Parsed document
  * @param root      Root JSON object from Claude Code
  * @param status    Output structure (must be initialized first)
  */
-void load_mccs_status(const cJSON *root, struct mccs_status *status);
+void load_mccs_status(struct json_doc *doc, json_ref root, struct mccs_status *status);
 
 /**
  * Load session_id and transcript_path from JSON
  *
+ * @param doc     Parsed document
  * @param root    Root JSON object
  * @param paths   Output structure for paths
  * @return        ResultVoid - Ok if at least one path was loaded, Err if both failed
  *
  * @error MCCS_ERR_INVALID_JSON if parameters are NULL or both paths missing
  */
-ResultVoid load_mccs_paths(const cJSON *root, struct mccs_paths *paths);
+ResultVoid load_mccs_paths(struct json_doc *doc, json_ref root, struct mccs_paths *paths);
 
 #endif /* MCCS_JSON_PARSER_H */
@@ -0,0 +1,764 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "json_tape.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "debug.h"
+
+#ifdef MCCS_USE_CJSON
+
+void json_doc_init(struct json_doc *doc) {
+  doc->root = NULL;
+  doc->error_offset = 0;
+}
+
+void json_doc_free(struct json_doc *doc) {
+  cJSON_Delete(doc->root);
+  doc->root = NULL;
+}
+
+ResultJsonRef json_doc_parse(struct json_doc *doc,
+                             const char *input,
+                             size_t length) {
+  cJSON_Delete(doc->root);
+  const char *parse_end = NULL;
+  doc->root = cJSON_ParseWithLengthOpts(input, length, &parse_end, false);
+  if (!doc->root) {
+    if (!parse_end) {
+      return ERR(ResultJsonRef, MCCS_ERR_OUT_OF_MEMORY);
+    }
+    doc->error_offset = (size_t)(parse_end - input);
+    return ERR(ResultJsonRef, MCCS_ERR_INVALID_JSON);
+  }
+  return OK(ResultJsonRef, doc->root);
+}
+
+bool json_doc_is_ascii(const struct json_doc *doc) {
+  (void)doc;
+  return false;
+}
+
+enum json_type json_type_of(const struct json_doc *doc,
+                            json_ref ref) {
+  (void)doc;
+  if (!ref) {
+    return JSON_TYPE_NONE;
+  }
+  switch (ref->type & 0xFF) {
+  case cJSON_NULL:
+    return JSON_TYPE_NULL;
+  case cJSON_False:
+    return JSON_TYPE_FALSE;
+  case cJSON_True:
+    return JSON_TYPE_TRUE;
+  case cJSON_Number:
+    return JSON_TYPE_NUMBER;
+  case cJSON_String:
+    return JSON_TYPE_STRING;
+  case cJSON_Array:
+    return JSON_TYPE_ARRAY;
+  case cJSON_Object:
+    return JSON_TYPE_OBJECT;
+  default:
+    return JSON_TYPE_NONE;
+  }
+}
+
+json_ref json_get(struct json_doc *doc,
+                  json_ref obj,
+                  const char *key) {
+  (void)doc;
+  return cJSON_IsObject(obj) ? cJSON_GetObjectItemCaseSensitive(obj, key) : NULL;
+}
+
+json_ref json_first(const struct json_doc *doc,
+                    json_ref array) {
+  (void)doc;
+  return cJSON_IsArray(array) ? array->child : NULL;
+}
+
+json_ref json_next(const struct json_doc *doc,
+                   json_ref array,
+                   json_ref item) {
+  (void)doc;
+  (void)array;
+  return item ? item->next : NULL;
+}
+
+double json_number(const struct json_doc *doc,
+                   json_ref ref) {
+  (void)doc;
+  return cJSON_IsNumber(ref) ? ref->valuedouble : 0;
+}
+
+const char *json_string(struct json_doc *doc,
+                        json_ref ref) {
+  (void)doc;
+  return cJSON_GetStringValue(ref);
+}
+
+size_t json_span(const struct json_doc *doc,
+                 json_ref ref) {
+  if (cJSON_IsString(ref)) {
+    return strlen(ref->valuestring);
+  }
+  if (!cJSON_IsObject(ref) && !cJSON_IsArray(ref)) {
+    return 0;
+  }
+  // Brackets, then each member: its key and colon, quotes, separator
+  size_t span = 2;
+  for (const cJSON *item = ref->child; item; item = item->next) {
+    span += (item->string && cJSON_IsObject(ref) ? strlen(item->string) + 3 : 0) + json_span(doc, item) +
+            (cJSON_IsString(item) ? 2 : 0) + (item->next ? 1 : 0);
+  }
+  return span;
+}
+
+#else /* tape */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__PCLMUL__)
+#include <wmmintrin.h>
+#endif
+
+#define JSON_TAPE_DECODED 0x01 /* string.offset/length refer to doc->strings */
+#define JSON_TAPE_BAD 0x02     /* String holds an invalid escape */
+
+/**
+ * Bit masks of one 64-byte block (bit i = byte i)
+ */
+struct json_block {
+  uint64_t quote;     ///< '"'
+  uint64_t backslash; ///< '\\'
+  uint64_t op;        ///< { } [ ] : ,
+  uint64_t blank;     ///< Space, tab, newline, carriage return
+  uint64_t high;      ///< Bytes above 0x7F
+};
+
+/**
+ * Classify 64 bytes
+ */
+static void json_classify(const unsigned char *p,
+                          struct json_block *b) {
+#if defined(__SSE2__)
+  b->quote = b->backslash = b->op = b->blank = b->high = 0;
+  for (int k = 0; k < 4; k++) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(const void *)(p + 16 * k));
+    __m128i op = _mm_or_si128(
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('{')), _mm_cmpeq_epi8(v, _mm_set1_epi8('}'))),
+                     _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('[')), _mm_cmpeq_epi8(v, _mm_set1_epi8(']')))),
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')), _mm_cmpeq_epi8(v, _mm_set1_epi8(','))));
+    __m128i blank = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+    int shift = 16 * k;
+    b->quote |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))) << shift;
+    b->backslash |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))) << shift;
+    b->op |= (uint64_t)(uint16_t)_mm_movemask_epi8(op) << shift;
+    b->blank |= (uint64_t)(uint16_t)_mm_movemask_epi8(blank) << shift;
+    b->high |= (uint64_t)(uint16_t)_mm_movemask_epi8(v) << shift;
+  }
+#else
+  uint64_t quote = 0, backslash = 0, op = 0, blank = 0, high = 0;
+  for (int i = 0; i < 64; i++) {
+    unsigned char c = p[i];
+    uint64_t bit = 1ULL << i;
+    quote |= c == '"' ? bit : 0;
+    backslash |= c == '\\' ? bit : 0;
+    op |= (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') ? bit : 0;
+    blank |= (c == ' ' || c == '\t' || c == '\n' || c == '\r') ? bit : 0;
+    high |= c >= 0x80 ? bit : 0;
+  }
+  b->quote = quote;
+  b->backslash = backslash;
+  b->op = op;
+  b->blank = blank;
+  b->high = high;
+#endif
+}
+
+/**
+ * Bytes preceded by an unescaped backslash
+ *
+ * @param backslash    Backslash mask of the block
+ * @param carry        In: the block starts escaped; out: the next one does
+ */
+static uint64_t json_escaped(uint64_t backslash,
+                             uint64_t *carry) {
+  uint64_t escaped = *carry;
+  backslash &= ~escaped; // An escaped backslash escapes nothing
+  *carry = 0;
+  while (backslash) {
+    uint64_t bit = backslash & (0 - backslash);
+    if (bit == 1ULL << 63) {
+      *carry = 1;
+    } else {
+      escaped |= bit << 1;
+      backslash &= ~(bit << 1);
+    }
+    backslash &= backslash - 1;
+  }
+  return escaped;
+}
+
+/**
+ * Prefix XOR: bit i is the parity of bits 0..i (set inside strings)
+ */
+static uint64_t json_prefix_xor(uint64_t x) {
+#if defined(__PCLMUL__) && defined(__SSE2__)
+  __m128i all = _mm_set1_epi8((char)0xFF);
+  __m128i r = _mm_clmulepi64_si128(_mm_set_epi64x(0, (long long)x), all, 0);
+  return (uint64_t)_mm_cvtsi128_si64(r);
+#else
+  x ^= x << 1;
+  x ^= x << 2;
+  x ^= x << 4;
+  x ^= x << 8;
+  x ^= x << 16;
+  x ^= x << 32;
+  return x;
+#endif
+}
+
+/**
+ * Stage 1: offsets of the structural bytes
+ *
+ * @param ascii    Output: no byte above 0x7F
+ * @return Number of offsets, or SIZE_MAX if a string is not terminated
+ */
+static size_t json_index(const char *input,
+                         size_t length,
+                         uint32_t *index,
+                         bool *ascii) {
+  size_t count = 0;
+  uint64_t escape_carry = 0;
+  uint64_t string_carry = 0; // All ones while inside a string
+  uint64_t other_carry = 0;  // Last byte of the previous block was part of a scalar
+  uint64_t high = 0;
+  unsigned char tail[64];
+
+  for (size_t base = 0; base < length; base += 64) {
+    const unsigned char *p = (const unsigned char *)input + base;
+    if (length - base < 64) {
+      memset(tail, ' ', sizeof(tail));
+      memcpy(tail, p, length - base);
+      p = tail;
+    }
+    struct json_block b;
+    json_classify(p, &b);
+    high |= b.high;
+
+    uint64_t quote = b.quote & ~json_escaped(b.backslash, &escape_carry);
+    uint64_t in_string = json_prefix_xor(quote) ^ string_carry;
+    string_carry = (uint64_t)((int64_t)in_string >> 63);
+
+    uint64_t other = ~(b.op | b.blank | quote | in_string);
+    uint64_t scalar_start = other & ~((other << 1) | other_carry);
+    other_carry = other >> 63;
+
+    uint64_t structural = (b.op & ~in_string) | quote | scalar_start;
+    while (structural) {
+      index[count++] = (uint32_t)(base + (size_t)__builtin_ctzll(structural));
+      structural &= structural - 1;
+    }
+  }
+  *ascii = high == 0;
+  return string_carry ? SIZE_MAX : count;
+}
+
+/**
+ * Check that a scalar ends at pos (end of input, blank, operator or quote)
+ */
+static bool json_scalar_ends(const char *input,
+                             size_t length,
+                             size_t pos) {
+  if (pos >= length) {
+    return true;
+  }
+  char c = input[pos];
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',' || c == ':' ||
+         c == '}' || c == ']' || c == '{' || c == '[' || c == '"';
+}
+
+/**
+ * Decode a number at pos
+ *
+ * @return Bytes consumed, or 0 if it is not a valid JSON number
+ */
+static size_t json_parse_number(const char *input,
+                                size_t length,
+                                size_t pos,
+                                double *out) {
+  size_t i = pos;
+  bool negative = i < length && input[i] == '-';
+  i += negative;
+  if (i >= length || input[i] < '0' || input[i] > '9') {
+    return 0;
+  }
+  uint64_t mantissa = 0;
+  size_t digits = 0;
+  if (input[i] == '0') {
+    i++;
+  } else {
+    while (i < length && input[i] >= '0' && input[i] <= '9') {
+      mantissa = mantissa * 10 + (uint64_t)(input[i] - '0');
+      digits++;
+      i++;
+    }
+  }
+  bool integral = true;
+  if (i < length && input[i] == '.') {
+    integral = false;
+    i++;
+    size_t start = i;
+    while (i < length && input[i] >= '0' && input[i] <= '9') {
+      i++;
+    }
+    if (i == start) {
+      return 0;
+    }
+  }
+  if (i < length && (input[i] == 'e' || input[i] == 'E')) {
+    integral = false;
+    i++;
+    if (i < length && (input[i] == '+' || input[i] == '-')) {
+      i++;
+    }
+    size_t start = i;
+    while (i < length && input[i] >= '0' && input[i] <= '9') {
+      i++;
+    }
+    if (i == start) {
+      return 0;
+    }
+  }
+  size_t len = i - pos;
+  if (len > JSON_TAPE_MAX_NUMBER || !json_scalar_ends(input, length, i)) {
+    return 0;
+  }
+
+  // Token counts: integers exact in a double need no strtod
+  if (integral && digits <= 15) {
+    *out = negative ? -(double)mantissa : (double)mantissa;
+    return len;
+  }
+  char buf[JSON_TAPE_MAX_NUMBER + 1];
+  memcpy(buf, input + pos, len);
+  buf[len] = '\0';
+  *out = strtod(buf, NULL);
+  return len;
+}
+
+/**
+ * Grow a buffer to hold at least need elements
+ */
+static bool json_reserve(void **buf,
+                         size_t *cap,
+                         size_t need,
+                         size_t elem) {
+  if (need <= *cap) {
+    return true;
+  }
+  size_t grown = *cap * 2 > need ? *cap * 2 : need;
+  void *p = realloc(*buf, grown * elem);
+  if (!p) {
+    return false;
+  }
+  *buf = p;
+  *cap = grown;
+  return true;
+}
+
+void json_doc_init(struct json_doc *doc) {
+  memset(doc, 0, sizeof(*doc));
+}
+
+void json_doc_free(struct json_doc *doc) {
+  free(doc->tape);
+  free(doc->index);
+  free(doc->strings);
+  memset(doc, 0, sizeof(*doc));
+}
+
+/**
+ * Parser states of stage 2
+ */
+enum json_state {
+  JSON_EXPECT_VALUE,
+  JSON_EXPECT_VALUE_OR_END, ///< After '['
+  JSON_EXPECT_KEY,
+  JSON_EXPECT_KEY_OR_END,   ///< After '{'
+  JSON_EXPECT_COLON,
+  JSON_EXPECT_COMMA_OR_END,
+  JSON_EXPECT_NOTHING,      ///< Root value complete
+};
+
+static ResultJsonRef json_fail(struct json_doc *doc,
+                               size_t offset) {
+  doc->error_offset = offset;
+  DEBUG_LOG("JSON syntax error at offset %zu", offset);
+  return ERR(ResultJsonRef, MCCS_ERR_INVALID_JSON);
+}
+
+/**
+ * Close a container at its bracket
+ */
+static inline void json_close(struct json_tape_entry *container,
+                              uint32_t next,
+                              size_t pos) {
+  container->next = next;
+  container->value.span.length = (uint32_t)pos + 1 - container->value.span.offset;
+}
+
+ResultJsonRef json_doc_parse(struct json_doc *doc,
+                             const char *input,
+                             size_t length) {
+  doc->input = input;
+  doc->tape_count = 0;
+  doc->strings_len = 0;
+  doc->error_offset = 0;
+  if (length >= UINT32_MAX) {
+    return json_fail(doc, 0);
+  }
+  if (!json_reserve((void **)&doc->index, &doc->index_cap, length + 1, sizeof(*doc->index)) ||
+      !json_reserve((void **)&doc->strings, &doc->strings_cap, length + 1, 1)) {
+    return ERR(ResultJsonRef, MCCS_ERR_OUT_OF_MEMORY);
+  }
+
+  size_t count = json_index(input, length, doc->index, &doc->ascii);
+  if (count == SIZE_MAX) {
+    return json_fail(doc, length);
+  }
+  if (!json_reserve((void **)&doc->tape, &doc->tape_cap, count + 1, sizeof(*doc->tape))) {
+    return ERR(ResultJsonRef, MCCS_ERR_OUT_OF_MEMORY);
+  }
+
+  const uint32_t *index = doc->index;
+  struct json_tape_entry *tape = doc->tape;
+  uint32_t n = 0;
+  uint32_t stack[JSON_TAPE_MAX_DEPTH];
+  size_t depth = 0;
+  enum json_state state = JSON_EXPECT_VALUE;
+
+  for (size_t i = 0; i < count; i++) {
+    size_t pos = index[i];
+    char c = input[pos];
+    bool value_done = false;
+
+    switch (state) {
+    case JSON_EXPECT_KEY_OR_END:
+    case JSON_EXPECT_VALUE_OR_END:
+      if (c == (state == JSON_EXPECT_KEY_OR_END ? '}' : ']')) {
+        json_close(&tape[stack[--depth]], n, pos);
+        value_done = true;
+        break;
+      }
+      if (state == JSON_EXPECT_VALUE_OR_END) {
+        goto value;
+      }
+      // fall through
+    case JSON_EXPECT_KEY:
+      if (c != '"') {
+        return json_fail(doc, pos);
+      }
+      tape[n] = (struct json_tape_entry){.type = JSON_TYPE_STRING, .next = n + 1};
+      tape[n].value.string.offset = (uint32_t)pos + 1;
+      tape[n].value.string.length = index[i + 1] - (uint32_t)pos - 1;
+      n++;
+      i++; // Closing quote
+      state = JSON_EXPECT_COLON;
+      break;
+    case JSON_EXPECT_COLON:
+      if (c != ':') {
+        return json_fail(doc, pos);
+      }
+      state = JSON_EXPECT_VALUE;
+      break;
+    case JSON_EXPECT_COMMA_OR_END: {
+      bool in_object = tape[stack[depth - 1]].type == JSON_TYPE_OBJECT;
+      if (c == ',') {
+        state = in_object ? JSON_EXPECT_KEY : JSON_EXPECT_VALUE;
+      } else if (c == (in_object ? '}' : ']')) {
+        json_close(&tape[stack[--depth]], n, pos);
+        value_done = true;
+      } else {
+        return json_fail(doc, pos);
+      }
+      break;
+    }
+    case JSON_EXPECT_NOTHING:
+      return json_fail(doc, pos);
+    case JSON_EXPECT_VALUE:
+    value:
+      tape[n] = (struct json_tape_entry){.next = n + 1};
+      if (c == '{' || c == '[') {
+        if (depth == JSON_TAPE_MAX_DEPTH) {
+          return json_fail(doc, pos);
+        }
+        tape[n].type = c == '{' ? JSON_TYPE_OBJECT : JSON_TYPE_ARRAY;
+        tape[n].value.span.offset = (uint32_t)pos;
+        stack[depth++] = n++;
+        state = c == '{' ? JSON_EXPECT_KEY_OR_END : JSON_EXPECT_VALUE_OR_END;
+        break;
+      }
+      if (c == '"') {
+        tape[n].type = JSON_TYPE_STRING;
+        tape[n].value.string.offset = (uint32_t)pos + 1;
+        tape[n].value.string.length = index[i + 1] - (uint32_t)pos - 1;
+        i++;
+      } else if (c == 't' || c == 'f' || c == 'n') {
+        const char *word = c == 't' ? "true" : (c == 'f' ? "false" : "null");
+        size_t len = strlen(word);
+        if (length - pos < len || memcmp(input + pos, word, len) != 0 ||
+            !json_scalar_ends(input, length, pos + len)) {
+          return json_fail(doc, pos);
+        }
+        tape[n].type = c == 't' ? JSON_TYPE_TRUE : (c == 'f' ? JSON_TYPE_FALSE : JSON_TYPE_NULL);
+      } else {
+        if (json_parse_number(input, length, pos, &tape[n].value.number) == 0) {
+          return json_fail(doc, pos);
+        }
+        tape[n].type = JSON_TYPE_NUMBER;
+      }
+      n++;
+      value_done = true;
+      break;
+    }
+
+    if (value_done) {
+      state = depth == 0 ? JSON_EXPECT_NOTHING : JSON_EXPECT_COMMA_OR_END;
+    }
+  }
+
+  if (state != JSON_EXPECT_NOTHING) {
+    return json_fail(doc, length);
+  }
+  doc->tape_count = n;
+  return OK(ResultJsonRef, 0);
+}
+
+bool json_doc_is_ascii(const struct json_doc *doc) {
+  return doc->ascii;
+}
+
+enum json_type json_type_of(const struct json_doc *doc,
+                            json_ref ref) {
+  return ref < doc->tape_count ? (enum json_type)doc->tape[ref].type : JSON_TYPE_NONE;
+}
+
+/**
+ * Value of four hex digits (-1 if malformed)
+ */
+static long json_hex4(const char *p,
+                      const char *end) {
+  if (end - p < 4) {
+    return -1;
+  }
+  long value = 0;
+  for (int i = 0; i < 4; i++) {
+    char c = p[i];
+    int digit = c >= '0' && c <= '9' ? c - '0'
+                : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                : c >= 'A' && c <= 'F' ? c - 'A' + 10
+                                       : -1;
+    if (digit < 0) {
+      return -1;
+    }
+    value = value * 16 + digit;
+  }
+  return value;
+}
+
+/**
+ * Unescape a raw string span into out
+ *
+ * @return Decoded length, or SIZE_MAX on a bad escape
+ */
+static size_t json_unescape(const char *raw,
+                            size_t len,
+                            char *out) {
+  const char *p = raw;
+  const char *end = raw + len;
+  char *o = out;
+  while (p < end) {
+    const char *bs = memchr(p, '\\', (size_t)(end - p));
+    size_t plain = (size_t)((bs ? bs : end) - p);
+    memcpy(o, p, plain);
+    o += plain;
+    p += plain;
+    if (!bs) {
+      break;
+    }
+    if (end - p < 2) {
+      return SIZE_MAX;
+    }
+    char e = p[1];
+    p += 2;
+    switch (e) {
+    case '"':
+    case '\\':
+    case '/':
+      *o++ = e;
+      break;
+    case 'b':
+      *o++ = '\b';
+      break;
+    case 'f':
+      *o++ = '\f';
+      break;
+    case 'n':
+      *o++ = '\n';
+      break;
+    case 'r':
+      *o++ = '\r';
+      break;
+    case 't':
+      *o++ = '\t';
+      break;
+    case 'u': {
+      long cp = json_hex4(p, end);
+      if (cp < 0) {
+        return SIZE_MAX;
+      }
+      p += 4;
+      if (cp >= 0xDC00 && cp <= 0xDFFF) {
+        return SIZE_MAX;
+      }
+      if (cp >= 0xD800 && cp <= 0xDBFF) {
+        long low = end - p >= 6 && p[0] == '\\' && p[1] == 'u' ? json_hex4(p + 2, end) : -1;
+        if (low < 0xDC00 || low > 0xDFFF) {
+          return SIZE_MAX;
+        }
+        p += 6;
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+      }
+      // UTF-8 is never longer than the 6 or 12 escape bytes it replaces
+      if (cp < 0x80) {
+        *o++ = (char)cp;
+      } else if (cp < 0x800) {
+        *o++ = (char)(0xC0 | (cp >> 6));
+        *o++ = (char)(0x80 | (cp & 0x3F));
+      } else if (cp < 0x10000) {
+        *o++ = (char)(0xE0 | (cp >> 12));
+        *o++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *o++ = (char)(0x80 | (cp & 0x3F));
+      } else {
+        *o++ = (char)(0xF0 | (cp >> 18));
+        *o++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+        *o++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *o++ = (char)(0x80 | (cp & 0x3F));
+      }
+      break;
+    }
+    default:
+      return SIZE_MAX;
+    }
+  }
+  return (size_t)(o - out);
+}
+
+/**
+ * Decode a string entry into doc->strings (once)
+ */
+static bool json_decode(struct json_doc *doc,
+                        struct json_tape_entry *e) {
+  if (e->flags & JSON_TAPE_DECODED) {
+    return true;
+  }
+  if (e->flags & JSON_TAPE_BAD) {
+    return false;
+  }
+  // Decoded strings never exceed their raw span: strings_cap covers the whole input
+  char *out = doc->strings + doc->strings_len;
+  size_t len = json_unescape(doc->input + e->value.string.offset, e->value.string.length, out);
+  if (len == SIZE_MAX) {
+    e->flags |= JSON_TAPE_BAD;
+    return false;
+  }
+  out[len] = '\0';
+  e->value.string.offset = (uint32_t)doc->strings_len;
+  e->value.string.length = (uint32_t)len;
+  e->flags |= JSON_TAPE_DECODED;
+  doc->strings_len += len + 1;
+  return true;
+}
+
+size_t json_span(const struct json_doc *doc,
+                 json_ref ref) {
+  switch (json_type_of(doc, ref)) {
+  case JSON_TYPE_STRING:
+    return doc->tape[ref].value.string.length;
+  case JSON_TYPE_OBJECT:
+  case JSON_TYPE_ARRAY:
+    return doc->tape[ref].value.span.length;
+  default:
+    return 0;
+  }
+}
+
+const char *json_string(struct json_doc *doc,
+                        json_ref ref) {
+  if (json_type_of(doc, ref) != JSON_TYPE_STRING) {
+    return NULL;
+  }
+  struct json_tape_entry *e = &doc->tape[ref];
+  return json_decode(doc, e) ? doc->strings + e->value.string.offset : NULL;
+}
+
+json_ref json_get(struct json_doc *doc,
+                  json_ref obj,
+                  const char *key) {
+  if (json_type_of(doc, obj) != JSON_TYPE_OBJECT) {
+    return JSON_REF_NONE;
+  }
+  size_t key_len = strlen(key);
+  uint32_t end = doc->tape[obj].next;
+  for (uint32_t k = obj + 1; k < end; k = doc->tape[k + 1].next) {
+    struct json_tape_entry *e = &doc->tape[k];
+    const char *name;
+    if (e->flags & JSON_TAPE_DECODED) {
+      name = doc->strings + e->value.string.offset;
+    } else {
+      name = doc->input + e->value.string.offset;
+      // An escaped key only matches after decoding
+      if (e->value.string.length != key_len &&
+          memchr(name, '\\', e->value.string.length) != NULL && json_decode(doc, e)) {
+        name = doc->strings + e->value.string.offset;
+      }
+    }
+    if (e->value.string.length == key_len && memcmp(name, key, key_len) == 0) {
+      return k + 1;
+    }
+  }
+  return JSON_REF_NONE;
+}
+
+json_ref json_first(const struct json_doc *doc,
+                    json_ref array) {
+  if (json_type_of(doc, array) != JSON_TYPE_ARRAY || array + 1 >= doc->tape[array].next) {
+    return JSON_REF_NONE;
+  }
+  return array + 1;
+}
+
+json_ref json_next(const struct json_doc *doc,
+                   json_ref array,
+                   json_ref item) {
+  // Elements follow each other; the array's next is the position after the last one
+  if (item == JSON_REF_NONE || doc->tape[item].next >= doc->tape[array].next) {
+    return JSON_REF_NONE;
+  }
+  return doc->tape[item].next;
+}
+
+double json_number(const struct json_doc *doc,
+                   json_ref ref) {
+  return json_type_of(doc, ref) == JSON_TYPE_NUMBER ? doc->tape[ref].value.number : 0;
+}
+
+#endif /* MCCS_USE_CJSON */
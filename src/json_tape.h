@@ -0,0 +1,272 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file json_tape.h
+ * @brief Two-stage JSON parser producing a flat tape, with a small navigation API
+ *
+ * Stage 1 classifies the input 64 bytes at a time (SSE2 compares where
+ * available) into bit masks of quotes, backslashes, operators and blanks,
+ * removes escaped quotes, computes which bytes are inside strings with a
+ * prefix XOR and writes the offsets of all structural bytes into an index:
+ * operators outside strings, every unescaped quote and the first byte of
+ * each number or literal.
+ *
+ * Stage 2 walks the index once and appends one 16-byte entry per value to a
+ * contiguous tape. Containers store the tape position just past their last
+ * member, so a lookup skips whole subtrees; object members are a key entry
+ * followed by the value. Numbers and literals are decoded here; strings only
+ * record their raw span in the input and are unescaped on first access,
+ * since most of a transcript line is message text nobody reads. Containers
+ * record their span too, so the size of a subtree is known without
+ * walking or decoding it.
+ *
+ * A json_doc keeps its buffers between parses (one allocation pattern per
+ * line length, not one malloc per value) and points into the input, which
+ * must stay unchanged while the document is used.
+ *
+ * Building with MCCS_USE_CJSON (make JSON=cjson) implements the same API on
+ * top of cJSON, for comparison.
+ */
+
+#ifndef MCCS_JSON_TAPE_H
+#define MCCS_JSON_TAPE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "result.h"
+
+#ifdef MCCS_USE_CJSON
+#include "lib/cjson/cJSON.h"
+typedef const cJSON *json_ref; ///< Value handle (node pointer)
+#define JSON_REF_NONE NULL
+#else
+typedef uint32_t json_ref; ///< Value handle (tape position)
+#define JSON_REF_NONE UINT32_MAX
+#endif
+
+#define JSON_TAPE_MAX_DEPTH 1000 /* Nesting limit (same as cJSON) */
+#define JSON_TAPE_MAX_NUMBER 63  /* Longest accepted number literal */
+
+DEFINE_RESULT(ResultJsonRef, json_ref, enum MccsError);
+
+/**
+ * Value types
+ */
+enum json_type {
+  JSON_TYPE_NONE = 0, ///< Missing value (JSON_REF_NONE)
+  JSON_TYPE_NULL,
+  JSON_TYPE_FALSE,
+  JSON_TYPE_TRUE,
+  JSON_TYPE_NUMBER,
+  JSON_TYPE_STRING,
+  JSON_TYPE_ARRAY,
+  JSON_TYPE_OBJECT,
+};
+
+#ifndef MCCS_USE_CJSON
+/**
+ * One tape entry
+ */
+struct json_tape_entry {
+  uint8_t type;  ///< enum json_type
+  uint8_t flags; ///< JSON_TAPE_* string state
+  uint16_t reserved;
+  uint32_t next; ///< Tape position after this value (and its members)
+  union {
+    double number; ///< JSON_TYPE_NUMBER
+    struct {
+      uint32_t offset; ///< Raw span in the input, or decoded copy in strings
+      uint32_t length; ///< Length of the span or of the decoded copy
+    } string;          ///< JSON_TYPE_STRING
+    struct {
+      uint32_t offset; ///< Input offset of the opening bracket
+      uint32_t length; ///< Bytes up to and including the closing bracket
+    } span;            ///< JSON_TYPE_OBJECT, JSON_TYPE_ARRAY
+  } value;
+};
+#endif
+
+/**
+ * Parsed document and its reusable buffers
+ */
+struct json_doc {
+#ifdef MCCS_USE_CJSON
+  cJSON *root; ///< Parsed tree (NULL before the first parse)
+#else
+  const char *input;             ///< Parsed input (not owned)
+  struct json_tape_entry *tape;  ///< Values in document order
+  uint32_t tape_count;           ///< Entries in use
+  size_t tape_cap;               ///< Allocated entries
+  uint32_t *index;               ///< Stage 1 output: structural offsets
+  size_t index_cap;              ///< Allocated offsets
+  char *strings;                 ///< Decoded strings (NUL-terminated)
+  size_t strings_len;            ///< Bytes in use
+  size_t strings_cap;            ///< Allocated bytes (enough for every string of the input)
+  bool ascii;                    ///< No input byte above 0x7F (found by stage 1)
+#endif
+  size_t error_offset; ///< Input offset of the last syntax error
+};
+
+/**
+ * Initialize an empty document
+ *
+ * @param doc    Document to initialize
+ */
+void json_doc_init(struct json_doc *doc);
+
+/**
+ * Release the buffers of a document
+ *
+ * @param doc    Document to free (may be reused after json_doc_init)
+ */
+void json_doc_free(struct json_doc *doc);
+
+/**
+ * Parse a JSON text, replacing the previous contents of doc
+ *
+ * @param doc       Document (buffers are reused)
+ * @param input     JSON text (need not be NUL-terminated; must outlive the use of doc)
+ * @param length    Length of input
+ * @return          Result<json_ref> - Ok with the root value or Err with error code
+ *
+ * @note Whitespace may surround the value; anything else after it is an error.
+ * @note String escapes are checked when the string is first read: a string
+ *       with a bad escape reads as missing.
+ * @error MCCS_ERR_INVALID_JSON on syntax errors (doc->error_offset is set)
+ * @error MCCS_ERR_OUT_OF_MEMORY if the buffers cannot grow
+ */
+ResultJsonRef json_doc_parse(struct json_doc *doc,
+                             const char *input,
+                             size_t length);
+
+/**
+ * Check whether the parsed input was pure ASCII
+ *
+ * @param doc    Parsed document
+ * @return       true if no byte is above 0x7F (always false with MCCS_USE_CJSON)
+ *
+ * @note Lets callers skip UTF-8 validation of strings copied out of the document.
+ */
+bool json_doc_is_ascii(const struct json_doc *doc);
+
+/**
+ * Type of a value
+ *
+ * @param doc    Parsed document
+ * @param ref    Value handle (JSON_REF_NONE gives JSON_TYPE_NONE)
+ * @return       Value type
+ */
+enum json_type json_type_of(const struct json_doc *doc,
+                            json_ref ref);
+
+/**
+ * Member of an object by key (case-sensitive, first match)
+ *
+ * @param doc    Parsed document
+ * @param obj    Object handle
+ * @param key    Member name
+ * @return       Member value, or JSON_REF_NONE if obj is not an object or has no such key
+ */
+json_ref json_get(struct json_doc *doc,
+                  json_ref obj,
+                  const char *key);
+
+/**
+ * First element of an array
+ *
+ * @param doc      Parsed document
+ * @param array    Array handle
+ * @return         First element, or JSON_REF_NONE if array is not an array or is empty
+ */
+json_ref json_first(const struct json_doc *doc,
+                    json_ref array);
+
+/**
+ * Element after another one of the same array
+ *
+ * @param doc      Parsed document
+ * @param array    Array handle
+ * @param item     Element of array (from json_first() or json_next())
+ * @return         Next element, or JSON_REF_NONE after the last one
+ */
+json_ref json_next(const struct json_doc *doc,
+                   json_ref array,
+                   json_ref item);
+
+/**
+ * Number value
+ *
+ * @return       The number, or 0 if ref is not a number
+ */
+double json_number(const struct json_doc *doc,
+                   json_ref ref);
+
+/**
+ * String value
+ *
+ * @return       NUL-terminated decoded string (valid until the next parse),
+ *               or NULL if ref is not a string or holds a bad escape
+ */
+const char *json_string(struct json_doc *doc,
+                        json_ref ref);
+
+/**
+ * Bytes a value takes in the input, without decoding it
+ *
+ * @param doc    Parsed document
+ * @param ref    Value handle
+ * @return       Escaped length between the quotes for a string (its
+ *               decoded length once json_string() has read it), bracket
+ *               to bracket for a container, 0 for other values
+ *
+ * @note With MCCS_USE_CJSON the source is gone: containers are measured
+ *       by walking the tree, as the compact form of their members
+ */
+size_t json_span(const struct json_doc *doc,
+                 json_ref ref);
+
+/**
+ * Check whether a value is an object
+ */
+static inline bool json_is_object(const struct json_doc *doc,
+                                  json_ref ref) {
+  return json_type_of(doc, ref) == JSON_TYPE_OBJECT;
+}
+
+/**
+ * Check whether a value is a number
+ */
+static inline bool json_is_number(const struct json_doc *doc,
+                                  json_ref ref) {
+  return json_type_of(doc, ref) == JSON_TYPE_NUMBER;
+}
+
+/**
+ * Check whether a value is a string
+ */
+static inline bool json_is_string(const struct json_doc *doc,
+                                  json_ref ref) {
+  return json_type_of(doc, ref) == JSON_TYPE_STRING;
+}
+
+/**
+ * Check whether a value is true or false
+ */
+static inline bool json_is_bool(const struct json_doc *doc,
+                                json_ref ref) {
+  enum json_type type = json_type_of(doc, ref);
+  return type == JSON_TYPE_TRUE || type == JSON_TYPE_FALSE;
+}
+
+/**
+ * Check whether a value is true
+ */
+static inline bool json_is_true(const struct json_doc *doc,
+                                json_ref ref) {
+  return json_type_of(doc, ref) == JSON_TYPE_TRUE;
+}
+
+#endif /* MCCS_JSON_TAPE_H */
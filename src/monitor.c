@@ -0,0 +1,681 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "monitor.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cache.h"
+#include "constants.h"
+#include "debug.h"
+#include "render_ctx.h"
+#include "safe_conv.h"
+#include "sgr.h"
+#include "token_calculator.h"
+#include "utf8.h"
+
+#define MONITOR_BURN_SAMPLES 16     /* Token totals kept per session for the burn rate */
+#define MONITOR_BURN_MIN_MS 10000   /* Shortest span a burn rate is reported over */
+#define MONITOR_MAX_ROWS 128        /* Screen rows drawn at most */
+#define MONITOR_HEADER_ROWS 2       /* Title and column headings */
+#define MONITOR_DEFAULT_ROWS 24     /* Screen height when the terminal size is unknown */
+#define MONITOR_CELL_SIZE 48        /* Bytes per cell text (including terminator) */
+#define MONITOR_NAME_SIZE 64        /* Cache file name buffer */
+#define MONITOR_COLUMN_GAP 2        /* Spaces between columns */
+#define MONITOR_CTX_WARN_PCT 80     /* Context percentage shown in the warning color */
+#define MONITOR_OUT_BUFFER 65536    /* stdout buffer: one write per tick */
+
+enum monitor_column {
+  MONITOR_COL_PROJECT,
+  MONITOR_COL_SESSION,
+  MONITOR_COL_CTX,
+  MONITOR_COL_CONTEXT,
+  MONITOR_COL_TOTAL,
+  MONITOR_COL_BURN,
+  MONITOR_COL_COST,
+  MONITOR_COL_LAST,
+  MONITOR_COLUMNS
+};
+
+struct monitor_column_spec {
+  const char *title; ///< Column heading
+  int width;         ///< Display width in characters
+  bool right;        ///< Right-align the cell text
+};
+
+static const struct monitor_column_spec monitor_columns[MONITOR_COLUMNS] = {
+    [MONITOR_COL_PROJECT] = {"PROJECT", 24, false},
+    [MONITOR_COL_SESSION] = {"SESSION", 8, false},
+    [MONITOR_COL_CTX] = {"CTX", 4, true},
+    [MONITOR_COL_CONTEXT] = {"CONTEXT", 7, true},
+    [MONITOR_COL_TOTAL] = {"TOTAL", 7, true},
+    [MONITOR_COL_BURN] = {"BURN/MIN", 8, true},
+    [MONITOR_COL_COST] = {"COST", 8, true},
+    [MONITOR_COL_LAST] = {"LAST", 8, false},
+};
+
+/**
+ * Session token total at one point in time
+ */
+struct monitor_sample {
+  int64_t t_ms;   ///< CLOCK_MONOTONIC time (ms)
+  uint64_t total; ///< Session total tokens
+};
+
+/**
+ * Everything the monitor knows about one session
+ */
+struct monitor_session {
+  char name[MONITOR_NAME_SIZE];                      ///< Cache file name
+  bool seen;                                         ///< Cache file found in the current scan
+  bool cache_loaded;                                 ///< cache holds a readable record
+  struct timespec cache_mtime;                       ///< Cache mtime when last read
+  off_t cache_size;                                  ///< Cache size when last read
+  struct token_cache cache;                          ///< Last cache record read
+  struct transcript_stats stats;                     ///< Token data, advanced by tailing the transcript
+  int64_t last_activity;                             ///< Last transcript or cache write (epoch seconds)
+  struct monitor_sample samples[MONITOR_BURN_SAMPLES]; ///< Ring of token totals
+  uint32_t sample_count;                             ///< Valid samples
+  uint32_t sample_next;                              ///< Ring slot written next
+};
+
+/**
+ * One screen cell: text and the theme style it is drawn in
+ */
+struct monitor_cell {
+  char text[MONITOR_CELL_SIZE];
+  const char *style;
+};
+
+/**
+ * Full screen contents (row-major grid of cells)
+ */
+struct monitor_frame {
+  uint32_t rows;
+  struct monitor_cell cells[MONITOR_MAX_ROWS][MONITOR_COLUMNS];
+};
+
+struct monitor_state {
+  struct mccs_render_ctx ctx;                         ///< Output stream, theme and SGR state
+  struct monitor_session *sessions;                   ///< MONITOR_MAX_SESSIONS slots
+  size_t count;                                       ///< Sessions in use
+  struct monitor_session *order[MONITOR_MAX_SESSIONS]; ///< Displayed sessions, most recent first
+  size_t shown_count;                                 ///< Valid entries of order
+  struct monitor_frame *frame;                        ///< Frame being built
+  struct monitor_frame *shown;                        ///< Frame currently on screen
+};
+
+static volatile sig_atomic_t monitor_quit = 0;
+static volatile sig_atomic_t monitor_resized = 0;
+
+static void monitor_on_signal(int sig) {
+  if (sig == SIGWINCH) {
+    monitor_resized = 1;
+  } else {
+    monitor_quit = 1;
+  }
+}
+
+/**
+ * Milliseconds on the system-wide monotonic clock
+ */
+static int64_t monitor_now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / MS_TO_NANOSEC;
+}
+
+/**
+ * Find the session tracked under a cache file name, adding it if new
+ *
+ * @return    Session slot, or NULL when MONITOR_MAX_SESSIONS are tracked
+ */
+static struct monitor_session *monitor_find(struct monitor_state *st,
+                                            const char *name) {
+  for (size_t i = 0; i < st->count; i++) {
+    if (strcmp(st->sessions[i].name, name) == 0) {
+      return &st->sessions[i];
+    }
+  }
+  if (st->count >= MONITOR_MAX_SESSIONS) {
+    return NULL;
+  }
+
+  struct monitor_session *s = &st->sessions[st->count++];
+  memset(s, 0, sizeof(*s));
+  snprintf(s->name, sizeof(s->name), "%s", name);
+  init_transcript_stats(&s->stats);
+  return s;
+}
+
+/**
+ * Re-read a session's cache file and adopt its statistics if they are newer
+ */
+static void monitor_load_cache(struct monitor_state *st,
+                               struct monitor_session *s) {
+  char path[BUF_PATH_SIZE + MONITOR_NAME_SIZE];
+  snprintf(path, sizeof(path), "%s/%s", st->ctx.cache_dir, s->name);
+
+  ResultTokenCache cache_result = read_cache_file(path);
+  if (IS_ERR(cache_result)) {
+    DEBUG_LOG("Monitor: skipping unreadable cache %s", s->name);
+    return;
+  }
+
+  struct token_cache cache = UNWRAP_OK(cache_result);
+  bool same_transcript = s->cache_loaded &&
+                         s->cache.transcript_hash == cache.transcript_hash &&
+                         strcmp(s->cache.transcript_path, cache.transcript_path) == 0;
+  if (!same_transcript || cache.transcript_file_size >= s->stats.parsed_offset) {
+    // The status line parsed at least as far as we did: take its numbers
+    s->stats.session_tokens = cache.session_tokens;
+    s->stats.context_tokens = cache.context_tokens;
+    s->stats.top_turns = cache.top_turns;
+    s->stats.compactions = cache.compactions;
+    s->stats.segment_tokens = cache.segment_tokens;
+    s->stats.prompt_cache = cache.prompt_cache;
+    // The rest of the scan state, so the tail parse resumes where the status line stopped
+    s->stats.turn = cache.turn;
+    s->stats.activity = cache.activity;
+    s->stats.api_errors = cache.api_errors;
+    s->stats.files = cache.files;
+    s->stats.branch = cache.branch;
+    s->stats.chunks = cache.chunks;
+    s->stats.parsed_offset = cache.transcript_file_size;
+  }
+  s->cache = cache;
+  s->cache_loaded = true;
+}
+
+/**
+ * Record the session total for the burn rate (at most one sample per slot width)
+ */
+static void monitor_sample(struct monitor_session *s,
+                           int64_t now_ms) {
+  uint64_t total = s->stats.session_tokens.total_tokens;
+  if (s->sample_count > 0) {
+    const struct monitor_sample *newest =
+        &s->samples[(s->sample_next + MONITOR_BURN_SAMPLES - 1) % MONITOR_BURN_SAMPLES];
+    if (newest->total == total ||
+        now_ms - newest->t_ms < MONITOR_BURN_WINDOW_MS / MONITOR_BURN_SAMPLES) {
+      return;
+    }
+  }
+
+  s->samples[s->sample_next] = (struct monitor_sample){.t_ms = now_ms, .total = total};
+  s->sample_next = (s->sample_next + 1) % MONITOR_BURN_SAMPLES;
+  if (s->sample_count < MONITOR_BURN_SAMPLES) {
+    s->sample_count++;
+  }
+}
+
+/**
+ * Tokens per minute over the burn window
+ *
+ * @return    false while less than MONITOR_BURN_MIN_MS of history is available
+ */
+static bool monitor_burn_rate(const struct monitor_session *s,
+                              int64_t now_ms,
+                              uint64_t *rate) {
+  if (s->sample_count == 0) {
+    return false;
+  }
+
+  // Baseline: the newest sample that is already outside the window, or the oldest one
+  uint32_t oldest = (s->sample_next + MONITOR_BURN_SAMPLES - s->sample_count) % MONITOR_BURN_SAMPLES;
+  const struct monitor_sample *base = &s->samples[oldest];
+  for (uint32_t i = 1; i < s->sample_count; i++) {
+    const struct monitor_sample *sample = &s->samples[(oldest + i) % MONITOR_BURN_SAMPLES];
+    if (now_ms - sample->t_ms < MONITOR_BURN_WINDOW_MS) {
+      break;
+    }
+    base = sample;
+  }
+
+  int64_t elapsed = now_ms - base->t_ms;
+  if (elapsed < MONITOR_BURN_MIN_MS) {
+    return false;
+  }
+  uint64_t total = s->stats.session_tokens.total_tokens;
+  uint64_t delta = total >= base->total ? total - base->total : 0;
+  *rate = delta * 60000 / (uint64_t)elapsed;
+  return true;
+}
+
+/**
+ * Fold transcript bytes appended since the last tick into the session
+ */
+static void monitor_tail(struct monitor_state *st,
+                         struct monitor_session *s,
+                         int64_t now_ms) {
+  s->last_activity = s->cache.last_update_time;
+
+  struct stat ts;
+  if (s->cache.transcript_path[0] != '\0' && stat(s->cache.transcript_path, &ts) == 0) {
+    if ((int64_t)ts.st_mtime > s->last_activity) {
+      s->last_activity = (int64_t)ts.st_mtime;
+    }
+
+    ResultSize size_result = safe_off_to_size(ts.st_size);
+    size_t size = IS_OK(size_result) ? UNWRAP_OK(size_result) : 0;
+    if (size < s->stats.parsed_offset) {
+      // Rewritten rather than appended: start over
+      init_transcript_stats(&s->stats);
+    }
+    if (size > s->stats.parsed_offset) {
+      ResultVoid scan_result = scan_transcript(s->cache.transcript_path, &st->ctx.scratch, &s->stats);
+      if (IS_ERR(scan_result)) {
+        DEBUG_LOG("Monitor: transcript scan failed for %s", s->name);
+      }
+    }
+  }
+
+  monitor_sample(s, now_ms);
+}
+
+/**
+ * Scan the cache directory and bring every active session up to date
+ */
+static void monitor_refresh(struct monitor_state *st,
+                            int64_t now_ms) {
+  DIR *dir = opendir(st->ctx.cache_dir);
+  if (!dir) {
+    return;
+  }
+
+  for (size_t i = 0; i < st->count; i++) {
+    st->sessions[i].seen = false;
+  }
+
+  int64_t now = (int64_t)time(NULL);
+  int dfd = dirfd(dir);
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != NULL) {
+    const char *name = entry->d_name;
+    size_t len = strlen(name);
+    if (len <= strlen(".cache") || len >= MONITOR_NAME_SIZE ||
+        strcmp(name + len - strlen(".cache"), ".cache") != 0) {
+      continue;
+    }
+
+    struct stat cs;
+    if (fstatat(dfd, name, &cs, 0) != 0 || now - (int64_t)cs.st_mtime > MONITOR_ACTIVE_WINDOW_S) {
+      continue;
+    }
+
+    struct monitor_session *s = monitor_find(st, name);
+    if (!s) {
+      continue;
+    }
+    s->seen = true;
+
+    // Only caches written since the last tick are read again
+    if (cs.st_mtim.tv_sec != s->cache_mtime.tv_sec || cs.st_mtim.tv_nsec != s->cache_mtime.tv_nsec ||
+        cs.st_size != s->cache_size) {
+      s->cache_mtime = cs.st_mtim;
+      s->cache_size = cs.st_size;
+      monitor_load_cache(st, s);
+    }
+  }
+  closedir(dir);
+
+  // Drop sessions whose cache went away or went quiet
+  size_t kept = 0;
+  for (size_t i = 0; i < st->count; i++) {
+    if (st->sessions[i].seen) {
+      if (kept != i) {
+        st->sessions[kept] = st->sessions[i];
+      }
+      kept++;
+    }
+  }
+  st->count = kept;
+
+  st->shown_count = 0;
+  for (size_t i = 0; i < st->count; i++) {
+    struct monitor_session *s = &st->sessions[i];
+    if (s->cache_loaded) {
+      monitor_tail(st, s, now_ms);
+      st->order[st->shown_count++] = s;
+    }
+  }
+}
+
+/**
+ * Most recently active sessions first, then by cache name for a stable order
+ */
+static int monitor_compare(const void *a,
+                           const void *b) {
+  const struct monitor_session *sa = *(const struct monitor_session *const *)a;
+  const struct monitor_session *sb = *(const struct monitor_session *const *)b;
+  if (sa->last_activity != sb->last_activity) {
+    return sa->last_activity > sb->last_activity ? -1 : 1;
+  }
+  return strcmp(sa->name, sb->name);
+}
+
+static void monitor_cell_set(struct monitor_cell *cell,
+                             const char *style,
+                             const char *fmt,
+                             ...) __attribute__((format(printf, 3, 4)));
+
+static void monitor_cell_set(struct monitor_cell *cell,
+                             const char *style,
+                             const char *fmt,
+                             ...) {
+  va_list args;
+  va_start(args, fmt);
+  int written = vsnprintf(cell->text, sizeof(cell->text), fmt, args);
+  va_end(args);
+  if (written >= (int)sizeof(cell->text)) {
+    // Cut short: drop a codepoint split by the terminator
+    cell->text[utf8_trim_partial(cell->text, sizeof(cell->text) - 1)] = '\0';
+  }
+  cell->style = style;
+}
+
+/**
+ * Fill one session row
+ */
+static void monitor_build_row(struct monitor_state *st,
+                              struct monitor_cell *row,
+                              const struct monitor_session *s,
+                              int64_t now_ms) {
+  const struct color_theme *theme = &st->ctx.theme;
+  char value[MONITOR_CELL_SIZE];
+
+  const char *project = strrchr(s->cache.project_dir, '/');
+  project = project && project[1] != '\0' ? project + 1 : s->cache.project_dir;
+  monitor_cell_set(&row[MONITOR_COL_PROJECT], theme->dir, "%s", project[0] != '\0' ? project : "-");
+  monitor_cell_set(&row[MONITOR_COL_SESSION], theme->label, "%.8s", s->cache.session_id);
+
+  uint32_t pct = calculate_percentage(s->stats.context_tokens, DEFAULT_TOKEN_LIMIT, false);
+  monitor_cell_set(&row[MONITOR_COL_CTX], pct >= MONITOR_CTX_WARN_PCT ? theme->badge_over : theme->progress_ctx,
+                   "%u%%", pct);
+
+  format_tokens(value, sizeof(value), s->stats.context_tokens);
+  monitor_cell_set(&row[MONITOR_COL_CONTEXT], theme->progress_ctx, "%s", value);
+
+  format_tokens(value, sizeof(value), s->stats.session_tokens.total_tokens);
+  monitor_cell_set(&row[MONITOR_COL_TOTAL], theme->progress_ses, "%s", value);
+
+  uint64_t rate = 0;
+  if (monitor_burn_rate(s, now_ms, &rate)) {
+    format_tokens(value, sizeof(value), rate);
+    monitor_cell_set(&row[MONITOR_COL_BURN], theme->token_output, "%s", value);
+  } else {
+    monitor_cell_set(&row[MONITOR_COL_BURN], theme->token_output, "-");
+  }
+
+  if (isnan(s->cache.cost_usd)) {
+    monitor_cell_set(&row[MONITOR_COL_COST], theme->cost, "-");
+  } else {
+    monitor_cell_set(&row[MONITOR_COL_COST], theme->cost, "$%.2f", s->cache.cost_usd);
+  }
+
+  // Absolute time: the cell only changes when the session does
+  time_t last = (time_t)s->last_activity;
+  struct tm tm_last;
+  if (localtime_r(&last, &tm_last) && strftime(value, sizeof(value), "%H:%M:%S", &tm_last) > 0) {
+    monitor_cell_set(&row[MONITOR_COL_LAST], theme->time_total, "%s", value);
+  } else {
+    monitor_cell_set(&row[MONITOR_COL_LAST], theme->time_total, "-");
+  }
+}
+
+/**
+ * Lay out the next frame: title, headings, then one row per session
+ */
+static void monitor_build(struct monitor_state *st,
+                          int64_t now_ms,
+                          uint32_t max_rows) {
+  struct monitor_frame *frame = st->frame;
+  const struct color_theme *theme = &st->ctx.theme;
+
+  qsort(st->order, st->shown_count, sizeof(st->order[0]), monitor_compare);
+
+  size_t rows = MONITOR_HEADER_ROWS + st->shown_count;
+  frame->rows = rows < max_rows ? (uint32_t)rows : max_rows;
+
+  for (uint32_t r = 0; r < frame->rows && r < MONITOR_HEADER_ROWS; r++) {
+    for (size_t c = 0; c < MONITOR_COLUMNS; c++) {
+      monitor_cell_set(&frame->cells[r][c], NULL, "%s", "");
+    }
+  }
+
+  if (frame->rows > 0) {
+    monitor_cell_set(&frame->cells[0][MONITOR_COL_PROJECT], theme->model_name,
+                     "mini-ccstatus top: %zu", st->shown_count);
+    char clock[MONITOR_CELL_SIZE] = "";
+    time_t now = time(NULL);
+    struct tm tm_now;
+    if (localtime_r(&now, &tm_now)) {
+      strftime(clock, sizeof(clock), "%H:%M:%S", &tm_now);
+    }
+    monitor_cell_set(&frame->cells[0][MONITOR_COL_LAST], theme->time_total, "%s", clock);
+  }
+  if (frame->rows > 1) {
+    for (size_t c = 0; c < MONITOR_COLUMNS; c++) {
+      monitor_cell_set(&frame->cells[1][c], theme->label, "%s", monitor_columns[c].title);
+    }
+  }
+
+  for (uint32_t r = MONITOR_HEADER_ROWS; r < frame->rows; r++) {
+    monitor_build_row(st, frame->cells[r], st->order[r - MONITOR_HEADER_ROWS], now_ms);
+  }
+}
+
+/**
+ * Write one cell padded (or truncated) to its column width
+ */
+static void monitor_put_cell(struct mccs_render_ctx *ctx,
+                             size_t column,
+                             const struct monitor_cell *cell,
+                             bool pad) {
+  const struct monitor_column_spec *spec = &monitor_columns[column];
+  // Widths count codepoints, so multi-byte names are neither split nor misaligned
+  size_t shown = 0;
+  size_t bytes = utf8_prefix(cell->text, strlen(cell->text), (size_t)spec->width, &shown);
+  int fill = spec->right || pad ? spec->width - (int)shown : 0;
+  sgr_set(ctx, cell->style);
+  if (spec->right) {
+    fprintf(ctx->out, "%*s%.*s", fill, "", (int)bytes, cell->text);
+  } else {
+    fprintf(ctx->out, "%.*s%*s", (int)bytes, cell->text, fill, "");
+  }
+}
+
+/**
+ * Print the frame as plain lines (top --once)
+ */
+static void monitor_print(struct monitor_state *st) {
+  struct mccs_render_ctx *ctx = &st->ctx;
+  for (uint32_t r = 0; r < st->frame->rows; r++) {
+    for (size_t c = 0; c < MONITOR_COLUMNS; c++) {
+      bool last = (c + 1 == MONITOR_COLUMNS);
+      monitor_put_cell(ctx, c, &st->frame->cells[r][c], !last);
+      if (!last) {
+        sgr_set(ctx, NULL);
+        fprintf(ctx->out, "%*s", MONITOR_COLUMN_GAP, "");
+      }
+    }
+    sgr_end_line(ctx);
+  }
+}
+
+/**
+ * Bring the screen from the shown frame to the built one
+ *
+ * @param full    Repaint everything (first frame, resize)
+ *
+ * @note Only cells whose text or style changed are rewritten; each costs a
+ *       cursor move plus the padded cell.
+ */
+static void monitor_draw(struct monitor_state *st,
+                         bool full) {
+  struct mccs_render_ctx *ctx = &st->ctx;
+  const struct monitor_frame *frame = st->frame;
+  const struct monitor_frame *shown = st->shown;
+
+  if (full) {
+    sgr_set(ctx, NULL);
+    fputs("\033[2J", ctx->out);
+  }
+
+  for (uint32_t r = 0; r < frame->rows; r++) {
+    int col = 1;
+    for (size_t c = 0; c < MONITOR_COLUMNS; c++) {
+      const struct monitor_cell *cell = &frame->cells[r][c];
+      const struct monitor_cell *prev = &shown->cells[r][c];
+      if (full || r >= shown->rows || cell->style != prev->style || strcmp(cell->text, prev->text) != 0) {
+        fprintf(ctx->out, "\033[%u;%dH", r + 1, col);
+        monitor_put_cell(ctx, c, cell, true);
+      }
+      col += monitor_columns[c].width + MONITOR_COLUMN_GAP;
+    }
+  }
+
+  if (!full) {
+    sgr_set(ctx, NULL);
+    for (uint32_t r = frame->rows; r < shown->rows; r++) {
+      fprintf(ctx->out, "\033[%u;1H\033[2K", r + 1);
+    }
+  }
+
+  sgr_set(ctx, NULL);
+  fflush(ctx->out);
+
+  struct monitor_frame *tmp = st->shown;
+  st->shown = st->frame;
+  st->frame = tmp;
+}
+
+/**
+ * Terminal height, capped to MONITOR_MAX_ROWS
+ */
+static uint32_t monitor_screen_rows(void) {
+  struct winsize ws;
+  uint32_t rows = MONITOR_DEFAULT_ROWS;
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0) {
+    rows = ws.ws_row;
+  }
+  return rows < MONITOR_MAX_ROWS ? rows : MONITOR_MAX_ROWS;
+}
+
+/**
+ * Sleep until the next tick or a key press
+ *
+ * @return    true if the user asked to quit
+ */
+static bool monitor_wait(bool keys) {
+  struct pollfd pfd = {.fd = STDIN_FILENO, .events = POLLIN, .revents = 0};
+  if (poll(&pfd, keys ? 1 : 0, MONITOR_REFRESH_MS) > 0 && (pfd.revents & POLLIN)) {
+    char input[16];
+    ssize_t got = read(STDIN_FILENO, input, sizeof(input));
+    for (ssize_t i = 0; i < got; i++) {
+      if (input[i] == 'q' || input[i] == 'Q') {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static void monitor_free(struct monitor_state *st) {
+  mccs_render_ctx_free(&st->ctx);
+  free(st->sessions);
+  free(st->frame);
+  free(st->shown);
+  free(st);
+}
+
+int mccs_run_top(const struct cli_options *opts,
+                 bool use_color) {
+  struct monitor_state *st = calloc(1, sizeof(*st));
+  if (!st) {
+    return MCCS_ERROR_MEMORY;
+  }
+  mccs_render_ctx_init(&st->ctx, use_color, false, MCCS_STDOUT);
+  mccs_render_ctx_set_colors(&st->ctx, opts->theme_colors);
+  st->sessions = calloc(MONITOR_MAX_SESSIONS, sizeof(*st->sessions));
+  st->frame = calloc(1, sizeof(*st->frame));
+  st->shown = calloc(1, sizeof(*st->shown));
+  if (!st->sessions || !st->frame || !st->shown) {
+    monitor_free(st);
+    return MCCS_ERROR_MEMORY;
+  }
+  get_cache_dir(&st->ctx);
+
+  if (opts->top_once) {
+    int64_t now_ms = monitor_now_ms();
+    monitor_refresh(st, now_ms);
+    monitor_build(st, now_ms, MONITOR_MAX_ROWS);
+    monitor_print(st);
+    monitor_free(st);
+    return 0;
+  }
+
+  static char out_buffer[MONITOR_OUT_BUFFER];
+  setvbuf(st->ctx.out, out_buffer, _IOFBF, sizeof(out_buffer));
+
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = monitor_on_signal;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+  sigaction(SIGHUP, &sa, NULL);
+  sigaction(SIGWINCH, &sa, NULL);
+
+  // Unbuffered, silent keyboard so a single 'q' quits
+  struct termios saved;
+  bool keys = isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &saved) == 0;
+  if (keys) {
+    struct termios raw = saved;
+    raw.c_lflag &= ~(tcflag_t)(ICANON | ECHO);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+  }
+
+  fputs("\033[?1049h\033[?25l", st->ctx.out);
+
+  bool full = true;
+  while (!monitor_quit) {
+    if (monitor_resized) {
+      monitor_resized = 0;
+      full = true;
+    }
+    int64_t now_ms = monitor_now_ms();
+    monitor_refresh(st, now_ms);
+    monitor_build(st, now_ms, monitor_screen_rows());
+    monitor_draw(st, full);
+    full = false;
+    if (monitor_wait(keys)) {
+      break;
+    }
+  }
+
+  sgr_set(&st->ctx, NULL);
+  fputs("\033[?25h\033[?1049l", st->ctx.out);
+  fflush(st->ctx.out);
+  if (keys) {
+    tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+  }
+
+  monitor_free(st);
+  return 0;
+}
@@ -0,0 +1,41 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file monitor.h
+ * @brief Live full-screen view of every active session (mini-ccstatus top)
+ *
+ * Watches the per-user cache directory and shows one row per session with
+ * context usage, burn rate, cost and last activity. Each tick only re-reads
+ * cache files whose mtime or size changed and only parses bytes appended to
+ * transcripts since the previous tick; the screen is kept as a grid of cells
+ * and only cells whose content changed are rewritten, using cursor
+ * addressing on the alternate screen.
+ */
+
+#ifndef MCCS_MONITOR_H
+#define MCCS_MONITOR_H
+
+#include <stdbool.h>
+
+#include "types_struct.h"
+
+#define MONITOR_MAX_SESSIONS 256          /* Sessions tracked at once */
+#define MONITOR_REFRESH_MS 1000           /* Tick interval */
+#define MONITOR_ACTIVE_WINDOW_S 3600      /* Caches untouched for longer are hidden */
+#define MONITOR_BURN_WINDOW_MS 300000     /* Burn rate averaging window (5 min) */
+
+/**
+ * Run the session monitor until the user quits (q, Ctrl-C)
+ *
+ * @param opts         CLI options (top_once prints one frame and returns)
+ * @param use_color    Whether to use ANSI color codes
+ * @return             Exit code (0 on success, MCCS_ERROR_IO on failure)
+ *
+ * @note Sessions appear once a status line render with token segments
+ *       enabled has written their cache.
+ */
+int mccs_run_top(const struct cli_options *opts,
+                 bool use_color);
+
+#endif /* MCCS_MONITOR_H */
@@ -0,0 +1,220 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "project_root.h"
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cache.h"
+#include "debug.h"
+
+#define PROJECT_ROOT_MAGIC 0xCCCE0001
+
+/**
+ * Cached answer for one directory
+ */
+struct project_root_entry {
+  char dir[BUF_PATH_SIZE]; ///< Normalized directory path (key)
+  uint32_t root_len;       ///< Length of the root prefix of dir (0 = none)
+  uint32_t found;          ///< Non-zero if dir is inside a repository
+  int64_t dir_mtime_ns;    ///< mtime of dir when walked
+  int64_t root_mtime_ns;   ///< mtime of the root when walked (found only)
+  int64_t walked_at;       ///< Time of the walk (epoch s)
+};
+
+/**
+ * On-disk table (written whole, replaced atomically)
+ */
+struct project_root_table {
+  uint32_t magic;                                              ///< PROJECT_ROOT_MAGIC
+  uint32_t next;                                               ///< Next slot to replace
+  struct project_root_entry entries[PROJECT_ROOT_CACHE_ENTRIES]; ///< Remembered directories
+};
+
+/**
+ * Copy dir without trailing slashes
+ *
+ * @return Length of the copy, or 0 if dir is not an absolute path that fits
+ */
+static size_t project_root_normalize(const char *dir,
+                                     char *out) {
+  if (!dir || dir[0] != '/') {
+    return 0;
+  }
+  size_t len = strlen(dir);
+  if (len >= BUF_PATH_SIZE) {
+    return 0;
+  }
+  while (len > 1 && dir[len - 1] == '/') {
+    len--;
+  }
+  memcpy(out, dir, len);
+  out[len] = '\0';
+  return len;
+}
+
+/**
+ * mtime of a path prefix in nanoseconds (-1 if it cannot be stat'ed)
+ */
+static int64_t project_root_mtime(const char *path,
+                                  size_t len) {
+  char prefix[BUF_PATH_SIZE];
+  memcpy(prefix, path, len);
+  prefix[len] = '\0';
+  struct stat st;
+  if (stat(prefix, &st) != 0) {
+    return -1;
+  }
+  return (int64_t)st.st_mtim.tv_sec * 1000000000 + (int64_t)st.st_mtim.tv_nsec;
+}
+
+/**
+ * Walk up from a normalized directory of length len
+ */
+static bool project_root_walk_normalized(const char *dir,
+                                         size_t len,
+                                         size_t *root_len) {
+  char probe[BUF_PATH_SIZE + sizeof("/" PROJECT_ROOT_MARKER)];
+  struct stat st;
+  while (true) {
+    // "/" has no separator to add: probe "/.git", not "//.git"
+    snprintf(probe, sizeof(probe), "%.*s/%s", (int)(len > 1 ? len : 0), dir, PROJECT_ROOT_MARKER);
+    if (stat(probe, &st) == 0) {
+      *root_len = len;
+      return true;
+    }
+    if (len == 1) {
+      *root_len = 0;
+      return false;
+    }
+    while (len > 1 && dir[len - 1] != '/') {
+      len--;
+    }
+    if (len > 1) {
+      len--; // Drop the separator, keep "/" as the last candidate
+    }
+  }
+}
+
+bool project_root_walk(const char *dir,
+                       size_t *root_len) {
+  char norm[BUF_PATH_SIZE];
+  size_t len = project_root_normalize(dir, norm);
+  *root_len = 0;
+  return len > 0 && project_root_walk_normalized(norm, len, root_len);
+}
+
+/**
+ * Read the table (false if missing, short or from another version)
+ */
+static bool project_root_read(const char *path,
+                              struct project_root_table *table) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  bool ok = read(fd, table, sizeof(*table)) == (ssize_t)sizeof(*table) &&
+            table->magic == PROJECT_ROOT_MAGIC;
+  close(fd);
+  return ok;
+}
+
+/**
+ * Replace the table through a temporary file and rename()
+ */
+static void project_root_write(const char *cache_dir,
+                               const char *path,
+                               const struct project_root_table *table) {
+  char tmp[BUF_PATH_SIZE];
+  snprintf(tmp, sizeof(tmp), "%s/roots.XXXXXX", cache_dir);
+  int fd = mkstemp(tmp);
+  if (fd < 0) {
+    DEBUG_LOG("Project root table: cannot create %s", tmp);
+    return;
+  }
+  bool ok = write(fd, table, sizeof(*table)) == (ssize_t)sizeof(*table);
+  close(fd);
+  if (!ok || rename(tmp, path) != 0) {
+    DEBUG_LOG("Project root table: write failed");
+    unlink(tmp);
+  }
+}
+
+bool find_project_root(struct mccs_render_ctx *ctx,
+                       const char *dir,
+                       size_t *root_len) {
+  char norm[BUF_PATH_SIZE];
+  size_t len = project_root_normalize(dir, norm);
+  *root_len = 0;
+  if (len == 0) {
+    return false;
+  }
+
+  size_t depth = 0;
+  for (size_t i = 0; i < len; i++) {
+    depth += norm[i] == '/';
+  }
+  if (depth <= PROJECT_ROOT_WALK_DEPTH) {
+    return project_root_walk_normalized(norm, len, root_len);
+  }
+
+  const char *cache_dir = get_cache_dir(ctx);
+  char path[BUF_PATH_SIZE];
+  snprintf(path, sizeof(path), "%s/%s", cache_dir, PROJECT_ROOT_CACHE_FILE);
+
+  struct project_root_table table;
+  bool loaded = project_root_read(path, &table);
+  if (!loaded) {
+    memset(&table, 0, sizeof(table));
+    table.magic = PROJECT_ROOT_MAGIC;
+  }
+
+  int64_t now = (int64_t)time(NULL);
+  int64_t dir_mtime = project_root_mtime(norm, len);
+  struct project_root_entry *slot = NULL;
+  for (size_t i = 0; loaded && i < PROJECT_ROOT_CACHE_ENTRIES; i++) {
+    struct project_root_entry *e = &table.entries[i];
+    if (strcmp(e->dir, norm) != 0) {
+      continue;
+    }
+    slot = e;
+    bool fresh = e->walked_at <= now && now - e->walked_at < PROJECT_ROOT_RECHECK_S &&
+                 e->dir_mtime_ns == dir_mtime && dir_mtime >= 0 && e->root_len <= len &&
+                 (!e->found || project_root_mtime(norm, e->root_len) == e->root_mtime_ns);
+    if (fresh) {
+      DEBUG_LOG("Project root cache hit for %s", norm);
+      *root_len = e->found ? e->root_len : 0;
+      return e->found != 0;
+    }
+    break;
+  }
+
+  DEBUG_LOG("Project root cache miss for %s, walking up", norm);
+  size_t found_len = 0;
+  bool found = project_root_walk_normalized(norm, len, &found_len);
+  *root_len = found_len;
+  if (dir_mtime < 0) {
+    return found;
+  }
+
+  if (!slot) {
+    slot = &table.entries[table.next % PROJECT_ROOT_CACHE_ENTRIES];
+    table.next = (table.next + 1) % PROJECT_ROOT_CACHE_ENTRIES;
+  }
+  memset(slot, 0, sizeof(*slot));
+  memcpy(slot->dir, norm, len + 1);
+  slot->root_len = (uint32_t)found_len;
+  slot->found = found;
+  slot->dir_mtime_ns = dir_mtime;
+  slot->root_mtime_ns = found ? project_root_mtime(norm, found_len) : 0;
+  slot->walked_at = now;
+  project_root_write(cache_dir, path, &table);
+  return found;
+}
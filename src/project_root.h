@@ -0,0 +1,63 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file project_root.h
+ * @brief Repository root detection with a persistent per-user cache
+ *
+ * The directory segment shows the working directory relative to the
+ * repository that contains it (the nearest ancestor holding a .git entry).
+ * Finding it walks up one level at a time, so the answer for each directory
+ * is kept in a small table in /tmp/mini-ccstatus/<uid>/roots.cache together
+ * with the mtimes of the directory and of the root it resolved to. A render
+ * then costs one table read and two stats instead of one stat per level.
+ *
+ * Creating or removing .git in the directory itself or in the root changes
+ * their mtimes and invalidates the entry at once; a .git appearing in an
+ * intermediate directory is picked up by the periodic re-walk
+ * (PROJECT_ROOT_RECHECK_S).
+ */
+
+#ifndef MCCS_PROJECT_ROOT_H
+#define MCCS_PROJECT_ROOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "render_ctx.h"
+
+#define PROJECT_ROOT_MARKER ".git"              /* Entry marking a repository root */
+#define PROJECT_ROOT_CACHE_FILE "roots.cache"   /* Table file inside the cache directory */
+#define PROJECT_ROOT_CACHE_ENTRIES 16           /* Directories remembered (oldest replaced first) */
+#define PROJECT_ROOT_RECHECK_S 60               /* Re-walk a cached directory at least this often */
+#define PROJECT_ROOT_WALK_DEPTH 4               /* Paths this shallow are walked directly (cheaper than the table) */
+
+/**
+ * Find the repository root of a directory by walking up its ancestors
+ *
+ * @param dir         Absolute directory path (trailing slashes ignored)
+ * @param root_len    Output: length of the root prefix of dir (0 = none)
+ * @return            true if an ancestor (or dir itself) holds PROJECT_ROOT_MARKER
+ *
+ * @note Uncached: one stat per level until the root or "/" is reached
+ */
+bool project_root_walk(const char *dir,
+                       size_t *root_len);
+
+/**
+ * Find the repository root of a directory through the per-user cache
+ *
+ * @param ctx         Render context owning the cache directory buffer
+ * @param dir         Absolute directory path (trailing slashes ignored)
+ * @param root_len    Output: length of the root prefix of dir (0 = none)
+ * @return            true if dir is inside a repository
+ *
+ * @note Falls back to project_root_walk() when the table is missing, stale
+ *       or unreadable, and then stores the fresh answer (best effort).
+ * @note Paths of at most PROJECT_ROOT_WALK_DEPTH components skip the table.
+ */
+bool find_project_root(struct mccs_render_ctx *ctx,
+                       const char *dir,
+                       size_t *root_len);
+
+#endif /* MCCS_PROJECT_ROOT_H */
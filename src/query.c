@@ -0,0 +1,541 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "query.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "constants.h"
+#include "history.h"
+#include "render_ctx.h"
+
+#define SECONDS_PER_DAY 86400
+#define QUERY_LABEL_SIZE 16 /* "YYYY-MM-DD" plus margin */
+
+enum query_dim {
+  QUERY_DIM_SESSION,
+  QUERY_DIM_MODEL,
+  QUERY_DIM_DAY,
+  QUERY_DIM_WEEK
+};
+
+static const char *const query_dim_names[] = {"session", "model", "day", "week"};
+static const char *const query_dim_headers[] = {"SESSION", "MODEL", "DAY", "WEEK"};
+
+enum query_sort {
+  QUERY_SORT_TURNS,
+  QUERY_SORT_INPUT,
+  QUERY_SORT_OUTPUT,
+  QUERY_SORT_CACHE_WRITE,
+  QUERY_SORT_CACHE_READ,
+  QUERY_SORT_TOTAL,
+  QUERY_SORT_CACHE_EFF,
+  QUERY_SORT_COUNT
+};
+
+static const char *const query_sort_names[QUERY_SORT_COUNT] = {
+    "turns", "input", "output", "cache-write", "cache-read", "total", "cache-eff"};
+
+/**
+ * Parsed query with the dense group table it fills
+ */
+struct query_plan {
+  enum query_dim dims[QUERY_MAX_DIMS]; ///< Group dimensions, outermost first
+  size_t dim_count;                    ///< Dimensions in use (0 = one overall group)
+  int64_t since;                       ///< First accepted ts (inclusive)
+  int64_t until;                       ///< Last accepted ts (exclusive)
+  bool time_filter;                    ///< since/until narrow the range
+  bool time_dims;                      ///< A day or week dimension is used
+  int64_t first_bucket[QUERY_MAX_DIMS]; ///< First day/week number of a time dimension
+  uint32_t card[QUERY_MAX_DIMS];       ///< Keys per dimension
+  size_t groups;                       ///< Product of card
+  uint8_t *allowed_models;             ///< Per model code: 1 if --model accepts it (NULL = all)
+  uint64_t *turns;                     ///< Turns per group
+  uint64_t *sums[HISTORY_TOKEN_COLUMNS]; ///< Token sums per group and column
+};
+
+/**
+ * Days since 1970-01-01 of a proleptic Gregorian date
+ */
+static int64_t query_days_from_civil(int64_t y,
+                                     int64_t m,
+                                     int64_t d) {
+  y -= m <= 2;
+  int64_t era = (y >= 0 ? y : y - 399) / 400;
+  int64_t yoe = y - era * 400;
+  int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+/**
+ * Format a day number as YYYY-MM-DD
+ */
+static void query_format_day(int64_t days,
+                             char *out,
+                             size_t size) {
+  time_t t = (time_t)(days * SECONDS_PER_DAY);
+  struct tm tm;
+  if (!gmtime_r(&t, &tm)) {
+    snprintf(out, size, "%s", UNKNOWN_VALUE);
+    return;
+  }
+  strftime(out, size, "%Y-%m-%d", &tm);
+}
+
+/**
+ * Parse YYYY-MM-DD into seconds since epoch at 00:00 UTC
+ */
+static bool query_parse_day(const char *text,
+                            int64_t *out) {
+  int y = 0, m = 0, d = 0, used = 0;
+  if (sscanf(text, "%4d-%2d-%2d%n", &y, &m, &d, &used) != 3 || text[used] != '\0' ||
+      m < 1 || m > 12 || d < 1 || d > 31) {
+    return false;
+  }
+  *out = query_days_from_civil(y, m, d) * SECONDS_PER_DAY;
+  return true;
+}
+
+/**
+ * Day number of a ts (floor division, so pre-epoch times stay consistent)
+ */
+static inline int64_t query_day(int64_t ts) {
+  return ts >= 0 ? ts / SECONDS_PER_DAY : (ts - SECONDS_PER_DAY + 1) / SECONDS_PER_DAY;
+}
+
+/**
+ * Week number of a ts; week w starts on the Monday of day 7 * w - 3
+ */
+static inline int64_t query_week(int64_t ts) {
+  int64_t shifted = query_day(ts) + 3;
+  return shifted >= 0 ? shifted / 7 : (shifted - 6) / 7;
+}
+
+static bool query_parse_dims(const char *by,
+                             struct query_plan *plan) {
+  if (!by || !*by) {
+    return true;
+  }
+  const char *p = by;
+  while (*p) {
+    size_t len = strcspn(p, ",");
+    bool found = false;
+    for (size_t d = 0; d < sizeof(query_dim_names) / sizeof(query_dim_names[0]); d++) {
+      if (strlen(query_dim_names[d]) == len && strncmp(p, query_dim_names[d], len) == 0) {
+        if (plan->dim_count == QUERY_MAX_DIMS) {
+          return false;
+        }
+        plan->dims[plan->dim_count++] = (enum query_dim)d;
+        found = true;
+      }
+    }
+    if (!found) {
+      return false;
+    }
+    p += len;
+    if (*p == ',') {
+      p++;
+    }
+  }
+  return true;
+}
+
+/**
+ * Time range of the rows a time dimension has to cover
+ *
+ * @return false if no row is both dated and inside the --since/--until window
+ */
+static bool query_time_span(const struct history_view *view,
+                            const struct query_plan *plan,
+                            int64_t *lo,
+                            int64_t *hi) {
+  int64_t min_ts = INT64_MAX;
+  int64_t max_ts = INT64_MIN;
+  for (size_t i = 0; i < view->rows; i++) {
+    int64_t ts = view->ts[i];
+    if (ts > 0 && ts >= plan->since && ts < plan->until) {
+      min_ts = ts < min_ts ? ts : min_ts;
+      max_ts = ts > max_ts ? ts : max_ts;
+    }
+  }
+  *lo = min_ts;
+  *hi = max_ts;
+  return min_ts <= max_ts;
+}
+
+/**
+ * Size the dense group table from the dimensions and the data
+ *
+ * @return false if the table would exceed QUERY_MAX_GROUPS
+ */
+static bool query_plan_groups(const struct history_view *view,
+                              struct query_plan *plan) {
+  int64_t lo = 0, hi = -1;
+  bool dated = plan->time_dims && query_time_span(view, plan, &lo, &hi);
+
+  uint64_t groups = 1;
+  for (size_t d = 0; d < plan->dim_count; d++) {
+    uint64_t card = 0;
+    switch (plan->dims[d]) {
+    case QUERY_DIM_SESSION:
+      card = view->session_count;
+      break;
+    case QUERY_DIM_MODEL:
+      card = view->model_count;
+      break;
+    case QUERY_DIM_DAY:
+      plan->first_bucket[d] = dated ? query_day(lo) : 0;
+      card = dated ? (uint64_t)(query_day(hi) - plan->first_bucket[d] + 1) : 0;
+      break;
+    case QUERY_DIM_WEEK:
+      plan->first_bucket[d] = dated ? query_week(lo) : 0;
+      card = dated ? (uint64_t)(query_week(hi) - plan->first_bucket[d] + 1) : 0;
+      break;
+    }
+    if (card > QUERY_MAX_GROUPS) {
+      return false;
+    }
+    plan->card[d] = (uint32_t)card;
+    groups *= card;
+    if (groups > QUERY_MAX_GROUPS) {
+      return false;
+    }
+  }
+  plan->groups = (size_t)groups;
+  return true;
+}
+
+/**
+ * Key of row i in dimension d (the row must have passed the filters)
+ */
+static inline uint32_t query_key(const struct history_view *view,
+                                 const struct query_plan *plan,
+                                 size_t d,
+                                 size_t i) {
+  switch (plan->dims[d]) {
+  case QUERY_DIM_SESSION:
+    return view->session[i];
+  case QUERY_DIM_MODEL:
+    return view->model[i];
+  case QUERY_DIM_DAY:
+    return (uint32_t)(query_day(view->ts[i]) - plan->first_bucket[d]);
+  case QUERY_DIM_WEEK:
+    return (uint32_t)(query_week(view->ts[i]) - plan->first_bucket[d]);
+  }
+  return 0;
+}
+
+/**
+ * Accumulate every row of the view into the group table
+ *
+ * @return Rows scanned (blocks skipped by the index are not counted)
+ */
+static size_t query_scan(const struct history_view *view,
+                         struct query_plan *plan) {
+  static uint32_t sel[HISTORY_BLOCK_ROWS];
+  static uint32_t gid[HISTORY_BLOCK_ROWS];
+  size_t scanned = 0;
+  uint32_t session_count = (uint32_t)view->session_count;
+  uint32_t model_count = (uint32_t)view->model_count;
+
+  for (size_t start = 0; start < view->rows; start += HISTORY_BLOCK_ROWS) {
+    size_t block = start / HISTORY_BLOCK_ROWS;
+    if (plan->time_filter && block < view->blocks &&
+        (view->index[block].max_ts < plan->since || view->index[block].min_ts >= plan->until)) {
+      continue;
+    }
+    size_t end = start + HISTORY_BLOCK_ROWS < view->rows ? start + HISTORY_BLOCK_ROWS : view->rows;
+    scanned += end - start;
+
+    // Selection vector: every row is written, only accepted rows advance n
+    size_t n = 0;
+    for (size_t i = start; i < end; i++) {
+      int64_t ts = view->ts[i];
+      uint32_t model = view->model[i];
+      uint32_t in_dict = (uint32_t)(model < model_count) & (uint32_t)(view->session[i] < session_count);
+      uint32_t keep = (uint32_t)(ts >= plan->since) & (uint32_t)(ts < plan->until) & in_dict &
+                      (uint32_t)(!plan->time_dims || ts > 0);
+      keep &= plan->allowed_models ? (uint32_t)plan->allowed_models[model < model_count ? model : 0] : 1u;
+      sel[n] = (uint32_t)i;
+      n += keep;
+    }
+    if (n == 0) {
+      continue;
+    }
+
+    for (size_t j = 0; j < n; j++) {
+      uint32_t g = 0;
+      for (size_t d = 0; d < plan->dim_count; d++) {
+        g = g * plan->card[d] + query_key(view, plan, d, sel[j]);
+      }
+      gid[j] = g;
+    }
+
+    for (size_t j = 0; j < n; j++) {
+      plan->turns[gid[j]]++;
+    }
+    for (size_t c = 0; c < HISTORY_TOKEN_COLUMNS; c++) {
+      const uint64_t *column = view->tokens[c];
+      uint64_t *sums = plan->sums[c];
+      for (size_t j = 0; j < n; j++) {
+        sums[gid[j]] += column[sel[j]];
+      }
+    }
+  }
+  return scanned;
+}
+
+static enum query_sort query_sort_key;
+static const struct query_plan *query_sort_plan;
+
+static double query_metric(uint32_t g) {
+  const struct query_plan *plan = query_sort_plan;
+  uint64_t write = plan->sums[HISTORY_CACHE_WRITE][g];
+  uint64_t read = plan->sums[HISTORY_CACHE_READ][g];
+  switch (query_sort_key) {
+  case QUERY_SORT_TURNS:
+    return (double)plan->turns[g];
+  case QUERY_SORT_INPUT:
+    return (double)plan->sums[HISTORY_INPUT][g];
+  case QUERY_SORT_OUTPUT:
+    return (double)plan->sums[HISTORY_OUTPUT][g];
+  case QUERY_SORT_CACHE_WRITE:
+    return (double)write;
+  case QUERY_SORT_CACHE_READ:
+    return (double)read;
+  case QUERY_SORT_CACHE_EFF:
+    return write + read ? (double)read / (double)(write + read) : 0.0;
+  case QUERY_SORT_TOTAL:
+  case QUERY_SORT_COUNT:
+    break;
+  }
+  return (double)plan->sums[HISTORY_INPUT][g] + (double)plan->sums[HISTORY_OUTPUT][g] +
+         (double)write + (double)read;
+}
+
+/**
+ * qsort comparator: descending metric, then ascending group (stable keys)
+ */
+static int query_compare(const void *a,
+                         const void *b) {
+  uint32_t ga = *(const uint32_t *)a;
+  uint32_t gb = *(const uint32_t *)b;
+  double ma = query_metric(ga);
+  double mb = query_metric(gb);
+  if (ma != mb) {
+    return ma < mb ? 1 : -1;
+  }
+  return ga < gb ? -1 : (ga > gb ? 1 : 0);
+}
+
+/**
+ * Label of key k in dimension d
+ */
+static const char *query_label(const struct history_view *view,
+                               const struct query_plan *plan,
+                               size_t d,
+                               uint32_t k,
+                               char *buf,
+                               size_t size) {
+  switch (plan->dims[d]) {
+  case QUERY_DIM_SESSION:
+    return view->sessions[k];
+  case QUERY_DIM_MODEL:
+    return *view->models[k] ? view->models[k] : UNKNOWN_VALUE;
+  case QUERY_DIM_DAY:
+    query_format_day(plan->first_bucket[d] + k, buf, size);
+    return buf;
+  case QUERY_DIM_WEEK:
+    query_format_day((plan->first_bucket[d] + k) * 7 - 3, buf, size);
+    return buf;
+  }
+  return UNKNOWN_VALUE;
+}
+
+/**
+ * Print the non-empty groups as a table
+ */
+static int query_print(const struct history_view *view,
+                       const struct query_plan *plan,
+                       const struct query_options *q,
+                       enum query_sort sort,
+                       size_t scanned,
+                       double elapsed_ms) {
+  uint32_t *order = malloc((plan->groups ? plan->groups : 1) * sizeof(*order));
+  if (!order) {
+    return MCCS_ERROR_MEMORY;
+  }
+  size_t count = 0;
+  uint64_t turns = 0;
+  for (size_t g = 0; g < plan->groups; g++) {
+    if (plan->turns[g] > 0) {
+      order[count++] = (uint32_t)g;
+      turns += plan->turns[g];
+    }
+  }
+
+  query_sort_key = sort;
+  query_sort_plan = plan;
+  qsort(order, count, sizeof(*order), query_compare);
+  if (q->reverse) {
+    for (size_t i = 0; i < count / 2; i++) {
+      uint32_t tmp = order[i];
+      order[i] = order[count - 1 - i];
+      order[count - 1 - i] = tmp;
+    }
+  }
+
+  // Key columns are as wide as their longest label
+  int widths[QUERY_MAX_DIMS] = {0};
+  char buf[QUERY_LABEL_SIZE];
+  for (size_t d = 0; d < plan->dim_count; d++) {
+    widths[d] = (int)strlen(query_dim_headers[plan->dims[d]]);
+    for (size_t i = 0; i < count; i++) {
+      uint32_t k = order[i];
+      for (size_t e = plan->dim_count; e-- > d + 1;) {
+        k /= plan->card[e];
+      }
+      k %= plan->card[d];
+      int len = (int)strlen(query_label(view, plan, d, k, buf, sizeof(buf)));
+      widths[d] = len > widths[d] ? len : widths[d];
+    }
+  }
+
+  FILE *out = MCCS_STDOUT;
+  for (size_t d = 0; d < plan->dim_count; d++) {
+    fprintf(out, "%-*s  ", widths[d], query_dim_headers[plan->dims[d]]);
+  }
+  fprintf(out, "%10s %14s %14s %14s %14s %15s %7s\n",
+          "TURNS", "INPUT", "OUTPUT", "CACHE_W", "CACHE_R", "TOTAL", "CACHE%");
+
+  size_t shown = q->limit && q->limit < count ? q->limit : count;
+  for (size_t i = 0; i < shown; i++) {
+    uint32_t g = order[i];
+    uint32_t rest = g;
+    uint32_t keys[QUERY_MAX_DIMS] = {0};
+    for (size_t d = plan->dim_count; d-- > 0;) {
+      keys[d] = rest % plan->card[d];
+      rest /= plan->card[d];
+    }
+    for (size_t d = 0; d < plan->dim_count; d++) {
+      fprintf(out, "%-*s  ", widths[d], query_label(view, plan, d, keys[d], buf, sizeof(buf)));
+    }
+    uint64_t input = plan->sums[HISTORY_INPUT][g];
+    uint64_t output = plan->sums[HISTORY_OUTPUT][g];
+    uint64_t write = plan->sums[HISTORY_CACHE_WRITE][g];
+    uint64_t read = plan->sums[HISTORY_CACHE_READ][g];
+    fprintf(out, "%10" PRIu64 " %14" PRIu64 " %14" PRIu64 " %14" PRIu64 " %14" PRIu64 " %15" PRIu64 " %6.1f%%\n",
+            plan->turns[g], input, output, write, read, input + output + write + read,
+            write + read ? 100.0 * (double)read / (double)(write + read) : 0.0);
+  }
+  fprintf(out, "%zu groups, %" PRIu64 " turns (%zu rows scanned in %.2f ms)\n",
+          count, turns, scanned, elapsed_ms);
+
+  free(order);
+  return 0;
+}
+
+static void query_plan_free(struct query_plan *plan) {
+  free(plan->allowed_models);
+  free(plan->turns);
+  for (size_t c = 0; c < HISTORY_TOKEN_COLUMNS; c++) {
+    free(plan->sums[c]);
+  }
+}
+
+int mccs_run_query(const struct cli_options *opts) {
+  const struct query_options *q = &opts->query_opts;
+  struct query_plan plan = {.since = INT64_MIN, .until = INT64_MAX};
+
+  if (!query_parse_dims(q->by, &plan)) {
+    fprintf(MCCS_STDERR, "error: --by takes up to %d of session,model,day,week\n", QUERY_MAX_DIMS);
+    return 1;
+  }
+  if ((q->since && !query_parse_day(q->since, &plan.since)) ||
+      (q->until && !query_parse_day(q->until, &plan.until))) {
+    fprintf(MCCS_STDERR, "error: --since and --until take a YYYY-MM-DD date\n");
+    return 1;
+  }
+  if (q->until) {
+    plan.until += SECONDS_PER_DAY;
+  }
+  plan.time_filter = q->since || q->until;
+  for (size_t d = 0; d < plan.dim_count; d++) {
+    plan.time_dims = plan.time_dims || plan.dims[d] == QUERY_DIM_DAY || plan.dims[d] == QUERY_DIM_WEEK;
+  }
+
+  enum query_sort sort = QUERY_SORT_TOTAL;
+  if (q->sort) {
+    for (sort = 0; sort < QUERY_SORT_COUNT && strcmp(q->sort, query_sort_names[sort]) != 0; sort++) {
+    }
+    if (sort == QUERY_SORT_COUNT) {
+      fprintf(MCCS_STDERR, "error: --sort takes turns, input, output, cache-write, cache-read, total or cache-eff\n");
+      return 1;
+    }
+  }
+
+  char dir[BUF_PATH_SIZE];
+  if (q->store) {
+    snprintf(dir, sizeof(dir), "%s", q->store);
+  } else {
+    struct mccs_render_ctx ctx;
+    mccs_render_ctx_init(&ctx, false, false, MCCS_STDOUT);
+    history_dir(&ctx, dir, sizeof(dir));
+    mccs_render_ctx_free(&ctx);
+  }
+
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+
+  struct history_view view;
+  ResultVoid open_result = history_open(dir, &view);
+  if (IS_ERR(open_result)) {
+    fprintf(MCCS_STDERR, "error: cannot read history store %s\n", dir);
+    return MCCS_ERROR_IO;
+  }
+
+  int exit_code = 0;
+  if (!query_plan_groups(&view, &plan)) {
+    fprintf(MCCS_STDERR, "error: too many groups, narrow the query with --since/--until\n");
+    exit_code = 1;
+  }
+
+  if (exit_code == 0 && q->model) {
+    plan.allowed_models = calloc(view.model_count ? view.model_count : 1, 1);
+    if (plan.allowed_models) {
+      for (size_t m = 0; m < view.model_count; m++) {
+        plan.allowed_models[m] = strstr(view.models[m], q->model) != NULL;
+      }
+    } else {
+      exit_code = MCCS_ERROR_MEMORY;
+    }
+  }
+
+  if (exit_code == 0) {
+    size_t slots = plan.groups ? plan.groups : 1;
+    plan.turns = calloc(slots, sizeof(uint64_t));
+    bool allocated = plan.turns != NULL;
+    for (size_t c = 0; c < HISTORY_TOKEN_COLUMNS; c++) {
+      plan.sums[c] = calloc(slots, sizeof(uint64_t));
+      allocated = allocated && plan.sums[c];
+    }
+    exit_code = allocated ? 0 : MCCS_ERROR_MEMORY;
+  }
+
+  if (exit_code == 0) {
+    size_t scanned = plan.groups ? query_scan(&view, &plan) : 0;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double elapsed_ms = (double)(t1.tv_sec - t0.tv_sec) * MS_PER_SECOND +
+                        (double)(t1.tv_nsec - t0.tv_nsec) / (double)MS_TO_NANOSEC;
+    exit_code = query_print(&view, &plan, q, sort, scanned, elapsed_ms);
+  }
+
+  query_plan_free(&plan);
+  history_close(&view);
+  return exit_code;
+}
@@ -0,0 +1,34 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file query.h
+ * @brief Aggregations over the turn history store (mini-ccstatus query)
+ *
+ * Groups the rows recorded with --history by up to two dimensions (session,
+ * model, day, week) and sums their token columns. Each block of rows is
+ * skipped when its time range misses the --since/--until window; surviving
+ * rows are selected into a row-index vector without branches and summed one
+ * column at a time, so the inner loops only touch the mapped column they add.
+ * Days and weeks are UTC; weeks start on Monday.
+ */
+
+#ifndef MCCS_QUERY_H
+#define MCCS_QUERY_H
+
+#include "types_struct.h"
+
+#define QUERY_MAX_DIMS 2           /* Group dimensions per query */
+#define QUERY_MAX_GROUPS (1u << 20) /* Upper bound of the dense group table */
+
+/**
+ * Run a query over the history store and print the resulting table
+ *
+ * @param opts    CLI options (query_opts holds the query)
+ * @return        Exit code (0 on success, MCCS_ERROR_IO or MCCS_ERROR_MEMORY on failure)
+ *
+ * @note Invalid query options are reported on MCCS_STDERR with exit code 1
+ */
+int mccs_run_query(const struct cli_options *opts);
+
+#endif /* MCCS_QUERY_H */
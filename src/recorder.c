@@ -0,0 +1,194 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "recorder.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "constants.h"
+#include "debug.h"
+#include "lib/cjson/cJSON.h"
+#include "safe_conv.h"
+
+#define RECORDER_HASH_FNV_OFFSET 1469598103934665603ULL
+#define RECORDER_HASH_FNV_PRIME 1099511628211ULL
+#define RECORDER_COPY_CHUNK 65536
+
+/**
+ * Get the size of a file, 0 if missing
+ */
+static size_t recorder_file_size(const char *path) {
+  struct stat st;
+  if (stat(path, &st) != 0) {
+    return 0;
+  }
+  ResultSize size_result = safe_off_to_size(st.st_size);
+  return IS_OK(size_result) ? UNWRAP_OK(size_result) : 0;
+}
+
+/**
+ * Copy bytes [from, to) of src to the end of dst
+ */
+static ResultVoid recorder_copy_range(const char *src,
+                                      const char *dst,
+                                      size_t from,
+                                      size_t to) {
+  FILE *in = fopen(src, "rb");
+  if (!in) {
+    return ERR(ResultVoid, MCCS_ERR_FILE_NOT_FOUND);
+  }
+  FILE *out = fopen(dst, "ab");
+  if (!out) {
+    fclose(in);
+    return ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+  }
+
+  bool failed = from > (size_t)INT64_MAX || fseeko(in, (off_t)from, SEEK_SET) != 0;
+  char buf[RECORDER_COPY_CHUNK];
+  size_t remaining = to - from;
+  while (!failed && remaining > 0) {
+    size_t want = remaining < sizeof(buf) ? remaining : sizeof(buf);
+    size_t got = fread(buf, 1, want, in);
+    if (got == 0 || fwrite(buf, 1, got, out) != got) {
+      failed = true;
+    }
+    remaining -= got;
+  }
+
+  fclose(in);
+  if (fclose(out) != 0) {
+    failed = true;
+  }
+  return failed ? ERR(ResultVoid, MCCS_ERR_IO_ERROR) : OK(ResultVoid, 0);
+}
+
+/**
+ * Mirror transcript growth into the sidecar copy
+ *
+ * @param trace_path       Trace file path (sidecar dir is derived from it)
+ * @param transcript       Original transcript path
+ * @param sidecar_name     Output: sidecar file name (relative to the sidecar dir)
+ * @param name_size        Size of sidecar_name
+ * @param size             Output: transcript size covered by the sidecar
+ */
+static ResultVoid recorder_sync_transcript(const char *trace_path,
+                                           const char *transcript,
+                                           char *sidecar_name,
+                                           size_t name_size,
+                                           size_t *size) {
+  uint64_t hash = RECORDER_HASH_FNV_OFFSET;
+  for (const unsigned char *p = (const unsigned char *)transcript; *p; p++) {
+    hash ^= (uint64_t)(*p);
+    hash *= RECORDER_HASH_FNV_PRIME;
+  }
+  snprintf(sidecar_name, name_size, "%016llx.jsonl", (unsigned long long)hash);
+
+  char dir[BUF_TRANSCRIPT_PATH_SIZE];
+  char sidecar[BUF_TRANSCRIPT_PATH_SIZE + 32];
+  int n = snprintf(dir, sizeof(dir), "%s" RECORDER_SIDECAR_SUFFIX, trace_path);
+  if (n < 0 || (size_t)n >= sizeof(dir)) {
+    return ERR(ResultVoid, MCCS_ERR_BUFFER_TOO_SMALL);
+  }
+  if (mkdir(dir, CACHE_DIR_MODE) != 0 && errno != EEXIST) {
+    return ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+  }
+  snprintf(sidecar, sizeof(sidecar), "%s/%s", dir, sidecar_name);
+
+  size_t recorded = recorder_file_size(sidecar);
+  size_t current = recorder_file_size(transcript);
+  if (current < recorded) {
+    // Transcript was rewritten: start the copy over
+    DEBUG_LOG("Recorder: transcript shrank, restarting sidecar copy");
+    if (truncate(sidecar, 0) != 0) {
+      return ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+    }
+    recorded = 0;
+  }
+
+  if (current > recorded) {
+    ResultVoid copy_result = recorder_copy_range(transcript, sidecar, recorded, current);
+    if (IS_ERR(copy_result)) {
+      return copy_result;
+    }
+  }
+
+  *size = current;
+  return OK(ResultVoid, 0);
+}
+
+ResultVoid mccs_record_tick(const char *trace_path,
+                            const char *payload,
+                            size_t length) {
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  int64_t t_ms = (int64_t)now.tv_sec * 1000 + now.tv_nsec / MS_TO_NANOSEC;
+
+  int fd = open(trace_path, O_WRONLY | O_CREAT | O_APPEND, 0600);
+  if (fd < 0) {
+    DEBUG_LOG("Recorder: cannot open trace %s", trace_path);
+    return ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+  }
+  if (flock(fd, LOCK_EX) != 0) {
+    close(fd);
+    return ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+  }
+
+  cJSON *tick = cJSON_CreateObject();
+  cJSON *root = cJSON_ParseWithLength(payload, length);
+  ResultVoid result = OK(ResultVoid, 0);
+  char sidecar_name[32] = "";
+  size_t size = 0;
+
+  const cJSON *transcript = root ? cJSON_GetObjectItemCaseSensitive(root, "transcript_path") : NULL;
+  const char *transcript_path = cJSON_GetStringValue(transcript);
+  if (transcript_path && transcript_path[0] != '\0') {
+    result = recorder_sync_transcript(trace_path, transcript_path, sidecar_name, sizeof(sidecar_name), &size);
+  }
+
+  if (!tick) {
+    result = ERR(ResultVoid, MCCS_ERR_OUT_OF_MEMORY);
+  }
+
+  if (IS_OK(result)) {
+    cJSON_AddNumberToObject(tick, "t_ms", (double)t_ms);
+    cJSON_AddStringToObject(tick, "transcript", sidecar_name);
+    cJSON_AddNumberToObject(tick, "size", (double)size);
+    if (root) {
+      cJSON_AddItemToObject(tick, "payload", root);
+      root = NULL;
+    } else {
+      // Keep invalid payloads verbatim: they are part of the load too
+      char *raw = strndup(payload, length);
+      cJSON_AddStringToObject(tick, "payload_raw", raw ? raw : "");
+      free(raw);
+    }
+
+    char *line = cJSON_PrintUnformatted(tick);
+    if (!line) {
+      result = ERR(ResultVoid, MCCS_ERR_OUT_OF_MEMORY);
+    } else {
+      size_t line_len = strlen(line);
+      line[line_len] = '\n'; // Reuse the terminator slot: one write() per tick
+      ssize_t written = write(fd, line, line_len + 1);
+      if (written < 0 || (size_t)written != line_len + 1) {
+        result = ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+      }
+      free(line);
+    }
+  }
+
+  cJSON_Delete(root);
+  cJSON_Delete(tick);
+  flock(fd, LOCK_UN);
+  close(fd);
+  return result;
+}
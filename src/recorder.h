@@ -0,0 +1,45 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file recorder.h
+ * @brief Tick recorder for record-and-replay benchmarks
+ *
+ * With --record <trace>, every invocation appends one NDJSON line to the
+ * trace: wall-clock time, the raw stdin payload and the transcript size at
+ * that moment. Transcript bytes appended since the previous tick are copied
+ * into a sidecar directory (<trace>.d/) so the replayer can reproduce the
+ * file growth without access to the original session.
+ *
+ * Trace line format:
+ *   {"t_ms":<epoch ms>,"transcript":"<sidecar file>","size":<bytes>,"payload":{...}}
+ */
+
+#ifndef MCCS_RECORDER_H
+#define MCCS_RECORDER_H
+
+#include <stddef.h>
+
+#include "result.h"
+#include "token_calculator.h"
+
+#define RECORDER_SIDECAR_SUFFIX ".d" /* Sidecar directory suffix for transcript copies */
+
+/**
+ * Append one tick to a trace file
+ *
+ * @param trace_path    Trace file (created if missing)
+ * @param payload       Raw stdin payload
+ * @param length        Length of payload
+ * @return              ResultVoid - Ok(0) on success or Err with error code
+ *
+ * @note Holds an exclusive lock on the trace while copying transcript growth
+ *       so concurrent invocations record consistent sizes.
+ * @error MCCS_ERR_IO_ERROR if the trace or sidecar cannot be written
+ * @error MCCS_ERR_OUT_OF_MEMORY on allocation failure
+ */
+ResultVoid mccs_record_tick(const char *trace_path,
+                            const char *payload,
+                            size_t length);
+
+#endif /* MCCS_RECORDER_H */
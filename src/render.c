@@ -0,0 +1,520 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "render.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "cache.h"
+#include "chunk_store.h"
+#include "debug.h"
+#include "display.h"
+#include "history.h"
+#include "json_parser.h"
+#include "project_root.h"
+#include "safe_conv.h"
+#include "top_turns.h"
+
+#define RENDER_HASH_FNV_OFFSET 1469598103934665603ULL
+#define RENDER_HASH_FNV_PRIME 1099511628211ULL
+
+/**
+ * Milliseconds on the system-wide monotonic clock
+ */
+static int64_t render_now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / MS_TO_NANOSEC;
+}
+
+/**
+ * FNV-1a hash of a stdin payload
+ */
+static uint64_t render_digest(const char *buffer,
+                              size_t length) {
+  uint64_t hash = RENDER_HASH_FNV_OFFSET;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= (uint64_t)(unsigned char)buffer[i];
+    hash *= RENDER_HASH_FNV_PRIME;
+  }
+  return hash;
+}
+
+/**
+ * Take the token data of a job from its loaded cache
+ */
+static void render_use_cache(struct mccs_render_job *job) {
+  job->session_tokens = job->cache.session_tokens;
+  job->session_tokens_parsed = true;
+  job->context_tokens = job->cache.context_tokens;
+  job->context_tokens_parsed = (job->context_tokens > 0);
+  job->top_turns = job->cache.top_turns;
+  job->top_turns_parsed = true;
+  job->compactions = job->cache.compactions;
+  job->segment_tokens = job->cache.segment_tokens;
+  job->prompt_cache = job->cache.prompt_cache;
+  job->parsed_offset = job->cache.transcript_file_size;
+  job->chunks = job->cache.chunks;
+  job->turn = job->cache.turn;
+  job->turn_cost_base = job->cache.turn_cost_base;
+  job->activity = job->cache.activity;
+  job->api_errors = job->cache.api_errors;
+  job->files = job->cache.files;
+  job->branch = job->cache.branch;
+}
+
+/**
+ * Identity the session cache of a job must match
+ */
+static void render_identity(const struct mccs_render_job *job,
+                            struct cache_identity *id) {
+  cache_identity_init(id, job->paths.session_id, job->status.buffers.buf_project, job->paths.transcript_path);
+}
+
+/**
+ * Check whether a job repeats the session's last full render within the window
+ */
+static bool render_is_debounced(const struct mccs_render_job *job,
+                                const struct cache_identity *id) {
+  if (job->debounce_ms == 0 || !job->cache_loaded ||
+      job->cache.render.input_digest != job->input_digest ||
+      !is_cache_valid(&job->cache, id)) {
+    return false;
+  }
+  int64_t elapsed = render_now_ms() - job->cache.render.last_render_ms;
+  return elapsed >= 0 && elapsed < (int64_t)job->debounce_ms;
+}
+
+ResultVoid mccs_render_prepare(struct mccs_render_ctx *ctx,
+                               const struct cli_options *opts,
+                               const char *buffer,
+                               size_t length,
+                               struct mccs_render_job *job) {
+  memset(job, 0, sizeof(*job));
+
+  struct json_doc *doc = &ctx->scratch.json;
+  ResultJsonRef root_result = parse_json_document(ctx, doc, buffer, length);
+  if (IS_ERR(root_result)) {
+    return ERR(ResultVoid, UNWRAP_ERR(root_result));
+  }
+
+  json_ref root = UNWRAP_OK(root_result);
+
+  init_mccs_status(&job->status);
+  load_mccs_status(doc, root, &job->status);
+  if (!opts->top_turns_json && job->status.string_refs.cwd == job->status.buffers.buf_cwd) {
+    (void)find_project_root(ctx, job->status.buffers.buf_cwd, &job->status.cwd_root_len);
+  }
+
+  ResultVoid paths_result = load_mccs_paths(doc, root, &job->paths);
+  bool has_paths = IS_OK(paths_result);
+
+  job->needs_session_tokens = opts->show_token_breakdown ||
+                              opts->show_session_tokens ||
+                              opts->show_cache_efficiency ||
+                              opts->show_input_output_ratio ||
+                              opts->show_cache_write_read_ratio ||
+                              opts->show_turn_cost ||
+                              opts->show_activity ||
+                              opts->show_api_errors ||
+                              opts->show_files ||
+                              opts->show_abandoned ||
+                              opts->show_context_mix ||
+                              opts->show_all;
+
+  job->needs_context_tokens = opts->show_context_tokens ||
+                              opts->show_all;
+
+  job->needs_top_turns = opts->show_top_turns ||
+                         opts->top_turns_json ||
+                         opts->show_all;
+
+  job->record_history = opts->record_history;
+  job->approximate = opts->approximate;
+  uint32_t budget_ms = opts->budget_ms > 0 ? opts->budget_ms : (opts->approximate ? ESTIMATE_DEFAULT_BUDGET_MS : 0);
+  job->deadline_ms = budget_ms > 0 ? render_now_ms() + (int64_t)budget_ms : 0;
+
+  bool needs_token_parsing = job->needs_session_tokens ||
+                             job->needs_context_tokens ||
+                             job->needs_top_turns ||
+                             job->record_history;
+
+  job->has_transcript = has_paths && job->paths.transcript_path[0] != '\0' && needs_token_parsing;
+  job->debounce_ms = opts->debounce_ms;
+  if (job->debounce_ms > 0 && job->has_transcript) {
+    job->input_digest = render_digest(buffer, length);
+  }
+  init_token_counts(&job->session_tokens);
+  top_turns_init(&job->top_turns);
+  return OK(ResultVoid, 0);
+}
+
+void mccs_render_lookup_cache(struct mccs_render_ctx *ctx,
+                              struct mccs_render_job *job) {
+  if (!job->has_transcript) {
+    return;
+  }
+
+  struct cache_identity id;
+  render_identity(job, &id);
+  ResultTokenCache cache_result = load_cache(ctx, &id);
+  job->cache_loaded = IS_OK(cache_result);
+  if (job->cache_loaded) {
+    job->cache = UNWRAP_OK(cache_result);
+  }
+
+  if (render_is_debounced(job, &id)) {
+    struct cache_render_stamp stamp = job->cache.render;
+    stamp.debounced_renders++;
+    (void)update_cache_render(ctx, job->paths.session_id, NULL, &stamp);
+    DEBUG_LOG("Render debounced (%llu debounced renders in this session)",
+              (unsigned long long)stamp.debounced_renders);
+    job->debounced = true;
+    job->needs_refresh = false;
+    render_use_cache(job);
+    return;
+  }
+
+  bool should_refresh = should_refresh_cache(&job->cache, &id);
+
+  job->needs_refresh = !job->cache_loaded || should_refresh;
+
+  if (!job->needs_refresh) {
+    DEBUG_LOG("Using cached token data");
+    render_use_cache(job);
+  }
+}
+
+/**
+ * Session cost when the request in progress started
+ *
+ * @param job        Job after its transcript parse
+ * @param resumed    The parse continued from the job's cache record
+ * @return           Cost in USD, or NaN if unknown
+ *
+ * @note The status line only reports the session cost, so the turn cost is
+ *       the difference with the cost of the last refresh before the prompt:
+ *       the cached record if the prompt was appended after it, zero if
+ *       nothing before the prompt used tokens
+ */
+static double render_turn_cost_base(const struct mccs_render_job *job,
+                                    bool resumed) {
+  if (!job->turn.started) {
+    return NAN;
+  }
+  if (resumed && job->cache.turn.started && job->cache.turn.prompt_offset == job->turn.prompt_offset) {
+    return job->cache.turn_cost_base;
+  }
+  if (resumed && job->turn.prompt_offset >= job->cache.transcript_file_size) {
+    return job->cache.cost_usd;
+  }
+  return job->turn.tokens.total_tokens == job->session_tokens.total_tokens ? 0.0 : NAN;
+}
+
+/**
+ * Replace the totals of a partial scan by a whole-file estimate
+ *
+ * @param ctx      Render context (scratch buffer)
+ * @param job      Job holding the partial token data
+ * @param stats    State of the partial scan
+ *
+ * @note The context comes from the end of the file and stays exact; it is
+ *       hidden if the tail holds no assistant turn. The cache keeps the exact
+ *       partial totals and offset; the estimate is never stored.
+ */
+static void render_estimate(struct mccs_render_ctx *ctx,
+                            struct mccs_render_job *job,
+                            const struct transcript_stats *stats) {
+  struct stat st;
+  if (stat(job->paths.transcript_path, &st) != 0 || st.st_size < 0) {
+    return;
+  }
+  size_t size = (size_t)st.st_size;
+  ResultVoid result = estimate_transcript_tokens(job->paths.transcript_path, &ctx->scratch, stats, size,
+                                                 &job->estimate);
+  if (IS_ERR(result)) {
+    job->estimate.valid = false;
+    return;
+  }
+  if (job->needs_context_tokens) {
+    uint64_t context = 0;
+    result = scan_transcript_tail(job->paths.transcript_path, &ctx->scratch, size, &context);
+    job->context_tokens = context;
+    job->context_tokens_parsed = IS_OK(result) && UNWRAP_OK(result) == 1 && context > 0;
+  }
+}
+
+/**
+ * Chunk cursor of an earlier scan of the job's transcript
+ *
+ * @note The cache record may be expired or partial: the chunk store checks
+ *       the cursor against the transcript before trusting it
+ */
+static const struct chunk_cursor *render_chunk_hint(const struct mccs_render_job *job,
+                                                    const struct cache_identity *id) {
+  return job->cache_loaded && cache_same_transcript(&job->cache, id) ? &job->cache.chunks : NULL;
+}
+
+void mccs_render_parse(struct mccs_render_ctx *ctx,
+                       struct mccs_render_job *job) {
+  if (!job->has_transcript || !job->needs_refresh) {
+    return;
+  }
+
+  char store_path[BUF_PATH_SIZE];
+  snprintf(store_path, sizeof(store_path), "%s/%s", get_cache_dir(ctx), CHUNK_STORE_FILE);
+  struct transcript_stats stats;
+  init_transcript_stats(&stats);
+  stats.chunk_store = store_path;
+  struct cache_identity id;
+  render_identity(job, &id);
+  bool resumed = job->cache_loaded && can_resume_cache(&job->cache, &id);
+  if (resumed) {
+    DEBUG_LOG("Transcript grew, resuming parse at offset %zu", job->cache.transcript_file_size);
+    stats.session_tokens = job->cache.session_tokens;
+    stats.context_tokens = job->cache.context_tokens;
+    stats.top_turns = job->cache.top_turns;
+    stats.compactions = job->cache.compactions;
+    stats.segment_tokens = job->cache.segment_tokens;
+    stats.prompt_cache = job->cache.prompt_cache;
+    stats.parsed_offset = job->cache.transcript_file_size;
+    stats.chunks = job->cache.chunks;
+    stats.turn = job->cache.turn;
+    stats.activity = job->cache.activity;
+    stats.api_errors = job->cache.api_errors;
+    stats.files = job->cache.files;
+    stats.branch = job->cache.branch;
+  } else if (chunk_store_resume(store_path, job->paths.transcript_path,
+                                render_chunk_hint(job, &id), &stats)) {
+    DEBUG_LOG("Cache miss, transcript starts with known chunks, parsing from offset %zu", stats.parsed_offset);
+  } else {
+    DEBUG_LOG("Cache miss or expired, parsing token data");
+  }
+
+  stats.deadline_ms = job->deadline_ms;
+  ctx->history.count = 0;
+  ResultVoid result = job->record_history
+                          ? scan_transcript_turns(job->paths.transcript_path, &ctx->scratch, &stats,
+                                                  history_collect, &ctx->history)
+                          : scan_transcript(job->paths.transcript_path, &ctx->scratch, &stats);
+  if (IS_OK(result) && ctx->history.count > 0) {
+    char dir[BUF_PATH_SIZE];
+    ResultVoid append_result = history_append(history_dir(ctx, dir, sizeof(dir)), job->paths.session_id,
+                                              ctx->history.turns, ctx->history.count);
+    if (IS_ERR(append_result)) {
+      DEBUG_LOG("History append failed (error %d)", UNWRAP_ERR(append_result));
+    }
+  }
+  if (IS_OK(result)) {
+    job->session_tokens = stats.session_tokens;
+    job->session_tokens_parsed = job->needs_session_tokens;
+    job->context_tokens = stats.context_tokens;
+    job->context_tokens_parsed = job->needs_context_tokens && (job->context_tokens > 0);
+    job->top_turns = stats.top_turns;
+    job->top_turns_parsed = job->needs_top_turns;
+    job->compactions = stats.compactions;
+    job->segment_tokens = stats.segment_tokens;
+    job->prompt_cache = stats.prompt_cache;
+    job->parsed_offset = stats.parsed_offset;
+    job->chunks = stats.chunks;
+    job->turn = stats.turn;
+    job->turn_cost_base = render_turn_cost_base(job, resumed);
+    job->activity = stats.activity;
+    job->api_errors = stats.api_errors;
+    job->files = stats.files;
+    job->branch = stats.branch;
+    job->partial = stats.partial;
+  }
+  if (IS_OK(result) && job->partial && job->approximate) {
+    render_estimate(ctx, job, &stats);
+  }
+}
+
+void mccs_render_share_tokens(struct mccs_render_job *dst,
+                              const struct mccs_render_job *src) {
+  if (!dst->has_transcript || !dst->needs_refresh) {
+    return;
+  }
+  dst->session_tokens = src->session_tokens;
+  dst->session_tokens_parsed = src->session_tokens_parsed && dst->needs_session_tokens;
+  dst->context_tokens = src->context_tokens;
+  dst->context_tokens_parsed = src->context_tokens_parsed && dst->needs_context_tokens;
+  dst->top_turns = src->top_turns;
+  dst->top_turns_parsed = src->top_turns_parsed && dst->needs_top_turns;
+  dst->compactions = src->compactions;
+  dst->segment_tokens = src->segment_tokens;
+  dst->prompt_cache = src->prompt_cache;
+  dst->parsed_offset = src->parsed_offset;
+  dst->chunks = src->chunks;
+  dst->turn = src->turn;
+  dst->turn_cost_base = src->turn_cost_base;
+  dst->activity = src->activity;
+  dst->api_errors = src->api_errors;
+  dst->files = src->files;
+  dst->branch = src->branch;
+  dst->partial = src->partial;
+  dst->estimate = src->estimate;
+}
+
+void mccs_render_store(struct mccs_render_ctx *ctx,
+                       struct mccs_render_job *job) {
+  if (!job->has_transcript || job->debounced) {
+    return;
+  }
+
+  struct cache_render_stamp stamp = {
+      .input_digest = job->input_digest,
+      .last_render_ms = job->debounce_ms > 0 && !job->partial ? render_now_ms() : 0,
+      .debounced_renders = job->cache.render.debounced_renders,
+  };
+  if (job->debounce_ms > 0) {
+    DEBUG_LOG("Full render (%llu debounced renders in this session)",
+              (unsigned long long)stamp.debounced_renders);
+  }
+
+  if (!job->needs_refresh) {
+    // Cache hit: only the debounce stamp changes
+    if (job->debounce_ms > 0) {
+      (void)update_cache_render(ctx, job->paths.session_id, &stamp, NULL);
+    }
+    return;
+  }
+
+  struct token_cache *cache = &job->cache;
+  cache->magic = CACHE_MAGIC;
+  cache->last_update_time = (int64_t)time(NULL);
+  struct cache_identity id;
+  render_identity(job, &id);
+  cache_set_identity(cache, &id);
+
+  // Always store the full statistics: a later render resumes from them
+  cache->session_tokens = job->session_tokens;
+  cache->session_total_tokens = job->session_tokens.total_tokens;
+  cache->context_tokens = job->context_tokens;
+  cache->top_turns = job->top_turns;
+  cache->compactions = job->compactions;
+  cache->segment_tokens = job->segment_tokens;
+  cache->prompt_cache = job->prompt_cache;
+  cache->transcript_file_size = job->parsed_offset;
+  cache->chunks = job->chunks;
+  cache->turn = job->turn;
+  cache->turn_cost_base = job->turn_cost_base;
+  cache->activity = job->activity;
+  cache->api_errors = job->api_errors;
+  cache->files = job->files;
+  cache->branch = job->branch;
+  cache->cost_usd = job->status.counters.cost_usd;
+  cache->render = stamp;
+  cache->partial = job->partial;
+
+  (void)save_cache(ctx, cache, job->paths.session_id);
+}
+
+void mccs_render_output(struct mccs_render_ctx *ctx,
+                        const struct cli_options *opts,
+                        const struct mccs_render_job *job) {
+  const struct mccs_status *status = &job->status;
+  const struct token_counts *session_tokens = &job->session_tokens;
+  bool session_tokens_parsed = job->session_tokens_parsed;
+  // An estimate replaces the partial session values; the context stays exact
+  if (job->estimate.valid) {
+    session_tokens = &job->estimate.tokens;
+  }
+  ctx->partial_tokens = job->partial && !job->estimate.valid;
+  ctx->estimated_tokens = job->estimate.valid;
+  ctx->estimate_error_pct = job->estimate.error_pct;
+
+  if (opts->top_turns_json) {
+    print_top_turns_json(ctx, job->top_turns_parsed ? &job->top_turns : NULL);
+    return;
+  }
+
+  print_mccs_status_line(ctx, status, opts->simple_status_line);
+
+  if ((opts->show_context_tokens || opts->show_all) && job->context_tokens_parsed) {
+    print_context_percentage(ctx, job->context_tokens, opts->clamp_percentages);
+  }
+
+  if ((opts->show_session_tokens || opts->show_all) && session_tokens_parsed) {
+    print_session_total(ctx, session_tokens->total_tokens, opts->clamp_percentages);
+    if (!job->estimate.valid) {
+      print_compaction_segment(ctx, job->compactions, &job->segment_tokens);
+    }
+  }
+
+  if ((opts->show_turn_cost || opts->show_all) && session_tokens_parsed && !job->estimate.valid) {
+    // Session cost now minus the cost when the prompt arrived
+    double turn_cost = status->counters.cost_usd - job->turn_cost_base;
+    print_turn_cost(ctx, &job->turn, turn_cost >= 0 ? turn_cost : NAN);
+  }
+
+  if ((opts->show_cache_efficiency || opts->show_all) && session_tokens_parsed) {
+    print_cache_efficiency(ctx, session_tokens, &job->prompt_cache);
+  }
+
+  if (opts->show_api_time_ratio || opts->show_all) {
+    print_api_time_ratio(ctx, status->counters.api_ms, status->counters.duration_ms);
+  }
+
+  if ((opts->show_activity || opts->show_all) && session_tokens_parsed && !job->estimate.valid) {
+    print_activity(ctx, &job->activity);
+  }
+
+  if ((opts->show_api_errors || opts->show_all) && session_tokens_parsed) {
+    print_api_errors(ctx, &job->api_errors);
+  }
+
+  if ((opts->show_files || opts->show_all) && session_tokens_parsed && !job->estimate.valid) {
+    print_files_touched(ctx, &job->files);
+  }
+
+  if ((opts->show_context_mix || opts->show_all) && session_tokens_parsed && !job->estimate.valid) {
+    print_context_mix(ctx, &job->branch, job->context_tokens);
+  }
+
+  if ((opts->show_abandoned || opts->show_all) && session_tokens_parsed && !job->estimate.valid) {
+    print_abandoned_branches(ctx, &job->branch);
+  }
+
+  if (opts->show_lines_ratio || opts->show_all) {
+    print_lines_ratio(ctx, status->counters.lines_added, status->counters.lines_removed);
+  }
+
+  if ((opts->show_input_output_ratio || opts->show_all) && session_tokens_parsed) {
+    print_input_output_ratio(ctx, session_tokens);
+  }
+
+  if ((opts->show_cache_write_read_ratio || opts->show_all) && session_tokens_parsed) {
+    print_cache_write_read_ratio(ctx, session_tokens);
+  }
+
+  if ((opts->show_token_breakdown || opts->show_all) && session_tokens_parsed && !opts->hide_token_breakdown) {
+    print_token_breakdown(ctx, session_tokens);
+  }
+
+  if ((opts->show_top_turns || opts->show_all) && job->top_turns_parsed) {
+    print_top_turns(ctx, &job->top_turns);
+  }
+}
+
+ResultVoid mccs_render_json(struct mccs_render_ctx *ctx,
+                            const struct cli_options *opts,
+                            const char *buffer,
+                            size_t length) {
+  struct mccs_render_job job;
+  ResultVoid prepare_result = mccs_render_prepare(ctx, opts, buffer, length, &job);
+  if (IS_ERR(prepare_result)) {
+    return prepare_result;
+  }
+
+  mccs_render_lookup_cache(ctx, &job);
+  mccs_render_parse(ctx, &job);
+  mccs_render_store(ctx, &job);
+  mccs_render_output(ctx, opts, &job);
+  return OK(ResultVoid, 0);
+}
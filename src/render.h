@@ -0,0 +1,158 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file render.h
+ * @brief Status line render pipeline
+ *
+ * Turns one Claude Code status JSON document into the formatted status
+ * output: parses the document, resolves token statistics through the
+ * session cache and prints every enabled segment into the render context.
+ */
+
+#ifndef MCCS_RENDER_H
+#define MCCS_RENDER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "render_ctx.h"
+#include "result.h"
+#include "token_calculator.h"
+#include "types_struct.h"
+
+/**
+ * State of one document moving through the render stages
+ *
+ * @note string_refs inside status point into status.buffers, so jobs must
+ *       not be copied by value once prepared.
+ */
+struct mccs_render_job {
+  struct mccs_status status;          ///< Parsed status line fields
+  struct mccs_paths paths;            ///< Session ID and transcript path
+  bool has_transcript;                ///< Document references a transcript
+  bool needs_session_tokens;          ///< Some enabled segment needs session totals
+  bool needs_context_tokens;          ///< Some enabled segment needs context tokens
+  bool needs_top_turns;               ///< Top turns display or JSON is enabled
+  struct token_cache cache;           ///< Cache record (loaded or rebuilt)
+  bool cache_loaded;                  ///< Cache was read from disk
+  bool needs_refresh;                 ///< Transcript must be parsed
+  struct token_counts session_tokens; ///< Session token totals
+  bool session_tokens_parsed;         ///< session_tokens is valid
+  uint64_t context_tokens;            ///< Context window tokens
+  bool context_tokens_parsed;         ///< context_tokens is valid
+  struct top_turns top_turns;         ///< Most expensive turns
+  bool top_turns_parsed;              ///< top_turns is valid
+  uint32_t compactions;               ///< Compaction boundaries seen (valid with session_tokens)
+  struct token_counts segment_tokens; ///< Tokens since the last compaction
+  struct prompt_cache_state prompt_cache; ///< Last prompt cache write/read
+  size_t parsed_offset;               ///< Transcript bytes covered by the token data
+  struct chunk_cursor chunks;         ///< Transcript chunking state at parsed_offset
+  struct current_turn turn;           ///< Request in progress (valid with session_tokens)
+  double turn_cost_base;              ///< Session cost when the request started (NaN if unknown)
+  struct activity_map activity;       ///< Minutes with assistant turns (valid with session_tokens)
+  struct api_error_state api_errors;  ///< Failed and retried requests (valid with session_tokens)
+  struct file_set files;              ///< Files read and edited (valid with session_tokens)
+  struct branch_state branch;         ///< Active conversation branch (valid with session_tokens)
+  uint32_t debounce_ms;               ///< Debounce window (0 = disabled)
+  uint64_t input_digest;              ///< Hash of the stdin payload (debounce only)
+  bool debounced;                     ///< Answered from the cache without a transcript stat
+  bool record_history;                ///< Append parsed turns to the history store (--history)
+  int64_t deadline_ms;                ///< CLOCK_MONOTONIC time the transcript scan must stop at (0 = none)
+  bool partial;                       ///< Token data comes from a scan cut short by the deadline
+  bool approximate;                   ///< Estimate the unparsed rest of a partial scan (--approximate)
+  struct token_estimate estimate;     ///< Whole-file session totals (valid with partial only)
+};
+
+/**
+ * Stage 1: parse the status document into a render job
+ *
+ * @param ctx       Render context (receives the JSON error state)
+ * @param opts      CLI options (decide which token data is needed)
+ * @param buffer    JSON string buffer
+ * @param length    Length of buffer
+ * @param job       Output: prepared job
+ * @return          ResultVoid - Ok(0) on success or Err with error code
+ *
+ * @error MCCS_ERR_INVALID_JSON on malformed input, MCCS_ERR_OUT_OF_MEMORY on OOM
+ */
+ResultVoid mccs_render_prepare(struct mccs_render_ctx *ctx,
+                               const struct cli_options *opts,
+                               const char *buffer,
+                               size_t length,
+                               struct mccs_render_job *job);
+
+/**
+ * Stage 2: load the session cache and decide whether a parse is needed
+ *
+ * @param ctx    Render context owning the cache path buffers
+ * @param job    Prepared job; fills cache fields and, on a hit, the tokens
+ *
+ * @note With a debounce window, a payload identical to the last full render
+ *       of the session and arriving within the window is answered from the
+ *       cache without stat'ing the transcript.
+ */
+void mccs_render_lookup_cache(struct mccs_render_ctx *ctx,
+                              struct mccs_render_job *job);
+
+/**
+ * Stage 3: parse the transcript of a job that needs a refresh
+ *
+ * @param ctx    Render context providing scratch memory
+ * @param job    Job with needs_refresh set; receives token results
+ *
+ * @note When the cached statistics are still valid and the transcript only
+ *       grew, parsing resumes at the cached offset and merges into them.
+ */
+void mccs_render_parse(struct mccs_render_ctx *ctx,
+                       struct mccs_render_job *job);
+
+/**
+ * Copy transcript results from one job into another sharing the transcript
+ *
+ * @param dst    Job that skipped its own parse
+ * @param src    Job whose transcript parse already ran
+ */
+void mccs_render_share_tokens(struct mccs_render_job *dst,
+                              const struct mccs_render_job *src);
+
+/**
+ * Stage 4: persist refreshed token data to the session cache
+ *
+ * @param ctx    Render context owning the cache path buffers
+ * @param job    Job after mccs_render_parse() or mccs_render_share_tokens()
+ */
+void mccs_render_store(struct mccs_render_ctx *ctx,
+                       struct mccs_render_job *job);
+
+/**
+ * Stage 5: print every enabled segment of a job
+ *
+ * @param ctx     Render context (output stream, theme)
+ * @param opts    CLI options for display formatting
+ * @param job     Completed job
+ */
+void mccs_render_output(struct mccs_render_ctx *ctx,
+                        const struct cli_options *opts,
+                        const struct mccs_render_job *job);
+
+/**
+ * Render a complete status JSON document
+ *
+ * @param ctx       Render context (output stream, theme, scratch memory)
+ * @param opts      CLI options for display formatting
+ * @param buffer    JSON string buffer
+ * @param length    Length of buffer
+ * @return          ResultVoid - Ok(0) on success or Err with error code
+ *
+ * @note Runs all render stages in order. Reentrant: all mutable state lives
+ *       in ctx, so separate contexts can render concurrently from different threads.
+ * @error MCCS_ERR_INVALID_JSON on malformed input, MCCS_ERR_OUT_OF_MEMORY on OOM
+ */
+ResultVoid mccs_render_json(struct mccs_render_ctx *ctx,
+                            const struct cli_options *opts,
+                            const char *buffer,
+                            size_t length);
+
+#endif /* MCCS_RENDER_H */
@@ -0,0 +1,89 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "render_ctx.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sgr.h"
+
+/* struct color_theme member of each theme slot */
+static const size_t theme_slot_offsets[MCCS_THEME_SLOT_COUNT] = {
+    [MCCS_THEME_LABEL] = offsetof(struct color_theme, label),
+    [MCCS_THEME_MODEL_NAME] = offsetof(struct color_theme, model_name),
+    [MCCS_THEME_MODEL_ID] = offsetof(struct color_theme, model_id),
+    [MCCS_THEME_VERSION] = offsetof(struct color_theme, version),
+    [MCCS_THEME_DIR] = offsetof(struct color_theme, dir),
+    [MCCS_THEME_COST] = offsetof(struct color_theme, cost),
+    [MCCS_THEME_TIME_TOTAL] = offsetof(struct color_theme, time_total),
+    [MCCS_THEME_TIME_API] = offsetof(struct color_theme, time_api),
+    [MCCS_THEME_LINES_ADDED] = offsetof(struct color_theme, lines_added),
+    [MCCS_THEME_LINES_REMOVED] = offsetof(struct color_theme, lines_removed),
+    [MCCS_THEME_BADGE_UNDER] = offsetof(struct color_theme, badge_under),
+    [MCCS_THEME_BADGE_OVER] = offsetof(struct color_theme, badge_over),
+    [MCCS_THEME_TOKEN_INPUT] = offsetof(struct color_theme, token_input),
+    [MCCS_THEME_TOKEN_OUTPUT] = offsetof(struct color_theme, token_output),
+    [MCCS_THEME_TOKEN_CACHE_CREATE] = offsetof(struct color_theme, token_cache_create),
+    [MCCS_THEME_TOKEN_CACHE_READ] = offsetof(struct color_theme, token_cache_read),
+    [MCCS_THEME_PROGRESS_EMPTY] = offsetof(struct color_theme, progress_empty),
+    [MCCS_THEME_PROGRESS_CTX] = offsetof(struct color_theme, progress_ctx),
+    [MCCS_THEME_PROGRESS_SES] = offsetof(struct color_theme, progress_ses),
+    [MCCS_THEME_PROGRESS_CACHE] = offsetof(struct color_theme, progress_cache),
+    [MCCS_THEME_PROGRESS_API_TIME] = offsetof(struct color_theme, progress_api_time),
+};
+
+void mccs_render_ctx_init(struct mccs_render_ctx *ctx,
+                          bool use_color,
+                          bool use_verbose,
+                          FILE *out) {
+  if (!ctx) {
+    return;
+  }
+  memset(ctx, 0, sizeof(*ctx));
+  ctx->use_color = use_color;
+  ctx->use_verbose = use_verbose;
+  ctx->theme = *get_theme(use_color);
+  ctx->out = out ? out : MCCS_STDOUT;
+  ctx->last_error = MCCS_OK;
+  ctx->json_error_ptr = NULL;
+  ctx->scratch.line = NULL;
+  ctx->scratch.cap = 0;
+  json_doc_init(&ctx->scratch.json);
+  sgr_state_init(&ctx->sgr);
+}
+
+void mccs_render_ctx_set_colors(struct mccs_render_ctx *ctx,
+                                const uint16_t colors[MCCS_THEME_SLOT_COUNT]) {
+  if (!ctx || !ctx->use_color) {
+    return;
+  }
+  for (size_t i = 0; i < MCCS_THEME_SLOT_COUNT; i++) {
+    if (colors[i] == 0 || colors[i] > 256) {
+      continue;
+    }
+    snprintf(ctx->theme_sgr[i], sizeof(ctx->theme_sgr[i]), "\033[1m\033[38;5;%um", (unsigned int)colors[i] - 1);
+    const char **slot = (const char **)(void *)((char *)&ctx->theme + theme_slot_offsets[i]);
+    *slot = ctx->theme_sgr[i];
+  }
+}
+
+void mccs_render_ctx_free(struct mccs_render_ctx *ctx) {
+  if (!ctx) {
+    return;
+  }
+  free(ctx->scratch.line);
+  ctx->scratch.line = NULL;
+  ctx->scratch.cap = 0;
+  json_doc_free(&ctx->scratch.json);
+  free(ctx->history.turns);
+  memset(&ctx->history, 0, sizeof(ctx->history));
+}
+
+enum MccsError mccs_render_ctx_fail(struct mccs_render_ctx *ctx, enum MccsError err) {
+  if (ctx) {
+    ctx->last_error = err;
+  }
+  return err;
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file render_ctx.h
+ * @brief Per-render context owning all mutable rendering state
+ *
+ * A render context bundles everything a single status line render writes to:
+ * the output stream, a private copy of the color theme, cache path buffers,
+ * the last parse error, reusable scratch memory and the terminal style state.
+ * Independent contexts can render different sessions concurrently from
+ * separate threads.
+ */
+
+#ifndef MCCS_RENDER_CTX_H
+#define MCCS_RENDER_CTX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "colors.h"
+#include "constants.h"
+#include "result.h"
+#include "types_struct.h"
+
+#define THEME_SGR_SIZE 16 /* "\033[1m\033[38;5;NNNm" plus NUL */
+
+/**
+ * Mutable state for one render (one session at a time)
+ *
+ * @note A context must not be shared between threads; create one per worker.
+ */
+struct mccs_render_ctx {
+  bool use_color;                   ///< Whether ANSI colors are emitted
+  bool use_verbose;                 ///< Whether field labels are shown
+  enum mccs_gradient_mode gradient; ///< Progress bar gradient mode (colors only)
+  struct color_theme theme;         ///< Private copy of the selected theme
+  char theme_sgr[MCCS_THEME_SLOT_COUNT][THEME_SGR_SIZE]; ///< Escapes of recolored theme slots
+  FILE *out;                        ///< Output stream for rendered lines
+  char cache_dir[BUF_PATH_SIZE];    ///< Per-user cache directory
+  char cache_path[BUF_PATH_SIZE];   ///< Cache file path for the current session
+  enum MccsError last_error;        ///< Last error recorded during render
+  const char *json_error_ptr;       ///< Position of the last JSON syntax error (or NULL)
+  struct mccs_scratch scratch;      ///< Reusable line buffer for transcript parsing
+  struct mccs_sgr_state sgr;        ///< Attributes last written to out (see sgr.h)
+  struct history_batch history;     ///< Turns collected for the history store (--history)
+  bool partial_tokens;              ///< Token values come from a scan cut short by --budget-ms
+  bool estimated_tokens;            ///< Session values are extrapolated from a sample (--approximate)
+  uint32_t estimate_error_pct;      ///< Error bound of the estimate, percent of the total
+};
+
+/**
+ * Initialize a render context
+ *
+ * @param ctx          Context to initialize
+ * @param use_color    Whether to use ANSI color codes
+ * @param use_verbose  Whether to show field labels
+ * @param out          Output stream (NULL selects MCCS_STDOUT)
+ */
+void mccs_render_ctx_init(struct mccs_render_ctx *ctx,
+                          bool use_color,
+                          bool use_verbose,
+                          FILE *out);
+
+/**
+ * Recolor theme elements with 256-color palette entries
+ *
+ * @param ctx     Initialized context
+ * @param colors  Palette index + 1 per theme slot; 0 keeps the theme color
+ *
+ * @note Does nothing without colors. The theme then points into ctx, so the
+ *       context must not be copied afterwards.
+ */
+void mccs_render_ctx_set_colors(struct mccs_render_ctx *ctx,
+                                const uint16_t colors[MCCS_THEME_SLOT_COUNT]);
+
+/**
+ * Release memory owned by a render context
+ *
+ * @param ctx    Context to clean up (the output stream is not closed)
+ */
+void mccs_render_ctx_free(struct mccs_render_ctx *ctx);
+
+/**
+ * Record an error in the context and pass it through
+ *
+ * @param ctx    Render context
+ * @param err    Error code to record
+ * @return       The same error code, for use in return statements
+ */
+enum MccsError mccs_render_ctx_fail(struct mccs_render_ctx *ctx, enum MccsError err);
+
+#endif /* MCCS_RENDER_CTX_H */
@@ -0,0 +1,180 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "sgr.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "colors.h"
+
+#define SGR_PARAM_RESET 0
+#define SGR_PARAM_BOLD 1
+#define SGR_PARAM_NORMAL_INTENSITY 22
+#define SGR_PARAM_FG_EXTENDED 38 /* Followed by ;5;N for a 256-color index */
+#define SGR_PARAM_FG_DEFAULT 39
+#define SGR_EXTENDED_256 5
+#define SGR_COLOR_MAX 255
+
+/**
+ * Read one decimal SGR parameter (empty means 0)
+ *
+ * @param p      In/out cursor
+ * @param out    Output: parameter value
+ * @return       false on malformed input
+ */
+static bool sgr_read_param(const char **p,
+                           unsigned *out) {
+  unsigned value = 0;
+  while (**p >= '0' && **p <= '9') {
+    value = value * 10 + (unsigned)(**p - '0');
+    if (value > SGR_COLOR_MAX) {
+      return false;
+    }
+    (*p)++;
+  }
+  *out = value;
+  return true;
+}
+
+/**
+ * Parse a style string into the attributes it leaves active
+ *
+ * @param style    Escape string (sequence of ESC [ params m)
+ * @param out      Output: resulting attributes, assuming a reset beforehand
+ * @return         false if the style uses anything besides reset/bold/256-color fg
+ */
+static bool sgr_parse(const char *style,
+                      struct mccs_sgr_state *out) {
+  out->known = true;
+  out->bold = false;
+  out->fg = -1;
+  out->last = style;
+
+  const char *p = style;
+  while (*p) {
+    if (p[0] != '\033' || p[1] != '[') {
+      return false;
+    }
+    p += 2;
+    while (true) {
+      unsigned param;
+      if (!sgr_read_param(&p, &param)) {
+        return false;
+      }
+      if (param == SGR_PARAM_RESET) {
+        out->bold = false;
+        out->fg = -1;
+      } else if (param == SGR_PARAM_BOLD) {
+        out->bold = true;
+      } else if (param == SGR_PARAM_NORMAL_INTENSITY) {
+        out->bold = false;
+      } else if (param == SGR_PARAM_FG_DEFAULT) {
+        out->fg = -1;
+      } else if (param == SGR_PARAM_FG_EXTENDED) {
+        unsigned mode, color;
+        if (*p++ != ';' || !sgr_read_param(&p, &mode) || mode != SGR_EXTENDED_256 ||
+            *p++ != ';' || !sgr_read_param(&p, &color)) {
+          return false;
+        }
+        out->fg = (int16_t)color;
+      } else {
+        return false;
+      }
+
+      if (*p == 'm') {
+        p++;
+        break;
+      }
+      if (*p++ != ';') {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void sgr_state_init(struct mccs_sgr_state *state) {
+  state->known = false;
+  state->bold = false;
+  state->fg = -1;
+  state->last = NULL;
+}
+
+void sgr_set(struct mccs_render_ctx *ctx,
+             const char *style) {
+  if (!ctx->use_color) {
+    return;
+  }
+  struct mccs_sgr_state *cur = &ctx->sgr;
+  if (!style) {
+    style = "";
+  }
+  if (cur->known && style == cur->last) {
+    return;
+  }
+
+  struct mccs_sgr_state want;
+  if (!sgr_parse(style, &want)) {
+    // Opaque style: apply it from a clean slate and stop tracking
+    fprintf(ctx->out, ANSI_RESET "%s", style);
+    sgr_state_init(cur);
+    return;
+  }
+
+  // Turning an attribute off costs a reset; everything else is additive
+  bool reset = !cur->known || (cur->bold && !want.bold) || (cur->fg >= 0 && want.fg < 0);
+  bool from_bold = reset ? false : cur->bold;
+  int16_t from_fg = reset ? -1 : cur->fg;
+
+  // Fold all changes into one sequence: "\033[0;1;38;5;Nm" at most
+  char seq[32] = "\033[";
+  size_t len = 2;
+  if (reset) {
+    seq[len++] = '0';
+    seq[len++] = ';';
+  }
+  if (want.bold && !from_bold) {
+    seq[len++] = '1';
+    seq[len++] = ';';
+  }
+  if (want.fg >= 0 && want.fg != from_fg) {
+    int n = snprintf(seq + len, sizeof(seq) - len, "38;5;%u;", (unsigned)want.fg);
+    len += n > 0 ? (size_t)n : 0;
+  }
+  if (len > 2) {
+    seq[len - 1] = 'm'; // Replace the trailing separator
+    fwrite(seq, 1, len, ctx->out);
+  }
+  *cur = want;
+}
+
+void sgr_puts(struct mccs_render_ctx *ctx,
+              const char *style,
+              const char *text) {
+  sgr_set(ctx, style);
+  fputs(text, ctx->out);
+}
+
+void sgr_printf(struct mccs_render_ctx *ctx,
+                const char *style,
+                const char *fmt,
+                ...) {
+  sgr_set(ctx, style);
+  va_list args;
+  va_start(args, fmt);
+  vfprintf(ctx->out, fmt, args);
+  va_end(args);
+}
+
+void sgr_write_span(struct mccs_render_ctx *ctx,
+                    const char *bytes,
+                    size_t len) {
+  sgr_set(ctx, NULL);
+  fwrite(bytes, 1, len, ctx->out);
+}
+
+void sgr_end_line(struct mccs_render_ctx *ctx) {
+  sgr_set(ctx, NULL);
+  fputc('\n', ctx->out);
+}
@@ -0,0 +1,84 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file sgr.h
+ * @brief SGR-state-tracking escape emitter shared by all print_* functions
+ *
+ * Theme styles are plain escape strings ("\033[1m\033[38;5;81m"). Instead of
+ * writing a style and a reset around every field, display code asks for the
+ * style a piece of text needs and the emitter writes only the attributes that
+ * differ from what the terminal already has, folded into a single sequence.
+ * Consecutive fields in the same color, labels following a reset and empty
+ * progress bar cells therefore cost no escape bytes at all.
+ *
+ * Styles the emitter cannot parse are written verbatim after a reset, so
+ * custom themes keep working, just without the savings.
+ */
+
+#ifndef MCCS_SGR_H
+#define MCCS_SGR_H
+
+#include "render_ctx.h"
+
+/**
+ * Forget the terminal state (next style change starts with a reset)
+ *
+ * @param state    SGR state to reset
+ */
+void sgr_state_init(struct mccs_sgr_state *state);
+
+/**
+ * Switch the output to a style, writing escapes only if it changes
+ *
+ * @param ctx      Render context (no-op when colors are disabled)
+ * @param style    Theme style string; NULL, "" and the reset code select the default style
+ */
+void sgr_set(struct mccs_render_ctx *ctx,
+             const char *style);
+
+/**
+ * Write text in a style
+ *
+ * @param ctx      Render context
+ * @param style    Theme style string
+ * @param text     Text to write
+ */
+void sgr_puts(struct mccs_render_ctx *ctx,
+              const char *style,
+              const char *text);
+
+/**
+ * Write formatted text in a style
+ *
+ * @param ctx      Render context
+ * @param style    Theme style string
+ * @param fmt      printf-style format
+ */
+void sgr_printf(struct mccs_render_ctx *ctx,
+                const char *style,
+                const char *fmt,
+                ...) __attribute__((format(printf, 3, 4)));
+
+/**
+ * Write a pre-rendered span that starts and ends in the default style
+ *
+ * @param ctx      Render context
+ * @param bytes    Span bytes (text and escapes)
+ * @param len      Length of bytes
+ */
+void sgr_write_span(struct mccs_render_ctx *ctx,
+                    const char *bytes,
+                    size_t len);
+
+/**
+ * Return to the default style and end the line
+ *
+ * @param ctx    Render context
+ *
+ * @note Every rendered line ends in the default style so that lines can be
+ *       consumed independently.
+ */
+void sgr_end_line(struct mccs_render_ctx *ctx);
+
+#endif /* MCCS_SGR_H */
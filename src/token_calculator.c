@@ -4,14 +4,23 @@
 #include "token_calculator.h"
 
 #include <inttypes.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
 
+#include "activity.h"
+#include "branch.h"
+#include "chunk_store.h"
 #include "constants.h"
 #include "debug.h"
-#include "lib/cjson/cJSON.h"
+#include "file_set.h"
+#include "json_tape.h"
 #include "safe_conv.h"
+#include "top_turns.h"
 
 void init_token_counts(struct token_counts *tokens) {
   if (!tokens) {
@@ -93,6 +102,7 @@ uint32_t calculate_percentage(uint64_t tokens,
 /**
  * Extract and accumulate token counts from a JSON usage object
  *
+ * @param doc       Parsed transcript line
  * @param usage     JSON object containing token usage fields
  * @param tokens    Token counts structure to accumulate into
  * @return          ResultVoid - Ok if successful, Err on overflow or conversion error
@@ -102,26 +112,26 @@ uint32_t calculate_percentage(uint64_t tokens,
  * @error MCCS_ERR_INVALID_CONVERSION if double to uint64 conversion fails
  * @error MCCS_ERR_OVERFLOW if token addition would overflow
  */
-static ResultVoid extract_tokens_from_usage(const cJSON *usage, struct token_counts *tokens) {
-  if (!usage || !cJSON_IsObject(usage)) {
+static ResultVoid extract_tokens_from_usage(struct json_doc *doc, json_ref usage, struct token_counts *tokens) {
+  if (!json_is_object(doc, usage)) {
     return ERR(ResultVoid, MCCS_ERR_INVALID_JSON);
   }
 
-  const cJSON *input = cJSON_GetObjectItemCaseSensitive(usage, "input_tokens");
-  const cJSON *output = cJSON_GetObjectItemCaseSensitive(usage, "output_tokens");
+  json_ref input = json_get(doc, usage, "input_tokens");
+  json_ref output = json_get(doc, usage, "output_tokens");
 
-  const cJSON *cache_creation = cJSON_GetObjectItemCaseSensitive(usage, "cache_creation_input_tokens");
-  const cJSON *cache_read = cJSON_GetObjectItemCaseSensitive(usage, "cache_read_input_tokens");
+  json_ref cache_creation = json_get(doc, usage, "cache_creation_input_tokens");
+  json_ref cache_read = json_get(doc, usage, "cache_read_input_tokens");
 
-  if (!cache_creation) {
-    cache_creation = cJSON_GetObjectItemCaseSensitive(usage, "cache_creation_tokens");
+  if (cache_creation == JSON_REF_NONE) {
+    cache_creation = json_get(doc, usage, "cache_creation_tokens");
   }
-  if (!cache_read) {
-    cache_read = cJSON_GetObjectItemCaseSensitive(usage, "cache_read_tokens");
+  if (cache_read == JSON_REF_NONE) {
+    cache_read = json_get(doc, usage, "cache_read_tokens");
   }
 
-  if (input && cJSON_IsNumber(input)) {
-    ResultU64 temp_value_result = safe_double_to_uint64(input->valuedouble);
+  if (json_is_number(doc, input)) {
+    ResultU64 temp_value_result = safe_double_to_uint64(json_number(doc, input));
     if (IS_ERR(temp_value_result)) {
       return ERR(ResultVoid, UNWRAP_ERR(temp_value_result));
     }
@@ -132,8 +142,8 @@ static ResultVoid extract_tokens_from_usage(const cJSON *usage, struct token_cou
     }
     tokens->input_tokens = UNWRAP_OK(new_total_result);
   }
-  if (output && cJSON_IsNumber(output)) {
-    ResultU64 temp_value_result = safe_double_to_uint64(output->valuedouble);
+  if (json_is_number(doc, output)) {
+    ResultU64 temp_value_result = safe_double_to_uint64(json_number(doc, output));
     if (IS_ERR(temp_value_result)) {
       return ERR(ResultVoid, UNWRAP_ERR(temp_value_result));
     }
@@ -144,8 +154,8 @@ static ResultVoid extract_tokens_from_usage(const cJSON *usage, struct token_cou
     }
     tokens->output_tokens = UNWRAP_OK(new_total_result);
   }
-  if (cache_creation && cJSON_IsNumber(cache_creation)) {
-    ResultU64 temp_value_result = safe_double_to_uint64(cache_creation->valuedouble);
+  if (json_is_number(doc, cache_creation)) {
+    ResultU64 temp_value_result = safe_double_to_uint64(json_number(doc, cache_creation));
     if (IS_ERR(temp_value_result)) {
       return ERR(ResultVoid, UNWRAP_ERR(temp_value_result));
     }
@@ -156,8 +166,8 @@ static ResultVoid extract_tokens_from_usage(const cJSON *usage, struct token_cou
     }
     tokens->cache_creation_tokens = UNWRAP_OK(new_total_result);
   }
-  if (cache_read && cJSON_IsNumber(cache_read)) {
-    ResultU64 temp_value_result = safe_double_to_uint64(cache_read->valuedouble);
+  if (json_is_number(doc, cache_read)) {
+    ResultU64 temp_value_result = safe_double_to_uint64(json_number(doc, cache_read));
     if (IS_ERR(temp_value_result)) {
       return ERR(ResultVoid, UNWRAP_ERR(temp_value_result));
     }
@@ -187,6 +197,9 @@ ResultTokenCounts parse_session_tokens(const char *session_path) {
   size_t cap = 0;
   ssize_t len;
   size_t line_count = 0;
+  struct json_doc json;
+  json_doc_init(&json);
+  struct json_doc *doc = &json;
 
   while ((len = getline(&line, &cap, fp)) != -1) {
     line_count++;
@@ -194,26 +207,26 @@ ResultTokenCounts parse_session_tokens(const char *session_path) {
       continue;
     }
 
-    cJSON *entry = cJSON_ParseWithLength(line, (size_t)len);
-    if (!entry) {
+    ResultJsonRef entry_result = json_doc_parse(doc, line, (size_t)len);
+    if (IS_ERR(entry_result)) {
       continue;
     }
+    json_ref entry = UNWRAP_OK(entry_result);
 
-    const cJSON *message = cJSON_GetObjectItemCaseSensitive(entry, "message");
-    if (message && cJSON_IsObject(message)) {
-      const cJSON *usage = cJSON_GetObjectItemCaseSensitive(message, "usage");
-      ResultVoid extract_result = extract_tokens_from_usage(usage, &tokens);
+    json_ref message = json_get(doc, entry, "message");
+    if (json_is_object(doc, message)) {
+      json_ref usage = json_get(doc, message, "usage");
+      ResultVoid extract_result = extract_tokens_from_usage(doc, usage, &tokens);
       if (IS_ERR(extract_result)) {
-        cJSON_Delete(entry);
+        json_doc_free(doc);
         free(line);
         fclose(fp);
         return ERR(ResultTokenCounts, UNWRAP_ERR(extract_result));
       }
     }
-
-    cJSON_Delete(entry);
   }
 
+  json_doc_free(doc);
   free(line);
   fclose(fp);
 
@@ -240,19 +253,23 @@ ResultU64 count_context_tokens(const char *transcript_path) {
   ssize_t len;
   char *last_assistant_line = NULL;
   size_t last_assistant_cap = 0;
+  struct json_doc json;
+  json_doc_init(&json);
+  struct json_doc *doc = &json;
 
   while ((len = getline(&line, &cap, fp)) != -1) {
     if (len <= 1) {
       continue;
     }
 
-    cJSON *entry = cJSON_ParseWithLength(line, (size_t)len);
-    if (entry) {
-      const cJSON *message = cJSON_GetObjectItemCaseSensitive(entry, "message");
-      if (message && cJSON_IsObject(message)) {
-        const cJSON *role = cJSON_GetObjectItemCaseSensitive(message, "role");
-        if (role && cJSON_IsString(role)) {
-          const char *role_str = cJSON_GetStringValue(role);
+    ResultJsonRef entry_result = json_doc_parse(doc, line, (size_t)len);
+    if (IS_OK(entry_result)) {
+      json_ref entry = UNWRAP_OK(entry_result);
+      json_ref message = json_get(doc, entry, "message");
+      if (json_is_object(doc, message)) {
+        json_ref role = json_get(doc, message, "role");
+        if (json_is_string(doc, role)) {
+          const char *role_str = json_string(doc, role);
           if (role_str && strcmp(role_str, "assistant") == 0) {
             if ((size_t)len > last_assistant_cap) {
               char *new_buf = realloc(last_assistant_line, (size_t)len + 1);
@@ -268,7 +285,6 @@ ResultU64 count_context_tokens(const char *transcript_path) {
           }
         }
       }
-      cJSON_Delete(entry);
     }
   }
 
@@ -276,25 +292,26 @@ ResultU64 count_context_tokens(const char *transcript_path) {
   fclose(fp);
 
   if (last_assistant_line) {
-    cJSON *entry = cJSON_Parse(last_assistant_line);
-    if (entry) {
-      const cJSON *message = cJSON_GetObjectItemCaseSensitive(entry, "message");
-      if (message && cJSON_IsObject(message)) {
-        const cJSON *usage = cJSON_GetObjectItemCaseSensitive(message, "usage");
-        if (usage && cJSON_IsObject(usage)) {
-          const cJSON *input = cJSON_GetObjectItemCaseSensitive(usage, "input_tokens");
-          const cJSON *cache_creation = cJSON_GetObjectItemCaseSensitive(usage, "cache_creation_input_tokens");
-          const cJSON *cache_read = cJSON_GetObjectItemCaseSensitive(usage, "cache_read_input_tokens");
-
-          if (!cache_creation) {
-            cache_creation = cJSON_GetObjectItemCaseSensitive(usage, "cache_creation_tokens");
+    ResultJsonRef entry_result = json_doc_parse(doc, last_assistant_line, strlen(last_assistant_line));
+    if (IS_OK(entry_result)) {
+      json_ref entry = UNWRAP_OK(entry_result);
+      json_ref message = json_get(doc, entry, "message");
+      if (json_is_object(doc, message)) {
+        json_ref usage = json_get(doc, message, "usage");
+        if (json_is_object(doc, usage)) {
+          json_ref input = json_get(doc, usage, "input_tokens");
+          json_ref cache_creation = json_get(doc, usage, "cache_creation_input_tokens");
+          json_ref cache_read = json_get(doc, usage, "cache_read_input_tokens");
+
+          if (cache_creation == JSON_REF_NONE) {
+            cache_creation = json_get(doc, usage, "cache_creation_tokens");
           }
-          if (!cache_read) {
-            cache_read = cJSON_GetObjectItemCaseSensitive(usage, "cache_read_tokens");
+          if (cache_read == JSON_REF_NONE) {
+            cache_read = json_get(doc, usage, "cache_read_tokens");
           }
 
-          if (input && cJSON_IsNumber(input)) {
-            ResultU64 temp_value_result = safe_double_to_uint64(input->valuedouble);
+          if (json_is_number(doc, input)) {
+            ResultU64 temp_value_result = safe_double_to_uint64(json_number(doc, input));
             if (IS_OK(temp_value_result)) {
               uint64_t temp_value = UNWRAP_OK(temp_value_result);
               ResultU64 new_total_result = safe_add_uint64(context_tokens, temp_value);
@@ -303,8 +320,8 @@ ResultU64 count_context_tokens(const char *transcript_path) {
               }
             }
           }
-          if (cache_creation && cJSON_IsNumber(cache_creation)) {
-            ResultU64 temp_value_result = safe_double_to_uint64(cache_creation->valuedouble);
+          if (json_is_number(doc, cache_creation)) {
+            ResultU64 temp_value_result = safe_double_to_uint64(json_number(doc, cache_creation));
             if (IS_OK(temp_value_result)) {
               uint64_t temp_value = UNWRAP_OK(temp_value_result);
               ResultU64 new_total_result = safe_add_uint64(context_tokens, temp_value);
@@ -313,8 +330,8 @@ ResultU64 count_context_tokens(const char *transcript_path) {
               }
             }
           }
-          if (cache_read && cJSON_IsNumber(cache_read)) {
-            ResultU64 temp_value_result = safe_double_to_uint64(cache_read->valuedouble);
+          if (json_is_number(doc, cache_read)) {
+            ResultU64 temp_value_result = safe_double_to_uint64(json_number(doc, cache_read));
             if (IS_OK(temp_value_result)) {
               uint64_t temp_value = UNWRAP_OK(temp_value_result);
               ResultU64 new_total_result = safe_add_uint64(context_tokens, temp_value);
@@ -325,13 +342,14 @@ ResultU64 count_context_tokens(const char *transcript_path) {
           }
         }
       }
-      cJSON_Delete(entry);
     }
+    json_doc_free(doc);
     free(last_assistant_line);
     DEBUG_LOG("Context tokens from last assistant message: %lu", context_tokens);
     return OK(ResultU64, context_tokens);
   }
 
+  json_doc_free(doc);
   DEBUG_LOG("No assistant message found in transcript");
   return OK(ResultU64, 0);
 }
@@ -339,6 +357,17 @@ ResultU64 count_context_tokens(const char *transcript_path) {
 ResultVoid parse_tokens_single_pass(const char *transcript_path,
                                     struct token_counts *session_tokens,
                                     uint64_t *context_tokens) {
+  struct mccs_scratch scratch = {.line = NULL, .cap = 0};
+  ResultVoid result = parse_tokens_with_scratch(transcript_path, &scratch, session_tokens, context_tokens);
+  free(scratch.line);
+  json_doc_free(&scratch.json);
+  return result;
+}
+
+ResultVoid parse_tokens_with_scratch(const char *transcript_path,
+                                     struct mccs_scratch *scratch,
+                                     struct token_counts *session_tokens,
+                                     uint64_t *context_tokens) {
   DEBUG_LOG("Single-pass parsing tokens from: %s", transcript_path);
 
   if (!session_tokens && !context_tokens) {
@@ -346,132 +375,816 @@ ResultVoid parse_tokens_single_pass(const char *transcript_path,
     return OK(ResultVoid, 0);
   }
 
-  FILE *fp = fopen(transcript_path, "r");
-  if (!fp) {
-    DEBUG_LOG("Failed to open transcript file: %s", transcript_path);
-    return ERR(ResultVoid, MCCS_ERR_FILE_NOT_FOUND);
+  struct transcript_stats stats;
+  init_transcript_stats(&stats);
+  ResultVoid result = scan_transcript(transcript_path, scratch, &stats);
+  if (IS_ERR(result)) {
+    return result;
   }
 
   if (session_tokens) {
-    init_token_counts(session_tokens);
+    *session_tokens = stats.session_tokens;
   }
   if (context_tokens) {
-    *context_tokens = 0;
+    *context_tokens = stats.context_tokens;
   }
+  return OK(ResultVoid, 0);
+}
 
-  char *line = NULL;
-  size_t cap = 0;
-  ssize_t len;
-  size_t line_count = 0;
+void init_transcript_stats(struct transcript_stats *stats) {
+  if (!stats) {
+    return;
+  }
+  init_token_counts(&stats->session_tokens);
+  stats->context_tokens = 0;
+  top_turns_init(&stats->top_turns);
+  stats->compactions = 0;
+  init_token_counts(&stats->segment_tokens);
+  stats->prompt_cache.last_touch = 0;
+  stats->prompt_cache.ttl_s = 0;
+  stats->turn.started = false;
+  stats->turn.prompt_offset = 0;
+  stats->turn.prompt_time = 0;
+  init_token_counts(&stats->turn.tokens);
+  activity_init(&stats->activity);
+  file_set_init(&stats->files);
+  branch_init(&stats->branch);
+  stats->api_errors.failed = 0;
+  stats->api_errors.retried = 0;
+  stats->api_errors.last_error = 0;
+  stats->parsed_offset = 0;
+  stats->deadline_ms = 0;
+  stats->partial = false;
+  chunk_cursor_init(&stats->chunks);
+  stats->chunk_store = NULL;
+}
 
-  uint64_t last_assistant_input = 0;
-  bool found_assistant = false;
+/**
+ * Add one set of token counts to another with overflow checking
+ *
+ * @param dst    Accumulator
+ * @param src    Counts to add
+ * @return       ResultVoid - Ok on success, Err on overflow
+ *
+ * @error MCCS_ERR_OVERFLOW if any category would overflow
+ */
+static ResultVoid add_token_counts(struct token_counts *dst,
+                                   const struct token_counts *src) {
+  ResultU64 input = safe_add_uint64(dst->input_tokens, src->input_tokens);
+  ResultU64 output = safe_add_uint64(dst->output_tokens, src->output_tokens);
+  ResultU64 creation = safe_add_uint64(dst->cache_creation_tokens, src->cache_creation_tokens);
+  ResultU64 read = safe_add_uint64(dst->cache_read_tokens, src->cache_read_tokens);
+  if (IS_ERR(input) || IS_ERR(output) || IS_ERR(creation) || IS_ERR(read)) {
+    return ERR(ResultVoid, MCCS_ERR_OVERFLOW);
+  }
+  dst->input_tokens = UNWRAP_OK(input);
+  dst->output_tokens = UNWRAP_OK(output);
+  dst->cache_creation_tokens = UNWRAP_OK(creation);
+  dst->cache_read_tokens = UNWRAP_OK(read);
+  return OK(ResultVoid, 0);
+}
 
-  while ((len = getline(&line, &cap, fp)) != -1) {
-    line_count++;
-    if (len <= 1) {
-      continue;
+/**
+ * Parse an ISO-8601 UTC timestamp ("2025-01-15T10:00:01.123Z")
+ *
+ * @param value    Timestamp string (may be NULL)
+ * @return         Seconds since epoch, or 0 if missing or malformed
+ */
+static int64_t parse_iso8601_utc(const char *value) {
+  if (!value) {
+    return 0;
+  }
+  struct tm tm;
+  memset(&tm, 0, sizeof(tm));
+  if (sscanf(value, "%4d-%2d-%2dT%2d:%2d:%2d",
+             &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+             &tm.tm_hour, &tm.tm_min, &tm.tm_sec) != 6) {
+    return 0;
+  }
+  tm.tm_year -= 1900;
+  tm.tm_mon -= 1;
+  time_t t = timegm(&tm);
+  return t == (time_t)-1 ? 0 : (int64_t)t;
+}
+
+/**
+ * Record a turn that wrote or read the prompt cache
+ *
+ * @param state        Prompt cache state to update
+ * @param doc          Parsed transcript line
+ * @param usage        Usage object of the turn
+ * @param turn         Token counts of the turn
+ * @param turn_time    Turn time (seconds since epoch)
+ *
+ * @note A write sets the lifetime: 1 hour if any tokens went to the extended
+ *       cache (usage.cache_creation.ephemeral_1h_input_tokens), 5 minutes
+ *       otherwise. A read refreshes the entries it hit, keeping the lifetime.
+ */
+static void track_prompt_cache(struct prompt_cache_state *state,
+                               struct json_doc *doc,
+                               json_ref usage,
+                               const struct token_counts *turn,
+                               int64_t turn_time) {
+  if (turn->cache_creation_tokens > 0) {
+    json_ref creation = json_get(doc, usage, "cache_creation");
+    json_ref long_ttl = json_get(doc, creation, "ephemeral_1h_input_tokens");
+    bool extended = json_number(doc, long_ttl) > 0;
+    state->ttl_s = extended ? PROMPT_CACHE_TTL_LONG_S : PROMPT_CACHE_TTL_S;
+  } else if (state->ttl_s == 0) {
+    state->ttl_s = PROMPT_CACHE_TTL_S;
+  }
+  if (turn_time > state->last_touch) {
+    state->last_touch = turn_time;
+  }
+}
+
+/**
+ * Check whether a transcript entry marks a conversation compaction
+ *
+ * @param doc        Parsed transcript line
+ * @param entry      Root of the line
+ * @param subtype    entry.subtype (NULL if missing)
+ * @param segment    Tokens of the current segment so far
+ * @return           true if a new segment starts after this entry
+ *
+ * @note Current transcripts write a system entry with subtype
+ *       "compact_boundary" followed by the summary message; older ones only
+ *       the summary (isCompactSummary). A summary right after a boundary
+ *       finds an empty segment and is not counted twice.
+ */
+static bool is_compaction_boundary(struct json_doc *doc,
+                                   json_ref entry,
+                                   const char *subtype,
+                                   const struct token_counts *segment) {
+  if (subtype && strcmp(subtype, "compact_boundary") == 0) {
+    return true;
+  }
+
+  json_ref summary = json_get(doc, entry, "isCompactSummary");
+  bool segment_empty = segment->input_tokens == 0 && segment->output_tokens == 0 &&
+                       segment->cache_creation_tokens == 0 && segment->cache_read_tokens == 0;
+  return json_is_true(doc, summary) && !segment_empty;
+}
+
+/**
+ * Check whether a transcript entry is a prompt typed by the user
+ *
+ * @param doc        Parsed transcript line
+ * @param entry      Root of the line
+ * @param message    entry.message
+ * @return           true for a user message holding something other than tool results
+ *
+ * @note Tool results, meta lines (command caveats), compaction summaries
+ *       and subagent (sidechain) prompts do not start a turn
+ */
+static bool is_user_prompt(struct json_doc *doc,
+                           json_ref entry,
+                           json_ref message) {
+  const char *role = json_string(doc, json_get(doc, message, "role"));
+  if (!role || strcmp(role, "user") != 0 || json_is_true(doc, json_get(doc, entry, "isMeta")) ||
+      json_is_true(doc, json_get(doc, entry, "isCompactSummary")) ||
+      json_is_true(doc, json_get(doc, entry, "isSidechain"))) {
+    return false;
+  }
+
+  json_ref content = json_get(doc, message, "content");
+  if (json_is_string(doc, content)) {
+    return true;
+  }
+  for (json_ref item = json_first(doc, content); item != JSON_REF_NONE; item = json_next(doc, content, item)) {
+    const char *type = json_string(doc, json_get(doc, item, "type"));
+    if (!type || strcmp(type, "tool_result") != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Key of a uuid field of a transcript entry
+ */
+static uint64_t entry_uuid_key(struct json_doc *doc,
+                               json_ref entry,
+                               const char *field) {
+  const char *uuid = json_string(doc, json_get(doc, entry, field));
+  return uuid ? branch_key(uuid, strlen(uuid)) : 0;
+}
+
+/**
+ * Move the active branch to a transcript entry
+ *
+ * @param branch    Branch state to update
+ * @param doc       Parsed line
+ * @param entry     Transcript entry (not a sidechain one)
+ * @return          Key of the entry's parent (0 if none)
+ *
+ * @note A compaction boundary has no parentUuid; its logicalParentUuid
+ *       links it to the conversation it summarizes
+ */
+static uint64_t follow_branch(struct branch_state *branch,
+                              struct json_doc *doc,
+                              json_ref entry) {
+  uint64_t parent = entry_uuid_key(doc, entry, "parentUuid");
+  if (parent == 0) {
+    parent = entry_uuid_key(doc, entry, "logicalParentUuid");
+  }
+  branch_follow(branch, parent, entry_uuid_key(doc, entry, "uuid"));
+  return parent;
+}
+
+/**
+ * Add the content of a transcript entry to the context composition
+ *
+ * @param branch     Branch state whose tip gets the content
+ * @param doc        Parsed line
+ * @param entry      Transcript entry (not a sidechain one)
+ * @param message    Its message (JSON_REF_NONE for attachment entries)
+ *
+ * @note Sizes are the raw spans recorded by the parser: no string is
+ *       decoded, and escapes count as written
+ */
+static void measure_context(struct branch_state *branch,
+                            struct json_doc *doc,
+                            json_ref entry,
+                            json_ref message) {
+  json_ref content = json_get(doc, message, "content");
+  if (content == JSON_REF_NONE) {
+    json_ref attachment = json_get(doc, entry, "attachment");
+    branch_add_context(branch, CONTEXT_ATTACHMENTS, json_span(doc, attachment));
+    return;
+  }
+
+  const char *role = json_string(doc, json_get(doc, message, "role"));
+  if (!role) {
+    return;
+  }
+  if (strcmp(role, "assistant") == 0 || json_is_true(doc, json_get(doc, entry, "isCompactSummary"))) {
+    branch_add_context(branch, CONTEXT_ASSISTANT, json_span(doc, content));
+    return;
+  }
+  if (strcmp(role, "user") != 0) {
+    return;
+  }
+
+  enum context_kind text_kind = json_is_true(doc, json_get(doc, entry, "isMeta")) ? CONTEXT_ATTACHMENTS
+                                                                                 : CONTEXT_PROMPTS;
+  if (json_is_string(doc, content)) {
+    branch_add_context(branch, text_kind, json_span(doc, content));
+    return;
+  }
+  for (json_ref item = json_first(doc, content); item != JSON_REF_NONE; item = json_next(doc, content, item)) {
+    const char *type = json_string(doc, json_get(doc, item, "type"));
+    enum context_kind kind = text_kind;
+    if (type && strcmp(type, "tool_result") == 0) {
+      kind = CONTEXT_TOOL_RESULTS;
+    } else if (type && (strcmp(type, "image") == 0 || strcmp(type, "document") == 0)) {
+      kind = CONTEXT_ATTACHMENTS;
     }
+    branch_add_context(branch, kind, json_span(doc, item));
+  }
+}
 
-    cJSON *entry = cJSON_ParseWithLength(line, (size_t)len);
-    if (!entry) {
+/**
+ * Record the files passed to the file tools called by an assistant message
+ *
+ * @param files      Set of touched files to update
+ * @param doc        Parsed transcript line
+ * @param message    entry.message of an assistant line
+ *
+ * @note Read counts as a read; Edit, MultiEdit and Write as an edit
+ */
+static void track_touched_files(struct file_set *files,
+                                struct json_doc *doc,
+                                json_ref message) {
+  json_ref content = json_get(doc, message, "content");
+  for (json_ref item = json_first(doc, content); item != JSON_REF_NONE; item = json_next(doc, content, item)) {
+    const char *type = json_string(doc, json_get(doc, item, "type"));
+    const char *name = json_string(doc, json_get(doc, item, "name"));
+    if (!type || !name || strcmp(type, "tool_use") != 0) {
+      continue;
+    }
+    enum file_touch kind;
+    if (strcmp(name, "Read") == 0) {
+      kind = FILE_TOUCH_READ;
+    } else if (strcmp(name, "Edit") == 0 || strcmp(name, "MultiEdit") == 0 || strcmp(name, "Write") == 0) {
+      kind = FILE_TOUCH_EDIT;
+    } else {
       continue;
     }
+    const char *path = json_string(doc, json_get(doc, json_get(doc, item, "input"), "file_path"));
+    if (path) {
+      file_set_add(files, kind, path, strlen(path));
+    }
+  }
+}
 
-    const cJSON *message = cJSON_GetObjectItemCaseSensitive(entry, "message");
-    if (message && cJSON_IsObject(message)) {
-      const cJSON *usage = cJSON_GetObjectItemCaseSensitive(message, "usage");
-
-      if (session_tokens && usage) {
-        ResultVoid extract_result = extract_tokens_from_usage(usage, session_tokens);
-        if (IS_ERR(extract_result)) {
-          cJSON_Delete(entry);
-          free(line);
-          fclose(fp);
-          return ERR(ResultVoid, UNWRAP_ERR(extract_result));
-        }
-      }
+/**
+ * Count a failed or retried API request
+ *
+ * @param state         Error counts to update
+ * @param retry         A retry notice (system entry) rather than a failure
+ * @param error_time    Time of the entry (seconds since epoch, 0 if unknown)
+ */
+static void count_api_error(struct api_error_state *state,
+                            bool retry,
+                            int64_t error_time) {
+  if (retry) {
+    state->retried++;
+  } else {
+    state->failed++;
+  }
+  if (error_time > state->last_error) {
+    state->last_error = error_time;
+  }
+}
 
-      if (context_tokens) {
-        const cJSON *role = cJSON_GetObjectItemCaseSensitive(message, "role");
-        if (role && cJSON_IsString(role)) {
-          const char *role_str = cJSON_GetStringValue(role);
-          if (role_str && strcmp(role_str, "assistant") == 0 && usage) {
-            uint64_t total_context = 0;
+/**
+ * Monotonic clock in milliseconds (for scan deadlines)
+ */
+static int64_t transcript_now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / MS_TO_NANOSEC;
+}
 
-            const cJSON *input = cJSON_GetObjectItemCaseSensitive(usage, "input_tokens");
-            const cJSON *cache_creation = cJSON_GetObjectItemCaseSensitive(usage, "cache_creation_input_tokens");
-            const cJSON *cache_read = cJSON_GetObjectItemCaseSensitive(usage, "cache_read_input_tokens");
+ResultVoid scan_transcript(const char *transcript_path,
+                           struct mccs_scratch *scratch,
+                           struct transcript_stats *stats) {
+  return scan_transcript_turns(transcript_path, scratch, stats, NULL, NULL);
+}
 
-            if (!cache_creation) {
-              cache_creation = cJSON_GetObjectItemCaseSensitive(usage, "cache_creation_tokens");
-            }
-            if (!cache_read) {
-              cache_read = cJSON_GetObjectItemCaseSensitive(usage, "cache_read_tokens");
-            }
+/**
+ * Fold one parsed transcript entry into the statistics
+ *
+ * @param doc            Parsed transcript line
+ * @param entry          Root of the line
+ * @param line_offset    Offset of the line in the transcript
+ * @param stats          Statistics to update
+ * @param visit          Called for an assistant turn with tokens (may be NULL)
+ * @param user           Passed through to visit
+ * @return               Result<void> - Ok(0), or Err on token overflow
+ */
+static ResultVoid scan_transcript_entry(struct json_doc *doc,
+                                        json_ref entry,
+                                        size_t line_offset,
+                                        struct transcript_stats *stats,
+                                        turn_visitor visit,
+                                        void *user) {
+  // Subagent lines are not part of the conversation path
+  bool on_path = !json_is_true(doc, json_get(doc, entry, "isSidechain"));
+  uint64_t parent = 0;
+  if (on_path) {
+    parent = follow_branch(&stats->branch, doc, entry);
+    stats->context_tokens = stats->branch.tip.context_tokens;
+  }
 
-            if (input && cJSON_IsNumber(input)) {
-              ResultU64 temp_value_result = safe_double_to_uint64(input->valuedouble);
-              if (IS_OK(temp_value_result)) {
-                uint64_t temp_value = UNWRAP_OK(temp_value_result);
-                ResultU64 total_context_result = safe_add_uint64(total_context, temp_value);
-                if (IS_OK(total_context_result)) {
-                  total_context = UNWRAP_OK(total_context_result);
-                }
-              }
-            }
-            if (cache_creation && cJSON_IsNumber(cache_creation)) {
-              ResultU64 temp_value_result = safe_double_to_uint64(cache_creation->valuedouble);
-              if (IS_OK(temp_value_result)) {
-                uint64_t temp_value = UNWRAP_OK(temp_value_result);
-                ResultU64 total_context_result = safe_add_uint64(total_context, temp_value);
-                if (IS_OK(total_context_result)) {
-                  total_context = UNWRAP_OK(total_context_result);
-                }
-              }
-            }
-            if (cache_read && cJSON_IsNumber(cache_read)) {
-              ResultU64 temp_value_result = safe_double_to_uint64(cache_read->valuedouble);
-              if (IS_OK(temp_value_result)) {
-                uint64_t temp_value = UNWRAP_OK(temp_value_result);
-                ResultU64 total_context_result = safe_add_uint64(total_context, temp_value);
-                if (IS_OK(total_context_result)) {
-                  total_context = UNWRAP_OK(total_context_result);
-                }
-              }
-            }
+  const char *subtype = json_string(doc, json_get(doc, entry, "subtype"));
+  if (is_compaction_boundary(doc, entry, subtype, &stats->segment_tokens)) {
+    // The context restarts from the summary; session totals carry on
+    stats->compactions++;
+    init_token_counts(&stats->segment_tokens);
+    branch_compact(&stats->branch);
+    stats->context_tokens = 0;
+    DEBUG_LOG("Compaction boundary #%u at offset %zu", stats->compactions, line_offset);
+    return OK(ResultVoid, 0);
+  }
 
-            if (total_context > 0) {
-              last_assistant_input = total_context;
-              found_assistant = true;
-              DEBUG_LOG("Found assistant message with %lu total context tokens", last_assistant_input);
-            }
-          }
+  json_ref message = json_get(doc, entry, "message");
+  json_ref usage = json_get(doc, message, "usage");
+  bool has_usage = json_is_object(doc, usage);
+  if (!has_usage) {
+    if (subtype && strcmp(subtype, "api_error") == 0) {
+      // Each retry after a failed attempt writes a system entry (retryAttempt, retryInMs)
+      count_api_error(&stats->api_errors, true, parse_iso8601_utc(json_string(doc, json_get(doc, entry, "timestamp"))));
+    } else if (is_user_prompt(doc, entry, message)) {
+      // A later prompt with the same parent is an edit or a rewind to here
+      branch_mark_fork(&stats->branch, parent);
+      stats->turn.started = true;
+      stats->turn.prompt_offset = line_offset;
+      stats->turn.prompt_time = parse_iso8601_utc(json_string(doc, json_get(doc, entry, "timestamp")));
+      init_token_counts(&stats->turn.tokens);
+    }
+  }
+  if (on_path) {
+    measure_context(&stats->branch, doc, entry, message);
+  }
+  if (!has_usage) {
+    return OK(ResultVoid, 0);
+  }
+
+  struct token_counts turn;
+  init_token_counts(&turn);
+  ResultVoid extract_result = extract_tokens_from_usage(doc, usage, &turn);
+  if (IS_OK(extract_result)) {
+    extract_result = add_token_counts(&stats->session_tokens, &turn);
+  }
+  if (IS_OK(extract_result)) {
+    extract_result = add_token_counts(&stats->segment_tokens, &turn);
+  }
+  if (IS_OK(extract_result) && stats->turn.started) {
+    extract_result = add_token_counts(&stats->turn.tokens, &turn);
+  }
+  if (IS_ERR(extract_result)) {
+    return extract_result;
+  }
+
+  json_ref role = json_get(doc, message, "role");
+  const char *role_str = json_string(doc, role);
+  if (!role_str || strcmp(role_str, "assistant") != 0) {
+    return OK(ResultVoid, 0);
+  }
+  track_touched_files(&stats->files, doc, message);
+
+  ResultU64 context_result = safe_add_uint64(turn.input_tokens, turn.cache_creation_tokens);
+  if (IS_OK(context_result)) {
+    context_result = safe_add_uint64(UNWRAP_OK(context_result), turn.cache_read_tokens);
+  }
+  ResultU64 turn_total = calculate_total_tokens(&turn);
+  if (on_path) {
+    branch_add_turn(&stats->branch, IS_OK(turn_total) ? UNWRAP_OK(turn_total) : 0,
+                    IS_OK(context_result) ? UNWRAP_OK(context_result) : 0);
+    stats->context_tokens = stats->branch.tip.context_tokens;
+    DEBUG_LOG("Found assistant message with %lu total context tokens", stats->context_tokens);
+  }
+
+  json_ref timestamp = json_get(doc, entry, "timestamp");
+  int64_t turn_time = parse_iso8601_utc(json_string(doc, timestamp));
+  activity_mark(&stats->activity, turn_time);
+  if (turn_time > 0 && (turn.cache_creation_tokens > 0 || turn.cache_read_tokens > 0)) {
+    track_prompt_cache(&stats->prompt_cache, doc, usage, &turn, turn_time);
+  }
+
+  if (IS_OK(turn_total) && UNWRAP_OK(turn_total) > 0) {
+    struct turn_record record = {
+        .offset = line_offset,
+        .timestamp = turn_time,
+        .tokens = turn,
+    };
+    record.tokens.total_tokens = UNWRAP_OK(turn_total);
+    top_turns_push(&stats->top_turns, &record);
+    if (visit) {
+      json_ref model = json_get(doc, message, "model");
+      visit(&record, json_string(doc, model), user);
+    }
+  } else if (json_is_true(doc, json_get(doc, entry, "isApiErrorMessage"))) {
+    // A request that gave up ends with a synthetic assistant message without tokens
+    count_api_error(&stats->api_errors, false, turn_time);
+  }
+  return OK(ResultVoid, 0);
+}
+
+/**
+ * Fill in the total_tokens fields of session and segment counts
+ *
+ * @error MCCS_ERR_OVERFLOW if a total would overflow
+ */
+static ResultVoid finish_transcript_totals(struct transcript_stats *stats) {
+  ResultU64 total_result = calculate_total_tokens(&stats->session_tokens);
+  if (IS_ERR(total_result)) {
+    return ERR(ResultVoid, UNWRAP_ERR(total_result));
+  }
+  stats->session_tokens.total_tokens = UNWRAP_OK(total_result);
+  total_result = calculate_total_tokens(&stats->segment_tokens);
+  if (IS_ERR(total_result)) {
+    return ERR(ResultVoid, UNWRAP_ERR(total_result));
+  }
+  stats->segment_tokens.total_tokens = UNWRAP_OK(total_result);
+  total_result = calculate_total_tokens(&stats->turn.tokens);
+  if (IS_ERR(total_result)) {
+    return ERR(ResultVoid, UNWRAP_ERR(total_result));
+  }
+  stats->turn.tokens.total_tokens = UNWRAP_OK(total_result);
+  return OK(ResultVoid, 0);
+}
+
+/**
+ * Record the statistics at a chunk end in the chunk store
+ *
+ * @param fd        Store descriptor (opened on the first chunk, -1 if unavailable)
+ * @param stats     Statistics after the chunk
+ * @param offset    Offset of the chunk end
+ */
+static void record_transcript_chunk(int *fd,
+                                    const struct transcript_stats *stats,
+                                    size_t offset) {
+  if (*fd == -2) {
+    *fd = chunk_store_open(stats->chunk_store);
+  }
+  struct transcript_stats snapshot = *stats;
+  snapshot.parsed_offset = offset;
+  if (*fd < 0 || IS_ERR(finish_transcript_totals(&snapshot))) {
+    return;
+  }
+  chunk_store_put(*fd, &snapshot);
+}
+
+ResultVoid scan_transcript_turns(const char *transcript_path,
+                                 struct mccs_scratch *scratch,
+                                 struct transcript_stats *stats,
+                                 turn_visitor visit,
+                                 void *user) {
+  DEBUG_LOG("Scanning transcript %s from offset %zu", transcript_path, stats->parsed_offset);
+
+  FILE *fp = fopen(transcript_path, "r");
+  if (!fp) {
+    DEBUG_LOG("Failed to open transcript file: %s", transcript_path);
+    return ERR(ResultVoid, MCCS_ERR_FILE_NOT_FOUND);
+  }
+
+  if (stats->parsed_offset > (size_t)INT64_MAX ||
+      fseeko(fp, (off_t)stats->parsed_offset, SEEK_SET) != 0) {
+    fclose(fp);
+    return ERR(ResultVoid, MCCS_ERR_IO_ERROR);
+  }
+
+  size_t offset = stats->parsed_offset;
+  size_t line_count = 0;
+  ssize_t len;
+  struct json_doc *doc = &scratch->json;
+  int store_fd = -2; // Opened at the first chunk end
+  ResultVoid result = OK(ResultVoid, 0);
+  stats->partial = false;
+
+  while ((len = getline(&scratch->line, &scratch->cap, fp)) != -1) {
+    // Over budget: stop before this line, the next scan starts from it
+    if (stats->deadline_ms > 0 && line_count > 0 && line_count % TRANSCRIPT_DEADLINE_CHECK_LINES == 0 &&
+        transcript_now_ms() >= stats->deadline_ms) {
+      stats->partial = true;
+      DEBUG_LOG("Transcript scan deadline reached after %zu lines, stopping at offset %zu", line_count, offset);
+      break;
+    }
+    const char *line = scratch->line;
+    size_t line_len = (size_t)len;
+    bool complete = line_len > 0 && line[line_len - 1] == '\n';
+    size_t line_offset = offset;
+    line_count++;
+
+    if (line_len > 1) {
+      ResultJsonRef entry_result = json_doc_parse(doc, line, line_len);
+      if (IS_OK(entry_result)) {
+        result = scan_transcript_entry(doc, UNWRAP_OK(entry_result), line_offset, stats, visit, user);
+        if (IS_ERR(result)) {
+          break;
         }
+      } else if (!complete) {
+        // A final line without newline may still be in the middle of a write:
+        // leave it for the next scan instead of skipping it for good
+        continue;
       }
     }
-
-    cJSON_Delete(entry);
+    offset += line_len;
+    if (stats->chunk_store && chunk_cursor_feed(&stats->chunks, line, line_len)) {
+      record_transcript_chunk(&store_fd, stats, offset);
+    }
   }
 
-  free(line);
   fclose(fp);
+  if (store_fd >= 0) {
+    close(store_fd);
+  }
+  if (IS_ERR(result)) {
+    return result;
+  }
+  stats->parsed_offset = offset;
 
-  if (session_tokens) {
-    ResultU64 total_result = calculate_total_tokens(session_tokens);
-    if (IS_ERR(total_result)) {
-      return ERR(ResultVoid, UNWRAP_ERR(total_result));
+  result = finish_transcript_totals(stats);
+  if (IS_ERR(result)) {
+    return result;
+  }
+  DEBUG_LOG("Scanned %zu lines up to offset %zu, total session tokens: %lu",
+            line_count, offset, stats->session_tokens.total_tokens);
+  return OK(ResultVoid, 0);
+}
+
+/**
+ * Token counts and context of one transcript line (estimation and tail scans)
+ *
+ * @param doc        Parse buffers
+ * @param line       Line without guarantee of a trailing newline
+ * @param line_len   Line length
+ * @param segment    Tokens since the last compaction (updated)
+ * @param turn       Output: token counts of the line (zero if none)
+ * @param context    Output: context tokens of an assistant turn, 0 otherwise
+ * @return           true if the line is a compaction boundary
+ */
+static bool sample_transcript_line(struct json_doc *doc,
+                                   const char *line,
+                                   size_t line_len,
+                                   struct token_counts *segment,
+                                   struct token_counts *turn,
+                                   uint64_t *context) {
+  init_token_counts(turn);
+  *context = 0;
+  ResultJsonRef entry_result = line_len > 1 ? json_doc_parse(doc, line, line_len)
+                                             : ERR(ResultJsonRef, MCCS_ERR_INVALID_JSON);
+  if (IS_ERR(entry_result)) {
+    return false;
+  }
+  json_ref entry = UNWRAP_OK(entry_result);
+  if (is_compaction_boundary(doc, entry, json_string(doc, json_get(doc, entry, "subtype")), segment)) {
+    init_token_counts(segment);
+    return true;
+  }
+
+  json_ref message = json_get(doc, entry, "message");
+  json_ref usage = json_get(doc, message, "usage");
+  if (IS_OK(extract_tokens_from_usage(doc, usage, turn))) {
+    (void)add_token_counts(segment, turn);
+    json_ref role = json_get(doc, message, "role");
+    const char *role_str = json_string(doc, role);
+    if (role_str && strcmp(role_str, "assistant") == 0) {
+      ResultU64 context_result = safe_add_uint64(turn->input_tokens, turn->cache_creation_tokens);
+      if (IS_OK(context_result)) {
+        context_result = safe_add_uint64(UNWRAP_OK(context_result), turn->cache_read_tokens);
+      }
+      *context = IS_OK(context_result) ? UNWRAP_OK(context_result) : 0;
+    }
+  } else {
+    init_token_counts(turn);
+  }
+  return false;
+}
+
+/**
+ * Position fp at the first line starting at or after start
+ *
+ * @param fp       Open transcript
+ * @param scratch  Line buffer
+ * @param start    Byte offset; a line start if aligned is true
+ * @param aligned  start is known to be a line start
+ * @return         Offset of the first whole line, or SIZE_MAX on I/O error
+ */
+static size_t seek_line_start(FILE *fp,
+                              struct mccs_scratch *scratch,
+                              size_t start,
+                              bool aligned) {
+  if (start > (size_t)INT64_MAX || fseeko(fp, (off_t)(aligned ? start : start - 1), SEEK_SET) != 0) {
+    return SIZE_MAX;
+  }
+  if (aligned) {
+    return start;
+  }
+  // Read from the byte before start: if it is a newline, start is aligned
+  ssize_t skipped = getline(&scratch->line, &scratch->cap, fp);
+  return skipped < 0 ? SIZE_MAX : start - 1 + (size_t)skipped;
+}
+
+/**
+ * Sum the tokens of the lines starting in [start, end)
+ *
+ * @param sum      Accumulator (token categories only)
+ * @return         Bytes covered by the lines read (0 if none)
+ */
+static size_t sample_transcript_range(FILE *fp,
+                                      struct mccs_scratch *scratch,
+                                      size_t start,
+                                      size_t end,
+                                      bool aligned,
+                                      struct token_counts *sum) {
+  size_t offset = seek_line_start(fp, scratch, start, aligned);
+  if (offset == SIZE_MAX) {
+    return 0;
+  }
+  size_t first = offset;
+  struct token_counts segment;
+  init_token_counts(&segment);
+  ssize_t len;
+  while (offset < end && (len = getline(&scratch->line, &scratch->cap, fp)) != -1) {
+    struct token_counts turn;
+    uint64_t context;
+    (void)sample_transcript_line(&scratch->json, scratch->line, (size_t)len, &segment, &turn, &context);
+    (void)add_token_counts(sum, &turn);
+    offset += (size_t)len;
+  }
+  return offset > first ? offset - first : 0;
+}
+
+ResultVoid estimate_transcript_tokens(const char *transcript_path,
+                                      struct mccs_scratch *scratch,
+                                      const struct transcript_stats *stats,
+                                      size_t file_size,
+                                      struct token_estimate *out) {
+  init_token_counts(&out->tokens);
+  out->error_pct = 0;
+  out->valid = false;
+
+  FILE *fp = fopen(transcript_path, "r");
+  if (!fp) {
+    return ERR(ResultVoid, MCCS_ERR_FILE_NOT_FOUND);
+  }
+
+  size_t begin = stats->parsed_offset;
+  size_t span = file_size > begin ? file_size - begin : 0;
+  size_t chunks = span > (size_t)ESTIMATE_SAMPLE_CHUNKS * ESTIMATE_CHUNK_BYTES ? ESTIMATE_SAMPLE_CHUNKS : 1;
+  size_t stride = span / chunks;
+
+  struct token_counts sampled;
+  init_token_counts(&sampled);
+  size_t sampled_bytes = 0;
+  double density_sum = 0;
+  double density_sq_sum = 0;
+  size_t density_count = 0;
+
+  for (size_t i = 0; i < chunks; i++) {
+    size_t start = begin + i * stride;
+    size_t end = chunks == 1 ? file_size : start + ESTIMATE_CHUNK_BYTES;
+    struct token_counts chunk;
+    init_token_counts(&chunk);
+    size_t bytes = sample_transcript_range(fp, scratch, start, end, i == 0, &chunk);
+    if (bytes == 0) {
+      continue;
+    }
+    ResultU64 chunk_total = calculate_total_tokens(&chunk);
+    ResultVoid add_result = add_token_counts(&sampled, &chunk);
+    if (IS_ERR(chunk_total) || IS_ERR(add_result)) {
+      fclose(fp);
+      return ERR(ResultVoid, MCCS_ERR_OVERFLOW);
     }
-    session_tokens->total_tokens = UNWRAP_OK(total_result);
-    DEBUG_LOG("Parsed %zu lines, total session tokens: %lu", line_count, session_tokens->total_tokens);
+    double density = (double)UNWRAP_OK(chunk_total) / (double)bytes;
+    density_sum += density;
+    density_sq_sum += density * density;
+    density_count++;
+    sampled_bytes += bytes;
+  }
+  fclose(fp);
+
+  if (sampled_bytes == 0 && span > 0) {
+    return OK(ResultVoid, 0);
   }
 
-  if (context_tokens && found_assistant) {
-    *context_tokens = last_assistant_input;
-    DEBUG_LOG("Context tokens from last assistant: %lu", *context_tokens);
-  } else if (context_tokens) {
-    DEBUG_LOG("No assistant message found for context");
+  // Ratio estimate: sampled tokens per sampled byte, times the unparsed bytes
+  double scale = chunks == 1 || sampled_bytes == 0 ? 1.0 : (double)span / (double)sampled_bytes;
+  struct token_counts rest = {
+      .input_tokens = (uint64_t)((double)sampled.input_tokens * scale),
+      .output_tokens = (uint64_t)((double)sampled.output_tokens * scale),
+      .cache_creation_tokens = (uint64_t)((double)sampled.cache_creation_tokens * scale),
+      .cache_read_tokens = (uint64_t)((double)sampled.cache_read_tokens * scale),
+  };
+  out->tokens = stats->session_tokens;
+  ResultVoid add_result = add_token_counts(&out->tokens, &rest);
+  ResultU64 total_result = IS_OK(add_result) ? calculate_total_tokens(&out->tokens)
+                                             : ERR(ResultU64, MCCS_ERR_OVERFLOW);
+  ResultU64 rest_result = calculate_total_tokens(&rest);
+  if (IS_ERR(total_result) || IS_ERR(rest_result)) {
+    return ERR(ResultVoid, MCCS_ERR_OVERFLOW);
   }
+  out->tokens.total_tokens = UNWRAP_OK(total_result);
 
+  // 95% interval of the mean chunk density, carried over to the whole total
+  if (chunks > 1 && density_count > 1 && out->tokens.total_tokens > 0) {
+    double n = (double)density_count;
+    double mean = density_sum / n;
+    double variance = (density_sq_sum - n * mean * mean) / (n - 1);
+    if (mean > 0 && variance > 0) {
+      double rel = 1.96 * sqrt(variance / n) / mean;
+      double pct = 100.0 * rel * (double)UNWRAP_OK(rest_result) / (double)out->tokens.total_tokens;
+      out->error_pct = (uint32_t)(pct + 0.5);
+    }
+    if (out->error_pct == 0) {
+      out->error_pct = 1; // Extrapolated: never claim an exact value
+    }
+  }
+  out->valid = true;
+  DEBUG_LOG("Estimated %lu session tokens (+/-%u%%) from %zu of %zu unparsed bytes",
+            out->tokens.total_tokens, out->error_pct, sampled_bytes, span);
   return OK(ResultVoid, 0);
 }
+
+ResultVoid scan_transcript_tail(const char *transcript_path,
+                                struct mccs_scratch *scratch,
+                                size_t file_size,
+                                uint64_t *context_tokens) {
+  FILE *fp = fopen(transcript_path, "r");
+  if (!fp) {
+    return ERR(ResultVoid, MCCS_ERR_FILE_NOT_FOUND);
+  }
+
+  *context_tokens = 0;
+  for (size_t window = ESTIMATE_TAIL_BYTES;; window *= 2) {
+    size_t start = file_size > window ? file_size - window : 0;
+    size_t offset = seek_line_start(fp, scratch, start, start == 0);
+    bool found = false;
+    uint64_t context = 0;
+    struct token_counts segment;
+    init_token_counts(&segment);
+    ssize_t len;
+    while (offset < file_size && (len = getline(&scratch->line, &scratch->cap, fp)) != -1) {
+      struct token_counts turn;
+      uint64_t turn_context;
+      if (sample_transcript_line(&scratch->json, scratch->line, (size_t)len, &segment, &turn, &turn_context)) {
+        found = true;
+        context = 0;
+      } else if (turn_context > 0) {
+        found = true;
+        context = turn_context;
+      }
+      offset += (size_t)len;
+    }
+    if (found || start == 0 || window >= ESTIMATE_TAIL_MAX_BYTES) {
+      fclose(fp);
+      *context_tokens = context;
+      DEBUG_LOG("Tail scan of %zu bytes: context %lu (%s)", window, context, found ? "found" : "not found");
+      return OK(ResultVoid, found ? 1 : 0);
+    }
+  }
+}
@@ -105,4 +105,128 @@ ResultVoid parse_tokens_single_pass(const char *transcript_path,
                                     struct token_counts *session_tokens,
                                     uint64_t *context_tokens);
 
+/**
+ * Single-pass token parsing using caller-owned scratch memory
+ *
+ * @param transcript_path    Path to JSONL transcript file
+ * @param scratch            Reusable line buffer (e.g. from a render context)
+ * @param session_tokens     Output structure for accumulated session token counts (can be NULL)
+ * @param context_tokens     Output for context tokens from last assistant message (can be NULL)
+ * @return                   Result<void> - Ok(0) if successful or Err with error code
+ *
+ * @note Same semantics as parse_tokens_single_pass(); the line buffer is kept
+ *       in scratch for reuse instead of being freed on return.
+ * @error MCCS_ERR_FILE_NOT_FOUND if file cannot be opened
+ */
+ResultVoid parse_tokens_with_scratch(const char *transcript_path,
+                                     struct mccs_scratch *scratch,
+                                     struct token_counts *session_tokens,
+                                     uint64_t *context_tokens);
+
+/**
+ * Initialize transcript statistics for a scan from the start of the file
+ *
+ * @param stats    Statistics to reset
+ */
+void init_transcript_stats(struct transcript_stats *stats);
+
+/**
+ * Scan a transcript from stats->parsed_offset and fold new lines into stats
+ *
+ * @param transcript_path    Path to JSONL transcript file
+ * @param scratch            Reusable line buffer (e.g. from a render context)
+ * @param stats              In: state to resume from; Out: updated state
+ * @return                   Result<void> - Ok(0) if successful or Err with error code
+ *
+ * @note Accumulates session tokens over every line with usage, takes context
+ *       tokens from the last assistant turn and offers each assistant turn to
+ *       the top-turns heap. A compaction boundary bumps the compaction
+ *       count, resets the context tokens and starts a new token segment;
+ *       all of it is part of stats, so resumed scans see the same result.
+ *       Only complete lines advance parsed_offset, so a grown transcript
+ *       can be resumed from a cached stats snapshot.
+ * @note With stats->deadline_ms set, the clock is checked every
+ *       TRANSCRIPT_DEADLINE_CHECK_LINES lines; past the deadline the scan
+ *       stops early with stats->partial set and parsed_offset at the first
+ *       unparsed line, so a later scan finishes the work.
+ * @error MCCS_ERR_FILE_NOT_FOUND if file cannot be opened
+ * @error MCCS_ERR_IO_ERROR if the resume offset cannot be reached
+ * @error MCCS_ERR_OVERFLOW if token accumulation would overflow
+ */
+ResultVoid scan_transcript(const char *transcript_path,
+                           struct mccs_scratch *scratch,
+                           struct transcript_stats *stats);
+
+/**
+ * Callback for every assistant turn with token usage
+ *
+ * @param turn        Turn offset, timestamp and token counts
+ * @param model_id    message.model of the turn (NULL if missing)
+ * @param user        Caller data passed to scan_transcript_turns()
+ */
+typedef void (*turn_visitor)(const struct turn_record *turn,
+                             const char *model_id,
+                             void *user);
+
+/**
+ * scan_transcript() that also reports each assistant turn it folds in
+ *
+ * @param transcript_path    Path to JSONL transcript file
+ * @param scratch            Reusable line buffer
+ * @param stats              In: state to resume from; Out: updated state
+ * @param visit              Called once per assistant turn after parsed_offset (may be NULL)
+ * @param user               Passed through to visit
+ * @return                   Result<void> - same errors as scan_transcript()
+ */
+ResultVoid scan_transcript_turns(const char *transcript_path,
+                                 struct mccs_scratch *scratch,
+                                 struct transcript_stats *stats,
+                                 turn_visitor visit,
+                                 void *user);
+
+/**
+ * Estimate the session totals of a whole transcript from a partial scan
+ *
+ * @param transcript_path    Path to JSONL transcript file
+ * @param scratch            Reusable line buffer
+ * @param stats              Exact state of the bytes before stats->parsed_offset
+ * @param file_size          Current transcript size
+ * @param out                Output: stats totals plus the extrapolated rest
+ * @return                   Result<void> - Ok(0) if successful or Err with error code
+ *
+ * @note Parses ESTIMATE_SAMPLE_CHUNKS newline-aligned chunks evenly spaced
+ *       over [parsed_offset, file_size) and scales their token counts by
+ *       the unparsed byte count. The error bound comes from the spread of
+ *       the per-chunk token densities. A rest no larger than the sample is
+ *       parsed whole (error 0). out->valid stays false if nothing was read.
+ * @error MCCS_ERR_FILE_NOT_FOUND if file cannot be opened
+ * @error MCCS_ERR_OVERFLOW if token accumulation would overflow
+ */
+ResultVoid estimate_transcript_tokens(const char *transcript_path,
+                                      struct mccs_scratch *scratch,
+                                      const struct transcript_stats *stats,
+                                      size_t file_size,
+                                      struct token_estimate *out);
+
+/**
+ * Exact context tokens from the end of a transcript
+ *
+ * @param transcript_path    Path to JSONL transcript file
+ * @param scratch            Reusable line buffer
+ * @param file_size          Current transcript size
+ * @param context_tokens     Output: context tokens of the last assistant turn
+ *                           (0 if a compaction boundary follows it)
+ * @return                   Result<bool> as ResultVoid - Ok(1) if found, Ok(0) if
+ *                           the last ESTIMATE_TAIL_MAX_BYTES hold no assistant
+ *                           turn, or Err with error code
+ *
+ * @note Searches a tail window of ESTIMATE_TAIL_BYTES, doubling it until a
+ *       turn is found, so the cost does not depend on the transcript size.
+ * @error MCCS_ERR_FILE_NOT_FOUND if file cannot be opened
+ */
+ResultVoid scan_transcript_tail(const char *transcript_path,
+                                struct mccs_scratch *scratch,
+                                size_t file_size,
+                                uint64_t *context_tokens);
+
 #endif /* MCCS_TOKEN_CALCULATOR_H */
@@ -0,0 +1,98 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "top_turns.h"
+
+#include <string.h>
+
+/**
+ * Heap ordering: cheaper turns first, later turns lose ties
+ */
+static inline bool turn_less(const struct turn_record *a,
+                             const struct turn_record *b) {
+  if (a->tokens.total_tokens != b->tokens.total_tokens) {
+    return a->tokens.total_tokens < b->tokens.total_tokens;
+  }
+  return a->offset > b->offset;
+}
+
+static inline void turn_swap(struct turn_record *a,
+                             struct turn_record *b) {
+  struct turn_record tmp = *a;
+  *a = *b;
+  *b = tmp;
+}
+
+static void sift_up(struct turn_record *items,
+                    uint32_t i) {
+  while (i > 0) {
+    uint32_t parent = (i - 1) / 2;
+    if (!turn_less(&items[i], &items[parent])) {
+      break;
+    }
+    turn_swap(&items[i], &items[parent]);
+    i = parent;
+  }
+}
+
+static void sift_down(struct turn_record *items,
+                      uint32_t count,
+                      uint32_t i) {
+  while (true) {
+    uint32_t left = 2 * i + 1;
+    uint32_t right = left + 1;
+    uint32_t smallest = i;
+    if (left < count && turn_less(&items[left], &items[smallest])) {
+      smallest = left;
+    }
+    if (right < count && turn_less(&items[right], &items[smallest])) {
+      smallest = right;
+    }
+    if (smallest == i) {
+      return;
+    }
+    turn_swap(&items[i], &items[smallest]);
+    i = smallest;
+  }
+}
+
+void top_turns_init(struct top_turns *turns) {
+  memset(turns, 0, sizeof(*turns));
+}
+
+void top_turns_push(struct top_turns *turns,
+                    const struct turn_record *record) {
+  if (turns->count > TOP_TURNS_CAPACITY) {
+    turns->count = 0; // Corrupt input (e.g. foreign cache): start over
+  }
+
+  if (turns->count < TOP_TURNS_CAPACITY) {
+    turns->items[turns->count] = *record;
+    sift_up(turns->items, turns->count);
+    turns->count++;
+    return;
+  }
+
+  if (turn_less(&turns->items[0], record)) {
+    turns->items[0] = *record;
+    sift_down(turns->items, turns->count, 0);
+  }
+}
+
+size_t top_turns_sorted(const struct top_turns *turns,
+                        struct turn_record *out) {
+  struct top_turns heap = *turns;
+  if (heap.count > TOP_TURNS_CAPACITY) {
+    return 0;
+  }
+
+  // Pop the minimum repeatedly, filling the output from the back
+  size_t n = heap.count;
+  for (size_t i = n; i > 0; i--) {
+    out[i - 1] = heap.items[0];
+    heap.count--;
+    heap.items[0] = heap.items[heap.count];
+    sift_down(heap.items, heap.count, 0);
+  }
+  return n;
+}
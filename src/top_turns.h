@@ -0,0 +1,49 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file top_turns.h
+ * @brief Top-K most expensive turns tracker
+ *
+ * Keeps the TOP_TURNS_CAPACITY assistant turns with the highest total token
+ * usage in a fixed-size min-heap, so each transcript line costs O(log K)
+ * and the heap can be stored in the session cache as-is.
+ */
+
+#ifndef MCCS_TOP_TURNS_H
+#define MCCS_TOP_TURNS_H
+
+#include <stddef.h>
+
+#include "types_struct.h"
+
+/**
+ * Initialize an empty heap
+ *
+ * @param turns    Heap to initialize
+ */
+void top_turns_init(struct top_turns *turns);
+
+/**
+ * Offer a turn to the heap
+ *
+ * @param turns    Heap to update
+ * @param record   Turn to insert
+ *
+ * @note O(log K). When the heap is full the turn replaces the cheapest
+ *       retained one only if it is strictly more expensive.
+ */
+void top_turns_push(struct top_turns *turns,
+                    const struct turn_record *record);
+
+/**
+ * Copy the retained turns sorted by total tokens, most expensive first
+ *
+ * @param turns    Heap to read
+ * @param out      Output array with room for TOP_TURNS_CAPACITY records
+ * @return         Number of records written
+ */
+size_t top_turns_sorted(const struct top_turns *turns,
+                        struct turn_record *out);
+
+#endif /* MCCS_TOP_TURNS_H */
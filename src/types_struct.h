@@ -14,6 +14,7 @@
 #include <stdint.h>
 
 #include "constants.h"
+#include "json_tape.h"
 
 /**
  * Storage buffers for parsed JSON string values
@@ -60,6 +61,7 @@ struct mccs_status {
   struct mccs_buffers buffers;         ///< String storage
   struct mccs_string_refs string_refs; ///< Pointers into buffers
   struct mccs_counters counters;       ///< Numeric metrics
+  size_t cwd_root_len;                 ///< Length of the repository root prefix of buf_cwd (0 = none)
 };
 
 /**
@@ -74,19 +76,314 @@ struct token_counts {
   uint64_t total_tokens;          ///< Sum of all token categories
 };
 
+/**
+ * Reusable scratch memory for line-oriented parsing
+ * Owned by a render context so repeated parses avoid reallocations
+ */
+struct mccs_scratch {
+  char *line;           ///< getline() buffer (heap allocated, may be NULL)
+  size_t cap;           ///< Capacity of line buffer in bytes
+  struct json_doc json; ///< JSON parse buffers reused line after line
+};
+
+/**
+ * One assistant turn on its way into the history store
+ */
+struct history_turn {
+  int64_t timestamp;                  ///< Turn time (seconds since epoch, 0 if unknown)
+  uint64_t offset;                    ///< Byte offset of the transcript line
+  struct token_counts tokens;         ///< Token categories of this turn
+  char model_id[BUF_MODEL_ID_SIZE];   ///< message.model of the turn ("" if missing)
+};
+
+/**
+ * Growable list of turns collected during one transcript scan
+ * Owned by a render context so repeated renders reuse the allocation
+ */
+struct history_batch {
+  struct history_turn *turns; ///< Heap array (may be NULL)
+  size_t count;               ///< Turns in use
+  size_t cap;                 ///< Allocated turns
+};
+
+/**
+ * Terminal SGR attributes last emitted on a render context's stream
+ * Lets the emitter skip escapes that would not change the effective style
+ */
+struct mccs_sgr_state {
+  bool known;       ///< False until the first escape is written (terminal state unknown)
+  bool bold;        ///< Bold attribute is on
+  int16_t fg;       ///< 256-color foreground index, or -1 for the default color
+  const char *last; ///< Style string that produced this state (fast path)
+};
+
+/**
+ * Token usage of a single assistant turn in the transcript
+ */
+struct turn_record {
+  uint64_t offset;            ///< Byte offset of the transcript line
+  int64_t timestamp;          ///< Turn time (seconds since epoch, 0 if unknown)
+  struct token_counts tokens; ///< Token categories of this turn
+};
+
+/**
+ * Bounded min-heap of the most expensive turns (by total tokens)
+ * items[0] is the cheapest retained turn
+ */
+struct top_turns {
+  uint32_t count;                                ///< Number of valid items
+  struct turn_record items[TOP_TURNS_CAPACITY]; ///< Heap storage
+};
+
+/**
+ * Last prompt cache activity, enough to tell when the cache likely expires
+ */
+struct prompt_cache_state {
+  int64_t last_touch; ///< Time of the last assistant turn that wrote or read the cache (epoch s, 0 = never)
+  uint32_t ttl_s;     ///< Lifetime of the cache entries written last
+};
+
+/**
+ * Ways a tool call touches a file
+ */
+enum file_touch {
+  FILE_TOUCH_READ = 0, ///< Read
+  FILE_TOUCH_EDIT,     ///< Edit, MultiEdit, Write
+  FILE_TOUCH_KINDS
+};
+
+/**
+ * Distinct files touched by tool calls, by kind
+ * Exact while the paths fit in a small hash set, then a HyperLogLog sketch
+ * per kind in the same bytes, so the size stays fixed however many files
+ * a session touches
+ */
+struct file_set {
+  bool sketched;                     ///< registers are in use (counts are estimates)
+  uint32_t used;                     ///< Occupied slots (exact mode)
+  uint32_t counts[FILE_TOUCH_KINDS]; ///< Distinct paths per kind (exact mode)
+  union {
+    uint64_t slots[FILE_SET_SLOTS]; ///< Open addressing: path hash with the kind in bit 0 (0 = empty)
+    uint8_t registers[FILE_TOUCH_KINDS][FILE_SKETCH_REGISTERS]; ///< Largest hash rank per register
+  };
+};
+
+/**
+ * Failed and retried API requests seen in a transcript
+ */
+struct api_error_state {
+  uint32_t failed;    ///< Requests that gave up (assistant messages flagged isApiErrorMessage)
+  uint32_t retried;   ///< Retry attempts after an error (system entries with subtype api_error)
+  int64_t last_error; ///< Time of the latest failure or retry (epoch s, 0 = none)
+};
+
+/**
+ * What a part of the context window holds, by transcript entry content
+ */
+enum context_kind {
+  CONTEXT_TOOL_RESULTS = 0, ///< tool_result blocks of user lines
+  CONTEXT_ASSISTANT,        ///< Assistant text, thinking and tool calls (and compaction summaries)
+  CONTEXT_PROMPTS,          ///< Prompts typed by the user
+  CONTEXT_ATTACHMENTS,      ///< Images, documents, attachment entries and meta (injected) user lines
+  CONTEXT_KINDS
+};
+
+/**
+ * State of the conversation path up to one entry
+ */
+struct branch_point {
+  uint64_t key;                          ///< Hash of the entry uuid (0 = none)
+  uint64_t path_tokens;                  ///< Tokens of the assistant turns on the path to the entry
+  uint64_t context_tokens;               ///< Context tokens of the last assistant turn on that path
+  uint32_t context_bytes[CONTEXT_KINDS]; ///< Raw JSON bytes of that path since the last compaction, by kind
+};
+
+/**
+ * Active branch of a transcript that was rewound or had prompts edited
+ * Abandoned branches stay in the file; a prompt whose parent is not the
+ * latest entry moves the tip back to the state recorded for that parent.
+ * Only the parents of recent prompts are recorded (direct-mapped on the
+ * key), so the size stays fixed however long the session runs
+ */
+struct branch_state {
+  struct branch_point tip;                          ///< Latest entry on the active branch
+  uint64_t total_tokens;                            ///< Tokens of the assistant turns on every branch
+  uint32_t forks;                                   ///< Times the tip moved back to an earlier entry
+  struct branch_point fork_points[BRANCH_FORK_SLOTS]; ///< Path state at the parent of each prompt, by key
+};
+
+/**
+ * Minutes with assistant activity over the last ACTIVITY_WINDOW_MIN minutes
+ * A ring of bits indexed by minute (epoch / 60) modulo the window, so the
+ * map keeps a fixed size however long the session runs
+ */
+struct activity_map {
+  int64_t last_minute;           ///< Latest active minute (epoch / 60, 0 = none)
+  uint64_t bits[ACTIVITY_WORDS]; ///< Bit m % ACTIVITY_WINDOW_MIN set if minute m was active
+};
+
+/**
+ * Position of a transcript scan in the content-defined chunking
+ * A chunk ends after a line whose last bytes hash to a cut point, so a copy
+ * of a transcript prefix is cut like the original (see chunk_store.h)
+ */
+struct chunk_cursor {
+  uint64_t chain;  ///< Key of the last complete chunk (hash of every chunk up to it, 0 = none)
+  uint64_t digest; ///< Hash of the lines of the open chunk
+  uint64_t start;  ///< Offset of the open chunk
+  uint64_t bytes;  ///< Bytes in the open chunk
+};
+
+/**
+ * The user request being answered: its prompt and the usage since
+ * Tool results come back as user lines too; only a prompt typed by the
+ * user starts a new turn
+ */
+struct current_turn {
+  bool started;               ///< A user prompt has been seen
+  uint64_t prompt_offset;     ///< Byte offset of the prompt line
+  int64_t prompt_time;        ///< Prompt time (seconds since epoch, 0 if unknown)
+  struct token_counts tokens; ///< Usage of the lines after the prompt
+};
+
+/**
+ * Aggregated transcript statistics up to a byte offset
+ * Can be resumed from parsed_offset when the transcript grows
+ */
+struct transcript_stats {
+  struct token_counts session_tokens; ///< Total tokens across all lines
+  uint64_t context_tokens;            ///< Context tokens of the last assistant turn on the active branch
+  struct top_turns top_turns;         ///< Most expensive assistant turns
+  uint32_t compactions;               ///< Compaction boundaries seen
+  struct token_counts segment_tokens; ///< Tokens since the last compaction (whole session if none)
+  struct prompt_cache_state prompt_cache; ///< Last prompt cache write/read
+  struct current_turn turn;           ///< Request in progress at parsed_offset
+  struct activity_map activity;       ///< Minutes with assistant turns
+  struct api_error_state api_errors;  ///< Failed and retried requests
+  struct file_set files;              ///< Files read and edited by tool calls
+  struct branch_state branch;         ///< Active conversation branch
+  size_t parsed_offset;               ///< Bytes of complete lines consumed
+  int64_t deadline_ms;                ///< CLOCK_MONOTONIC time to stop scanning at (0 = none)
+  bool partial;                       ///< Scan stopped at the deadline before the end of the file
+  struct chunk_cursor chunks;         ///< Chunking state at parsed_offset
+  const char *chunk_store;            ///< Store to record a snapshot in at each chunk end (NULL = off)
+};
+
+/**
+ * Session totals estimated from a sample of the unparsed part of a transcript
+ */
+struct token_estimate {
+  struct token_counts tokens; ///< Exact totals of the parsed part plus the extrapolated rest
+  uint32_t error_pct;         ///< Half-width of the ~95% confidence interval, percent of the total
+  bool valid;                 ///< tokens holds an estimate
+};
+
+/**
+ * Last-render bookkeeping used by the render debounce
+ * Kept together so it can be updated in place without rewriting the cache
+ */
+struct cache_render_stamp {
+  uint64_t input_digest;      ///< FNV-1a hash of the last fully rendered stdin payload
+  int64_t last_render_ms;     ///< CLOCK_MONOTONIC time of that render (ms)
+  uint64_t debounced_renders; ///< Renders answered from the cache inside the window
+};
+
 /**
  * Cached token statistics to avoid re-parsing large files
  * Tracks file sizes to detect changes and invalidate cache
  * Stores raw token counts; percentages are derived during rendering
+ *
+ * The first CACHE_LINE_SIZE bytes hold everything a validity check reads
+ * and the headline totals: the owner and transcript hashes, the transcript
+ * identity, session tokens, context and cost (one cache line in the file
+ * and wherever the record is line-aligned). load_cache() reads that line
+ * alone first, and the rest only when the hashes match; the full identity
+ * strings sit in a cold tail it compares then.
  */
 struct token_cache {
+  // Hot: first cache line
   uint32_t magic;                       ///< Magic number for cache validation (CACHE_MAGIC)
+  bool partial;                         ///< Parse was cut short by --budget-ms (kept past CACHE_MAX_AGE_S)
   int64_t last_update_time;             ///< Last cache update (seconds since epoch)
+  uint64_t owner_hash;                  ///< cache_owner_hash() of session_id and project_dir
+  uint64_t transcript_hash;             ///< cache_identity_hash() of transcript_path
+  size_t transcript_file_size;          ///< Transcript bytes parsed (resume offset)
+  uint64_t session_total_tokens;        ///< session_tokens.total_tokens
+  uint64_t context_tokens;              ///< Context window tokens (last message)
+  double cost_usd;                      ///< Session cost at the last refresh (NaN if unknown)
+  // Warm: read once the hashes match
+  struct token_counts session_tokens;   ///< Total tokens across entire session
+  struct token_counts segment_tokens;   ///< Tokens since the last compaction
+  uint32_t compactions;                 ///< Compaction boundaries seen so far
+  struct prompt_cache_state prompt_cache; ///< Last prompt cache write/read
+  struct cache_render_stamp render;     ///< Debounce state (see --debounce-ms)
+  struct chunk_cursor chunks;           ///< Chunking state at transcript_file_size
+  struct current_turn turn;             ///< Request in progress at transcript_file_size
+  double turn_cost_base;                ///< Session cost when the request started (NaN if unknown)
+  struct activity_map activity;         ///< Minutes with assistant turns
+  struct api_error_state api_errors;    ///< Failed and retried requests
+  struct file_set files;                ///< Files read and edited by tool calls
+  struct branch_state branch;           ///< Active conversation branch
+  struct top_turns top_turns;           ///< Most expensive turns so far
+  // Cold: full identity, compared only when the hashes match
   char session_id[BUF_SESSION_ID_SIZE]; ///< Session ID for cache validation
   char project_dir[BUF_PATH_SIZE];      ///< Project directory for cache validation
-  struct token_counts session_tokens;   ///< Total tokens across entire session
-  struct token_counts context_tokens;   ///< Context window tokens (last message)
-  size_t transcript_file_size;          ///< Transcript file size at last parse
+  char transcript_path[BUF_TRANSCRIPT_PATH_SIZE]; ///< Transcript the statistics were parsed from
+};
+
+/**
+ * Progress bar coloring mode
+ * OFF keeps the theme's single color per bar; the others select a
+ * precomputed gradient table (see gradient.h)
+ */
+enum mccs_gradient_mode {
+  MCCS_GRADIENT_OFF = 0,   ///< One theme color per bar
+  MCCS_GRADIENT_256,       ///< Gradient quantized to the xterm 256-color cube
+  MCCS_GRADIENT_TRUECOLOR, ///< 24-bit gradient (COLORTERM=truecolor terminals)
+  MCCS_GRADIENT_MODE_COUNT
+};
+
+/**
+ * Theme elements a config file can recolor (one per struct color_theme
+ * member except reset)
+ */
+enum mccs_theme_slot {
+  MCCS_THEME_LABEL = 0,           ///< Field labels
+  MCCS_THEME_MODEL_NAME,          ///< Model display name
+  MCCS_THEME_MODEL_ID,            ///< Model ID string
+  MCCS_THEME_VERSION,             ///< Version string
+  MCCS_THEME_DIR,                 ///< Directory/path display
+  MCCS_THEME_COST,                ///< Cost display
+  MCCS_THEME_TIME_TOTAL,          ///< Total duration
+  MCCS_THEME_TIME_API,            ///< API time
+  MCCS_THEME_LINES_ADDED,         ///< Added lines count
+  MCCS_THEME_LINES_REMOVED,       ///< Removed lines count
+  MCCS_THEME_BADGE_UNDER,         ///< <200k token badge
+  MCCS_THEME_BADGE_OVER,          ///< >200k token badge
+  MCCS_THEME_TOKEN_INPUT,         ///< Input tokens
+  MCCS_THEME_TOKEN_OUTPUT,        ///< Output tokens
+  MCCS_THEME_TOKEN_CACHE_CREATE,  ///< Cache write tokens
+  MCCS_THEME_TOKEN_CACHE_READ,    ///< Cache read tokens
+  MCCS_THEME_PROGRESS_EMPTY,      ///< Empty progress bar segments
+  MCCS_THEME_PROGRESS_CTX,        ///< Context window progress bar
+  MCCS_THEME_PROGRESS_SES,        ///< Session total progress bar
+  MCCS_THEME_PROGRESS_CACHE,      ///< Cache efficiency progress bar
+  MCCS_THEME_PROGRESS_API_TIME,   ///< API time ratio progress bar
+  MCCS_THEME_SLOT_COUNT
+};
+
+/**
+ * Options of the query subcommand
+ */
+struct query_options {
+  const char *by;    ///< Comma-separated group dimensions: session, model, day, week (--by)
+  const char *since; ///< First day to include, YYYY-MM-DD (--since)
+  const char *until; ///< Last day to include, YYYY-MM-DD (--until)
+  const char *model; ///< Only models whose ID contains this substring (--model)
+  const char *sort;  ///< Column to sort groups by (--sort)
+  const char *store; ///< Store directory overriding the per-user one (--store)
+  bool reverse;      ///< Ascending instead of descending order (--reverse)
+  uint32_t limit;    ///< Maximum groups to print, 0 = all (--limit)
 };
 
 /**
@@ -108,6 +405,27 @@ struct cli_options {
   bool verbose;                     ///< Show field labels in status line (--verbose)
   bool hide_token_breakdown;        ///< Hide token breakdown line (--hide-breakdown)
   bool simple_status_line;          ///< Show simplified main status line (--simple)
+  bool show_top_turns;              ///< Show most expensive turns (--top-turns)
+  bool show_turn_cost;              ///< Show tokens and cost of the request in progress (--turn-cost)
+  bool show_activity;               ///< Show the session activity timeline (--activity)
+  bool show_api_errors;             ///< Show recent API errors and retries (--api-errors)
+  bool show_files;                  ///< Show distinct files read and edited (--files)
+  bool show_abandoned;              ///< Show tokens spent on abandoned branches (--abandoned)
+  bool show_context_mix;            ///< Show what fills the context window (--context-mix)
+  bool top_turns_json;              ///< Print most expensive turns as JSON (--top-turns-json)
+  const char *batch_source;         ///< Directory or NDJSON file to render in batch (--batch)
+  uint32_t batch_jobs;              ///< Worker threads for batch mode, 0 = auto (--jobs)
+  const char *record_trace;         ///< Trace file to append each tick to (--record)
+  enum mccs_gradient_mode gradient; ///< Progress bar gradient mode (--gradient)
+  uint16_t theme_colors[MCCS_THEME_SLOT_COUNT]; ///< 256-color palette index + 1 per theme slot, 0 = theme default (config color-* keys)
+  uint32_t debounce_ms;             ///< Reuse the cached result for identical input within this window (--debounce-ms)
+  uint32_t budget_ms;               ///< Stop parsing the transcript after this long, 0 = no limit (--budget-ms)
+  bool approximate;                 ///< Estimate session totals from a sample when the parse is cut short (--approximate)
+  bool top;                         ///< Run the live session monitor (top subcommand)
+  bool top_once;                    ///< Print one monitor frame as plain lines and exit (top --once)
+  bool record_history;              ///< Append parsed turns to the columnar history store (--history)
+  bool query;                       ///< Aggregate the history store (query subcommand)
+  struct query_options query_opts;  ///< Options of the query subcommand
 };
 
 /**
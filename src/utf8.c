@@ -0,0 +1,243 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+#include "utf8.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+/**
+ * Length of the ASCII run at the start of p
+ */
+static size_t utf8_ascii_run(const unsigned char *p,
+                             size_t len) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  for (; len - i >= 16; i += 16) {
+    int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(const void *)(p + i)));
+    if (mask != 0) {
+      return i + (size_t)__builtin_ctz((unsigned)mask);
+    }
+  }
+#else
+  for (; len - i >= 8; i += 8) {
+    uint64_t word;
+    memcpy(&word, p + i, sizeof(word));
+    if (word & 0x8080808080808080ULL) {
+      break;
+    }
+  }
+#endif
+  while (i < len && p[i] < 0x80) {
+    i++;
+  }
+  return i;
+}
+
+/**
+ * Length of the well-formed sequence at p (0 if invalid or cut short)
+ */
+static size_t utf8_sequence(const unsigned char *p,
+                            const unsigned char *end) {
+  unsigned char c = p[0];
+  size_t avail = (size_t)(end - p);
+  if (c < 0x80) {
+    return 1;
+  }
+  if (c >= 0xC2 && c <= 0xDF) {
+    return avail >= 2 && (p[1] & 0xC0) == 0x80 ? 2 : 0;
+  }
+  if (c >= 0xE0 && c <= 0xEF) {
+    // E0 needs A0..BF (no overlongs), ED needs 80..9F (no surrogates)
+    unsigned char lo = c == 0xE0 ? 0xA0 : 0x80;
+    unsigned char hi = c == 0xED ? 0x9F : 0xBF;
+    return avail >= 3 && p[1] >= lo && p[1] <= hi && (p[2] & 0xC0) == 0x80 ? 3 : 0;
+  }
+  if (c >= 0xF0 && c <= 0xF4) {
+    // F0 needs 90..BF (no overlongs), F4 needs 80..8F (at most U+10FFFF)
+    unsigned char lo = c == 0xF0 ? 0x90 : 0x80;
+    unsigned char hi = c == 0xF4 ? 0x8F : 0xBF;
+    return avail >= 4 && p[1] >= lo && p[1] <= hi && (p[2] & 0xC0) == 0x80 && (p[3] & 0xC0) == 0x80 ? 4 : 0;
+  }
+  return 0;
+}
+
+#if defined(__SSSE3__)
+/*
+ * Keiser and Lemire's lookup algorithm: three 16-entry tables indexed by the
+ * nibbles of each byte and of the byte before it flag every invalid 2-byte
+ * pattern; the bytes that must be the 3rd or 4th of a sequence are found from
+ * the bytes two and three positions back.
+ */
+#define UTF8_TOO_SHORT 0x01  /* Lead or ASCII byte where a continuation is due */
+#define UTF8_TOO_LONG 0x02   /* Continuation after ASCII */
+#define UTF8_OVERLONG_3 0x04 /* E0 80..9F */
+#define UTF8_TOO_LARGE 0x08  /* Above U+10FFFF */
+#define UTF8_SURROGATE 0x10  /* ED A0..BF */
+#define UTF8_OVERLONG_2 0x20 /* C0, C1 */
+#define UTF8_TOO_LARGE_1000 0x40
+#define UTF8_OVERLONG_4 0x40 /* F0 80..8F */
+#define UTF8_TWO_CONTS 0x80  /* Continuation after continuation (valid as 3rd/4th byte) */
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+#define B(x) ((char)(x))
+
+static __m128i utf8_check_block(__m128i input,
+                                __m128i prev) {
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+  const __m128i byte_1_high_table = _mm_setr_epi8(
+      B(UTF8_TOO_LONG), B(UTF8_TOO_LONG), B(UTF8_TOO_LONG), B(UTF8_TOO_LONG),
+      B(UTF8_TOO_LONG), B(UTF8_TOO_LONG), B(UTF8_TOO_LONG), B(UTF8_TOO_LONG),
+      B(UTF8_TWO_CONTS), B(UTF8_TWO_CONTS), B(UTF8_TWO_CONTS), B(UTF8_TWO_CONTS),
+      B(UTF8_TOO_SHORT | UTF8_OVERLONG_2),
+      B(UTF8_TOO_SHORT),
+      B(UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE),
+      B(UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4));
+  const __m128i byte_1_low_table = _mm_setr_epi8(
+      B(UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4),
+      B(UTF8_CARRY | UTF8_OVERLONG_2),
+      B(UTF8_CARRY), B(UTF8_CARRY),
+      B(UTF8_CARRY | UTF8_TOO_LARGE),
+      B(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      B(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      B(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      B(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      B(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      B(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      B(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      B(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      B(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE),
+      B(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+      B(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000));
+  const __m128i byte_2_high_table = _mm_setr_epi8(
+      B(UTF8_TOO_SHORT), B(UTF8_TOO_SHORT), B(UTF8_TOO_SHORT), B(UTF8_TOO_SHORT),
+      B(UTF8_TOO_SHORT), B(UTF8_TOO_SHORT), B(UTF8_TOO_SHORT), B(UTF8_TOO_SHORT),
+      B(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4),
+      B(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE),
+      B(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE),
+      B(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE),
+      B(UTF8_TOO_SHORT), B(UTF8_TOO_SHORT), B(UTF8_TOO_SHORT), B(UTF8_TOO_SHORT));
+
+  __m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+  __m128i special = _mm_and_si128(
+      _mm_and_si128(_mm_shuffle_epi8(byte_1_high_table, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                    _mm_shuffle_epi8(byte_1_low_table, _mm_and_si128(prev1, nibble))),
+      _mm_shuffle_epi8(byte_2_high_table, _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+
+  // Bytes two after an E0+ lead or three after an F0+ lead must continue it
+  __m128i third = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 14), _mm_set1_epi8(B(0xE0 - 0x80)));
+  __m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 13), _mm_set1_epi8(B(0xF0 - 0x80)));
+  __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(B(0x80)));
+  return _mm_xor_si128(must23, special);
+}
+
+bool utf8_validate(const char *s,
+                   size_t len) {
+  const __m128i zero = _mm_setzero_si128();
+  // Non-zero where the last three bytes of a block start a sequence that did not end
+  const __m128i incomplete_max = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                               B(0xF0 - 1), B(0xE0 - 1), B(0xC0 - 1));
+  __m128i error = zero;
+  __m128i prev = zero;
+  __m128i prev_incomplete = zero;
+  size_t i = 0;
+  for (; len - i >= 16; i += 16) {
+    __m128i input = _mm_loadu_si128((const __m128i *)(const void *)(s + i));
+    if (_mm_movemask_epi8(input) == 0) {
+      error = _mm_or_si128(error, prev_incomplete);
+    } else {
+      error = _mm_or_si128(error, utf8_check_block(input, prev));
+      prev_incomplete = _mm_subs_epu8(input, incomplete_max);
+    }
+    prev = input;
+  }
+  // Tail padded with NULs: a sequence cut short by the end reads as TOO_SHORT
+  char tail[16] = {0};
+  memcpy(tail, s + i, len - i);
+  error = _mm_or_si128(error, utf8_check_block(_mm_loadu_si128((const __m128i *)(const void *)tail), prev));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(error, zero)) == 0xFFFF;
+}
+#else
+bool utf8_validate(const char *s,
+                   size_t len) {
+  const unsigned char *p = (const unsigned char *)s;
+  size_t i = 0;
+  while ((i += utf8_ascii_run(p + i, len - i)) < len) {
+    size_t n = utf8_sequence(p + i, p + len);
+    if (n == 0) {
+      return false;
+    }
+    i += n;
+  }
+  return true;
+}
+#endif
+
+size_t utf8_truncate(const char *s,
+                     size_t len,
+                     size_t max) {
+  if (len <= max) {
+    return len;
+  }
+  // s[cut] is the first byte dropped: if it continues a sequence, drop its lead too
+  size_t cut = max;
+  for (int back = 0; back < 3 && cut > 0 && ((unsigned char)s[cut] & 0xC0) == 0x80; back++) {
+    cut--;
+  }
+  return cut;
+}
+
+size_t utf8_trim_partial(const char *s,
+                         size_t len) {
+  for (size_t back = 1; back <= 3 && back <= len; back++) {
+    unsigned char c = (unsigned char)s[len - back];
+    if ((c & 0xC0) != 0x80) {
+      size_t need = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+      return need > back ? len - back : len;
+    }
+  }
+  return len;
+}
+
+size_t utf8_sanitize(char *s,
+                     size_t len) {
+  if (utf8_validate(s, len)) {
+    return 0;
+  }
+  unsigned char *p = (unsigned char *)s;
+  size_t replaced = 0;
+  size_t i = 0;
+  while ((i += utf8_ascii_run(p + i, len - i)) < len) {
+    size_t n = utf8_sequence(p + i, p + len);
+    if (n == 0) {
+      p[i++] = UTF8_REPLACEMENT;
+      replaced++;
+    } else {
+      i += n;
+    }
+  }
+  return replaced;
+}
+
+size_t utf8_prefix(const char *s,
+                   size_t len,
+                   size_t count,
+                   size_t *taken) {
+  size_t i = 0;
+  size_t n = 0;
+  while (i < len && n < count) {
+    i++;
+    while (i < len && ((unsigned char)s[i] & 0xC0) == 0x80) {
+      i++;
+    }
+    n++;
+  }
+  *taken = n;
+  return i;
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file utf8.h
+ * @brief UTF-8 validation and codepoint-safe truncation
+ *
+ * Strings from the status payload end up in fixed-size buffers and on the
+ * terminal. Cutting them at a byte count can split a multi-byte sequence,
+ * and a stray invalid byte is enough for some terminals to garble the rest
+ * of the line. The validator skips ASCII 16 bytes at a time (SSE2, or 8 with
+ * a word test) and checks the remaining sequences strictly: no overlong
+ * forms, no surrogates, nothing above U+10FFFF.
+ */
+
+#ifndef MCCS_UTF8_H
+#define MCCS_UTF8_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define UTF8_REPLACEMENT '?' /* Written over each byte of an invalid sequence */
+
+/**
+ * Check that a byte string is valid UTF-8
+ *
+ * @param s      Bytes to check (need not be NUL-terminated)
+ * @param len    Number of bytes
+ * @return       true if every sequence is well formed
+ */
+bool utf8_validate(const char *s,
+                   size_t len);
+
+/**
+ * Longest prefix of at most max bytes that ends on a codepoint boundary
+ *
+ * @param s      String
+ * @param len    Length of s
+ * @param max    Byte budget
+ * @return       len if it fits, otherwise max minus the bytes of a codepoint cut in half
+ *
+ * @note Backs off at most three continuation bytes, so malformed input
+ *       cannot make it scan further.
+ */
+size_t utf8_truncate(const char *s,
+                     size_t len,
+                     size_t max);
+
+/**
+ * Length without an incomplete sequence at the end
+ *
+ * @param s      String already cut (e.g. by snprintf)
+ * @param len    Length of s
+ * @return       len, or the offset of a trailing lead byte whose sequence is cut short
+ */
+size_t utf8_trim_partial(const char *s,
+                         size_t len);
+
+/**
+ * Replace invalid sequences in place
+ *
+ * @param s      String to repair
+ * @param len    Length of s
+ * @return       Number of bytes replaced by UTF8_REPLACEMENT (0 if s was valid)
+ */
+size_t utf8_sanitize(char *s,
+                     size_t len);
+
+/**
+ * Byte length of the first count codepoints
+ *
+ * @param s        String (valid UTF-8)
+ * @param len      Length of s
+ * @param count    Codepoints wanted
+ * @param taken    Output: codepoints actually covered (fewer if s is shorter)
+ * @return         Bytes covering them
+ */
+size_t utf8_prefix(const char *s,
+                   size_t len,
+                   size_t count,
+                   size_t *taken);
+
+#endif /* MCCS_UTF8_H */
@@ -279,11 +279,643 @@ test_exceeds_200k_badge() {
   fi
 }
 
+# Test: Batch mode renders NDJSON and directories in input order
+test_batch_mode() {
+  local tmp
+  tmp="$(mktemp -d)"
+  cp "$FIXTURES/test_transcript.jsonl" "$tmp/transcript.jsonl"
+  mkdir "$tmp/docs"
+
+  local i
+  for i in 1 2 3 4 5 6; do
+    printf '{"session_id":"batch-test-%s-%s","transcript_path":"%s","model":{"id":"m","display_name":"Model%s"},"workspace":{"project_dir":"/tmp"},"version":"1.0.0"}\n' \
+      "$$" "$i" "$tmp/transcript.jsonl" "$i" | tee -a "$tmp/batch.ndjson" >"$tmp/docs/doc_$i.json"
+  done
+
+  local exit_code=0
+  local output dir_output
+  output="$(NO_COLOR=1 "$BIN" --session-tokens --batch "$tmp/batch.ndjson" --jobs 4)" || exit_code=$?
+  dir_output="$(NO_COLOR=1 "$BIN" --session-tokens --batch "$tmp/docs" -j 3)" || exit_code=$?
+  rm -rf "$tmp"
+
+  local models
+  models="$(echo "$output" | grep -o 'Model[0-9]' | tr -d '\n')"
+  if [[ "$exit_code" -eq 0 ]] && [[ "$models" == "Model1Model2Model3Model4Model5Model6" ]] &&
+    [[ "$(echo "$output" | grep -c '^Ses')" -eq 6 ]] && [[ "$output" == "$dir_output" ]]; then
+    test_passed "Batch mode (NDJSON and directory, input order)"
+  else
+    test_failed "Batch mode (NDJSON and directory, input order)"
+    echo "  models: $models"
+    echo "  output: $output"
+    echo "  exit code: $exit_code"
+  fi
+}
+
+
+# Test: --record appends one trace line per tick and mirrors transcript growth
+test_record_trace() {
+  local tmp
+  tmp="$(mktemp -d)"
+  : >"$tmp/transcript.jsonl"
+  local json="{\"session_id\":\"record-test-$$\",\"transcript_path\":\"$tmp/transcript.jsonl\",\"model\":{\"display_name\":\"Rec\"}}"
+
+  local exit_code=0
+  local i
+  for i in 1 2 3; do
+    sed -n "${i}p" "$FIXTURES/test_transcript.jsonl" >>"$tmp/transcript.jsonl"
+    echo "$json" | NO_COLOR=1 "$BIN" --session-tokens --record "$tmp/trace.ndjson" >/dev/null || exit_code=$?
+  done
+
+  local lines sizes
+  lines="$(wc -l <"$tmp/trace.ndjson")"
+  sizes="$(grep -o '"size":[0-9]*' "$tmp/trace.ndjson" | cut -d: -f2 | tr '\n' ' ')"
+  if [[ "$exit_code" -eq 0 ]] && [[ "$lines" -eq 3 ]] &&
+    cmp -s "$tmp/transcript.jsonl" "$tmp"/trace.ndjson.d/*.jsonl &&
+    [[ "$sizes" == "$(head -n 1 "$FIXTURES/test_transcript.jsonl" | wc -c) $(head -n 2 "$FIXTURES/test_transcript.jsonl" | wc -c) $(head -n 3 "$FIXTURES/test_transcript.jsonl" | wc -c) " ]]; then
+    test_passed "Record trace (--record)"
+  else
+    test_failed "Record trace (--record)"
+    echo "  trace lines: $lines, sizes: $sizes"
+    echo "  exit code: $exit_code"
+  fi
+  rm -rf "$tmp"
+}
+
+# Test: --all --verbose writes each style change once and keeps the visible text
+test_sgr_minimal_escapes() {
+  # ANSI bytes for this fixture when every field was wrapped in its own
+  # style + reset pair (before the SGR-state-tracking emitter)
+  local baseline_escape_bytes=1714
+
+  local tmp
+  tmp="$(mktemp -d)"
+  cp "$FIXTURES/test_transcript.jsonl" "$tmp/transcript.jsonl"
+  local json
+  json="$(sed "s#\"transcript_path\":\"[^\"]*\"#\"transcript_path\":\"$tmp/transcript.jsonl\"#" \
+    "$FIXTURES/test_status_with_transcript.json")"
+
+  local exit_code=0
+  echo "$json" | "$BIN" --all --verbose >"$tmp/color.out" || exit_code=$?
+  echo "$json" | NO_COLOR=1 "$BIN" --all --verbose >"$tmp/plain.out" || exit_code=$?
+
+  local color_bytes plain_bytes escape_bytes
+  color_bytes="$(wc -c <"$tmp/color.out")"
+  plain_bytes="$(wc -c <"$tmp/plain.out")"
+  escape_bytes=$((color_bytes - plain_bytes))
+
+  if [[ "$exit_code" -eq 0 ]] &&
+    [[ "$(sed 's/\x1b\[[0-9;]*m//g' "$tmp/color.out")" == "$(cat "$tmp/plain.out")" ]] &&
+    ! grep -qE $'\x1b\\[[0-9;]*m\x1b\\[' "$tmp/color.out" &&
+    [[ "$escape_bytes" -lt "$baseline_escape_bytes" ]]; then
+    test_passed "Minimal SGR escapes (--all --verbose)"
+    echo "  ANSI bytes: $escape_bytes (was $baseline_escape_bytes, -$(((baseline_escape_bytes - escape_bytes) * 100 / baseline_escape_bytes))%)," \
+      "output: $color_bytes bytes (was $((plain_bytes + baseline_escape_bytes)))"
+  else
+    test_failed "Minimal SGR escapes (--all --verbose)"
+    echo "  ANSI bytes: $escape_bytes (baseline $baseline_escape_bytes)"
+    echo "  exit code: $exit_code"
+  fi
+  rm -rf "$tmp"
+}
+
+# Test: --gradient swaps bar colors without changing the visible text
+test_gradient_bars() {
+  local json='{"session_id":"gradient-test","model":{"display_name":"Grad"},"cost":{"total_duration_ms":10000,"total_api_duration_ms":7000}}'
+  local strip='s/\x1b\[[0-9;]*m//g'
+
+  local exit_code=0
+  local plain truecolor cube
+  plain="$(echo "$json" | "$BIN" --api-time-ratio)" || exit_code=$?
+  truecolor="$(echo "$json" | "$BIN" --api-time-ratio --gradient truecolor)" || exit_code=$?
+  cube="$(echo "$json" | "$BIN" --api-time-ratio --gradient 256)" || exit_code=$?
+
+  local invalid_exit=0
+  echo "$json" | "$BIN" --gradient 16 >/dev/null 2>&1 || invalid_exit=$?
+
+  if [[ "$exit_code" -eq 0 ]] && [[ "$invalid_exit" -ne 0 ]] &&
+    [[ "$(echo "$truecolor" | sed "$strip")" == "$(echo "$plain" | sed "$strip")" ]] &&
+    [[ "$(echo "$cube" | sed "$strip")" == "$(echo "$plain" | sed "$strip")" ]] &&
+    echo "$truecolor" | grep -q '38;2;' && ! echo "$cube" | grep -q '38;2;' &&
+    [[ "$(echo "$cube" | grep -o '38;5;[0-9]*' | sort -u | wc -l)" -gt 2 ]]; then
+    test_passed "Gradient progress bars (--gradient)"
+  else
+    test_failed "Gradient progress bars (--gradient)"
+    echo "  exit code: $exit_code, invalid mode exit: $invalid_exit"
+  fi
+}
+
+# Test: --debounce-ms answers identical payloads from the cache within the window
+test_debounce_window() {
+  local tmp
+  tmp="$(mktemp -d)"
+  head -n 3 "$FIXTURES/test_transcript.jsonl" >"$tmp/transcript.jsonl"
+  local json="{\"session_id\":\"debounce-test-$$\",\"transcript_path\":\"$tmp/transcript.jsonl\"}"
+  local changed="{\"session_id\":\"debounce-test-$$\",\"transcript_path\":\"$tmp/transcript.jsonl\",\"version\":\"2\"}"
+
+  local exit_code=0
+  local first repeated updated
+  first="$(echo "$json" | NO_COLOR=1 "$BIN" -t --debounce-ms 60000 | tail -n 1)" || exit_code=$?
+  # Transcript growth inside the window is not seen by an identical payload...
+  tail -n +4 "$FIXTURES/test_transcript.jsonl" >>"$tmp/transcript.jsonl"
+  repeated="$(echo "$json" | NO_COLOR=1 "$BIN" -t --debounce-ms 60000 | tail -n 1)" || exit_code=$?
+  # ...but any change in the payload renders in full
+  updated="$(echo "$changed" | NO_COLOR=1 "$BIN" -t --debounce-ms 60000 | tail -n 1)" || exit_code=$?
+  rm -rf "$tmp"
+
+  if [[ "$exit_code" -eq 0 ]] && [[ "$first" == "$repeated" ]] && [[ "$first" != "$updated" ]]; then
+    test_passed "Render debounce window (--debounce-ms)"
+  else
+    test_failed "Render debounce window (--debounce-ms)"
+    echo "  first: $first"
+    echo "  repeated: $repeated"
+    echo "  updated: $updated"
+  fi
+}
 
 # Run all tests
 echo "Running test suite..."
 echo "===================="
 
+# Test: top --once lists active sessions and picks up transcript growth
+test_top_once() {
+  local tmp
+  tmp="$(mktemp -d)"
+  head -n 3 "$FIXTURES/test_transcript.jsonl" >"$tmp/grown.jsonl"
+  cp "$FIXTURES/test_transcript.jsonl" "$tmp/full.jsonl"
+
+  local exit_code=0
+  echo "{\"session_id\":\"topgrow-$$\",\"transcript_path\":\"$tmp/grown.jsonl\",\"workspace\":{\"project_dir\":\"/tmp/top-grown-$$\"},\"cost\":{\"total_cost_usd\":1.25}}" |
+    NO_COLOR=1 "$BIN" -t >/dev/null || exit_code=$?
+  echo "{\"session_id\":\"topfull-$$\",\"transcript_path\":\"$tmp/full.jsonl\",\"workspace\":{\"project_dir\":\"/tmp/top-full-$$\"}}" |
+    NO_COLOR=1 "$BIN" -t >/dev/null || exit_code=$?
+  # Grown after the last render: only the monitor's own tail parse can see it
+  tail -n +4 "$FIXTURES/test_transcript.jsonl" >>"$tmp/grown.jsonl"
+
+  local frame grown full
+  frame="$(NO_COLOR=1 "$BIN" top --once)" || exit_code=$?
+  grown="$(echo "$frame" | grep "top-grown-$$")"
+  full="$(echo "$frame" | grep "top-full-$$")"
+  rm -rf "$tmp"
+
+  # Same TOTAL column for both sessions; cost comes from the status payload
+  if [[ "$exit_code" -eq 0 ]] && [[ -n "$grown" ]] &&
+    [[ "$(echo "$grown" | awk '{print $5}')" == "$(echo "$full" | awk '{print $5}')" ]] &&
+    [[ "$grown" == *'$1.25'* ]] && [[ "$full" == *' - '* ]]; then
+    test_passed "Session monitor (top --once)"
+  else
+    test_failed "Session monitor (top --once)"
+    echo "$frame"
+  fi
+}
+
+test_history_query() {
+  local tmp
+  tmp="$(mktemp -d)"
+  head -n 3 "$FIXTURES/test_transcript.jsonl" >"$tmp/t.jsonl"
+
+  local exit_code=0 project
+  # Partial transcript, then its growth, then a full re-parse (new project dir)
+  for project in a a b; do
+    if [[ "$project" == "b" ]]; then
+      tail -n +4 "$FIXTURES/test_transcript.jsonl" >>"$tmp/t.jsonl"
+    fi
+    echo "{\"session_id\":\"history-$$\",\"transcript_path\":\"$tmp/t.jsonl\",\"workspace\":{\"project_dir\":\"/tmp/history-$project-$$\"}}" |
+      NO_COLOR=1 "$BIN" -t --history >/dev/null || exit_code=$?
+  done
+  local expected
+  expected="$(grep -c '"usage"' "$FIXTURES/test_transcript.jsonl")"
+
+  local row
+  row="$("$BIN" query --by session,day | grep "history-$$")" || exit_code=$?
+  rm -rf "$tmp"
+
+  # One row per assistant turn: neither the growth nor the re-parse duplicates
+  if [[ "$exit_code" -eq 0 ]] && [[ "$(echo "$row" | awk '{print $3}')" == "$expected" ]]; then
+    test_passed "Turn history store and query"
+  else
+    test_failed "Turn history store and query"
+    echo "$row"
+  fi
+}
+
+test_history_torn_dict() {
+  local tmp dict
+  tmp="$(mktemp -d)"
+  dict="/tmp/mini-ccstatus/$(id -u)/history/session.dict"
+  cp "$FIXTURES/test_transcript.jsonl" "$tmp/t.jsonl"
+
+  local exit_code=0 session
+  # An interrupted append leaves a line without its newline before the second session
+  for session in a b; do
+    if [[ "$session" == "b" ]]; then
+      printf 'torn-%s' "$$" >>"$dict"
+    fi
+    echo "{\"session_id\":\"torn-$session-$$\",\"transcript_path\":\"$tmp/t.jsonl\",\"workspace\":{\"project_dir\":\"/tmp/torn-$session-$$\"}}" |
+      NO_COLOR=1 "$BIN" -t --history >/dev/null || exit_code=$?
+  done
+  local expected
+  expected="$(grep -c '"usage"' "$FIXTURES/test_transcript.jsonl")"
+
+  local row
+  row="$("$BIN" query --by session | grep "torn-b-$$")" || exit_code=$?
+  rm -rf "$tmp"
+
+  # The torn bytes are cut off, so the new entry is a line of its own
+  if [[ "$exit_code" -eq 0 ]] && [[ "$(tail -n 1 "$dict")" == "torn-b-$$" ]] &&
+    [[ "$(echo "$row" | awk '{print $2}')" == "$expected" ]]; then
+    test_passed "History dictionary append after a torn line"
+  else
+    test_failed "History dictionary append after a torn line"
+    echo "$row"
+  fi
+}
+
+test_project_root() {
+  local tmp
+  tmp="$(mktemp -d)"
+  mkdir -p "$tmp/repo/.git" "$tmp/repo/a/b/c/d/e"
+
+  local exit_code=0 inside cached outside
+  local payload="{\"cwd\":\"$tmp/repo/a/b/c/d/e\",\"workspace\":{\"project_dir\":\"$tmp/repo\"}}"
+  inside="$(echo "$payload" | NO_COLOR=1 "$BIN")" || exit_code=$?
+  cached="$(echo "$payload" | NO_COLOR=1 "$BIN")" || exit_code=$?
+  # Removing .git changes the root's mtime, which invalidates the cached entry
+  rmdir "$tmp/repo/.git"
+  outside="$(echo "$payload" | NO_COLOR=1 "$BIN")" || exit_code=$?
+  rm -rf "$tmp"
+
+  if [[ "$exit_code" -eq 0 ]] && [[ "$inside" == *"| repo/a/b/c/d/e |"* ]] &&
+    [[ "$cached" == "$inside" ]] && [[ "$outside" == *"| e | repo |"* ]]; then
+    test_passed "Repository-relative directory"
+  else
+    test_failed "Repository-relative directory"
+    echo "$inside"
+    echo "$outside"
+  fi
+}
+
+test_budget_ms() {
+  local tmp
+  tmp="$(mktemp -d)"
+  local i
+  for ((i = 0; i < 4000; i++)); do
+    cat "$FIXTURES/test_transcript.jsonl"
+  done >"$tmp/t.jsonl"
+
+  local exit_code=0 first last full ticks=0
+  local payload="{\"session_id\":\"budget-$$\",\"transcript_path\":\"$tmp/t.jsonl\",\"workspace\":{\"project_dir\":\"/tmp/budget-$$\"}}"
+  first="$(echo "$payload" | NO_COLOR=1 "$BIN" -t --budget-ms 1)" || exit_code=$?
+  last="$first"
+  # Each tick continues from the saved offset until the whole file is parsed
+  while [[ "$(echo "$last" | tail -n 1)" == *"+" ]] && [[ "$ticks" -lt 500 ]]; do
+    last="$(echo "$payload" | NO_COLOR=1 "$BIN" -t --budget-ms 1)" || exit_code=$?
+    ticks=$((ticks + 1))
+  done
+  full="$(echo "{\"session_id\":\"budget-full-$$\",\"transcript_path\":\"$tmp/t.jsonl\"}" | NO_COLOR=1 "$BIN" -t)" || exit_code=$?
+  rm -rf "$tmp"
+
+  if [[ "$exit_code" -eq 0 ]] && [[ "$(echo "$first" | tail -n 1)" == *"+" ]] && [[ "$ticks" -gt 0 ]] &&
+    [[ "$(echo "$last" | tail -n 1)" == "$(echo "$full" | tail -n 1)" ]]; then
+    test_passed "Transcript parse budget (--budget-ms)"
+  else
+    test_failed "Transcript parse budget (--budget-ms)"
+    echo "$first"
+    echo "$last"
+    echo "$full"
+  fi
+}
+
+test_approximate() {
+  local tmp
+  tmp="$(mktemp -d)"
+  local i
+  for ((i = 0; i < 8000; i++)); do
+    cat "$FIXTURES/test_transcript.jsonl"
+  done >"$tmp/t.jsonl"
+
+  local exit_code=0 approx full
+  local payload="{\"session_id\":\"approx-$$\",\"transcript_path\":\"$tmp/t.jsonl\",\"workspace\":{\"project_dir\":\"/tmp/approx-$$\"}}"
+  approx="$(echo "$payload" | NO_COLOR=1 "$BIN" -c -t --approximate --budget-ms 1)" || exit_code=$?
+  full="$(echo "{\"session_id\":\"approx-full-$$\",\"transcript_path\":\"$tmp/t.jsonl\"}" | NO_COLOR=1 "$BIN" -c -t)" || exit_code=$?
+  rm -rf "$tmp"
+
+  # Session estimated (~ and error bound), context exact and unmarked
+  local ses ctx
+  ses="$(echo "$approx" | grep '^Ses')"
+  ctx="$(echo "$approx" | grep '^Ctx')"
+  if [[ "$exit_code" -eq 0 ]] && [[ "$ses" == *"~"*"±"*"%" ]] &&
+    [[ "$ctx" == "$(echo "$full" | grep '^Ctx')" ]]; then
+    test_passed "Approximate session totals (--approximate)"
+  else
+    test_failed "Approximate session totals (--approximate)"
+    echo "$approx"
+    echo "$full"
+  fi
+}
+
+test_config_file() {
+  local tmp
+  tmp="$(mktemp -d)"
+  mkdir -p "$tmp/mini-ccstatus"
+  printf '# layout\nsession-tokens = true\nverbose = yes  # labels\nunknown-key = 1\n' >"$tmp/mini-ccstatus/config"
+
+  local exit_code=0 first second edited ignored colored
+  local payload="{\"session_id\":\"config-$$\",\"transcript_path\":\"$FIXTURES/test_transcript.jsonl\"}"
+  first="$(echo "$payload" | NO_COLOR=1 XDG_CONFIG_HOME="$tmp" "$BIN")" || exit_code=$?
+  # Second run reads the snapshot instead of the text
+  second="$(echo "$payload" | NO_COLOR=1 XDG_CONFIG_HOME="$tmp" "$BIN")" || exit_code=$?
+  printf 'session-tokens = true\n' >"$tmp/mini-ccstatus/config"
+  edited="$(echo "$payload" | NO_COLOR=1 XDG_CONFIG_HOME="$tmp" "$BIN")" || exit_code=$?
+  ignored="$(echo "$payload" | NO_COLOR=1 XDG_CONFIG_HOME="$tmp" "$BIN" --no-config)" || exit_code=$?
+  printf 'color-cost = 196\ncolor-dir = 256\n' >"$tmp/mini-ccstatus/config"
+  colored="$(echo "$payload" | XDG_CONFIG_HOME="$tmp" "$BIN")" || exit_code=$?
+  rm -rf "$tmp"
+
+  if [[ "$exit_code" -eq 0 ]] && [[ "$first" == *"Session "* ]] && [[ "$first" == "$second" ]] &&
+    [[ -f "/tmp/mini-ccstatus/$(id -u)/config.snap" ]] &&
+    [[ "$edited" == *"Ses "* ]] && [[ "$edited" != *"Session "* ]] && [[ "$ignored" != *"Ses"* ]] &&
+    [[ "$colored" == *"38;5;196m\$0."* ]] && [[ "$colored" == *"38;5;81m"* ]]; then
+    test_passed "Config file and snapshot"
+  else
+    test_failed "Config file and snapshot"
+    echo "$first"
+    echo "$edited"
+    echo "$ignored"
+    echo "$colored"
+  fi
+}
+
+# Test: Truncated and malformed strings stay valid UTF-8
+test_utf8_fields() {
+  local name exit_code=0 output
+  name="$(printf 'a%.0s' {1..62})"
+  # 62 + 2 bytes: the é straddles the 63-byte model name limit; 0xFF is never valid
+  output="$(printf '{"model":{"display_name":"%s\xc3\xa9"},"version":"1.0\xff","cwd":"/tmp/caf\xc3\xa9"}' "$name" |
+    NO_COLOR=1 "$BIN")" || exit_code=$?
+
+  if [[ "$exit_code" -eq 0 ]] && printf '%s' "$output" | iconv -f UTF-8 -t UTF-8 >/dev/null 2>&1 &&
+    [[ "$output" == *"$name "* ]] && [[ "$output" == *'1.0?'* ]] && [[ "$output" == *$'caf\xc3\xa9'* ]]; then
+    test_passed "UTF-8 safe truncation and sanitizing"
+  else
+    test_failed "UTF-8 safe truncation and sanitizing"
+    echo "  output: $output"
+    echo "  exit code: $exit_code"
+  fi
+}
+
+test_chunk_resume() {
+  local tmp
+  tmp="$(mktemp -d)"
+  local i
+  for ((i = 0; i < 300; i++)); do
+    cat "$FIXTURES/test_transcript.jsonl"
+  done >"$tmp/old.jsonl"
+  # Resumed session: a copy of the old transcript plus new turns
+  { cat "$tmp/old.jsonl" "$FIXTURES/test_transcript.jsonl"; } >"$tmp/new.jsonl"
+
+  local exit_code=0 resumed fresh
+  local store="/tmp/mini-ccstatus/$(id -u)/chunks.store"
+  echo "{\"session_id\":\"chunks-old-$$\",\"transcript_path\":\"$tmp/old.jsonl\"}" |
+    NO_COLOR=1 "$BIN" -t >/dev/null || exit_code=$?
+  local recorded=0
+  [[ -s "$store" ]] && recorded=1
+  resumed="$(echo "{\"session_id\":\"chunks-new-$$\",\"transcript_path\":\"$tmp/new.jsonl\"}" | NO_COLOR=1 "$BIN" -t -c)" || exit_code=$?
+  # Same transcript without the store: a full parse must agree
+  rm -f "$store"
+  fresh="$(echo "{\"session_id\":\"chunks-fresh-$$\",\"transcript_path\":\"$tmp/new.jsonl\"}" | NO_COLOR=1 "$BIN" -t -c)" || exit_code=$?
+  rm -rf "$tmp"
+
+  if [[ "$exit_code" -eq 0 ]] && [[ "$recorded" -eq 1 ]] && [[ "$resumed" == "$fresh" ]] &&
+    [[ "$resumed" == *"Ses"* ]]; then
+    test_passed "Resumed transcript reuses known chunks"
+  else
+    test_failed "Resumed transcript reuses known chunks"
+    echo "$resumed"
+    echo "$fresh"
+  fi
+}
+
+# Test: a session's cache is not reused for another transcript of the same size
+test_cache_transcript_identity() {
+  local tmp
+  tmp="$(mktemp -d)"
+  cp "$FIXTURES/test_transcript.jsonl" "$tmp/first.jsonl"
+  # Same length, other token counts
+  sed 's/"output_tokens":500/"output_tokens":900/' "$FIXTURES/test_transcript.jsonl" >"$tmp/second.jsonl"
+
+  local exit_code=0 first second fresh
+  first="$(echo "{\"session_id\":\"identity-$$\",\"transcript_path\":\"$tmp/first.jsonl\"}" |
+    NO_COLOR=1 "$BIN" -t)" || exit_code=$?
+  second="$(echo "{\"session_id\":\"identity-$$\",\"transcript_path\":\"$tmp/second.jsonl\"}" |
+    NO_COLOR=1 "$BIN" -t)" || exit_code=$?
+  fresh="$(echo "{\"session_id\":\"identity-fresh-$$\",\"transcript_path\":\"$tmp/second.jsonl\"}" |
+    NO_COLOR=1 "$BIN" -t)" || exit_code=$?
+  rm -rf "$tmp"
+
+  if [[ "$exit_code" -eq 0 ]] && [[ "$second" == "$fresh" ]] && [[ "$first" != "$second" ]]; then
+    test_passed "Cache is checked against the transcript identity"
+  else
+    test_failed "Cache is checked against the transcript identity"
+    echo "$first"
+    echo "$second"
+    echo "$fresh"
+  fi
+}
+
+# Test: --turn-cost follows the request in progress across renders
+test_turn_cost() {
+  local tmp
+  tmp="$(mktemp -d)"
+  cp "$FIXTURES/test_transcript.jsonl" "$tmp/t.jsonl"
+  local render_json
+  render_json() { echo "{\"session_id\":\"turn-$$\",\"transcript_path\":\"$tmp/t.jsonl\",\"cost\":{\"total_cost_usd\":$1}}"; }
+
+  local exit_code=0 first prompt tools
+  first="$(render_json 0.05 | NO_COLOR=1 "$BIN" -u | tail -1)" || exit_code=$?
+  printf '%s\n' '{"type":"user","message":{"role":"user","content":[{"type":"text","text":"Next"}]}}' >>"$tmp/t.jsonl"
+  prompt="$(render_json 0.05 | NO_COLOR=1 "$BIN" -u | tail -1)" || exit_code=$?
+  # Tool results stay in the same turn
+  printf '%s\n' \
+    '{"type":"assistant","message":{"role":"assistant","usage":{"input_tokens":100,"output_tokens":50}}}' \
+    '{"type":"user","message":{"role":"user","content":[{"type":"tool_result","content":"ok"}]}}' \
+    '{"type":"assistant","message":{"role":"assistant","usage":{"input_tokens":200,"output_tokens":50}}}' \
+    >>"$tmp/t.jsonl"
+  tools="$(render_json 0.08 | NO_COLOR=1 "$BIN" -u | tail -1)" || exit_code=$?
+  rm -rf "$tmp"
+
+  if [[ "$exit_code" -eq 0 ]] && [[ "$first" == "Trn 3.4K" ]] && [[ "$prompt" == "Trn 0 / \$0.0000" ]] &&
+    [[ "$tools" == "Trn 400 / \$0.0300" ]]; then
+    test_passed "Current turn tokens and cost"
+  else
+    test_failed "Current turn tokens and cost"
+    echo "$first"
+    echo "$prompt"
+    echo "$tools"
+  fi
+}
+
+# Test: --activity shades active minutes and splits active from idle time
+test_activity() {
+  local tmp
+  tmp="$(mktemp -d)"
+  cp "$FIXTURES/test_transcript.jsonl" "$tmp/t.jsonl"
+  local json="{\"session_id\":\"activity-$$\",\"transcript_path\":\"$tmp/t.jsonl\"}"
+
+  local exit_code=0 first later
+  first="$(echo "$json" | NO_COLOR=1 "$BIN" --activity | tail -1)" || exit_code=$?
+  # One more turn 90 minutes after the fixture's last one
+  printf '%s\n' \
+    '{"type":"assistant","timestamp":"2025-01-15T11:32:30Z","message":{"role":"assistant","usage":{"input_tokens":10,"output_tokens":5}}}' \
+    >>"$tmp/t.jsonl"
+  later="$(echo "$json" | NO_COLOR=1 "$BIN" -b -v | tail -1)" || exit_code=$?
+  rm -rf "$tmp"
+
+  if [[ "$exit_code" -eq 0 ]] && [[ "$first" == "Act ░░░░░░░░░░░░░░░▁ 0h03m/0h00m idle" ]] &&
+    [[ "$later" == "Activity ░░░░░░░░░░░░░▁░▁ 0h04m active, 1h29m idle" ]]; then
+    test_passed "Activity timeline"
+  else
+    test_failed "Activity timeline"
+    echo "$first"
+    echo "$later"
+  fi
+}
+
+# Test: --api-errors shows failed and retried requests only after a recent error
+test_api_errors() {
+  local tmp
+  tmp="$(mktemp -d)"
+  cp "$FIXTURES/test_transcript.jsonl" "$tmp/t.jsonl"
+  local json="{\"session_id\":\"api-errors-$$\",\"transcript_path\":\"$tmp/t.jsonl\"}"
+  local retry failed
+  retry() { echo "{\"type\":\"system\",\"subtype\":\"api_error\",\"level\":\"error\",\"retryInMs\":1100,\"retryAttempt\":1,\"timestamp\":\"$1\"}"; }
+  failed() { echo "{\"type\":\"assistant\",\"isApiErrorMessage\":true,\"timestamp\":\"$1\",\"message\":{\"model\":\"<synthetic>\",\"role\":\"assistant\",\"usage\":{\"input_tokens\":0,\"output_tokens\":0}}}"; }
+
+  local exit_code=0 old recent
+  retry "2025-01-15T10:03:00Z" >>"$tmp/t.jsonl"
+  old="$(echo "$json" | NO_COLOR=1 "$BIN" --api-errors | tail -1)" || exit_code=$?
+  retry "$(date -u -d '-150 seconds' +%Y-%m-%dT%H:%M:%SZ)" >>"$tmp/t.jsonl"
+  failed "$(date -u -d '-130 seconds' +%Y-%m-%dT%H:%M:%SZ)" >>"$tmp/t.jsonl"
+  recent="$(echo "$json" | NO_COLOR=1 "$BIN" -r | tail -1)" || exit_code=$?
+  rm -rf "$tmp"
+
+  if [[ "$exit_code" -eq 0 ]] && [[ "$old" != Err* ]] && [[ "$recent" == "Err 1 failed, 2 retried, 2m ago" ]]; then
+    test_passed "API errors after a recent failure"
+  else
+    test_failed "API errors after a recent failure"
+    echo "$old"
+    echo "$recent"
+  fi
+}
+
+# Test: --files counts distinct files read and edited by tool calls
+test_files_touched() {
+  local tmp
+  tmp="$(mktemp -d)"
+  cp "$FIXTURES/test_transcript.jsonl" "$tmp/t.jsonl"
+  local json="{\"session_id\":\"files-$$\",\"transcript_path\":\"$tmp/t.jsonl\"}"
+  local tool
+  tool() { echo "{\"type\":\"tool_use\",\"name\":\"$1\",\"input\":{\"file_path\":\"$2\"}}"; }
+
+  local exit_code=0 none touched
+  none="$(echo "$json" | NO_COLOR=1 "$BIN" --files | tail -1)" || exit_code=$?
+  echo "{\"type\":\"assistant\",\"message\":{\"role\":\"assistant\",\"content\":[$(tool Read /p/a.c),$(tool Read /p/b.c),$(tool Edit /p/a.c),$(tool Read /p/a.c),$(tool Write /p/c.c)],\"usage\":{\"input_tokens\":10,\"output_tokens\":5}}}" >>"$tmp/t.jsonl"
+  touched="$(echo "$json" | NO_COLOR=1 "$BIN" -f | tail -1)" || exit_code=$?
+  rm -rf "$tmp"
+
+  if [[ "$exit_code" -eq 0 ]] && [[ "$none" != Files* ]] && [[ "$touched" == "Files 2 edited / 2 read" ]]; then
+    test_passed "Files touched by tool calls"
+  else
+    test_failed "Files touched by tool calls"
+    echo "$none"
+    echo "$touched"
+  fi
+}
+
+test_abandoned_branches() {
+  local tmp
+  tmp="$(mktemp -d)"
+  local json="{\"session_id\":\"branch-$$\",\"transcript_path\":\"$tmp/t.jsonl\"}"
+  local entry
+  entry() { echo "{\"type\":\"$1\",\"uuid\":\"$2\",\"parentUuid\":\"$3\",\"message\":{\"role\":\"$1\",\"content\":\"x\"${4:-}}}"; }
+  local usage=',"usage":{"input_tokens":400,"output_tokens":100}'
+
+  {
+    entry user u1 null
+    entry assistant a1 u1 ',"usage":{"input_tokens":80,"output_tokens":20}'
+    entry user u2 a1
+    entry assistant a2 u2 "$usage"
+  } >"$tmp/t.jsonl"
+  local exit_code=0 linear edited
+  linear="$(echo "$json" | NO_COLOR=1 "$BIN" -c -x | tail -1)" || exit_code=$?
+  # Editing the second prompt forks from a1
+  {
+    entry user u3 a1
+    entry assistant a3 u3 ',"usage":{"input_tokens":90,"output_tokens":5}'
+  } >>"$tmp/t.jsonl"
+  edited="$(echo "$json" | NO_COLOR=1 "$BIN" -c --abandoned)" || exit_code=$?
+  rm -rf "$tmp"
+
+  if [[ "$exit_code" -eq 0 ]] && [[ "$linear" != Abandoned* ]] && [[ "$edited" == *"Abandoned 500 in 1 fork"* ]] &&
+    [[ "$edited" == *"Ctx "*" 90"* ]]; then
+    test_passed "Abandoned branches and active-branch context"
+  else
+    test_failed "Abandoned branches and active-branch context"
+    echo "$linear"
+    echo "$edited"
+  fi
+}
+
+test_context_mix() {
+  local tmp
+  tmp="$(mktemp -d)"
+  local json="{\"session_id\":\"mix-$$\",\"transcript_path\":\"$tmp/t.jsonl\"}"
+  local body
+  body="$(printf '%*s' 2000 '' | tr ' ' x)"
+  {
+    echo '{"type":"user","uuid":"u1","message":{"role":"user","content":"read it"}}'
+    echo '{"type":"assistant","uuid":"a1","parentUuid":"u1","message":{"role":"assistant","content":[{"type":"text","text":"ok"}],"usage":{"input_tokens":900,"output_tokens":10}}}'
+    echo "{\"type\":\"user\",\"uuid\":\"r1\",\"parentUuid\":\"a1\",\"message\":{\"role\":\"user\",\"content\":[{\"type\":\"tool_result\",\"content\":\"$body\"}]}}"
+  } >"$tmp/t.jsonl"
+
+  local exit_code=0 compact verbose
+  compact="$(echo "$json" | NO_COLOR=1 "$BIN" --context-mix | tail -1)" || exit_code=$?
+  verbose="$(echo "$json" | NO_COLOR=1 "$BIN" -m -v | tail -1)" || exit_code=$?
+  rm -rf "$tmp"
+
+  if [[ "$exit_code" -eq 0 ]] && [[ "$compact" == "Mix ["*"] tools 56%"* ]] &&
+    [[ "$verbose" == *"tool results"*"prompts"*"other)" ]]; then
+    test_passed "Context composition by entry type"
+  else
+    test_failed "Context composition by entry type"
+    echo "$compact"
+    echo "$verbose"
+  fi
+}
+
+test_top_resume_context() {
+  local tmp
+  tmp="$(mktemp -d)"
+  cp "$FIXTURES/test_transcript.jsonl" "$tmp/t.jsonl"
+  local json="{\"session_id\":\"topctx-$$\",\"transcript_path\":\"$tmp/t.jsonl\",\"workspace\":{\"project_dir\":\"/tmp/top-ctx-$$\"}}"
+
+  local exit_code=0 status frame context
+  status="$(echo "$json" | NO_COLOR=1 "$BIN" -c | tail -1)" || exit_code=$?
+  # A tool result after the render: the monitor resumes from the cache and parses it
+  echo '{"type":"user","message":{"role":"user","content":[{"type":"tool_result","content":"ok"}]}}' >>"$tmp/t.jsonl"
+  frame="$(NO_COLOR=1 "$BIN" top --once)" || exit_code=$?
+  context="$(echo "$frame" | grep "top-ctx-$$" | awk '{print $4}')"
+  rm -rf "$tmp"
+
+  if [[ "$exit_code" -eq 0 ]] && [[ -n "$context" ]] && [[ "$context" != "0" ]] &&
+    [[ "$status" == *" $context" ]]; then
+    test_passed "Session monitor keeps the context after resuming"
+  else
+    test_failed "Session monitor keeps the context after resuming"
+    echo "$status"
+    echo "$frame"
+  fi
+}
+
 test_basic_status
 test_multi_pretty
 test_edge_cases
@@ -297,6 +929,28 @@ test_same_dirs
 test_empty_input
 test_eof_handling
 test_exceeds_200k_badge
+test_batch_mode
+test_record_trace
+test_sgr_minimal_escapes
+test_gradient_bars
+test_debounce_window
+test_top_once
+test_history_query
+test_project_root
+test_budget_ms
+test_approximate
+test_config_file
+test_utf8_fields
+test_chunk_resume
+test_cache_transcript_identity
+test_turn_cost
+test_activity
+test_api_errors
+test_files_touched
+test_abandoned_branches
+test_context_mix
+test_top_resume_context
+test_history_torn_dict
 
 # Summary
 echo "===================="
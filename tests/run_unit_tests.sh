@@ -15,22 +15,63 @@ NC='\033[0m' # No Color
 echo "Building unit tests..."
 echo "====================="
 
+# Display code needs the build-time generated gradient tables
+make -s obj/gen/gradient_tables.h
+
 # Build test executable
 cc -g -O0 -Wall -Wextra -DDEBUG \
    -I. \
    tests/test_token_calculator.c \
+   src/activity.c \
+   src/branch.c \
+   src/chunk_store.c \
+   src/file_set.c \
    src/token_calculator.c \
    src/safe_conv.c \
+   src/top_turns.c \
+   src/utf8.c \
    src/json_parser.c \
+   src/json_tape.c \
+   src/render_ctx.c \
+   src/sgr.c \
    lib/cjson/cJSON.c \
    -o tests/test_token_calculator \
    -lm
 
+# Build concurrent render test under ThreadSanitizer
+cc -g -O1 -Wall -Wextra -fsanitize=thread -pthread \
+   -I. -Iobj/gen \
+   tests/test_render_threads.c \
+   src/activity.c \
+   src/branch.c \
+   src/cache.c \
+   src/chunk_store.c \
+   src/cli_parser.c \
+   src/config.c \
+   src/display.c \
+   src/file_set.c \
+   src/gradient.c \
+   src/history.c \
+   src/json_parser.c \
+   src/json_tape.c \
+   src/project_root.c \
+   src/render.c \
+   src/render_ctx.c \
+   src/safe_conv.c \
+   src/sgr.c \
+   src/token_calculator.c \
+   src/top_turns.c \
+   src/utf8.c \
+   lib/cjson/cJSON.c \
+   -o tests/test_render_threads \
+   -lm
+
 echo "Running unit tests..."
 echo "===================="
 
-# Run tests
-if tests/test_token_calculator; then
+# Run tests (any ThreadSanitizer report fails the threaded test)
+if tests/test_token_calculator && \
+   TSAN_OPTIONS="halt_on_error=1 exitcode=66" tests/test_render_threads; then
   echo ""
   echo -e "${GREEN}SUCCESS${NC}: All unit tests passed!"
   exit 0
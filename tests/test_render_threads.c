@@ -0,0 +1,152 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file test_render_threads.c
+ * @brief Concurrent rendering test for per-render contexts
+ *
+ * Renders hundreds of independent sessions from a pool of threads, each
+ * with its own render context, and checks every output. Built with
+ * -fsanitize=thread by run_unit_tests.sh so any shared mutable state in the
+ * render pipeline shows up as a data race.
+ */
+
+#define _GNU_SOURCE // For mkdtemp, open_memstream
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../src/cache.h"
+#include "../src/cli_parser.h"
+#include "../src/render.h"
+#include "../src/render_ctx.h"
+
+#define N_SESSIONS 256
+#define N_THREADS 8
+
+#define GREEN "\033[0;32m"
+#define RED "\033[0;31m"
+#define NC "\033[0m"
+
+struct session_case {
+  char transcript[256];
+  char session_id[64];
+  char json[1024];
+  char *output;
+  size_t output_len;
+  int rc;
+};
+
+static struct session_case cases[N_SESSIONS];
+static atomic_int next_case;
+static struct cli_options opts;
+
+static void *render_worker(void *arg) {
+  (void)arg;
+  struct mccs_render_ctx ctx;
+  while (true) {
+    int i = atomic_fetch_add(&next_case, 1);
+    if (i >= N_SESSIONS) {
+      break;
+    }
+    struct session_case *c = &cases[i];
+    FILE *out = open_memstream(&c->output, &c->output_len);
+    if (!out) {
+      c->rc = -1;
+      continue;
+    }
+    mccs_render_ctx_init(&ctx, (i % 2) == 0, false, out);
+    ResultVoid result = mccs_render_json(&ctx, &opts, c->json, strlen(c->json));
+    c->rc = IS_OK(result) ? 0 : (int)UNWRAP_ERR(result);
+    mccs_render_ctx_free(&ctx);
+    fclose(out);
+  }
+  return NULL;
+}
+
+static int write_transcript(const char *path, unsigned int context) {
+  FILE *f = fopen(path, "w");
+  if (!f) {
+    return 0;
+  }
+  fprintf(f, "{\"message\":{\"role\":\"user\",\"content\":\"hi\"}}\n");
+  fprintf(f, "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":%u,\"output_tokens\":3}}}\n", context);
+  fclose(f);
+  return 1;
+}
+
+int main(void) {
+  printf("Running concurrent render tests...\n");
+  printf("==================================\n");
+
+  char dir[] = "/tmp/test_render_XXXXXX";
+  if (!mkdtemp(dir)) {
+    fprintf(stderr, "mkdtemp failed\n");
+    return 1;
+  }
+
+  mccs_init_cli_options(&opts);
+  opts.show_context_tokens = true;
+  opts.show_session_tokens = true;
+  opts.show_token_breakdown = true;
+
+  for (int i = 0; i < N_SESSIONS; i++) {
+    struct session_case *c = &cases[i];
+    snprintf(c->transcript, sizeof(c->transcript), "%s/session_%03d.jsonl", dir, i);
+    snprintf(c->session_id, sizeof(c->session_id), "thread-test-%d-%d", (int)getpid(), i);
+    if (!write_transcript(c->transcript, (unsigned int)i + 1)) {
+      fprintf(stderr, "failed to write %s\n", c->transcript);
+      return 1;
+    }
+    snprintf(c->json, sizeof(c->json),
+             "{\"session_id\":\"%s\",\"transcript_path\":\"%s\",\"cwd\":\"/tmp\","
+             "\"model\":{\"id\":\"m-%d\",\"display_name\":\"Model %d\"},"
+             "\"workspace\":{\"project_dir\":\"/tmp\"},\"version\":\"1.0.0\","
+             "\"cost\":{\"total_cost_usd\":0.5,\"total_duration_ms\":1000}}",
+             c->session_id, c->transcript, i, i);
+  }
+
+  pthread_t threads[N_THREADS];
+  for (int t = 0; t < N_THREADS; t++) {
+    pthread_create(&threads[t], NULL, render_worker, NULL);
+  }
+  for (int t = 0; t < N_THREADS; t++) {
+    pthread_join(threads[t], NULL);
+  }
+
+  int failed = 0;
+  struct mccs_render_ctx cleanup_ctx;
+  mccs_render_ctx_init(&cleanup_ctx, false, false, NULL);
+  for (int i = 0; i < N_SESSIONS; i++) {
+    struct session_case *c = &cases[i];
+    char expected_model[32];
+    char expected_ctx[32];
+    snprintf(expected_model, sizeof(expected_model), "Model %d", i);
+    snprintf(expected_ctx, sizeof(expected_ctx), " %d\n", i + 1);
+
+    const char *ctx_line = c->output ? strstr(c->output, "Ctx") : NULL;
+    const char *ctx_end = ctx_line ? strchr(ctx_line, '\n') : NULL;
+    const char *ctx_value = ctx_line ? strstr(ctx_line, expected_ctx) : NULL;
+    if (c->rc != 0 || !strstr(c->output, expected_model) || !ctx_value || ctx_value + 1 > ctx_end) {
+      fprintf(stderr, "session %d: unexpected output (rc=%d):\n%s\n", i, c->rc, c->output ? c->output : "(null)");
+      failed++;
+    }
+
+    free(c->output);
+    unlink(c->transcript);
+    unlink(get_cache_path(&cleanup_ctx, c->session_id));
+  }
+  mccs_render_ctx_free(&cleanup_ctx);
+  rmdir(dir);
+
+  printf("==================================\n");
+  if (failed > 0) {
+    printf("%sFAIL%s %d/%d sessions rendered incorrectly\n", RED, NC, failed, N_SESSIONS);
+    return 1;
+  }
+  printf("%sPASS%s %d sessions rendered concurrently on %d threads\n", GREEN, NC, N_SESSIONS, N_THREADS);
+  return 0;
+}
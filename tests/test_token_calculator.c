@@ -16,7 +16,15 @@
 #include <string.h>
 #include <unistd.h>
 #include "../src/token_calculator.h"
+#include "../src/activity.h"
+#include "../src/branch.h"
+#include "../src/chunk_store.h"
+#include "../src/file_set.h"
+#include "../src/json_tape.h"
 #include "../src/safe_conv.h"
+#include "../src/sgr.h"
+#include "../src/top_turns.h"
+#include "../src/utf8.h"
 
 // Test helper macros
 #define TEST_ASSERT(condition) \
@@ -399,6 +407,947 @@ static int test_overflow_boundaries(void) {
   return 1;
 }
 
+static int test_top_turns_heap(void) {
+  struct top_turns turns;
+  top_turns_init(&turns);
+
+  // Pseudo-random totals; the heap must keep exactly the K largest
+  uint64_t values[64];
+  uint64_t seed = 12345;
+  for (int i = 0; i < 64; i++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    values[i] = (seed >> 33) % 100000;
+    struct turn_record record = {.offset = (uint64_t)i * 100, .timestamp = i};
+    record.tokens.total_tokens = values[i];
+    top_turns_push(&turns, &record);
+  }
+  TEST_ASSERT(turns.count == TOP_TURNS_CAPACITY);
+
+  // Reference: selection of the K largest values
+  for (int i = 0; i < 64; i++) {
+    for (int j = i + 1; j < 64; j++) {
+      if (values[j] > values[i]) {
+        uint64_t tmp = values[i];
+        values[i] = values[j];
+        values[j] = tmp;
+      }
+    }
+  }
+
+  struct turn_record sorted[TOP_TURNS_CAPACITY];
+  size_t n = top_turns_sorted(&turns, sorted);
+  TEST_ASSERT(n == TOP_TURNS_CAPACITY);
+  for (size_t i = 0; i < n; i++) {
+    TEST_ASSERT(sorted[i].tokens.total_tokens == values[i]);
+  }
+
+  // Fewer turns than capacity are all kept, most expensive first
+  top_turns_init(&turns);
+  struct turn_record small = {.offset = 1};
+  small.tokens.total_tokens = 10;
+  top_turns_push(&turns, &small);
+  small.offset = 2;
+  small.tokens.total_tokens = 30;
+  top_turns_push(&turns, &small);
+  n = top_turns_sorted(&turns, sorted);
+  TEST_ASSERT(n == 2);
+  TEST_ASSERT(sorted[0].offset == 2 && sorted[1].offset == 1);
+
+  TEST_PASS("top_turns_heap");
+  return 1;
+}
+
+static int test_activity_map(void) {
+  struct activity_map map;
+  activity_init(&map);
+  TEST_ASSERT(activity_count(&map, 0, INT64_MAX) == 0);
+  TEST_ASSERT(activity_first(&map) == 0);
+
+  // Random walk of turn times against a plain list of active minutes
+  const int64_t base = 1736935200 / 60;
+  static bool active[16 * ACTIVITY_WINDOW_MIN];
+  memset(active, 0, sizeof(active));
+  int64_t latest = 0;
+  uint64_t seed = 777;
+  for (int i = 0; i < 2000; i++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    // Mostly forward, sometimes a few minutes back or a long pause
+    int64_t minute = latest + (int64_t)((seed >> 33) % 7) - 2;
+    if ((seed >> 20) % 97 == 0) {
+      minute = latest + ACTIVITY_WINDOW_MIN / 3;
+    }
+    if (minute < 0 || minute >= 16 * ACTIVITY_WINDOW_MIN) {
+      break;
+    }
+    activity_mark(&map, (base + minute) * 60 + (int64_t)((seed >> 40) % 60));
+    latest = minute > latest ? minute : latest;
+    if (latest - minute < ACTIVITY_WINDOW_MIN) {
+      active[minute] = true;
+    }
+
+    int64_t lo = latest - (int64_t)((seed >> 12) % (ACTIVITY_WINDOW_MIN + 40));
+    int64_t hi = lo + (int64_t)((seed >> 24) % (ACTIVITY_WINDOW_MIN + 40));
+    uint32_t expected = 0;
+    int64_t first = -1;
+    for (int64_t m = latest - ACTIVITY_WINDOW_MIN + 1; m <= latest; m++) {
+      if (m >= 0 && active[m]) {
+        expected += m >= lo && m <= hi;
+        first = first < 0 ? m : first;
+      }
+    }
+    TEST_ASSERT(map.last_minute == base + latest);
+    TEST_ASSERT(activity_count(&map, base + lo, base + hi) == expected);
+    TEST_ASSERT(activity_first(&map) == base + first);
+  }
+
+  // Older than the window: ignored; a day later: only the new minute remains
+  activity_mark(&map, (map.last_minute - ACTIVITY_WINDOW_MIN) * 60);
+  TEST_ASSERT(activity_first(&map) > map.last_minute - ACTIVITY_WINDOW_MIN);
+  activity_mark(&map, (map.last_minute + 1440) * 60);
+  TEST_ASSERT(activity_count(&map, 0, INT64_MAX) == 1);
+  TEST_ASSERT(activity_first(&map) == map.last_minute);
+
+  TEST_PASS("activity_map");
+  return 1;
+}
+
+static int test_file_set(void) {
+  struct file_set set;
+  file_set_init(&set);
+  char path[64];
+
+  // Exact while the table has room; a file both read and edited counts in each
+  for (int i = 0; i < 40; i++) {
+    int len = snprintf(path, sizeof(path), "/repo/src/file_%d.c", i);
+    file_set_add(&set, FILE_TOUCH_READ, path, (size_t)len);
+    file_set_add(&set, FILE_TOUCH_READ, path, (size_t)len);
+    if (i % 4 == 0) {
+      file_set_add(&set, FILE_TOUCH_EDIT, path, (size_t)len);
+    }
+  }
+  TEST_ASSERT(!set.sketched);
+  TEST_ASSERT(file_set_count(&set, FILE_TOUCH_READ) == 40);
+  TEST_ASSERT(file_set_count(&set, FILE_TOUCH_EDIT) == 10);
+
+  // Past the table: estimates within a few standard errors, same size
+  for (int i = 0; i < 20000; i++) {
+    int len = snprintf(path, sizeof(path), "/repo/src/file_%d.c", i);
+    file_set_add(&set, FILE_TOUCH_READ, path, (size_t)len);
+    if (i % 4 == 0) {
+      file_set_add(&set, FILE_TOUCH_EDIT, path, (size_t)len);
+    }
+  }
+  TEST_ASSERT(set.sketched);
+  uint32_t read = file_set_count(&set, FILE_TOUCH_READ);
+  uint32_t edited = file_set_count(&set, FILE_TOUCH_EDIT);
+  TEST_ASSERT(read > 17000 && read < 23000);
+  TEST_ASSERT(edited > 4250 && edited < 5750);
+
+  // Tool calls of assistant lines, resumed scan included
+  const char* lines =
+    "{\"message\":{\"role\":\"assistant\",\"content\":["
+    "{\"type\":\"tool_use\",\"name\":\"Read\",\"input\":{\"file_path\":\"/p/a.c\"}},"
+    "{\"type\":\"tool_use\",\"name\":\"Bash\",\"input\":{\"command\":\"ls\"}},"
+    "{\"type\":\"tool_use\",\"name\":\"Edit\",\"input\":{\"file_path\":\"/p/a.c\"}}],"
+    "\"usage\":{\"input_tokens\":10,\"output_tokens\":1}}}\n"
+    "{\"message\":{\"role\":\"user\",\"content\":[{\"type\":\"tool_result\",\"content\":\"ok\"}]}}\n";
+  const char* more =
+    "{\"message\":{\"role\":\"assistant\",\"content\":["
+    "{\"type\":\"tool_use\",\"name\":\"Write\",\"input\":{\"file_path\":\"/p/b.c\"}},"
+    "{\"type\":\"tool_use\",\"name\":\"MultiEdit\",\"input\":{\"file_path\":\"/p/a.c\"}},"
+    "{\"type\":\"tool_use\",\"name\":\"Read\",\"input\":{\"file_path\":\"/p/c.c\"}}],"
+    "\"usage\":{\"input_tokens\":10,\"output_tokens\":1}}}\n";
+  const char* created = create_test_jsonl(lines);
+  TEST_ASSERT(created != NULL);
+  char saved_path[256];
+  snprintf(saved_path, sizeof(saved_path), "%s", created);
+
+  struct mccs_scratch scratch = {.line = NULL, .cap = 0};
+  struct transcript_stats stats;
+  init_transcript_stats(&stats);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &stats)));
+  TEST_ASSERT(file_set_count(&stats.files, FILE_TOUCH_READ) == 1);
+  TEST_ASSERT(file_set_count(&stats.files, FILE_TOUCH_EDIT) == 1);
+  FILE* f = fopen(saved_path, "a");
+  TEST_ASSERT(f != NULL);
+  fputs(more, f);
+  fclose(f);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &stats)));
+  TEST_ASSERT(file_set_count(&stats.files, FILE_TOUCH_READ) == 2);
+  TEST_ASSERT(file_set_count(&stats.files, FILE_TOUCH_EDIT) == 2);
+
+  free(scratch.line);
+  json_doc_free(&scratch.json);
+  unlink(saved_path);
+
+  TEST_PASS("file_set");
+  return 1;
+}
+
+static int test_scan_transcript_resume(void) {
+  const char* part1 =
+    "{\"message\":{\"role\":\"user\",\"content\":\"hi\"}}\n"
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":200,\"output_tokens\":100}},\"timestamp\":\"2025-01-15T10:00:01Z\"}\n";
+  const char* part2 =
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":900,\"output_tokens\":10}},\"timestamp\":\"2025-01-15T10:05:00.500Z\"}\n"
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":50,\"output_tokens\":5}}}\n";
+
+  const char* path = create_test_jsonl(part1);
+  TEST_ASSERT(path != NULL);
+  char saved_path[256];
+  snprintf(saved_path, sizeof(saved_path), "%s", path);
+
+  struct mccs_scratch scratch = {.line = NULL, .cap = 0};
+  struct transcript_stats incremental;
+  init_transcript_stats(&incremental);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &incremental)));
+  TEST_ASSERT(incremental.parsed_offset == strlen(part1));
+  TEST_ASSERT(incremental.top_turns.count == 1);
+
+  // Append a complete line and a partial one still being written
+  FILE* f = fopen(saved_path, "a");
+  TEST_ASSERT(f != NULL);
+  fputs(part2, f);
+  fputs("{\"message\":{\"role\":\"assis", f);
+  fclose(f);
+
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &incremental)));
+  TEST_ASSERT(incremental.parsed_offset == strlen(part1) + strlen(part2));
+
+  struct transcript_stats full;
+  init_transcript_stats(&full);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &full)));
+
+  TEST_ASSERT(incremental.session_tokens.total_tokens == full.session_tokens.total_tokens);
+  TEST_ASSERT(incremental.session_tokens.total_tokens == 1265);
+  TEST_ASSERT(incremental.context_tokens == 50);
+  TEST_ASSERT(incremental.top_turns.count == 3);
+
+  struct turn_record sorted[TOP_TURNS_CAPACITY];
+  TEST_ASSERT(top_turns_sorted(&incremental.top_turns, sorted) == 3);
+  TEST_ASSERT(sorted[0].tokens.total_tokens == 910);
+  TEST_ASSERT(sorted[0].offset == strlen(part1));
+  TEST_ASSERT(sorted[0].timestamp == 1736935500);
+  TEST_ASSERT(sorted[2].timestamp == 0);
+
+  free(scratch.line);
+  json_doc_free(&scratch.json);
+  unlink(saved_path);
+
+  TEST_PASS("scan_transcript_resume");
+  return 1;
+}
+
+static int test_scan_transcript_compaction(void) {
+  const char* part1 =
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":1000,\"output_tokens\":100}}}\n"
+    "{\"type\":\"system\",\"subtype\":\"compact_boundary\",\"content\":\"Conversation compacted\"}\n"
+    "{\"type\":\"user\",\"isCompactSummary\":true,\"message\":{\"role\":\"user\",\"content\":\"summary\"}}\n";
+  const char* part2 =
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":300,\"output_tokens\":20}}}\n"
+    "{\"type\":\"user\",\"isCompactSummary\":true,\"message\":{\"role\":\"user\",\"content\":\"summary\"}}\n"
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":40,\"output_tokens\":2}}}\n";
+
+  const char* path = create_test_jsonl(part1);
+  TEST_ASSERT(path != NULL);
+  char saved_path[256];
+  snprintf(saved_path, sizeof(saved_path), "%s", path);
+
+  struct mccs_scratch scratch = {.line = NULL, .cap = 0};
+  struct transcript_stats incremental;
+  init_transcript_stats(&incremental);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &incremental)));
+  // Boundary and its summary count once; the context restarts
+  TEST_ASSERT(incremental.compactions == 1);
+  TEST_ASSERT(incremental.context_tokens == 0);
+  TEST_ASSERT(incremental.segment_tokens.total_tokens == 0);
+
+  FILE* f = fopen(saved_path, "a");
+  TEST_ASSERT(f != NULL);
+  fputs(part2, f);
+  fclose(f);
+
+  // Tail-only scan: a summary-only (older format) compaction inside the new bytes
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &incremental)));
+  struct transcript_stats full;
+  init_transcript_stats(&full);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &full)));
+
+  TEST_ASSERT(incremental.compactions == 2);
+  TEST_ASSERT(full.compactions == 2);
+  TEST_ASSERT(incremental.segment_tokens.total_tokens == 42);
+  TEST_ASSERT(full.segment_tokens.total_tokens == 42);
+  TEST_ASSERT(incremental.session_tokens.total_tokens == 1462);
+  TEST_ASSERT(incremental.context_tokens == 40);
+
+  free(scratch.line);
+  json_doc_free(&scratch.json);
+  unlink(saved_path);
+
+  TEST_PASS("scan_transcript_compaction");
+  return 1;
+}
+
+static int test_current_turn(void) {
+  const char* part1 =
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":1000,\"output_tokens\":100}}}\n"
+    "{\"type\":\"user\",\"message\":{\"role\":\"user\",\"content\":\"Fix the build\"},"
+    "\"timestamp\":\"2025-01-15T10:00:00Z\"}\n"
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":200,\"output_tokens\":20}}}\n"
+    "{\"type\":\"user\",\"message\":{\"role\":\"user\",\"content\":[{\"type\":\"tool_result\",\"content\":\"ok\"}]}}\n";
+  // Tool results, meta lines, summaries and subagent prompts do not start a turn
+  const char* part2 =
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":300,\"output_tokens\":30}}}\n"
+    "{\"type\":\"user\",\"isMeta\":true,\"message\":{\"role\":\"user\",\"content\":\"caveat\"}}\n"
+    "{\"type\":\"user\",\"isSidechain\":true,\"message\":{\"role\":\"user\",\"content\":\"subtask\"}}\n"
+    "{\"type\":\"system\",\"subtype\":\"compact_boundary\"}\n"
+    "{\"type\":\"user\",\"isCompactSummary\":true,\"message\":{\"role\":\"user\",\"content\":\"summary\"}}\n"
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":5,\"output_tokens\":5}}}\n";
+
+  const char* path = create_test_jsonl(part1);
+  TEST_ASSERT(path != NULL);
+  char saved_path[256];
+  snprintf(saved_path, sizeof(saved_path), "%s", path);
+
+  struct mccs_scratch scratch = {.line = NULL, .cap = 0};
+  struct transcript_stats incremental;
+  init_transcript_stats(&incremental);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &incremental)));
+  size_t prompt_offset = strchr(part1, '\n') - part1 + 1;
+  TEST_ASSERT(incremental.turn.started);
+  TEST_ASSERT(incremental.turn.prompt_offset == prompt_offset);
+  TEST_ASSERT(incremental.turn.prompt_time == 1736935200);
+  TEST_ASSERT(incremental.turn.tokens.total_tokens == 220);
+
+  FILE* f = fopen(saved_path, "a");
+  TEST_ASSERT(f != NULL);
+  fputs(part2, f);
+  fclose(f);
+
+  // Tail-only scan carries the turn on
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &incremental)));
+  struct transcript_stats full;
+  init_transcript_stats(&full);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &full)));
+  TEST_ASSERT(incremental.turn.prompt_offset == prompt_offset);
+  TEST_ASSERT(incremental.turn.tokens.total_tokens == 560);
+  TEST_ASSERT(full.turn.prompt_offset == prompt_offset);
+  TEST_ASSERT(full.turn.tokens.total_tokens == 560);
+
+  // A new prompt (text block in an array) restarts it
+  f = fopen(saved_path, "a");
+  TEST_ASSERT(f != NULL);
+  fputs("{\"type\":\"user\",\"message\":{\"role\":\"user\",\"content\":[{\"type\":\"text\",\"text\":\"Next\"}]}}\n", f);
+  fclose(f);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &incremental)));
+  TEST_ASSERT(incremental.turn.prompt_offset == strlen(part1) + strlen(part2));
+  TEST_ASSERT(incremental.turn.tokens.total_tokens == 0);
+  TEST_ASSERT(incremental.turn.prompt_time == 0);
+
+  free(scratch.line);
+  json_doc_free(&scratch.json);
+  unlink(saved_path);
+
+  TEST_PASS("current_turn");
+  return 1;
+}
+
+static int test_api_errors(void) {
+  const char* part1 =
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":100,\"output_tokens\":10}}}\n"
+    "{\"type\":\"system\",\"subtype\":\"api_error\",\"level\":\"error\",\"retryInMs\":1200,"
+    "\"retryAttempt\":1,\"maxRetries\":10,\"timestamp\":\"2025-01-15T10:00:00Z\"}\n"
+    "{\"type\":\"system\",\"subtype\":\"api_error\",\"level\":\"error\",\"retryInMs\":2400,"
+    "\"retryAttempt\":2,\"maxRetries\":10,\"timestamp\":\"2025-01-15T10:00:02Z\"}\n";
+  // The request gives up; text mentioning the markers is no error
+  const char* part2 =
+    "{\"type\":\"assistant\",\"isApiErrorMessage\":true,\"timestamp\":\"2025-01-15T10:00:05Z\","
+    "\"message\":{\"model\":\"<synthetic>\",\"role\":\"assistant\",\"content\":[{\"type\":\"text\","
+    "\"text\":\"API Error: 529 Overloaded\"}],\"usage\":{\"input_tokens\":0,\"output_tokens\":0}}}\n"
+    "{\"type\":\"user\",\"message\":{\"role\":\"user\",\"content\":\"why \\\"isApiErrorMessage\\\":true?\"}}\n"
+    "{\"message\":{\"role\":\"assistant\",\"content\":\"subtype api_error\","
+    "\"usage\":{\"input_tokens\":50,\"output_tokens\":5}}}\n";
+
+  const char* path = create_test_jsonl(part1);
+  TEST_ASSERT(path != NULL);
+  char saved_path[256];
+  snprintf(saved_path, sizeof(saved_path), "%s", path);
+
+  struct mccs_scratch scratch = {.line = NULL, .cap = 0};
+  struct transcript_stats incremental;
+  init_transcript_stats(&incremental);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &incremental)));
+  TEST_ASSERT(incremental.api_errors.retried == 2);
+  TEST_ASSERT(incremental.api_errors.failed == 0);
+  TEST_ASSERT(incremental.api_errors.last_error == 1736935202);
+
+  FILE* f = fopen(saved_path, "a");
+  TEST_ASSERT(f != NULL);
+  fputs(part2, f);
+  fclose(f);
+
+  // Counts carry over a resumed scan and match a full one
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &incremental)));
+  struct transcript_stats full;
+  init_transcript_stats(&full);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &full)));
+  TEST_ASSERT(incremental.api_errors.retried == 2);
+  TEST_ASSERT(incremental.api_errors.failed == 1);
+  TEST_ASSERT(incremental.api_errors.last_error == 1736935205);
+  TEST_ASSERT(memcmp(&incremental.api_errors, &full.api_errors, sizeof(full.api_errors)) == 0);
+  TEST_ASSERT(full.session_tokens.total_tokens == 165);
+
+  free(scratch.line);
+  json_doc_free(&scratch.json);
+  unlink(saved_path);
+
+  TEST_PASS("api_errors");
+  return 1;
+}
+
+static int test_branch_accounting(void) {
+  // u1 -> a1 -> u2 -> a2, then u2 is edited: u3 has the same parent as u2
+  const char* part1 =
+    "{\"type\":\"user\",\"uuid\":\"u1\",\"parentUuid\":null,\"message\":{\"role\":\"user\",\"content\":\"one\"}}\n"
+    "{\"type\":\"assistant\",\"uuid\":\"a1\",\"parentUuid\":\"u1\",\"message\":{\"role\":\"assistant\","
+    "\"usage\":{\"input_tokens\":80,\"output_tokens\":20}}}\n"
+    "{\"type\":\"user\",\"uuid\":\"u2\",\"parentUuid\":\"a1\",\"message\":{\"role\":\"user\",\"content\":\"two\"}}\n"
+    "{\"type\":\"assistant\",\"uuid\":\"a2\",\"parentUuid\":\"u2\",\"message\":{\"role\":\"assistant\","
+    "\"usage\":{\"input_tokens\":400,\"output_tokens\":100}}}\n";
+  // A subagent line and a line without uuid do not move the branch
+  const char* part2 =
+    "{\"type\":\"user\",\"uuid\":\"u3\",\"parentUuid\":\"a1\",\"message\":{\"role\":\"user\",\"content\":\"two!\"}}\n"
+    "{\"type\":\"assistant\",\"uuid\":\"s1\",\"parentUuid\":null,\"isSidechain\":true,"
+    "\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":9000,\"output_tokens\":1}}}\n"
+    "{\"type\":\"file-history-snapshot\",\"messageId\":\"u3\"}\n"
+    "{\"type\":\"assistant\",\"uuid\":\"a3\",\"parentUuid\":\"u3\",\"message\":{\"role\":\"assistant\","
+    "\"usage\":{\"input_tokens\":90,\"cache_read_input_tokens\":30,\"output_tokens\":5}}}\n";
+
+  const char* path = create_test_jsonl(part1);
+  TEST_ASSERT(path != NULL);
+  char saved_path[256];
+  snprintf(saved_path, sizeof(saved_path), "%s", path);
+
+  struct mccs_scratch scratch = {.line = NULL, .cap = 0};
+  struct transcript_stats incremental;
+  init_transcript_stats(&incremental);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &incremental)));
+  TEST_ASSERT(incremental.context_tokens == 400);
+  TEST_ASSERT(branch_abandoned_tokens(&incremental.branch) == 0);
+
+  FILE* f = fopen(saved_path, "a");
+  TEST_ASSERT(f != NULL);
+  fputs(part2, f);
+  fclose(f);
+
+  // The edited branch is the active one; the subagent turn is no part of it
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &incremental)));
+  TEST_ASSERT(incremental.context_tokens == 120);
+  TEST_ASSERT(incremental.branch.forks == 1);
+  TEST_ASSERT(incremental.branch.tip.path_tokens == 225);
+  TEST_ASSERT(branch_abandoned_tokens(&incremental.branch) == 500);
+  TEST_ASSERT(incremental.session_tokens.total_tokens == 9726);
+
+  struct transcript_stats full;
+  init_transcript_stats(&full);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &full)));
+  TEST_ASSERT(memcmp(&incremental.branch, &full.branch, sizeof(full.branch)) == 0);
+  TEST_ASSERT(full.context_tokens == 120);
+
+  uint64_t context = 0;
+  TEST_ASSERT(IS_OK(parse_tokens_single_pass(saved_path, NULL, &context)));
+  TEST_ASSERT(context == 120);
+
+  free(scratch.line);
+  json_doc_free(&scratch.json);
+  unlink(saved_path);
+
+  TEST_PASS("branch_accounting");
+  return 1;
+}
+
+static int test_context_mix(void) {
+  const char* asst = "[{\"type\":\"text\",\"text\":\"ok\\n\"}]";
+  const char* result = "{\"type\":\"tool_result\",\"tool_use_id\":\"t1\",\"content\":\"file body\"}";
+  const char* image = "{\"type\":\"image\",\"source\":{\"data\":\"AAAA\"}}";
+  const char* attachment = "{\"type\":\"file\",\"content\":\"x\"}";
+  char jsonl[2048];
+  snprintf(jsonl, sizeof(jsonl),
+           "{\"type\":\"user\",\"uuid\":\"u1\",\"message\":{\"role\":\"user\",\"content\":\"hello\"}}\n"
+           "{\"type\":\"attachment\",\"uuid\":\"f1\",\"parentUuid\":\"u1\",\"attachment\":%s}\n"
+           "{\"type\":\"assistant\",\"uuid\":\"a1\",\"parentUuid\":\"f1\",\"message\":{\"role\":\"assistant\","
+           "\"content\":%s,\"usage\":{\"input_tokens\":10,\"output_tokens\":1}}}\n"
+           "{\"type\":\"user\",\"uuid\":\"r1\",\"parentUuid\":\"a1\",\"message\":{\"role\":\"user\",\"content\":[%s,%s]}}\n"
+           "{\"type\":\"user\",\"uuid\":\"m1\",\"parentUuid\":\"r1\",\"isMeta\":true,"
+           "\"message\":{\"role\":\"user\",\"content\":\"caveat\"}}\n"
+           "{\"type\":\"user\",\"uuid\":\"u2\",\"parentUuid\":\"m1\",\"message\":{\"role\":\"user\",\"content\":\"go on\"}}\n",
+           attachment, asst, result, image);
+
+  const char* path = create_test_jsonl(jsonl);
+  TEST_ASSERT(path != NULL);
+  char saved_path[256];
+  snprintf(saved_path, sizeof(saved_path), "%s", path);
+
+  struct mccs_scratch scratch = {.line = NULL, .cap = 0};
+  struct transcript_stats stats;
+  init_transcript_stats(&stats);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &stats)));
+  const uint32_t* bytes = stats.branch.tip.context_bytes;
+  TEST_ASSERT(bytes[CONTEXT_TOOL_RESULTS] == strlen(result));
+  TEST_ASSERT(bytes[CONTEXT_ASSISTANT] == strlen(asst));
+  TEST_ASSERT(bytes[CONTEXT_PROMPTS] == strlen("hello") + strlen("go on"));
+  TEST_ASSERT(bytes[CONTEXT_ATTACHMENTS] == strlen(attachment) + strlen(image) + strlen("caveat"));
+
+  // Editing the second prompt drops it from the mix; a compaction starts over
+  FILE* f = fopen(saved_path, "a");
+  TEST_ASSERT(f != NULL);
+  fputs("{\"type\":\"user\",\"uuid\":\"u3\",\"parentUuid\":\"m1\",\"message\":{\"role\":\"user\",\"content\":\"stop\"}}\n", f);
+  fclose(f);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &stats)));
+  TEST_ASSERT(bytes[CONTEXT_PROMPTS] == strlen("hello") + strlen("stop"));
+
+  f = fopen(saved_path, "a");
+  TEST_ASSERT(f != NULL);
+  fputs("{\"type\":\"system\",\"subtype\":\"compact_boundary\",\"uuid\":\"c1\",\"parentUuid\":null,"
+        "\"logicalParentUuid\":\"u3\"}\n"
+        "{\"type\":\"user\",\"uuid\":\"s1\",\"parentUuid\":\"c1\",\"isCompactSummary\":true,"
+        "\"message\":{\"role\":\"user\",\"content\":\"summary\"}}\n", f);
+  fclose(f);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &stats)));
+  TEST_ASSERT(bytes[CONTEXT_ASSISTANT] == strlen("summary"));
+  TEST_ASSERT(bytes[CONTEXT_TOOL_RESULTS] == 0 && bytes[CONTEXT_PROMPTS] == 0 && bytes[CONTEXT_ATTACHMENTS] == 0);
+
+  free(scratch.line);
+  json_doc_free(&scratch.json);
+  unlink(saved_path);
+
+  TEST_PASS("context_mix");
+  return 1;
+}
+
+/**
+ * Append transcript lines [first, last) to buf; line 300 is a compaction boundary,
+ * every 25th line a prompt (every 50th an edit of the one before) and every 10th
+ * turn reads a file
+ */
+static size_t chunk_test_lines(char* buf, size_t len, int first, int last, const char* variant) {
+  for (int i = first; i < last; i++) {
+    if (i == 300) {
+      len += (size_t)sprintf(buf + len, "{\"type\":\"system\",\"subtype\":\"compact_boundary\",\"uuid\":\"%s-%d\"}\n",
+                             variant, i);
+      continue;
+    }
+    if (i > 0 && i % 25 == 0) {
+      int parent = i % 50 == 0 ? i - 26 : i - 1;
+      len += (size_t)sprintf(buf + len,
+                             "{\"type\":\"user\",\"message\":{\"role\":\"user\",\"content\":\"prompt %d\"},"
+                             "\"parentUuid\":\"%s-%08x\",\"uuid\":\"%s-%08x\"}\n",
+                             i, variant, (unsigned)(parent * 2654435761u), variant, (unsigned)(i * 2654435761u));
+      continue;
+    }
+    len += (size_t)sprintf(buf + len,
+                           "{\"message\":{\"role\":\"assistant\",\"content\":[{\"type\":\"%s\",\"name\":\"Read\","
+                           "\"input\":{\"file_path\":\"/src/f%d.c\"},\"text\":\"turn %d of a long session\"}],"
+                           "\"usage\":{\"input_tokens\":%d,\"output_tokens\":%d}},\"parentUuid\":\"%s-%08x\","
+                           "\"uuid\":\"%s-%08x\"}\n",
+                           i % 10 == 0 ? "tool_use" : "text", i, i, 100 + i, i % 37, variant,
+                           (unsigned)((i - 1) * 2654435761u), variant, (unsigned)(i * 2654435761u));
+  }
+  return len;
+}
+
+/**
+ * Scan a transcript with a fresh state, resuming from the chunk store if one is given
+ */
+static bool chunk_test_scan(const char* path, const char* store, struct mccs_scratch* scratch,
+                            struct transcript_stats* stats, bool* resumed) {
+  init_transcript_stats(stats);
+  stats->chunk_store = store;
+  *resumed = store && chunk_store_resume(store, path, NULL, stats);
+  return IS_OK(scan_transcript(path, scratch, stats));
+}
+
+static bool chunk_test_same(const struct transcript_stats* a, const struct transcript_stats* b) {
+  struct turn_record sa[TOP_TURNS_CAPACITY], sb[TOP_TURNS_CAPACITY];
+  size_t n = top_turns_sorted(&a->top_turns, sa);
+  return a->session_tokens.total_tokens == b->session_tokens.total_tokens &&
+         a->segment_tokens.total_tokens == b->segment_tokens.total_tokens &&
+         a->context_tokens == b->context_tokens && a->compactions == b->compactions &&
+         a->files.counts[FILE_TOUCH_READ] == b->files.counts[FILE_TOUCH_READ] &&
+         a->branch.forks == b->branch.forks && a->branch.total_tokens == b->branch.total_tokens &&
+         a->parsed_offset == b->parsed_offset && n == top_turns_sorted(&b->top_turns, sb) &&
+         (n == 0 || (sa[0].offset == sb[0].offset && sa[0].tokens.total_tokens == sb[0].tokens.total_tokens));
+}
+
+static int test_chunk_store(void) {
+  char store[] = "/tmp/mccs_chunks_XXXXXX";
+  int fd = mkstemp(store);
+  TEST_ASSERT(fd >= 0);
+  close(fd);
+
+  // Chunks cover every byte fed, never shorter than CHUNK_MIN_BYTES
+  struct chunk_cursor a, b;
+  chunk_cursor_init(&a);
+  chunk_cursor_init(&b);
+  char line[128];
+  size_t cuts = 0, fed = 0;
+  for (int i = 0; i < 4000; i++) {
+    int n = snprintf(line, sizeof(line), "{\"uuid\":\"%08x\"}\n", (unsigned)(i * 2654435761u));
+    fed += (size_t)n;
+    if (chunk_cursor_feed(&a, line, (size_t)n)) {
+      cuts++;
+      TEST_ASSERT(a.start >= cuts * CHUNK_MIN_BYTES && a.bytes == 0);
+    }
+  }
+  TEST_ASSERT(cuts > 0);
+  TEST_ASSERT(a.start + a.bytes == fed);
+  TEST_ASSERT(!chunk_cursor_feed(&b, line, strlen(line)));
+
+  char* text = malloc(1 << 20);
+  TEST_ASSERT(text != NULL);
+  struct mccs_scratch scratch = {.line = NULL, .cap = 0};
+  struct transcript_stats with_store, plain;
+  bool resumed;
+
+  // First session: nothing known yet, every chunk end is recorded
+  size_t old_len = chunk_test_lines(text, 0, 0, 800, "a");
+  char old_path[256];
+  snprintf(old_path, sizeof(old_path), "%s", create_test_jsonl(text));
+  TEST_ASSERT(chunk_test_scan(old_path, store, &scratch, &with_store, &resumed));
+  TEST_ASSERT(!resumed);
+  TEST_ASSERT(with_store.parsed_offset == old_len);
+  TEST_ASSERT(with_store.branch.forks > 0 && with_store.files.counts[FILE_TOUCH_READ] > 0);
+  struct chunk_cursor old_cursor = with_store.chunks;
+  TEST_ASSERT(old_cursor.chain != 0 && old_cursor.bytes > 0);
+
+  // Resumed session: the old transcript plus new turns, resumed at a chunk end inside the copy
+  size_t new_len = chunk_test_lines(text, old_len, 800, 900, "a");
+  char new_path[256];
+  snprintf(new_path, sizeof(new_path), "%s", create_test_jsonl(text));
+  struct transcript_stats probe;
+  init_transcript_stats(&probe);
+  TEST_ASSERT(chunk_store_resume(store, new_path, NULL, &probe));
+  TEST_ASSERT(probe.parsed_offset > old_len / 2 && probe.parsed_offset <= old_len);
+  TEST_ASSERT(chunk_test_scan(new_path, store, &scratch, &with_store, &resumed));
+  TEST_ASSERT(resumed);
+  TEST_ASSERT(chunk_test_scan(new_path, NULL, &scratch, &plain, &resumed));
+  TEST_ASSERT(plain.parsed_offset == new_len);
+  TEST_ASSERT(chunk_test_same(&with_store, &plain));
+  TEST_ASSERT(plain.compactions == 1);
+
+  // The cursor of the old scan starts the lookup at its last chunk end (the scan above recorded the
+  // chunks after it), unless its digest no longer matches
+  struct transcript_stats hinted;
+  init_transcript_stats(&hinted);
+  TEST_ASSERT(chunk_store_resume(store, new_path, &old_cursor, &hinted));
+  init_transcript_stats(&probe);
+  TEST_ASSERT(chunk_store_resume(store, new_path, NULL, &probe));
+  TEST_ASSERT(hinted.parsed_offset > old_cursor.start && hinted.parsed_offset == probe.parsed_offset);
+  TEST_ASSERT(chunk_test_same(&hinted, &probe));
+  old_cursor.digest ^= 1;
+  init_transcript_stats(&hinted);
+  TEST_ASSERT(chunk_store_resume(store, new_path, &old_cursor, &hinted));
+  TEST_ASSERT(hinted.parsed_offset == probe.parsed_offset);
+  unlink(new_path);
+
+  // Forked session: diverges after line 250, so only chunks before it match
+  size_t fork_at = chunk_test_lines(text, 0, 0, 250, "a");
+  chunk_test_lines(text, fork_at, 250, 700, "b");
+  snprintf(new_path, sizeof(new_path), "%s", create_test_jsonl(text));
+  init_transcript_stats(&probe);
+  TEST_ASSERT(chunk_store_resume(store, new_path, NULL, &probe));
+  TEST_ASSERT(probe.parsed_offset <= fork_at);
+  TEST_ASSERT(chunk_test_scan(new_path, store, &scratch, &with_store, &resumed));
+  TEST_ASSERT(chunk_test_scan(new_path, NULL, &scratch, &plain, &resumed));
+  TEST_ASSERT(chunk_test_same(&with_store, &plain));
+  unlink(new_path);
+
+  // Unrelated transcript: no prefix to reuse
+  chunk_test_lines(text, 0, 0, 400, "c");
+  snprintf(new_path, sizeof(new_path), "%s", create_test_jsonl(text));
+  init_transcript_stats(&probe);
+  TEST_ASSERT(!chunk_store_resume(store, new_path, NULL, &probe));
+  TEST_ASSERT(probe.parsed_offset == 0);
+
+  free(text);
+  free(scratch.line);
+  json_doc_free(&scratch.json);
+  unlink(new_path);
+  unlink(old_path);
+  unlink(store);
+
+  TEST_PASS("chunk_store");
+  return 1;
+}
+
+static int test_prompt_cache_tracking(void) {
+  const char* content =
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":10,\"cache_creation_input_tokens\":500}},\"timestamp\":\"2025-01-15T10:00:00Z\"}\n"
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":10,\"cache_read_input_tokens\":500}},\"timestamp\":\"2025-01-15T10:04:00Z\"}\n"
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":10,\"output_tokens\":3}},\"timestamp\":\"2025-01-15T10:09:00Z\"}\n";
+  const char* extended =
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"cache_creation_input_tokens\":80,"
+    "\"cache_creation\":{\"ephemeral_5m_input_tokens\":0,\"ephemeral_1h_input_tokens\":80}}},\"timestamp\":\"2025-01-15T11:00:00Z\"}\n";
+
+  const char* path = create_test_jsonl(content);
+  TEST_ASSERT(path != NULL);
+  char saved_path[256];
+  snprintf(saved_path, sizeof(saved_path), "%s", path);
+
+  struct mccs_scratch scratch = {.line = NULL, .cap = 0};
+  struct transcript_stats stats;
+  init_transcript_stats(&stats);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &stats)));
+  // The read refreshes the 5 minute entry; the uncached turn does not
+  TEST_ASSERT(stats.prompt_cache.last_touch == 1736935440);
+  TEST_ASSERT(stats.prompt_cache.ttl_s == PROMPT_CACHE_TTL_S);
+
+  FILE* f = fopen(saved_path, "a");
+  TEST_ASSERT(f != NULL);
+  fputs(extended, f);
+  fclose(f);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &stats)));
+  TEST_ASSERT(stats.prompt_cache.last_touch == 1736938800);
+  TEST_ASSERT(stats.prompt_cache.ttl_s == PROMPT_CACHE_TTL_LONG_S);
+
+  free(scratch.line);
+  json_doc_free(&scratch.json);
+  unlink(saved_path);
+
+  TEST_PASS("prompt_cache_tracking");
+  return 1;
+}
+
+static int test_estimate_transcript_tokens(void) {
+  const char* part1 =
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":200,\"output_tokens\":100}}}\n";
+  const char* part2 =
+    "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":900,\"output_tokens\":10}}}\n"
+    "{\"type\":\"system\",\"subtype\":\"compact_boundary\",\"content\":\"Conversation compacted\"}\n";
+
+  const char* path = create_test_jsonl(part1);
+  TEST_ASSERT(path != NULL);
+  char saved_path[256];
+  snprintf(saved_path, sizeof(saved_path), "%s", path);
+
+  struct mccs_scratch scratch = {.line = NULL, .cap = 0};
+  struct transcript_stats stats;
+  init_transcript_stats(&stats);
+  TEST_ASSERT(IS_OK(scan_transcript(saved_path, &scratch, &stats)));
+
+  FILE* f = fopen(saved_path, "a");
+  TEST_ASSERT(f != NULL);
+  fputs(part2, f);
+  fclose(f);
+  size_t size = strlen(part1) + strlen(part2);
+
+  // A rest smaller than the sample is read whole: exact, no error bound
+  struct token_estimate estimate;
+  TEST_ASSERT(IS_OK(estimate_transcript_tokens(saved_path, &scratch, &stats, size, &estimate)));
+  TEST_ASSERT(estimate.valid);
+  TEST_ASSERT(estimate.tokens.total_tokens == 1210);
+  TEST_ASSERT(estimate.error_pct == 0);
+
+  // The last assistant turn is followed by a compaction: the context is empty
+  uint64_t context = 1;
+  ResultVoid tail = scan_transcript_tail(saved_path, &scratch, size, &context);
+  TEST_ASSERT(IS_OK(tail) && UNWRAP_OK(tail) == 1 && context == 0);
+
+  // Larger than the sample: alternate two turn sizes so chunks differ
+  f = fopen(saved_path, "w");
+  TEST_ASSERT(f != NULL);
+  uint64_t exact = 0;
+  for (int i = 0; i < 40000; i++) {
+    int input = (i / 500) % 2 ? 1000 : 10;
+    fprintf(f, "{\"message\":{\"role\":\"assistant\",\"usage\":{\"input_tokens\":%d,\"output_tokens\":5}}}\n", input);
+    exact += (uint64_t)input + 5;
+  }
+  size = (size_t)ftell(f);
+  fclose(f);
+  TEST_ASSERT(size > (size_t)ESTIMATE_SAMPLE_CHUNKS * ESTIMATE_CHUNK_BYTES);
+
+  init_transcript_stats(&stats);
+  TEST_ASSERT(IS_OK(estimate_transcript_tokens(saved_path, &scratch, &stats, size, &estimate)));
+  TEST_ASSERT(estimate.valid && estimate.error_pct > 0);
+  uint64_t diff = estimate.tokens.total_tokens > exact ? estimate.tokens.total_tokens - exact
+                                                      : exact - estimate.tokens.total_tokens;
+  TEST_ASSERT(diff * 100 <= exact * estimate.error_pct * 2);
+
+  TEST_ASSERT(IS_OK(scan_transcript_tail(saved_path, &scratch, size, &context)));
+  TEST_ASSERT(context == 1000);
+
+  free(scratch.line);
+  json_doc_free(&scratch.json);
+  unlink(saved_path);
+
+  TEST_PASS("estimate_transcript_tokens");
+  return 1;
+}
+
+static int test_json_tape(void) {
+  struct json_doc doc;
+  json_doc_init(&doc);
+
+  // Nested lookup, numbers, literals and a key that repeats deeper down
+  const char *text = " {\"message\": {\"role\": \"assistant\", \"usage\": {\"input_tokens\": 1200,"
+                     " \"ratio\": -2.5e-1, \"flags\": [true, false, null]}},"
+                     " \"usage\": 7, \"empty\": {}, \"list\": []}\n";
+  ResultJsonRef root = json_doc_parse(&doc, text, strlen(text));
+  TEST_ASSERT(IS_OK(root));
+  json_ref message = json_get(&doc, UNWRAP_OK(root), "message");
+  json_ref usage = json_get(&doc, message, "usage");
+  TEST_ASSERT(json_is_object(&doc, usage));
+  TEST_ASSERT(json_number(&doc, json_get(&doc, usage, "input_tokens")) == 1200);
+  TEST_ASSERT(json_number(&doc, json_get(&doc, usage, "ratio")) == -0.25);
+  TEST_ASSERT(json_number(&doc, json_get(&doc, UNWRAP_OK(root), "usage")) == 7);
+  TEST_ASSERT(strcmp(json_string(&doc, json_get(&doc, message, "role")), "assistant") == 0);
+  TEST_ASSERT(json_type_of(&doc, json_get(&doc, usage, "flags")) == JSON_TYPE_ARRAY);
+  TEST_ASSERT(json_is_object(&doc, json_get(&doc, UNWRAP_OK(root), "empty")));
+  TEST_ASSERT(json_get(&doc, UNWRAP_OK(root), "missing") == JSON_REF_NONE);
+  TEST_ASSERT(json_get(&doc, json_get(&doc, UNWRAP_OK(root), "usage"), "x") == JSON_REF_NONE);
+  TEST_ASSERT(json_string(&doc, JSON_REF_NONE) == NULL);
+
+  // Array walk
+  json_ref flags = json_get(&doc, usage, "flags");
+  json_ref item = json_first(&doc, flags);
+  TEST_ASSERT(json_is_true(&doc, item));
+  item = json_next(&doc, flags, item);
+  TEST_ASSERT(json_type_of(&doc, item) == JSON_TYPE_FALSE);
+  item = json_next(&doc, flags, item);
+  TEST_ASSERT(json_type_of(&doc, item) == JSON_TYPE_NULL);
+  TEST_ASSERT(json_next(&doc, flags, item) == JSON_REF_NONE);
+  TEST_ASSERT(json_first(&doc, json_get(&doc, UNWRAP_OK(root), "list")) == JSON_REF_NONE);
+  TEST_ASSERT(json_first(&doc, usage) == JSON_REF_NONE);
+  const char *nested = "[{\"type\":\"tool_result\",\"content\":[{\"a\":1}]},\"x\"]";
+  ResultJsonRef array = json_doc_parse(&doc, nested, strlen(nested));
+  TEST_ASSERT(IS_OK(array));
+  item = json_first(&doc, UNWRAP_OK(array));
+  TEST_ASSERT(json_is_object(&doc, item));
+  item = json_next(&doc, UNWRAP_OK(array), item);
+  TEST_ASSERT(strcmp(json_string(&doc, item), "x") == 0);
+  TEST_ASSERT(json_next(&doc, UNWRAP_OK(array), item) == JSON_REF_NONE);
+  // Raw spans: bracket to bracket, escaped length between the quotes
+  TEST_ASSERT(json_span(&doc, UNWRAP_OK(array)) == strlen(nested));
+  TEST_ASSERT(json_span(&doc, json_first(&doc, UNWRAP_OK(array))) == strlen(nested) - 6);
+  TEST_ASSERT(json_span(&doc, item) == 1);
+  TEST_ASSERT(json_span(&doc, JSON_REF_NONE) == 0);
+
+  // Escapes, including backslashes straddling the 64-byte blocks of stage 1
+  char escaped[256];
+  snprintf(escaped, sizeof(escaped),
+           "{\"pad\":\"%s\",\"t\\\"k\":\"a\\\\\\\"b\\n\\u00e9\\ud83d\\ude00\",\"bad\":\"\\x\"}",
+           "0123456789012345678901234567890123456789012345678901\\\\");
+  root = json_doc_parse(&doc, escaped, strlen(escaped));
+  TEST_ASSERT(IS_OK(root));
+  const char *value = json_string(&doc, json_get(&doc, UNWRAP_OK(root), "t\"k"));
+  TEST_ASSERT(value && strcmp(value, "a\\\"b\n\xc3\xa9\xf0\x9f\x98\x80") == 0);
+  TEST_ASSERT(json_get(&doc, UNWRAP_OK(root), "bad") != JSON_REF_NONE);
+  TEST_ASSERT(json_string(&doc, json_get(&doc, UNWRAP_OK(root), "bad")) == NULL);
+
+  // Syntax errors
+  const char *invalid[] = {
+    "", "{", "{\"a\":1,}", "{\"a\" 1}", "[1 2]", "{\"a\":tru}", "{\"a\":01}",
+    "{\"a\":1} x", "\"open", "{\"a\":1]", "[-]", "{1:2}", "nulls",
+  };
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+    root = json_doc_parse(&doc, invalid[i], strlen(invalid[i]));
+    TEST_ASSERT(IS_ERR(root) && UNWRAP_ERR(root) == MCCS_ERR_INVALID_JSON);
+  }
+
+  // Nesting limit
+  char deep[2 * JSON_TAPE_MAX_DEPTH + 3];
+  memset(deep, '[', JSON_TAPE_MAX_DEPTH + 1);
+  memset(deep + JSON_TAPE_MAX_DEPTH + 1, ']', JSON_TAPE_MAX_DEPTH + 1);
+  TEST_ASSERT(IS_ERR(json_doc_parse(&doc, deep, 2 * JSON_TAPE_MAX_DEPTH + 2)));
+  TEST_ASSERT(IS_OK(json_doc_parse(&doc, deep + 1, 2 * JSON_TAPE_MAX_DEPTH)));
+
+  json_doc_free(&doc);
+  TEST_PASS("json_tape");
+  return 1;
+}
+
+static int test_utf8(void) {
+  // Valid: ASCII past the 16-byte fast path, 2/3/4-byte sequences, limits
+  TEST_ASSERT(utf8_validate("", 0));
+  TEST_ASSERT(utf8_validate("plain ascii text longer than sixteen bytes", 42));
+  const char *mixed = "Caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80 \xed\x9f\xbf \xf4\x8f\xbf\xbf";
+  TEST_ASSERT(utf8_validate(mixed, strlen(mixed)));
+
+  // Invalid: stray continuation, overlongs, surrogate, above U+10FFFF, cut short
+  const char *invalid[] = {
+    "\x80", "\xc0\xaf", "\xe0\x80\xaf", "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xf5\x80\x80\x80",
+    "\xc3", "\xe2\x82", "0123456789abcdef\xff",
+  };
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+    TEST_ASSERT(!utf8_validate(invalid[i], strlen(invalid[i])));
+  }
+
+  // Truncation backs off to the start of the codepoint that does not fit
+  const char *euro = "ab\xe2\x82\xac" "cd"; // "ab€cd"
+  TEST_ASSERT(utf8_truncate(euro, 7, 10) == 7);
+  TEST_ASSERT(utf8_truncate(euro, 7, 5) == 5);
+  TEST_ASSERT(utf8_truncate(euro, 7, 4) == 2);
+  TEST_ASSERT(utf8_truncate(euro, 7, 3) == 2);
+  TEST_ASSERT(utf8_truncate(euro, 7, 2) == 2);
+  TEST_ASSERT(utf8_trim_partial(euro, 4) == 2);
+  TEST_ASSERT(utf8_trim_partial(euro, 5) == 5);
+
+  // Sanitize replaces each bad byte and keeps the valid ones
+  char bad[] = "ok\xff\xc3\xa9\xe2\x82";
+  TEST_ASSERT(utf8_sanitize(bad, strlen(bad)) == 3);
+  TEST_ASSERT(strcmp(bad, "ok?\xc3\xa9??") == 0);
+
+  size_t taken = 0;
+  TEST_ASSERT(utf8_prefix(mixed, strlen(mixed), 5, &taken) == 6 && taken == 5);
+  TEST_ASSERT(utf8_prefix("ab", 2, 5, &taken) == 2 && taken == 2);
+
+  TEST_PASS("utf8");
+  return 1;
+}
+
+static int test_sgr_emitter(void) {
+  char *buf = NULL;
+  size_t len = 0;
+  FILE *out = open_memstream(&buf, &len);
+  TEST_ASSERT(out != NULL);
+
+  struct mccs_render_ctx ctx;
+  mccs_render_ctx_init(&ctx, true, false, out);
+
+  // First escape starts from a reset; repeats of the same style are free
+  sgr_puts(&ctx, ANSI_CYAN, "a");
+  sgr_puts(&ctx, ANSI_CYAN, "b");
+  // Same bold attribute: only the foreground changes
+  sgr_puts(&ctx, ANSI_GREEN, "c");
+  // Default style after colored text needs a reset, then nothing
+  sgr_puts(&ctx, ANSI_RESET, "d");
+  sgr_puts(&ctx, "", "e");
+  // Styles outside the tracked subset are written verbatim
+  sgr_puts(&ctx, "\033[4m", "f");
+  sgr_end_line(&ctx);
+  fflush(out);
+
+  const char *expected =
+    "\033[0;1;38;5;81mab\033[38;5;148mc\033[0mde\033[0m\033[4mf\033[0m\n";
+  TEST_ASSERT(strcmp(buf, expected) == 0);
+
+  // No-color contexts never write escapes
+  rewind(out);
+  mccs_render_ctx_init(&ctx, false, false, out);
+  sgr_puts(&ctx, ANSI_CYAN, "x");
+  sgr_end_line(&ctx);
+  fputc('\0', out);
+  fflush(out);
+  TEST_ASSERT(strcmp(buf, "x\n") == 0);
+
+  fclose(out);
+  free(buf);
+  mccs_render_ctx_free(&ctx);
+
+  TEST_PASS("sgr_emitter");
+  return 1;
+}
+
 // Main test runner
 int main(void) {
   printf("Running token_calculator unit tests...\n");
@@ -422,6 +1371,21 @@ int main(void) {
   RUN_TEST(test_parse_tokens_single_pass);
   RUN_TEST(test_overflow_protection);
   RUN_TEST(test_overflow_boundaries);
+  RUN_TEST(test_top_turns_heap);
+  RUN_TEST(test_activity_map);
+  RUN_TEST(test_file_set);
+  RUN_TEST(test_scan_transcript_resume);
+  RUN_TEST(test_scan_transcript_compaction);
+  RUN_TEST(test_current_turn);
+  RUN_TEST(test_api_errors);
+  RUN_TEST(test_branch_accounting);
+  RUN_TEST(test_context_mix);
+  RUN_TEST(test_chunk_store);
+  RUN_TEST(test_prompt_cache_tracking);
+  RUN_TEST(test_estimate_transcript_tokens);
+  RUN_TEST(test_json_tape);
+  RUN_TEST(test_utf8);
+  RUN_TEST(test_sgr_emitter);
 
   printf("=====================================\n");
   printf("Results: %d/%d tests passed\n", passed, total);
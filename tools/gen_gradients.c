@@ -0,0 +1,175 @@
+// Copyright (c) 2025 Michele Tavella <meeghele@proton.me>
+// Licensed under the MIT License. See LICENSE file for details.
+
+/**
+ * @file gen_gradients.c
+ * @brief Build-time generator for gradient_tables.h (see src/gradient.h)
+ *
+ * Usage: gen_gradients > gradient_tables.h
+ *
+ * For every gradient mode, bar kind and fill level it renders the bar cells
+ * exactly as the terminal should receive them: one color change per cell
+ * (skipped when the quantized color repeats), the empty cells in the theme's
+ * empty color and a trailing reset.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/colors.h"
+#include "src/constants.h"
+#include "src/gradient.h"
+
+#define GEN_SPAN_MAX 2048
+#define GEN_STOPS 3
+#define ANSI_BOLD_PREFIX "\033[1m"
+
+struct rgb {
+  uint8_t r, g, b;
+};
+
+/* Gradient stops per bar kind, sampled at the start, middle and end of the bar */
+static const struct rgb bar_stops[MCCS_BAR_KIND_COUNT][GEN_STOPS] = {
+    [MCCS_BAR_CONTEXT] = {{166, 226, 46}, {230, 219, 116}, {249, 38, 114}},
+    [MCCS_BAR_SESSION] = {{166, 226, 46}, {230, 219, 116}, {249, 38, 114}},
+    [MCCS_BAR_CACHE] = {{249, 38, 114}, {230, 219, 116}, {166, 226, 46}},
+    [MCCS_BAR_API_TIME] = {{95, 95, 135}, {135, 135, 215}, {215, 215, 255}},
+};
+
+static const char *const bar_names[MCCS_BAR_KIND_COUNT] = {
+    [MCCS_BAR_CONTEXT] = "context",
+    [MCCS_BAR_SESSION] = "session",
+    [MCCS_BAR_CACHE] = "cache",
+    [MCCS_BAR_API_TIME] = "api_time",
+};
+
+static const char *const mode_names[MCCS_GRADIENT_MODE_COUNT] = {
+    [MCCS_GRADIENT_256] = "256",
+    [MCCS_GRADIENT_TRUECOLOR] = "truecolor",
+};
+
+/**
+ * Color of cell i, interpolated along the bar's stops
+ */
+static struct rgb cell_color(enum mccs_bar_kind kind, uint32_t i) {
+  const struct rgb *stops = bar_stops[kind];
+  // Position in [0, 1] scaled to stop segments
+  double t = (double)i / (double)(PROGRESS_BAR_WIDTH - 1) * (GEN_STOPS - 1);
+  uint32_t seg = t >= GEN_STOPS - 1 ? GEN_STOPS - 2 : (uint32_t)t;
+  double f = t - seg;
+  const struct rgb *a = &stops[seg];
+  const struct rgb *b = &stops[seg + 1];
+  struct rgb out = {
+      (uint8_t)(a->r + (b->r - a->r) * f + 0.5),
+      (uint8_t)(a->g + (b->g - a->g) * f + 0.5),
+      (uint8_t)(a->b + (b->b - a->b) * f + 0.5),
+  };
+  return out;
+}
+
+/**
+ * Nearest level of the xterm 6x6x6 color cube for one channel
+ */
+static uint32_t cube_level(uint8_t v) {
+  static const uint8_t levels[6] = {0, 95, 135, 175, 215, 255};
+  uint32_t best = 0;
+  for (uint32_t i = 1; i < 6; i++) {
+    if (abs(v - levels[i]) < abs(v - levels[best])) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+/**
+ * SGR parameters selecting a cell's foreground color in the given mode
+ */
+static void cell_params(enum mccs_gradient_mode mode,
+                        struct rgb c,
+                        char *out,
+                        size_t size) {
+  if (mode == MCCS_GRADIENT_TRUECOLOR) {
+    snprintf(out, size, "38;2;%u;%u;%u", c.r, c.g, c.b);
+  } else {
+    uint32_t idx = 16 + 36 * cube_level(c.r) + 6 * cube_level(c.g) + cube_level(c.b);
+    snprintf(out, size, "38;5;%u", idx);
+  }
+}
+
+/**
+ * Render the cells of one bar into span, returning its length
+ */
+static size_t render_span(enum mccs_gradient_mode mode,
+                          enum mccs_bar_kind kind,
+                          uint32_t filled,
+                          char *span) {
+  size_t len = 0;
+  char prev[32] = "";
+  for (uint32_t i = 0; i < filled; i++) {
+    char params[32];
+    cell_params(mode, cell_color(kind, i), params, sizeof(params));
+    if (strcmp(params, prev) != 0) {
+      // The first escape also turns bold on, like the theme colors do
+      len += (size_t)sprintf(span + len, "\033[%s%sm", i == 0 ? "1;" : "", params);
+      memcpy(prev, params, sizeof(prev));
+    }
+    len += (size_t)sprintf(span + len, "%s", PROGRESS_BAR_FILLED);
+  }
+  if (filled < PROGRESS_BAR_WIDTH) {
+    // Bold is already on after filled cells: only the color changes
+    const char *empty = ANSI_CTX_EMPTY;
+    if (filled > 0 && strncmp(empty, ANSI_BOLD_PREFIX, strlen(ANSI_BOLD_PREFIX)) == 0) {
+      empty += strlen(ANSI_BOLD_PREFIX);
+    }
+    len += (size_t)sprintf(span + len, "%s", empty);
+    for (uint32_t i = filled; i < PROGRESS_BAR_WIDTH; i++) {
+      len += (size_t)sprintf(span + len, "%s", PROGRESS_BAR_EMPTY);
+    }
+  }
+  len += (size_t)sprintf(span + len, "%s", ANSI_RESET);
+  return len;
+}
+
+/**
+ * Print bytes as a C string literal (octal escapes never swallow the next char)
+ */
+static void print_literal(const char *bytes,
+                          size_t len) {
+  putchar('"');
+  for (size_t i = 0; i < len; i++) {
+    unsigned char ch = (unsigned char)bytes[i];
+    if (ch >= 0x20 && ch < 0x7f && ch != '"' && ch != '\\' && ch != '?') {
+      putchar(ch);
+    } else {
+      printf("\\%03o", ch);
+    }
+  }
+  putchar('"');
+}
+
+int main(void) {
+  char span[GEN_SPAN_MAX];
+
+  printf("/* Generated by tools/gen_gradients.c - do not edit */\n\n");
+  printf("#ifndef MCCS_GRADIENT_TABLES_H\n#define MCCS_GRADIENT_TABLES_H\n\n");
+  printf("static const struct mccs_gradient_span\n"
+         "    gradient_tables[MCCS_GRADIENT_MODE_COUNT - 1][MCCS_BAR_KIND_COUNT][PROGRESS_BAR_WIDTH + 1] = {\n");
+  for (int mode = MCCS_GRADIENT_256; mode < MCCS_GRADIENT_MODE_COUNT; mode++) {
+    printf("  {\n");
+    for (int kind = 0; kind < MCCS_BAR_KIND_COUNT; kind++) {
+      printf("    { /* %s, %s */\n", mode_names[mode], bar_names[kind]);
+      for (uint32_t filled = 0; filled <= PROGRESS_BAR_WIDTH; filled++) {
+        size_t len = render_span((enum mccs_gradient_mode)mode, (enum mccs_bar_kind)kind, filled, span);
+        printf("      {%zu, ", len);
+        print_literal(span, len);
+        printf("},\n");
+      }
+      printf("    },\n");
+    }
+    printf("  },\n");
+  }
+  printf("};\n\n#endif /* MCCS_GRADIENT_TABLES_H */\n");
+  return 0;
+}